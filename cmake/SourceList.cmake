@@ -34,6 +34,8 @@ endfunction()
 function(set_compile_flags)
     cmake_parse_arguments(PARAM "" "" "COMPILE_FLAGS" ${ARGN})
     set(PARAM_FILES "${PARAM_UNPARSED_ARGUMENTS}")
+    # Multiple flags are stored space separated, so they stay in a single entry.
+    string(REPLACE ";" " " PARAM_COMPILE_FLAGS "${PARAM_COMPILE_FLAGS}")
 
     get_property(SOURCE_PROPERTIES GLOBAL PROPERTY source_properties)
 
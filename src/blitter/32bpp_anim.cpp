@@ -312,6 +312,7 @@ void Blitter_32bppAnim::Draw(Blitter::BlitterParams *bp, BlitterMode mode, ZoomL
 	}
 
 	const BlitterSpriteFlags sprite_flags = ((const SpriteData *) bp->sprite)->flags;
+	if (MayDrawAnimated(mode, sprite_flags)) this->MarkAnimated(bp->dst, bp->left, bp->top, bp->width, bp->height);
 
 	switch (mode) {
 		default: NOT_REACHED();
@@ -397,6 +398,7 @@ void Blitter_32bppAnim::SetPixel(void *video, int x, int y, uint8 colour)
 	/* Set the colour in the anim-buffer too, if we are rendering to the screen */
 	if (_screen_disable_anim) return;
 	this->anim_buf[this->ScreenToAnimOffset((uint32 *)video) + x + y * this->anim_buf_pitch] = colour | (DEFAULT_BRIGHTNESS << 8);
+	if (colour >= PALETTE_ANIM_START) this->MarkAnimated(video, x, y, 1, 1);
 }
 
 void Blitter_32bppAnim::DrawLine(void *video, int x, int y, int x2, int y2, int screen_width, int screen_height, uint8 colour, int width, int dash)
@@ -410,9 +412,11 @@ void Blitter_32bppAnim::DrawLine(void *video, int x, int y, int x2, int y2, int
 	} else {
 		uint16 * const offset_anim_buf = this->anim_buf + this->ScreenToAnimOffset((uint32 *)video);
 		const uint16 anim_colour = colour | (DEFAULT_BRIGHTNESS << 8);
+		const bool animated = colour >= PALETTE_ANIM_START;
 		this->DrawLineGeneric(x, y, x2, y2, screen_width, screen_height, width, dash, [&](int x, int y) {
 			*((Colour *)video + x + y * _screen.pitch) = c;
 			offset_anim_buf[x + y * this->anim_buf_pitch] = anim_colour;
+			if (animated) this->MarkAnimated(video, x, y, 1, 1);
 		});
 	}
 }
@@ -433,6 +437,7 @@ void Blitter_32bppAnim::SetRect(void *video, int x, int y, const uint8 *colours,
 			colours += pitch - width;
 		} while (--lines);
 	} else {
+		this->MarkAnimated(video, x, y, width, lines);
 		uint16 *dstanim = (uint16 *)(&this->anim_buf[this->ScreenToAnimOffset((uint32 *)video) + x + y * this->anim_buf_pitch]);
 		do {
 			uint w = width;
@@ -482,6 +487,7 @@ void Blitter_32bppAnim::DrawRect(void *video, int width, int height, uint8 colou
 
 	Colour colour32 = LookupColourInPalette(colour);
 	uint16 *anim_line = this->ScreenToAnimOffset((uint32 *)video) + this->anim_buf;
+	if (colour >= PALETTE_ANIM_START) this->MarkAnimated(video, 0, 0, width, height);
 
 	do {
 		Colour *dst = (Colour *)video;
@@ -506,6 +512,7 @@ void Blitter_32bppAnim::CopyFromBuffer(void *video, const void *src, int width,
 	Colour *dst = (Colour *)video;
 	const uint32 *usrc = (const uint32 *)src;
 	uint16 *anim_line = this->ScreenToAnimOffset((uint32 *)video) + this->anim_buf;
+	this->MarkAnimated(video, 0, 0, width, height);
 
 	for (; height > 0; height--) {
 		/* We need to keep those for palette animation. */
@@ -609,9 +616,69 @@ void Blitter_32bppAnim::ScrollBuffer(void *video, int left, int top, int width,
 		}
 	}
 
+	this->ScrollAnimSpans(left, top, width, height, scroll_x, scroll_y);
+
 	Blitter_32bppBase::ScrollBuffer(video, left, top, width, height, scroll_x, scroll_y);
 }
 
+/**
+ * Move the spans of animated pixels along with a scrolled part of the animation buffer.
+ * As the scrolled area may only partially overlap a span, the spans of the destination
+ * rows are extended instead of replaced.
+ * @param left The left of the scrolled area.
+ * @param top The top of the scrolled area.
+ * @param width The width of the scrolled area.
+ * @param height The height of the scrolled area.
+ * @param scroll_x How much to scroll in X.
+ * @param scroll_y How much to scroll in Y.
+ */
+void Blitter_32bppAnim::ScrollAnimSpans(int left, int top, int width, int height, int scroll_x, int scroll_y)
+{
+	const int right = left + width;
+	auto scroll_row = [&](int y) {
+		/* Only the part of the source span within the scrolled area moves, and it stays within that area. */
+		const AnimSpan &src = this->anim_spans[y - scroll_y];
+		if (src.left >= src.right) return;
+		const int span_left = std::max(std::max(src.left, left) + scroll_x, left);
+		const int span_right = std::min(std::min(src.right, right) + scroll_x, right);
+		if (span_left < span_right) this->ExtendAnimSpan(y, span_left, span_right);
+	};
+
+	/* Walk the rows in the same order as the data is moved, so every source row is read before it is changed. */
+	if (scroll_y > 0) {
+		for (int y = top + height - 1; y >= top + scroll_y; y--) scroll_row(y);
+	} else {
+		for (int y = top; y < top + height + scroll_y; y++) scroll_row(y);
+	}
+}
+
+/**
+ * Mark the rows containing palette animated pixels dirty, with one rectangle per run of consecutive rows.
+ * The spans must be exact, i.e. just updated by palette animation.
+ */
+void Blitter_32bppAnim::MakeAnimSpansDirty()
+{
+	int top = -1;
+	int left = 0;
+	int right = 0;
+	for (int y = 0; y <= this->anim_buf_height; y++) {
+		if (y < this->anim_buf_height && this->anim_spans[y].left < this->anim_spans[y].right) {
+			const AnimSpan &span = this->anim_spans[y];
+			if (top < 0) {
+				top = y;
+				left = span.left;
+				right = span.right;
+			} else {
+				left = std::min(left, span.left);
+				right = std::max(right, span.right);
+			}
+		} else if (top >= 0) {
+			VideoDriver::GetInstance()->MakeDirty(left, top, right - left, y - top);
+			top = -1;
+		}
+	}
+}
+
 int Blitter_32bppAnim::BufferSize(int width, int height)
 {
 	return width * height * (sizeof(uint32) + sizeof(uint16));
@@ -627,30 +694,32 @@ void Blitter_32bppAnim::PaletteAnimate(const Palette &palette)
 	 *  Especially when going between toyland and non-toyland. */
 	assert(this->palette.first_dirty == PALETTE_ANIM_START || this->palette.first_dirty == 0);
 
-	const uint16 *anim = this->anim_buf;
-	Colour *dst = (Colour *)_screen.dst_ptr;
-
-	/* Let's walk the anim buffer and try to find the pixels */
-	const int width = this->anim_buf_width;
-	const int pitch_offset = _screen.pitch - width;
-	const int anim_pitch_offset = this->anim_buf_pitch - width;
-	for (int y = this->anim_buf_height; y != 0 ; y--) {
-		for (int x = width; x != 0 ; x--) {
-			uint16 value = *anim;
+	/* Let's walk the spans of the anim buffer and try to find the pixels */
+	for (int y = 0; y < this->anim_buf_height; y++) {
+		AnimSpan &span = this->anim_spans[y];
+		if (span.left >= span.right) continue;
+
+		const uint16 *anim = this->anim_buf + y * this->anim_buf_pitch;
+		Colour *dst = (Colour *)_screen.dst_ptr + y * _screen.pitch;
+		int first = span.right;
+		int last = span.left;
+		for (int x = span.left; x < span.right; x++) {
+			uint16 value = anim[x];
 			uint8 colour = GB(value, 0, 8);
 			if (colour >= PALETTE_ANIM_START) {
 				/* Update this pixel */
-				*dst = this->AdjustBrightness(LookupColourInPalette(colour), GB(value, 8, 8));
+				dst[x] = this->AdjustBrightness(LookupColourInPalette(colour), GB(value, 8, 8));
+				first = std::min(first, x);
+				last = x + 1;
 			}
-			dst++;
-			anim++;
 		}
-		dst += pitch_offset;
-		anim += anim_pitch_offset;
+		/* Shrink the span to the pixels that are still animated. */
+		span.left = first;
+		span.right = last;
 	}
 
-	/* Make sure the backend redraws the whole screen */
-	VideoDriver::GetInstance()->MakeDirty(0, 0, _screen.width, _screen.height);
+	/* Make sure the backend redraws the animated pixels */
+	this->MakeAnimSpansDirty();
 }
 
 Blitter::PaletteAnimation Blitter_32bppAnim::UsePaletteAnimation()
@@ -667,6 +736,7 @@ void Blitter_32bppAnim::PostResize()
 		this->anim_buf_height = _screen.height;
 		this->anim_buf_pitch = (_screen.width + 7) & ~7;
 		this->anim_alloc = CallocT<uint16>(this->anim_buf_pitch * this->anim_buf_height + 8);
+		this->anim_spans.assign(this->anim_buf_height, AnimSpan{ 0, 0 });
 
 		/* align buffer to next 16 byte boundary */
 		this->anim_buf = reinterpret_cast<uint16 *>((reinterpret_cast<uintptr_t>(this->anim_alloc) + 0xF) & (~0xF));
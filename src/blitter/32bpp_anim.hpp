@@ -11,6 +11,7 @@
 #define BLITTER_32BPP_ANIM_HPP
 
 #include "32bpp_optimized.hpp"
+#include <vector>
 
 /** The optimised 32 bpp blitter with palette animation. */
 class Blitter_32bppAnim : public Blitter_32bppOptimized {
@@ -22,6 +23,80 @@ protected:
 	int anim_buf_height; ///< The height of the animation buffer.
 	Palette palette;     ///< The current palette.
 
+	/** Range of columns of a row of the animation buffer which may contain palette animated pixels. */
+	struct AnimSpan {
+		int left;  ///< First column which may be animated.
+		int right; ///< One past the last column which may be animated; the span is empty when this is not beyond left.
+	};
+	std::vector<AnimSpan> anim_spans; ///< For every row of the animation buffer the columns containing all its palette animated pixels.
+
+	/**
+	 * Extend the span of a row of the animation buffer.
+	 * @param y The row.
+	 * @param left First column to add.
+	 * @param right One past the last column to add.
+	 */
+	inline void ExtendAnimSpan(int y, int left, int right)
+	{
+		AnimSpan &span = this->anim_spans[y];
+		if (span.left >= span.right) {
+			span.left = left;
+			span.right = right;
+		} else {
+			span.left = std::min(span.left, left);
+			span.right = std::max(span.right, right);
+		}
+	}
+
+	/**
+	 * Mark an area that has been drawn as possibly containing palette animated pixels.
+	 * @param video The destination pointer (video-buffer) the coordinates are relative to.
+	 * @param x The x position within video-buffer.
+	 * @param y The y position within video-buffer.
+	 * @param width The width of the area.
+	 * @param height The height of the area.
+	 */
+	inline void MarkAnimated(const void *video, int x, int y, int width, int height)
+	{
+		if (this->anim_buf == nullptr) return;
+		const int offset = this->ScreenToAnimOffset((const uint32 *)video);
+		const int left = std::max(0, offset % this->anim_buf_pitch + x);
+		const int right = std::min(this->anim_buf_width, offset % this->anim_buf_pitch + x + width);
+		const int top = std::max(0, offset / this->anim_buf_pitch + y);
+		const int bottom = std::min(this->anim_buf_height, offset / this->anim_buf_pitch + y + height);
+		if (left >= right) return;
+		for (int row = top; row < bottom; row++) {
+			this->ExtendAnimSpan(row, left, right);
+		}
+	}
+
+	/**
+	 * Whether drawing a sprite might put palette animated pixels in the animation buffer.
+	 * @param mode The blitter mode.
+	 * @param flags The flags of the sprite.
+	 * @return True when the drawn area has to be marked as animated.
+	 */
+	static inline bool MayDrawAnimated(BlitterMode mode, BlitterSpriteFlags flags)
+	{
+		switch (mode) {
+			case BM_TRANSPARENT:
+			case BM_BLACK_REMAP:
+				return false;
+
+			case BM_COLOUR_REMAP:
+			case BM_COLOUR_REMAP_WITH_BRIGHTNESS:
+			case BM_CRASH_REMAP:
+				/* The remap may map any remappable pixel to an animated colour. */
+				return !(flags & SF_NO_REMAP);
+
+			default:
+				return !(flags & SF_NO_ANIM);
+		}
+	}
+
+	void ScrollAnimSpans(int left, int top, int width, int height, int scroll_x, int scroll_y);
+	void MakeAnimSpansDirty();
+
 public:
 	Blitter_32bppAnim() :
 		anim_buf(nullptr),
@@ -61,7 +136,7 @@ public:
 		return this->palette.palette[index];
 	}
 
-	inline int ScreenToAnimOffset(const uint32 *video)
+	inline int ScreenToAnimOffset(const uint32 *video) const
 	{
 		int raw_offset = video - (const uint32 *)_screen.dst_ptr;
 		if (_screen.pitch == this->anim_buf_pitch) return raw_offset;
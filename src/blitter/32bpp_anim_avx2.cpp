@@ -0,0 +1,24 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file 32bpp_anim_avx2.cpp Implementation of the AVX2 32 bpp blitter with animation support. */
+
+#ifdef WITH_SSE
+
+#include "../stdafx.h"
+#include "../video/video_driver.hpp"
+#include "../table/sprites.h"
+#include "32bpp_anim_avx2.hpp"
+#include "32bpp_sse_func.hpp"
+#include "32bpp_anim_sse_func.hpp"
+
+#include "../safeguards.h"
+
+/** Instantiation of the AVX2 32bpp blitter factory. */
+static FBlitter_32bppAVX2_Anim iFBlitter_32bppAVX2_Anim;
+
+#endif /* WITH_SSE */
@@ -29,70 +29,69 @@ void Blitter_32bppSSE2_Anim::PaletteAnimate(const Palette &palette)
 	 *  Especially when going between toyland and non-toyland. */
 	assert(this->palette.first_dirty == PALETTE_ANIM_START || this->palette.first_dirty == 0);
 
-	const uint16 *anim = this->anim_buf;
-	Colour *dst = (Colour *)_screen.dst_ptr;
-
-	bool screen_dirty = false;
-
-	/* Let's walk the anim buffer and try to find the pixels */
+	/* Let's walk the spans of the anim buffer and try to find the pixels */
 	const int width = this->anim_buf_width;
-	const int screen_pitch = _screen.pitch;
-	const int anim_pitch = this->anim_buf_pitch;
 	__m128i anim_cmp = _mm_set1_epi16(PALETTE_ANIM_START - 1);
 	__m128i brightness_cmp = _mm_set1_epi16(Blitter_32bppBase::DEFAULT_BRIGHTNESS);
 	__m128i colour_mask = _mm_set1_epi16(0xFF);
-	for (int y = this->anim_buf_height; y != 0 ; y--) {
-		Colour *next_dst_ln = dst + screen_pitch;
-		const uint16 *next_anim_ln = anim + anim_pitch;
-		int x = width;
-		while (x > 0) {
-			__m128i data = _mm_load_si128((const __m128i *) anim);
+	for (int y = 0; y < this->anim_buf_height; y++) {
+		AnimSpan &span = this->anim_spans[y];
+		if (span.left >= span.right) continue;
+
+		/* Rows start aligned, so start at the aligned block containing the span. */
+		const int start = span.left & ~7;
+		const uint16 *anim_line = this->anim_buf + y * this->anim_buf_pitch;
+		Colour *dst_line = (Colour *)_screen.dst_ptr + y * _screen.pitch;
+		int first = span.right;
+		int last = span.left;
+		for (int x = start; x < span.right; x += 8) {
+			Colour *dst = dst_line + x;
+			__m128i data = _mm_load_si128((const __m128i *) (anim_line + x));
 
 			/* low bytes only, shifted into high positions */
 			__m128i colour_data = _mm_and_si128(data, colour_mask);
 
 			/* test if any colour >= PALETTE_ANIM_START */
 			int colour_cmp_result = _mm_movemask_epi8(_mm_cmpgt_epi16(colour_data, anim_cmp));
-			if (unlikely(colour_cmp_result)) {
-				/* test if any brightness is unexpected */
-				if (unlikely(x < 8 || colour_cmp_result != 0xFFFF ||
-						_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_srli_epi16(data, 8), brightness_cmp)) != 0xFFFF)) {
-					/* slow path: < 8 pixels left or unexpected brightnesses */
-					for (int z = std::min<int>(x, 8); z != 0 ; z--) {
-						int value = _mm_extract_epi16(data, 0);
-						uint8 colour = GB(value, 0, 8);
-						if (colour >= PALETTE_ANIM_START) {
-							/* Update this pixel */
-							*dst = AdjustBrightneSSE(LookupColourInPalette(colour), GB(value, 8, 8));
-							screen_dirty = true;
-						}
-						data = _mm_srli_si128(data, 2);
-						dst++;
-					}
-				} else {
-					/* medium path: 8 pixels to animate all of expected brightnesses */
-					for (int z = 0; z < 8; z++) {
-						*dst = LookupColourInPalette(_mm_extract_epi16(colour_data, 0));
-						colour_data = _mm_srli_si128(colour_data, 2);
-						dst++;
+			if (likely(colour_cmp_result == 0)) {
+				/* fast path, no animation */
+				continue;
+			}
+
+			/* test if any brightness is unexpected */
+			if (unlikely(x + 8 > width || colour_cmp_result != 0xFFFF ||
+					_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_srli_epi16(data, 8), brightness_cmp)) != 0xFFFF)) {
+				/* slow path: < 8 pixels left or unexpected brightnesses */
+				for (int z = 0; z < std::min<int>(width - x, 8); z++) {
+					int value = _mm_extract_epi16(data, 0);
+					uint8 colour = GB(value, 0, 8);
+					if (colour >= PALETTE_ANIM_START) {
+						/* Update this pixel */
+						*dst = AdjustBrightneSSE(LookupColourInPalette(colour), GB(value, 8, 8));
+						first = std::min(first, x + z);
+						last = x + z + 1;
 					}
-					screen_dirty = true;
+					data = _mm_srli_si128(data, 2);
+					dst++;
 				}
 			} else {
-				/* fast path, no animation */
-				dst += 8;
+				/* medium path: 8 pixels to animate all of expected brightnesses */
+				for (int z = 0; z < 8; z++) {
+					*dst = LookupColourInPalette(_mm_extract_epi16(colour_data, 0));
+					colour_data = _mm_srli_si128(colour_data, 2);
+					dst++;
+				}
+				first = std::min(first, x);
+				last = x + 8;
 			}
-			anim += 8;
-			x -= 8;
 		}
-		dst = next_dst_ln;
-		anim = next_anim_ln;
+		/* Shrink the span to the pixels that are still animated. */
+		span.left = first;
+		span.right = last;
 	}
 
-	if (screen_dirty) {
-		/* Make sure the backend redraws the whole screen */
-		VideoDriver::GetInstance()->MakeDirty(0, 0, _screen.width, _screen.height);
-	}
+	/* Make sure the backend redraws the animated pixels */
+	this->MakeAnimSpansDirty();
 }
 
 #endif /* WITH_SSE */
@@ -182,6 +182,151 @@ static inline __m128i AdjustBrightnessOfTwoPixels(__m128i from, uint32 brightnes
 #endif
 }
 
+#if (SSE_VERSION >= 5)
+/* The AVX2 variants below do exactly what the SSE variants do, but on 4 pixels:
+ * each 128 bit lane of the expanded colours holds the 2 pixels the SSE variant works on. */
+
+static inline __m256i BroadcastMask(const __m128i mask)
+{
+	return _mm256_broadcastsi128_si256(mask);
+}
+
+/** Gather the low 8 bytes of both 128 bit lanes, i.e. the 4 pixels packed per lane. */
+static inline __m128i GatherPackedLanes(const __m256i from)
+{
+	return _mm256_castsi256_si128(_mm256_permute4x64_epi64(from, 0x08));
+}
+
+static inline __m128i AlphaBlendFourPixels(__m128i src, __m128i dst, const __m256i &distribution_mask, const __m256i &pack_mask)
+{
+	__m256i srcABCD = _mm256_cvtepu8_epi16(src);
+	__m256i dstABCD = _mm256_cvtepu8_epi16(dst);
+
+	__m256i alphaABCD = _mm256_cmpgt_epi16(srcABCD, _mm256_setzero_si256()); // if (alpha > 0) a++;
+	alphaABCD = _mm256_srli_epi16(alphaABCD, 15);
+	alphaABCD = _mm256_add_epi16(alphaABCD, srcABCD);
+	alphaABCD = _mm256_shuffle_epi8(alphaABCD, distribution_mask);
+
+	srcABCD = _mm256_sub_epi16(srcABCD, dstABCD);       //    (r - Cr)
+	srcABCD = _mm256_mullo_epi16(srcABCD, alphaABCD);   //  a*(r - Cr)
+	srcABCD = _mm256_srli_epi16(srcABCD, 8);            //  a*(r - Cr)/256
+	srcABCD = _mm256_add_epi16(srcABCD, dstABCD);       //  a*(r - Cr)/256 + Cr
+	return GatherPackedLanes(_mm256_shuffle_epi8(srcABCD, pack_mask));
+}
+
+static inline __m128i DarkenFourPixels(__m128i src, __m128i dst, const __m256i &distribution_mask, const __m256i &tr_nom_base)
+{
+	__m256i srcABCD = _mm256_cvtepu8_epi16(src);
+	__m256i dstABCD = _mm256_cvtepu8_epi16(dst);
+	__m256i alphaABCD = _mm256_shuffle_epi8(srcABCD, distribution_mask);
+	alphaABCD = _mm256_srli_epi16(alphaABCD, 2); // Reduce to 64 levels of shades so the max value fits in 16 bits.
+	__m256i nom = _mm256_sub_epi16(tr_nom_base, alphaABCD);
+	dstABCD = _mm256_mullo_epi16(dstABCD, nom);
+	dstABCD = _mm256_srli_epi16(dstABCD, 8);
+	return GatherPackedLanes(_mm256_packus_epi16(dstABCD, dstABCD));
+}
+
+/** Same as AdjustBrightnessOfTwoPixels(), with both pairs of pixels using the same pair of brightnesses. */
+static inline __m128i AdjustBrightnessOfFourPixels(__m128i from, uint32 brightness)
+{
+	brightness &= 0xFF00FF00;
+	brightness += Blitter_32bppBase::DEFAULT_BRIGHTNESS;
+
+	__m256i colABCD = _mm256_cvtepu8_epi16(from);
+	__m256i briABCD = _mm256_shuffle_epi8(_mm256_set1_epi32(brightness), BroadcastMask(BRIGHTNESS_LOW_CONTROL_MASK));
+	colABCD = _mm256_mullo_epi16(colABCD, briABCD);
+	__m256i colABCD_ob = _mm256_srli_epi16(colABCD, 8 + 7);
+	colABCD = _mm256_srli_epi16(colABCD, 7);
+
+	colABCD = _mm256_and_si256(colABCD, BroadcastMask(BRIGHTNESS_DIV_CLEANER));
+	colABCD_ob = _mm256_and_si256(colABCD_ob, BroadcastMask(OVERBRIGHT_PRESENCE_MASK));
+	colABCD_ob = _mm256_mullo_epi16(colABCD_ob, BroadcastMask(OVERBRIGHT_VALUE_MASK));
+	colABCD_ob = _mm256_and_si256(colABCD_ob, colABCD);
+	__m256i obABCD = _mm256_hadd_epi16(_mm256_hadd_epi16(colABCD_ob, _mm256_setzero_si256()), _mm256_setzero_si256());
+
+	obABCD = _mm256_srli_epi16(obABCD, 1);
+	obABCD = _mm256_shuffle_epi8(obABCD, BroadcastMask(OVERBRIGHT_CONTROL_MASK));
+	__m256i retABCD = BroadcastMask(OVERBRIGHT_VALUE_MASK);
+	retABCD = _mm256_subs_epu16(retABCD, colABCD);
+	retABCD = _mm256_mullo_epi16(retABCD, obABCD);
+	retABCD = _mm256_srli_epi16(retABCD, 8);
+	retABCD = _mm256_add_epi16(retABCD, colABCD);
+
+	return GatherPackedLanes(_mm256_packus_epi16(retABCD, retABCD));
+}
+#endif /* SSE_VERSION >= 5 */
+
+#if (SSE_VERSION >= 6)
+/* The AVX-512 variants, on 8 pixels. AVX-512 can narrow words to bytes
+ * directly, so no pack masks are needed; truncation matches the byte
+ * shuffles of the alpha blend and saturation matches the other packs. */
+
+static inline __m512i BroadcastMask512(const __m128i mask)
+{
+	return _mm512_broadcast_i32x4(mask);
+}
+
+static inline __m256i AlphaBlendEightPixels(__m256i src, __m256i dst, const __m512i &distribution_mask)
+{
+	__m512i srcAH = _mm512_cvtepu8_epi16(src);
+	__m512i dstAH = _mm512_cvtepu8_epi16(dst);
+
+	__m512i alphaAH = _mm512_min_epu16(srcAH, _mm512_set1_epi16(1)); // if (alpha > 0) a++;
+	alphaAH = _mm512_add_epi16(alphaAH, srcAH);
+	alphaAH = _mm512_shuffle_epi8(alphaAH, distribution_mask);
+
+	srcAH = _mm512_sub_epi16(srcAH, dstAH);
+	srcAH = _mm512_mullo_epi16(srcAH, alphaAH);
+	srcAH = _mm512_srli_epi16(srcAH, 8);
+	srcAH = _mm512_add_epi16(srcAH, dstAH);
+	return _mm512_cvtepi16_epi8(srcAH);
+}
+
+static inline __m256i DarkenEightPixels(__m256i src, __m256i dst, const __m512i &distribution_mask, const __m512i &tr_nom_base)
+{
+	__m512i srcAH = _mm512_cvtepu8_epi16(src);
+	__m512i dstAH = _mm512_cvtepu8_epi16(dst);
+	__m512i alphaAH = _mm512_shuffle_epi8(srcAH, distribution_mask);
+	alphaAH = _mm512_srli_epi16(alphaAH, 2);
+	__m512i nom = _mm512_sub_epi16(tr_nom_base, alphaAH);
+	dstAH = _mm512_mullo_epi16(dstAH, nom);
+	dstAH = _mm512_srli_epi16(dstAH, 8);
+	return _mm512_cvtusepi16_epi8(dstAH);
+}
+
+/** Same as AdjustBrightnessOfTwoPixels(), with all pairs of pixels using the same pair of brightnesses. */
+static inline __m256i AdjustBrightnessOfEightPixels(__m256i from, uint32 brightness)
+{
+	brightness &= 0xFF00FF00;
+	brightness += Blitter_32bppBase::DEFAULT_BRIGHTNESS;
+
+	__m512i colAH = _mm512_cvtepu8_epi16(from);
+	__m512i briAH = _mm512_shuffle_epi8(_mm512_set1_epi32(brightness), BroadcastMask512(BRIGHTNESS_LOW_CONTROL_MASK));
+	colAH = _mm512_mullo_epi16(colAH, briAH);
+	__m512i colAH_ob = _mm512_srli_epi16(colAH, 8 + 7);
+	colAH = _mm512_srli_epi16(colAH, 7);
+
+	colAH = _mm512_and_si512(colAH, BroadcastMask512(BRIGHTNESS_DIV_CLEANER));
+	colAH_ob = _mm512_and_si512(colAH_ob, BroadcastMask512(OVERBRIGHT_PRESENCE_MASK));
+	colAH_ob = _mm512_mullo_epi16(colAH_ob, BroadcastMask512(OVERBRIGHT_VALUE_MASK));
+	colAH_ob = _mm512_and_si512(colAH_ob, colAH);
+
+	/* There is no horizontal add; sum the channels of each pixel into the low word of its quadword instead. */
+	__m512i obAH = _mm512_madd_epi16(colAH_ob, _mm512_set1_epi16(1));
+	obAH = _mm512_add_epi32(obAH, _mm512_srli_epi64(obAH, 32));
+
+	obAH = _mm512_srli_epi16(obAH, 1);
+	obAH = _mm512_shuffle_epi8(obAH, BroadcastMask512(_mm_setr_epi8(0, 1, 0, 1, 0, 1, -1, -1, 8, 9, 8, 9, 8, 9, -1, -1)));
+	__m512i retAH = BroadcastMask512(OVERBRIGHT_VALUE_MASK);
+	retAH = _mm512_subs_epu16(retAH, colAH);
+	retAH = _mm512_mullo_epi16(retAH, obAH);
+	retAH = _mm512_srli_epi16(retAH, 8);
+	retAH = _mm512_add_epi16(retAH, colAH);
+
+	return _mm512_cvtusepi16_epi8(retAH);
+}
+#endif /* SSE_VERSION >= 6 */
+
 #if FULL_ANIMATION == 0
 /**
  * Draws a sprite to a (screen) buffer. It is templated to allow faster operation.
@@ -198,6 +343,10 @@ inline void Blitter_32bppSSE2::Draw(const Blitter::BlitterParams *bp, ZoomLevel
 inline void Blitter_32bppSSSE3::Draw(const Blitter::BlitterParams *bp, ZoomLevel zoom)
 #elif (SSE_VERSION == 4)
 inline void Blitter_32bppSSE4::Draw(const Blitter::BlitterParams *bp, ZoomLevel zoom)
+#elif (SSE_VERSION == 5)
+inline void Blitter_32bppAVX2::Draw(const Blitter::BlitterParams *bp, ZoomLevel zoom)
+#elif (SSE_VERSION == 6)
+inline void Blitter_32bppAVX512::Draw(const Blitter::BlitterParams *bp, ZoomLevel zoom)
 #endif
 {
 	const byte * const remap = bp->remap;
@@ -238,6 +387,15 @@ inline void Blitter_32bppSSE4::Draw(const Blitter::BlitterParams *bp, ZoomLevel
 	#define DARKEN_PARAM_2      tr_nom_base
 #endif
 	const __m128i tr_nom_base = TRANSPARENT_NOM_BASE;
+#if (SSE_VERSION >= 5)
+	const __m256i a_cm_256        = BroadcastMask(a_cm);
+	const __m256i pack_low_cm_256 = BroadcastMask(pack_low_cm);
+	const __m256i tr_nom_base_256 = BroadcastMask(tr_nom_base);
+#endif
+#if (SSE_VERSION >= 6)
+	const __m512i a_cm_512        = BroadcastMask512(a_cm);
+	const __m512i tr_nom_base_512 = BroadcastMask512(tr_nom_base);
+#endif
 
 	for (int y = bp->height; y != 0; y--) {
 		Colour *dst = dst_line;
@@ -268,7 +426,25 @@ inline void Blitter_32bppSSE4::Draw(const Blitter::BlitterParams *bp, ZoomLevel
 					break;
 				}
 
-				for (uint x = (uint) effective_width / 2; x > 0; x--) {
+#if (SSE_VERSION >= 6)
+				for (uint x = PIXEL_LOOP_COUNT(effective_width, 8); x > 0; x--) {
+					__m256i srcAH = _mm256_loadu_si256((const __m256i*) src);
+					__m256i dstAH = _mm256_loadu_si256((__m256i*) dst);
+					_mm256_storeu_si256((__m256i*) dst, AlphaBlendEightPixels(srcAH, dstAH, a_cm_512));
+					src += 8;
+					dst += 8;
+				}
+#endif
+#if (SSE_VERSION >= 5)
+				for (uint x = PIXEL_LOOP_COUNT(effective_width, 4); x > 0; x--) {
+					__m128i srcABCD = _mm_loadu_si128((const __m128i*) src);
+					__m128i dstABCD = _mm_loadu_si128((__m128i*) dst);
+					_mm_storeu_si128((__m128i*) dst, AlphaBlendFourPixels(srcABCD, dstABCD, a_cm_256, pack_low_cm_256));
+					src += 4;
+					dst += 4;
+				}
+#endif
+				for (uint x = PIXEL_LOOP_COUNT(effective_width, 2); x > 0; x--) {
 					__m128i srcABCD = _mm_loadl_epi64((const __m128i*) src);
 					__m128i dstABCD = _mm_loadl_epi64((__m128i*) dst);
 					_mm_storel_epi64((__m128i*) dst, AlphaBlendTwoPixels(srcABCD, dstABCD, ALPHA_BLEND_PARAM_1, ALPHA_BLEND_PARAM_2));
@@ -367,7 +543,25 @@ bmcr_alpha_blend_single:
 
 			case BM_TRANSPARENT:
 				/* Make the current colour a bit more black, so it looks like this image is transparent. */
-				for (uint x = (uint) bp->width / 2; x > 0; x--) {
+#if (SSE_VERSION >= 6)
+				for (uint x = PIXEL_LOOP_COUNT(bp->width, 8); x > 0; x--) {
+					__m256i srcAH = _mm256_loadu_si256((const __m256i*) src);
+					__m256i dstAH = _mm256_loadu_si256((__m256i*) dst);
+					_mm256_storeu_si256((__m256i*) dst, DarkenEightPixels(srcAH, dstAH, a_cm_512, tr_nom_base_512));
+					src += 8;
+					dst += 8;
+				}
+#endif
+#if (SSE_VERSION >= 5)
+				for (uint x = PIXEL_LOOP_COUNT(bp->width, 4); x > 0; x--) {
+					__m128i srcABCD = _mm_loadu_si128((const __m128i*) src);
+					__m128i dstABCD = _mm_loadu_si128((__m128i*) dst);
+					_mm_storeu_si128((__m128i*) dst, DarkenFourPixels(srcABCD, dstABCD, a_cm_256, tr_nom_base_256));
+					src += 4;
+					dst += 4;
+				}
+#endif
+				for (uint x = PIXEL_LOOP_COUNT(bp->width, 2); x > 0; x--) {
 					__m128i srcABCD = _mm_loadl_epi64((const __m128i*) src);
 					__m128i dstABCD = _mm_loadl_epi64((__m128i*) dst);
 					_mm_storel_epi64((__m128i *) dst, DarkenTwoPixels(srcABCD, dstABCD, DARKEN_PARAM_1, DARKEN_PARAM_2));
@@ -411,7 +605,25 @@ bmcr_alpha_blend_single:
 				break;
 
 			case BM_NORMAL_WITH_BRIGHTNESS:
-				for (uint x = (uint) effective_width / 2; x > 0; x--) {
+#if (SSE_VERSION >= 6)
+				for (uint x = PIXEL_LOOP_COUNT(effective_width, 8); x > 0; x--) {
+					__m256i srcAH = AdjustBrightnessOfEightPixels(_mm256_loadu_si256((const __m256i*) src), bm_normal_brightness);
+					__m256i dstAH = _mm256_loadu_si256((__m256i*) dst);
+					_mm256_storeu_si256((__m256i*) dst, AlphaBlendEightPixels(srcAH, dstAH, a_cm_512));
+					src += 8;
+					dst += 8;
+				}
+#endif
+#if (SSE_VERSION >= 5)
+				for (uint x = PIXEL_LOOP_COUNT(effective_width, 4); x > 0; x--) {
+					__m128i srcABCD = AdjustBrightnessOfFourPixels(_mm_loadu_si128((const __m128i*) src), bm_normal_brightness);
+					__m128i dstABCD = _mm_loadu_si128((__m128i*) dst);
+					_mm_storeu_si128((__m128i*) dst, AlphaBlendFourPixels(srcABCD, dstABCD, a_cm_256, pack_low_cm_256));
+					src += 4;
+					dst += 4;
+				}
+#endif
+				for (uint x = PIXEL_LOOP_COUNT(effective_width, 2); x > 0; x--) {
 #if (SSE_VERSION >= 3)
 					__m128i srcABCD = _mm_loadl_epi64((const __m128i*) src);
 					srcABCD = AdjustBrightnessOfTwoPixels(srcABCD, bm_normal_brightness);
@@ -487,6 +699,10 @@ void Blitter_32bppSSE2::Draw(Blitter::BlitterParams *bp, BlitterMode mode, ZoomL
 void Blitter_32bppSSSE3::Draw(Blitter::BlitterParams *bp, BlitterMode mode, ZoomLevel zoom)
 #elif (SSE_VERSION == 4)
 void Blitter_32bppSSE4::Draw(Blitter::BlitterParams *bp, BlitterMode mode, ZoomLevel zoom)
+#elif (SSE_VERSION == 5)
+void Blitter_32bppAVX2::Draw(Blitter::BlitterParams *bp, BlitterMode mode, ZoomLevel zoom)
+#elif (SSE_VERSION == 6)
+void Blitter_32bppAVX512::Draw(Blitter::BlitterParams *bp, BlitterMode mode, ZoomLevel zoom)
 #endif
 {
 	switch (mode) {
@@ -19,12 +19,26 @@
 #include <tmmintrin.h>
 #elif (SSE_VERSION == 4)
 #include <smmintrin.h>
+#elif (SSE_VERSION >= 5)
+#include <immintrin.h>
 #endif
 
 #define META_LENGTH 2 ///< Number of uint32 inserted before each line of pixels in a sprite.
 #define MARGIN_NORMAL_THRESHOLD (zoom == ZOOM_LVL_OUT_32X ? 8 : 4) ///< Minimum width to use margins with BM_NORMAL.
 #define MARGIN_REMAP_THRESHOLD 4 ///< Minimum width to use margins with BM_COLOUR_REMAP.
 
+/* SSE_VERSION 5 and 6 are AVX2 and AVX-512BW, which handle 4 and 8 pixels at once. */
+#if (SSE_VERSION >= 6)
+#define MAX_PIXELS_AT_ONCE 8 ///< Number of pixels handled at once with the widest registers.
+#elif (SSE_VERSION == 5)
+#define MAX_PIXELS_AT_ONCE 4 ///< Number of pixels handled at once with the widest registers.
+#else
+#define MAX_PIXELS_AT_ONCE 2 ///< Number of pixels handled at once with the widest registers.
+#endif
+
+/** Number of iterations of a loop handling \a n pixels at once, after the loops handling more pixels at once. */
+#define PIXEL_LOOP_COUNT(width, n) ((n) == MAX_PIXELS_AT_ONCE ? (uint) (width) / (n) : ((uint) (width) / (n)) & 1)
+
 #undef ALIGN
 
 #ifdef _MSC_VER
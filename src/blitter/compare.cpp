@@ -0,0 +1,192 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file compare.cpp Comparison of the output of blitters, to validate the optimised variants of a blitter. */
+
+#include "../stdafx.h"
+#include "../settings_type.h"
+#include "../string_func.h"
+#include "../core/alloc_func.hpp"
+#include "factory.hpp"
+#include "compare.hpp"
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "../safeguards.h"
+
+/** Names of the blitter modes, for reporting. */
+static const char * const _blitter_mode_names[] = {
+	"normal",
+	"colour remap",
+	"transparent",
+	"crash remap",
+	"black remap",
+	"normal with brightness",
+	"colour remap with brightness",
+};
+
+static const int COMPARE_BUFFER_WIDTH  = 256; ///< Width of the buffers drawn into.
+static const int COMPARE_BUFFER_HEIGHT = 16;  ///< Height of the buffers drawn into.
+
+/** Allocator for the encoded sprites, which are freed again with free(). */
+static void *CompareSpriteAllocate(size_t size)
+{
+	return MallocT<byte>(size);
+}
+
+/**
+ * Fill a sprite with random pixels. Lines get random runs of transparent
+ * pixels at both ends, and the remap channel and alpha channel favour the
+ * values blitters have special cases for. Not all sprites get translucent,
+ * remapped or animated pixels, as blitters have special cases for those too.
+ * @param rng The random number generator.
+ * @param sprite The sprites of all zoom levels.
+ * @param data The storage for the pixels of all zoom levels.
+ */
+static void GenerateCompareSprite(std::mt19937 &rng, SpriteLoader::Sprite *sprite, std::vector<SpriteLoader::CommonPixel> *data)
+{
+	const uint32 kind = rng();
+	const uint alpha_kinds = HasBit(kind, 0) ? 4 : 2;
+	const uint remap_kinds = HasBit(kind, 1) ? (HasBit(kind, 2) ? 4 : 3) : 1;
+
+	for (ZoomLevel z = ZOOM_LVL_BEGIN; z != ZOOM_LVL_END; z++) {
+		SpriteLoader::Sprite &s = sprite[z];
+		s.width = 1 + rng() % (COMPARE_BUFFER_WIDTH / 3);
+		s.height = 1 + rng() % (COMPARE_BUFFER_HEIGHT / 2);
+		s.x_offs = 0;
+		s.y_offs = 0;
+		s.type = ST_NORMAL;
+		s.colours = SCC_MASK;
+
+		data[z].assign(s.width * s.height, SpriteLoader::CommonPixel());
+		for (uint y = 0; y < s.height; y++) {
+			uint begin = (rng() % 2 == 0) ? rng() % s.width : 0;
+			uint end = (rng() % 2 == 0) ? begin + rng() % (s.width - begin) + 1 : s.width;
+			for (uint x = begin; x < end; x++) {
+				SpriteLoader::CommonPixel &p = data[z][y * s.width + x];
+				uint32 r = rng();
+				p.r = GB(r, 0, 8);
+				p.g = GB(r, 8, 8);
+				p.b = GB(r, 16, 8);
+				switch (GB(r, 24, 4) % alpha_kinds) {
+					case 0: p.a = 0; break;
+					case 1: p.a = 255; break;
+					default: p.a = 1 + rng() % 254; break;
+				}
+				switch (GB(r, 28, 4) % remap_kinds) {
+					case 0: p.m = 0; break;
+					case 1: p.m = 1 + rng() % (PALETTE_ANIM_START - 1); break;
+					case 2: p.m = rng(); break;
+					default: p.m = PALETTE_ANIM_START + rng() % (256 - PALETTE_ANIM_START); break;
+				}
+			}
+		}
+		s.data = data[z].data();
+	}
+}
+
+/**
+ * Compare the output of two blitters for random sprites, in all blitter modes and at all zoom levels.
+ * Both blitters have to be 32bpp blitters which draw without an animation buffer.
+ * @param name The blitter to check.
+ * @param reference_name The blitter with the expected output.
+ * @param iterations Number of sprites to draw per blitter mode and zoom level.
+ * @param output Function to report with.
+ * @return True when the blitters could be compared and their output was identical.
+ */
+bool CompareBlitterOutput(const std::string &name, const std::string &reference_name, uint iterations, std::function<void(const std::string &)> output)
+{
+	std::unique_ptr<Blitter> blitters[2];
+	const std::string *names[2] = { &name, &reference_name };
+	for (uint i = 0; i < 2; i++) {
+		BlitterFactory *factory = BlitterFactory::GetBlitterFactory(*names[i]);
+		if (factory == nullptr) {
+			output(stdstr_fmt("Blitter '%s' is not available", names[i]->c_str()));
+			return false;
+		}
+		blitters[i].reset(factory->CreateInstance());
+		if (blitters[i]->GetScreenDepth() != 32 || blitters[i]->UsePaletteAnimation() == Blitter::PALETTE_ANIMATION_BLITTER || blitters[i]->NeedsAnimationBuffer()) {
+			output(stdstr_fmt("Blitter '%s' can not be compared, only 32bpp blitters without an animation buffer can", names[i]->c_str()));
+			return false;
+		}
+	}
+
+	const ZoomLevel zoom_min = _settings_client.gui.zoom_min;
+	const ZoomLevel zoom_max = std::max(zoom_min, std::min(_settings_client.gui.zoom_max, ZOOM_LVL_DRAW_SPR));
+
+	std::mt19937 rng(0x4F545444);
+	SpriteLoader::Sprite sprite[ZOOM_LVL_COUNT];
+	std::vector<SpriteLoader::CommonPixel> sprite_data[ZOOM_LVL_COUNT];
+	std::vector<uint32> buffers[2];
+	byte remap[256];
+
+	bool identical = true;
+	for (BlitterMode mode = BM_NORMAL; mode <= BM_COLOUR_REMAP_WITH_BRIGHTNESS; mode = (BlitterMode)(mode + 1)) {
+		uint drawn = 0;
+		uint mismatches = 0;
+		for (uint i = 0; i < iterations; i++) {
+			GenerateCompareSprite(rng, sprite, sprite_data);
+			for (uint j = 0; j < lengthof(remap); j++) remap[j] = (rng() % 8 == 0) ? 0 : rng();
+
+			Sprite *encoded[2];
+			for (uint j = 0; j < 2; j++) encoded[j] = blitters[j]->Encode(sprite, CompareSpriteAllocate);
+
+			for (ZoomLevel z = zoom_min; z <= zoom_max; z++) {
+				const SpriteLoader::Sprite &s = sprite[z];
+
+				Blitter::BlitterParams bp;
+				bp.remap = remap;
+				bp.brightness_adjust = (int)(rng() % 128) - 64;
+				bp.sprite_width = s.width;
+				bp.sprite_height = s.height;
+				bp.skip_left = (rng() % 2 == 0) ? rng() % s.width : 0;
+				bp.skip_top = (rng() % 2 == 0) ? rng() % s.height : 0;
+				bp.width = s.width - bp.skip_left;
+				bp.height = s.height - bp.skip_top;
+				if (rng() % 2 == 0) bp.width -= rng() % bp.width;
+				if (rng() % 2 == 0) bp.height -= rng() % bp.height;
+				bp.left = rng() % (COMPARE_BUFFER_WIDTH - bp.width + 1);
+				bp.top = rng() % (COMPARE_BUFFER_HEIGHT - bp.height + 1);
+				bp.pitch = COMPARE_BUFFER_WIDTH;
+
+				buffers[0].resize(COMPARE_BUFFER_WIDTH * COMPARE_BUFFER_HEIGHT);
+				for (uint32 &pixel : buffers[0]) pixel = rng();
+				buffers[1] = buffers[0];
+
+				for (uint j = 0; j < 2; j++) {
+					bp.sprite = encoded[j]->data;
+					bp.dst = buffers[j].data();
+					blitters[j]->Draw(&bp, mode, z);
+				}
+
+				drawn++;
+				if (buffers[0] != buffers[1]) {
+					if (mismatches == 0) {
+						for (int p = 0; p < COMPARE_BUFFER_WIDTH * COMPARE_BUFFER_HEIGHT; p++) {
+							if (buffers[0][p] == buffers[1][p]) continue;
+							output(stdstr_fmt("  First difference in %s mode at zoom level %u, sprite %ux%u drawn %dx%d from %d,%d: pixel %d,%d is %08X instead of %08X",
+									_blitter_mode_names[mode], z, s.width, s.height, bp.width, bp.height, bp.skip_left, bp.skip_top,
+									p % COMPARE_BUFFER_WIDTH - bp.left, p / COMPARE_BUFFER_WIDTH - bp.top, buffers[0][p], buffers[1][p]));
+							break;
+						}
+					}
+					mismatches++;
+				}
+			}
+
+			for (uint j = 0; j < 2; j++) free(encoded[j]);
+		}
+
+		output(stdstr_fmt("%s: %u of %u sprites differ", _blitter_mode_names[mode], mismatches, drawn));
+		if (mismatches != 0) identical = false;
+	}
+
+	output(stdstr_fmt("Output of '%s' is %s to that of '%s'", blitters[0]->GetName(), identical ? "identical" : "NOT identical", blitters[1]->GetName()));
+	return identical;
+}
@@ -0,0 +1,18 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file compare.hpp Comparison of the output of blitters. */
+
+#ifndef BLITTER_COMPARE_HPP
+#define BLITTER_COMPARE_HPP
+
+#include <functional>
+#include <string>
+
+bool CompareBlitterOutput(const std::string &name, const std::string &reference_name, uint iterations, std::function<void(const std::string &)> output);
+
+#endif /* BLITTER_COMPARE_HPP */
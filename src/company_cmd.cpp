@@ -37,6 +37,7 @@
 #include "zoning.h"
 #include "tbtr_template_vehicle_func.h"
 #include "widgets/statusbar_widget.h"
+#include "departures_func.h"
 
 #include "table/strings.h"
 
@@ -935,7 +936,7 @@ CommandCost CmdCompanyCtrl(TileIndex tile, DoCommandFlag flags, uint32 p1, uint3
 			if (StoryPage::GetNumItems() == 0 || Goal::GetNumItems() == 0) InvalidateWindowData(WC_MAIN_TOOLBAR, 0);
 
 			InvalidateWindowData(WC_CLIENT_LIST, 0);
-			InvalidateWindowClassesData(WC_DEPARTURES_BOARD, 0);
+			InvalidateDepartureBoards();
 
 			extern void CheckCaches(bool force_check, std::function<void(const char *)> log);
 			CheckCaches(true, nullptr);
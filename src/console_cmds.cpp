@@ -53,6 +53,7 @@
 #include "linkgraph/linkgraphjob.h"
 #include "base_media_base.h"
 #include "debug_settings.h"
+#include "blitter/compare.hpp"
 #include <time.h>
 
 #include "safeguards.h"
@@ -2318,6 +2319,20 @@ DEF_CONSOLE_CMD(ConMapStats)
 	return true;
 }
 
+DEF_CONSOLE_CMD(ConSaveLoadStats)
+{
+	if (argc == 0) {
+		IConsoleHelp("Dump the profile of the last savegame save and load, per chunk.");
+		return true;
+	}
+
+	extern void DumpSaveLoadStats(char *b, const char *last);
+	char buffer[65536];
+	DumpSaveLoadStats(buffer, lastof(buffer));
+	PrintLineByLine(buffer);
+	return true;
+}
+
 DEF_CONSOLE_CMD(ConStFlowStats)
 {
 	if (argc == 0) {
@@ -2842,6 +2857,40 @@ DEF_CONSOLE_CMD(ConGfxDebug)
 	return true;
 }
 
+DEF_CONSOLE_CMD(ConDirtyBlockStats)
+{
+	if (argc == 0 || argc > 2) {
+		IConsoleHelp("Dump the counters of the redraw of dirty screen areas.  Usage: 'dump_dirty_block_stats [reset]'");
+		IConsoleHelp("  reset: reset the counters after dumping");
+		return true;
+	}
+
+	extern void DumpDirtyBlockStats(char *b, const char *last);
+	extern void ResetDirtyBlockStats();
+	char buffer[4096];
+	DumpDirtyBlockStats(buffer, lastof(buffer));
+	PrintLineByLine(buffer);
+	if (argc == 2 && strcmp(argv[1], "reset") == 0) ResetDirtyBlockStats();
+	return true;
+}
+
+DEF_CONSOLE_CMD(ConBlitterCompare)
+{
+	if (argc < 2 || argc > 4) {
+		IConsoleHelp("Debug: compare the output of a blitter with that of a reference blitter, for random sprites.  Usage: 'blitter_compare <blitter> [<reference blitter>] [<iterations>]'");
+		IConsoleHelp("  The default reference blitter is 32bpp-sse4, the default number of iterations is 1000.");
+		return true;
+	}
+
+	const char *reference = argc > 2 ? argv[2] : "32bpp-sse4";
+	uint iterations = argc > 3 ? atoi(argv[3]) : 1000;
+	CompareBlitterOutput(argv[1], reference, iterations, [](const std::string &line) {
+		IConsolePrint(CC_DEFAULT, line.c_str());
+	});
+
+	return true;
+}
+
 DEF_CONSOLE_CMD(ConCSleep)
 {
 	if (argc != 2) {
@@ -3456,6 +3505,7 @@ void IConsoleStdLibRegister()
 	IConsole::CmdRegister("dump_veh_stats",          ConVehicleStats,     nullptr, true);
 	IConsole::CmdRegister("dump_map_stats",          ConMapStats,         nullptr, true);
 	IConsole::CmdRegister("dump_st_flow_stats",      ConStFlowStats,      nullptr, true);
+	IConsole::CmdRegister("dump_savegame_stats",     ConSaveLoadStats,    nullptr, true);
 	IConsole::CmdRegister("dump_game_events",        ConDumpGameEvents,   nullptr, true);
 	IConsole::CmdRegister("dump_load_debug_log",     ConDumpLoadDebugLog, nullptr, true);
 	IConsole::CmdRegister("dump_load_debug_config",  ConDumpLoadDebugConfig, nullptr, true);
@@ -3473,6 +3523,8 @@ void IConsoleStdLibRegister()
 	IConsole::CmdRegister("viewport_mark_dirty",     ConViewportMarkDirty, nullptr, true);
 	IConsole::CmdRegister("viewport_mark_dirty_st_overlay", ConViewportMarkStationOverlayDirty, nullptr, true);
 	IConsole::CmdRegister("gfx_debug",               ConGfxDebug,         nullptr, true);
+	IConsole::CmdRegister("dump_dirty_block_stats",  ConDirtyBlockStats,  nullptr, true);
+	IConsole::CmdRegister("blitter_compare",         ConBlitterCompare,   nullptr, true);
 	IConsole::CmdRegister("csleep",                  ConCSleep,           nullptr, true);
 	IConsole::CmdRegister("recalculate_road_cached_one_way_states", ConRecalculateRoadCachedOneWayStates, ConHookNoNetwork, true);
 	IConsole::CmdRegister("misc_debug",              ConMiscDebug,        nullptr, true);
@@ -101,7 +101,16 @@ uint64 ottd_rdtsc() {return 0;}
 #if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
 void ottd_cpuid(int info[4], int type)
 {
-	__cpuid(info, type);
+	__cpuidex(info, type, 0);
+}
+
+/**
+ * Get the register state the OS saves and restores on context switches.
+ * @return The content of XCR0.
+ */
+static uint64 ottd_xgetbv()
+{
+	return _xgetbv(0);
 }
 #elif defined(__x86_64__) || defined(__i386)
 void ottd_cpuid(int info[4], int type)
@@ -121,21 +130,38 @@ void ottd_cpuid(int info[4], int type)
 			/* It is safe to write "=r" for (info[1]) as in case that PIC is enabled for i386,
 			 * the compiler will not choose EBX as target register (but something else).
 			 */
-			: "a" (type)
+			: "a" (type), "c" (0)
 	);
 #else
 	__asm__ __volatile__ (
 			"cpuid           \n\t"
 			: "=a" (info[0]), "=b" (info[1]), "=c" (info[2]), "=d" (info[3])
-			: "a" (type)
+			: "a" (type), "c" (0)
 	);
 #endif /* i386 PIC */
 }
+
+/**
+ * Get the register state the OS saves and restores on context switches.
+ * @return The content of XCR0.
+ */
+static uint64 ottd_xgetbv()
+{
+	uint32 high, low;
+	/* xgetbv, spelled out as not all assemblers know the mnemonic. */
+	__asm__ __volatile__ (".byte 0x0f, 0x01, 0xd0" : "=a" (low), "=d" (high) : "c" (0));
+	return ((uint64)high << 32) | low;
+}
 #else
 void ottd_cpuid(int info[4], int type)
 {
 	info[0] = info[1] = info[2] = info[3] = 0;
 }
+
+static uint64 ottd_xgetbv()
+{
+	return 0;
+}
 #endif
 
 bool HasCPUIDFlag(uint type, uint index, uint bit)
@@ -148,3 +174,27 @@ bool HasCPUIDFlag(uint type, uint index, uint bit)
 	ottd_cpuid(cpu_info, type);
 	return HasBit(cpu_info[index], bit);
 }
+
+/**
+ * Check whether the OS saves the given register state, i.e. the registers can be used.
+ * @param mask The bits of XCR0 that need to be set.
+ * @return True when the CPU has XSAVE, the OS enabled it and all bits in the mask are set.
+ */
+static bool HasOSRegisterState(uint64 mask)
+{
+	/* OSXSAVE: the OS enabled XSAVE, so XGETBV can be used. */
+	if (!HasCPUIDFlag(1, 2, 27)) return false;
+	return (ottd_xgetbv() & mask) == mask;
+}
+
+bool HasCPUAVX2Support()
+{
+	/* AVX and AVX2 instructions, and the SSE and AVX (YMM) register state. */
+	return HasCPUIDFlag(1, 2, 28) && HasCPUIDFlag(7, 1, 5) && HasOSRegisterState(0x06);
+}
+
+bool HasCPUAVX512BWSupport()
+{
+	/* AVX-512 foundation and byte/word instructions, and the opmask and ZMM register state too. */
+	return HasCPUAVX2Support() && HasCPUIDFlag(7, 1, 16) && HasCPUIDFlag(7, 1, 30) && HasOSRegisterState(0xE6);
+}
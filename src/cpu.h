@@ -32,4 +32,18 @@ void ottd_cpuid(int info[4], int type);
  */
 bool HasCPUIDFlag(uint type, uint index, uint bit);
 
+/**
+ * Check whether the AVX2 instructions can be used, i.e. the CPU supports
+ * them and the OS saves the AVX registers on context switches.
+ * @return True when AVX2 can be used.
+ */
+bool HasCPUAVX2Support();
+
+/**
+ * Check whether the AVX-512 foundation and byte/word instructions can be used,
+ * i.e. the CPU supports them and the OS saves the AVX-512 registers on context switches.
+ * @return True when AVX-512BW can be used.
+ */
+bool HasCPUAVX512BWSupport();
+
 #endif /* CPU_H */
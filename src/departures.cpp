@@ -38,6 +38,7 @@
 #include <set>
 #include <vector>
 #include <algorithm>
+#include <memory>
 
 /* A cache of used departure time for scheduled dispatch in departure time calculation */
 typedef std::map<uint32, std::set<DateTicksScaled>> schdispatch_cache_t;
@@ -804,3 +805,131 @@ DepartureList* MakeDepartureList(StationID station, const std::vector<const Vehi
 	/* Done. Phew! */
 	return result;
 }
+
+/** A computed departure list, shared by all boards showing the same departures. */
+struct DepartureCacheEntry {
+	StationID station;                         ///< The station of the departures.
+	DepartureType type;                        ///< The type of the departures.
+	bool show_vehicles_via;                    ///< Whether vehicles passing via the station are included.
+	bool show_pax;                             ///< Whether passenger vehicles are included.
+	bool show_freight;                         ///< Whether freight vehicles are included.
+	std::vector<const Vehicle *> vehicles;     ///< The vehicles the list was computed from, sorted.
+	std::vector<const OrderList *> orders;     ///< The order lists of these vehicles, sorted.
+	std::shared_ptr<const DepartureList> list; ///< The computed list.
+	DateTicksScaled valid_until;               ///< Date after which the list has to be recomputed.
+	bool valid;                                ///< Whether nothing changed which affects the list since it was computed.
+	uint32 last_used;                          ///< Tick counter at the last time the list was requested.
+};
+
+/** Maximum number of departure lists kept, including those of boards which have since been closed. */
+static const uint MAX_DEPARTURE_CACHE_ENTRIES = 32;
+
+static std::vector<DepartureCacheEntry> _departure_cache; ///< The cached departure lists.
+
+/**
+ * Delete a departure list including its departures.
+ * @param list The list to delete.
+ */
+static void DeleteDepartureList(DepartureList *list)
+{
+	for (Departure *d : *list) delete d;
+	delete list;
+}
+
+/**
+ * Get the list of departures for a station, recomputing it only when something affecting it changed.
+ * The list stays valid until one of its vehicles reaches a timing point, its orders, timetable
+ * or schedule change (see #InvalidateDepartureCache), or the first departure on it becomes due.
+ * Regardless, it is recomputed every day, so departures within the time window of the board appear.
+ * @param station the station to compute the departures of
+ * @param vehicles set of all the vehicles stopping at this station, of all vehicles types that we are interested in
+ * @param type the type of departures to get (departures or arrivals)
+ * @param show_vehicles_via whether to include vehicles that have this station in their orders but do not stop at it
+ * @param show_pax whether to include passenger vehicles
+ * @param show_freight whether to include freight vehicles
+ * @return a list of departures, which is empty if an error occurred
+ */
+std::shared_ptr<const DepartureList> GetDepartureList(StationID station, const std::vector<const Vehicle *> &vehicles, DepartureType type, bool show_vehicles_via, bool show_pax, bool show_freight)
+{
+	std::vector<const Vehicle *> sorted_vehicles = vehicles;
+	std::sort(sorted_vehicles.begin(), sorted_vehicles.end());
+
+	DepartureCacheEntry *entry = nullptr;
+	for (DepartureCacheEntry &e : _departure_cache) {
+		if (e.station == station && e.type == type && e.show_vehicles_via == show_vehicles_via && e.show_pax == show_pax &&
+				e.show_freight == show_freight && e.vehicles == sorted_vehicles) {
+			entry = &e;
+			break;
+		}
+	}
+
+	if (entry == nullptr) {
+		if (_departure_cache.size() >= MAX_DEPARTURE_CACHE_ENTRIES) {
+			/* Replace the least recently used list. */
+			entry = &*std::min_element(_departure_cache.begin(), _departure_cache.end(), [](const DepartureCacheEntry &a, const DepartureCacheEntry &b) {
+				return (int32)(a.last_used - b.last_used) < 0;
+			});
+		} else {
+			_departure_cache.emplace_back();
+			entry = &_departure_cache.back();
+		}
+		entry->station = station;
+		entry->type = type;
+		entry->show_vehicles_via = show_vehicles_via;
+		entry->show_pax = show_pax;
+		entry->show_freight = show_freight;
+		entry->vehicles = std::move(sorted_vehicles);
+		entry->orders.clear();
+		for (const Vehicle *v : entry->vehicles) {
+			if (v->orders.list != nullptr) entry->orders.push_back(v->orders.list);
+		}
+		std::sort(entry->orders.begin(), entry->orders.end());
+		entry->orders.erase(std::unique(entry->orders.begin(), entry->orders.end()), entry->orders.end());
+		entry->valid = false;
+	}
+
+	entry->last_used = _scaled_tick_counter;
+	if (entry->valid && _scaled_date_ticks < entry->valid_until) return entry->list;
+
+	DepartureList *list = MakeDepartureList(station, vehicles, type, show_vehicles_via, show_pax, show_freight);
+	entry->list = std::shared_ptr<const DepartureList>(list, DeleteDepartureList);
+	entry->valid = true;
+	entry->valid_until = _scaled_date_ticks + DAY_TICKS * _settings_game.economy.day_length_factor;
+	for (const Departure *d : *list) {
+		DateTicksScaled due = d->scheduled_date + std::max<Ticks>(d->lateness, 0);
+		if (due > _scaled_date_ticks) entry->valid_until = std::min(entry->valid_until, due);
+	}
+
+	return entry->list;
+}
+
+/**
+ * Mark cached departure lists as needing to be recomputed.
+ * @param v Vehicle whose orders, timetable or progress along its orders changed; all vehicles sharing its orders are affected as well.
+ *          When nullptr, all lists are discarded.
+ */
+void InvalidateDepartureCache(const Vehicle *v)
+{
+	if (_departure_cache.empty()) return;
+
+	if (v == nullptr) {
+		_departure_cache.clear();
+		return;
+	}
+
+	/* Vehicles without orders do not have any departures. */
+	if (v->orders.list == nullptr) return;
+
+	for (DepartureCacheEntry &e : _departure_cache) {
+		if (e.valid && std::binary_search(e.orders.begin(), e.orders.end(), v->orders.list)) e.valid = false;
+	}
+}
+
+/**
+ * Discard all cached departure lists and rebuild the vehicle lists of all departure boards.
+ */
+void InvalidateDepartureBoards()
+{
+	InvalidateDepartureCache(nullptr);
+	InvalidateWindowClassesData(WC_DEPARTURES_BOARD, 0);
+}
@@ -17,8 +17,13 @@
 #include "departures_type.h"
 
 #include <vector>
+#include <memory>
 
 DepartureList* MakeDepartureList(StationID station, const std::vector<const Vehicle *> &vehicles, DepartureType type = D_DEPARTURE,
 		bool show_vehicles_via = false, bool show_pax = true, bool show_freight = true);
+std::shared_ptr<const DepartureList> GetDepartureList(StationID station, const std::vector<const Vehicle *> &vehicles, DepartureType type = D_DEPARTURE,
+		bool show_vehicles_via = false, bool show_pax = true, bool show_freight = true);
+void InvalidateDepartureCache(const Vehicle *v = nullptr);
+void InvalidateDepartureBoards();
 
 #endif /* DEPARTURES_FUNC_H */
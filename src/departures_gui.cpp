@@ -88,8 +88,8 @@ template<bool Twaypoint = false>
 struct DeparturesWindow : public Window {
 protected:
 	StationID station;         ///< The station whose departures we're showing.
-	DepartureList *departures; ///< The current list of departures from this station.
-	DepartureList *arrivals;   ///< The current list of arrivals from this station.
+	std::shared_ptr<const DepartureList> departures; ///< The current list of departures from this station.
+	std::shared_ptr<const DepartureList> arrivals;   ///< The current list of arrivals from this station.
 	bool departures_invalid;   ///< The departures and arrivals list are currently invalid.
 	bool vehicles_invalid;     ///< The vehicles list is currently invalid.
 	uint entry_height;         ///< The height of an entry in the departures list.
@@ -110,7 +110,6 @@ protected:
 	virtual uint GetMinWidth() const;
 	static void RecomputeDateWidth();
 	virtual void DrawDeparturesListItems(const Rect &r) const;
-	void DeleteDeparturesList(DepartureList* list);
 
 	void ToggleCargoFilter(int widget, bool &flag)
 	{
@@ -213,8 +212,8 @@ public:
 
 	DeparturesWindow(WindowDesc *desc, WindowNumber window_number) : Window(desc),
 		station(window_number),
-		departures(new DepartureList()),
-		arrivals(new DepartureList()),
+		departures(std::make_shared<DepartureList>()),
+		arrivals(std::make_shared<DepartureList>()),
 		departures_invalid(true),
 		vehicles_invalid(true),
 		entry_height(1 + FONT_HEIGHT_NORMAL + 1 + (_settings_client.gui.departure_larger_font ? FONT_HEIGHT_NORMAL : FONT_HEIGHT_SMALL) + 1 + 1),
@@ -269,12 +268,6 @@ public:
 		if (_pause_mode != PM_UNPAUSED) this->OnGameTick();
 	}
 
-	virtual ~DeparturesWindow()
-	{
-		this->DeleteDeparturesList(departures);
-		this->DeleteDeparturesList(this->arrivals);
-	}
-
 	virtual void UpdateWidgetSize(int widget, Dimension *size, const Dimension &padding, Dimension *fill, Dimension *resize) override
 	{
 		switch (widget) {
@@ -446,12 +439,10 @@ public:
 		/* Recompute the list of departures if we're due to. */
 		if (this->calc_tick_countdown <= 0) {
 			this->calc_tick_countdown = _settings_client.gui.departure_calc_frequency;
-			this->DeleteDeparturesList(this->departures);
-			this->DeleteDeparturesList(this->arrivals);
 			bool show_pax = _settings_client.gui.departure_only_passengers ? true : this->show_pax;
 			bool show_freight = _settings_client.gui.departure_only_passengers ? false : this->show_freight;
-			this->departures = (this->departure_types[0] ? MakeDepartureList(this->station, this->vehicles, D_DEPARTURE, Twaypoint || this->departure_types[2], show_pax, show_freight) : new DepartureList());
-			this->arrivals   = (this->departure_types[1] && !_settings_client.gui.departure_show_both ? MakeDepartureList(this->station, this->vehicles, D_ARRIVAL, false, show_pax, show_freight) : new DepartureList());
+			this->departures = (this->departure_types[0] ? GetDepartureList(this->station, this->vehicles, D_DEPARTURE, Twaypoint || this->departure_types[2], show_pax, show_freight) : std::make_shared<DepartureList>());
+			this->arrivals   = (this->departure_types[1] && !_settings_client.gui.departure_show_both ? GetDepartureList(this->station, this->vehicles, D_ARRIVAL, false, show_pax, show_freight) : std::make_shared<DepartureList>());
 			this->departures_invalid = false;
 			this->SetWidgetDirty(WID_DB_LIST);
 		}
@@ -589,23 +580,6 @@ uint DeparturesWindow<Twaypoint>::GetMinWidth() const
 	return result + 140;
 }
 
-/**
- * Deletes this window's departure list.
- */
-template<bool Twaypoint>
-void DeparturesWindow<Twaypoint>::DeleteDeparturesList(DepartureList *list)
-{
-	/* SmallVector uses free rather than delete on its contents (which doesn't invoke the destructor), so we need to delete each departure manually. */
-	for (uint i = 0; i < list->size(); ++i) {
-		Departure **d = &(*list)[i];
-		delete *d;
-		/* Make sure a double free doesn't happen. */
-		*d = nullptr;
-	}
-	delete list;
-	list = nullptr;
-}
-
 /**
  * Draws a list of departures.
  */
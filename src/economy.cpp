@@ -54,6 +54,9 @@
 #include "tbtr_template_vehicle_func.h"
 #include "scope_info.h"
 #include "pathfinder/yapf/yapf_cache.h"
+#include "departures_func.h"
+#include "viewport_func.h"
+#include "smallmap_gui.h"
 
 #include "table/strings.h"
 #include "table/pricebase.h"
@@ -590,6 +593,10 @@ void ChangeOwnershipOfCompanyItems(Owner old_owner, Owner new_owner)
 
 	RegisterGameEvents(new_owner != INVALID_OWNER ? GEF_COMPANY_MERGE : GEF_COMPANY_DELETE);
 
+	/* The owners of the tiles were changed without marking the tiles dirty, so drop the cached map colours. */
+	ViewportMapInvalidateColourCaches();
+	InvalidateSmallMapColourCaches();
+
 	MarkWholeScreenDirty();
 }
 
@@ -2283,7 +2290,7 @@ static void DoAcquireCompany(Company *c)
 	InvalidateWindowClassesData(WC_SHIPS_LIST, 0);
 	InvalidateWindowClassesData(WC_ROADVEH_LIST, 0);
 	InvalidateWindowClassesData(WC_AIRCRAFT_LIST, 0);
-	InvalidateWindowClassesData(WC_DEPARTURES_BOARD, 0);
+	InvalidateDepartureBoards();
 
 	delete c;
 
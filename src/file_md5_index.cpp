@@ -0,0 +1,213 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file file_md5_index.cpp Persistent index of the MD5 sums of files. */
+
+#include "stdafx.h"
+#include "debug.h"
+#include "fileio_func.h"
+#include "file_md5_index.h"
+#include "string_func.h"
+#include "core/endian_func.hpp"
+
+#include <sys/stat.h>
+
+#include "safeguards.h"
+
+/** Magic at the start of an index file. */
+static const char FILE_MD5_INDEX_MAGIC[8] = { 'O', 'T', 'T', 'D', 'M', 'D', '5', 'I' };
+/** Version of the format of the index files; increase when changing the format. */
+static const uint32 FILE_MD5_INDEX_VERSION = 1;
+
+/**
+ * Get the size and modification time of a file on disk.
+ * @param path Full path of the file.
+ * @param[out] size The size of the file.
+ * @param[out] mtime The modification time of the file.
+ * @return Whether the file exists.
+ */
+static bool GetFileState(const std::string &path, uint64 &size, int64 &mtime)
+{
+#if defined(_WIN32)
+	struct _stat64 sb;
+	if (_wstat64(OTTD2FS(path).c_str(), &sb) != 0 || (sb.st_mode & _S_IFREG) == 0) return false;
+#else
+	struct stat sb;
+	if (stat(path.c_str(), &sb) != 0 || !S_ISREG(sb.st_mode)) return false;
+#endif
+	size = sb.st_size;
+	mtime = sb.st_mtime;
+	return true;
+}
+
+/**
+ * Determine the state of a file. For files within a tar, which are named by
+ * the path of the tar followed by their name within it, the state of the tar
+ * is used, as any change to the file changes the tar.
+ * @param path Full path of the file.
+ */
+FileMD5IndexKey::FileMD5IndexKey(const std::string &path) : path(path)
+{
+	std::string file = path;
+	for (;;) {
+		if (GetFileState(file, this->size, this->mtime)) {
+			this->valid = true;
+			return;
+		}
+		auto sep = file.rfind(PATHSEPCHAR);
+		if (sep == std::string::npos || sep == 0) return;
+		file.resize(sep);
+	}
+}
+
+/**
+ * Get the full name of the index file.
+ * @return The filename.
+ */
+std::string FileMD5Index::GetFilename() const
+{
+	return _personal_dir + "cache" PATHSEP + this->name;
+}
+
+/** Read the index file, if that has not been done yet. Must be called with the lock held. */
+void FileMD5Index::Load()
+{
+	if (this->loaded) return;
+	this->loaded = true;
+	if (_personal_dir.empty()) return;
+
+	size_t size;
+	std::unique_ptr<char[]> data = ReadFileToMem(this->GetFilename(), size, 64 * 1024 * 1024);
+	if (data == nullptr) return;
+
+	const byte *pos = (const byte *)data.get();
+	const byte *end = pos + size;
+	auto read = [&](void *dest, size_t len) -> bool {
+		if ((size_t)(end - pos) < len) return false;
+		memcpy(dest, pos, len);
+		pos += len;
+		return true;
+	};
+
+	char magic[sizeof(FILE_MD5_INDEX_MAGIC)];
+	uint32 version, count;
+	if (!read(magic, sizeof(magic)) || memcmp(magic, FILE_MD5_INDEX_MAGIC, sizeof(magic)) != 0) return;
+	if (!read(&version, sizeof(version)) || FROM_LE32(version) != FILE_MD5_INDEX_VERSION) return;
+	if (!read(&count, sizeof(count))) return;
+
+	for (count = FROM_LE32(count); count > 0; count--) {
+		uint16 length;
+		Entry entry;
+		if (!read(&length, sizeof(length))) break;
+		length = FROM_LE16(length);
+		if ((size_t)(end - pos) < length) break;
+		std::string path((const char *)pos, length);
+		pos += length;
+		if (!read(&entry.size, sizeof(entry.size)) || !read(&entry.mtime, sizeof(entry.mtime)) || !read(entry.md5sum, sizeof(entry.md5sum))) break;
+		entry.size = FROM_LE64(entry.size);
+		entry.mtime = (int64)FROM_LE64((uint64)entry.mtime);
+		entry.used = false;
+		this->entries[path] = entry;
+	}
+
+	DEBUG(misc, 3, "Loaded %u entries from MD5 index %s", (uint)this->entries.size(), this->name);
+}
+
+/**
+ * Look up the MD5 sum of a file.
+ * @param key The state of the file.
+ * @param[out] md5sum The MD5 sum, when found.
+ * @return Whether the file is in the index and has not changed since.
+ */
+bool FileMD5Index::Find(const FileMD5IndexKey &key, uint8 md5sum[16])
+{
+	if (!key.valid) return false;
+
+	std::lock_guard<std::mutex> lk(this->lock);
+	this->Load();
+
+	auto it = this->entries.find(key.path);
+	if (it == this->entries.end() || it->second.size != key.size || it->second.mtime != key.mtime) return false;
+
+	it->second.used = true;
+	memcpy(md5sum, it->second.md5sum, sizeof(it->second.md5sum));
+	return true;
+}
+
+/**
+ * Add the MD5 sum of a file to the index.
+ * @param key The state of the file at the moment it was hashed.
+ * @param md5sum The MD5 sum.
+ */
+void FileMD5Index::Add(const FileMD5IndexKey &key, const uint8 md5sum[16])
+{
+	if (!key.valid) return;
+
+	std::lock_guard<std::mutex> lk(this->lock);
+	this->Load();
+
+	Entry &entry = this->entries[key.path];
+	entry.size = key.size;
+	entry.mtime = key.mtime;
+	memcpy(entry.md5sum, md5sum, sizeof(entry.md5sum));
+	entry.used = true;
+	this->dirty = true;
+}
+
+/**
+ * Write the index file, without the files which have not been seen since it was loaded.
+ * Call this after a complete scan, so removed files do not stay in the index forever.
+ */
+void FileMD5Index::Save()
+{
+	std::lock_guard<std::mutex> lk(this->lock);
+	if (!this->loaded || _personal_dir.empty()) return;
+
+	for (auto it = this->entries.begin(); it != this->entries.end();) {
+		if (it->second.used) {
+			it->second.used = false;
+			++it;
+		} else {
+			it = this->entries.erase(it);
+			this->dirty = true;
+		}
+	}
+	if (!this->dirty) return;
+
+	std::vector<byte> buffer;
+	auto write = [&](const void *data, size_t len) {
+		buffer.insert(buffer.end(), (const byte *)data, (const byte *)data + len);
+	};
+
+	uint32 version = TO_LE32(FILE_MD5_INDEX_VERSION);
+	uint32 count = TO_LE32((uint32)this->entries.size());
+	write(FILE_MD5_INDEX_MAGIC, sizeof(FILE_MD5_INDEX_MAGIC));
+	write(&version, sizeof(version));
+	write(&count, sizeof(count));
+	for (const auto &it : this->entries) {
+		uint16 length = TO_LE16((uint16)std::min<size_t>(it.first.size(), UINT16_MAX));
+		uint64 size = TO_LE64(it.second.size);
+		uint64 mtime = TO_LE64((uint64)it.second.mtime);
+		write(&length, sizeof(length));
+		write(it.first.data(), FROM_LE16(length));
+		write(&size, sizeof(size));
+		write(&mtime, sizeof(mtime));
+		write(it.second.md5sum, sizeof(it.second.md5sum));
+	}
+
+	FioCreateDirectory(_personal_dir + "cache" PATHSEP);
+	FILE *f = FioFOpenFile(this->GetFilename(), "wb", NO_DIRECTORY);
+	if (f == nullptr) {
+		DEBUG(misc, 1, "Could not create MD5 index %s", this->GetFilename().c_str());
+		return;
+	}
+	if (fwrite(buffer.data(), 1, buffer.size(), f) != buffer.size()) {
+		DEBUG(misc, 1, "Could not write MD5 index %s", this->GetFilename().c_str());
+	}
+	FioFCloseFile(f);
+	this->dirty = false;
+}
@@ -0,0 +1,67 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file file_md5_index.h Persistent index of the MD5 sums of files. */
+
+#ifndef FILE_MD5_INDEX_H
+#define FILE_MD5_INDEX_H
+
+#include <string>
+#include <unordered_map>
+#include <mutex>
+#if defined(__MINGW32__)
+#include "3rdparty/mingw-std-threads/mingw.mutex.h"
+#endif
+
+/** Identification of the state of a file on disk. */
+struct FileMD5IndexKey {
+	std::string path;   ///< Full path of the file.
+	uint64 size = 0;    ///< Size of the file, or of the tar it is in.
+	int64 mtime = 0;    ///< Modification time of the file, or of the tar it is in.
+	bool valid = false; ///< Whether the state of the file could be determined.
+
+	FileMD5IndexKey() {}
+	FileMD5IndexKey(const std::string &path);
+};
+
+/**
+ * Index of MD5 sums of files, stored in the personal directory.
+ * When the size and modification time of a file are unchanged since the
+ * sum was calculated, the stored sum is used instead of reading the file.
+ * All methods may be called from multiple threads.
+ */
+class FileMD5Index {
+	/** An indexed file. */
+	struct Entry {
+		uint64 size;      ///< Size of the file at the time of hashing.
+		int64 mtime;      ///< Modification time of the file at the time of hashing.
+		uint8 md5sum[16]; ///< The MD5 sum.
+		bool used;        ///< Whether the entry was looked up or added since the index was loaded.
+	};
+
+	const char *name;                                ///< Name of the index file.
+	std::mutex lock;                                 ///< Lock for all members below.
+	std::unordered_map<std::string, Entry> entries;  ///< The indexed files, by full path.
+	bool loaded = false;                             ///< Whether the index file has been read.
+	bool dirty = false;                              ///< Whether the entries differ from the index file.
+
+	std::string GetFilename() const;
+	void Load();
+
+public:
+	/**
+	 * Create an index.
+	 * @param name Name of the index file within the cache directory.
+	 */
+	FileMD5Index(const char *name) : name(name) {}
+
+	bool Find(const FileMD5IndexKey &key, uint8 md5sum[16]);
+	void Add(const FileMD5IndexKey &key, const uint8 md5sum[16]);
+	void Save();
+};
+
+#endif /* FILE_MD5_INDEX_H */
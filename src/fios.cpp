@@ -14,6 +14,7 @@
 #include "3rdparty/md5/md5.h"
 #include "fileio_func.h"
 #include "fios.h"
+#include "file_md5_index.h"
 #include "network/network_content.h"
 #include "screenshot.h"
 #include "string_func.h"
@@ -648,6 +649,9 @@ struct ScenarioIdentifier {
 	}
 };
 
+/** Index of the MD5 sums of scenarios, so unchanged scenarios need not be hashed at every scan. */
+static FileMD5Index _scenario_md5_index("scenario_md5.idx");
+
 /**
  * Scanner to find the unique IDs of scenarios
  */
@@ -667,6 +671,7 @@ public:
 
 		this->FileScanner::Scan(".id", SCENARIO_DIR, true, true);
 		this->scanned = true;
+		_scenario_md5_index.Save();
 	}
 
 	bool AddFile(const std::string &filename, size_t basepath_length, const std::string &tar_filename) override
@@ -683,19 +688,24 @@ public:
 		Md5 checksum;
 		uint8 buffer[1024];
 		size_t len, size;
+		std::string path;
 
 		/* open the scenario file, but first get the name.
 		 * This is safe as we check on extension which
 		 * must always exist. */
-		f = FioFOpenFile(filename.substr(0, filename.rfind('.')), "rb", SCENARIO_DIR, &size);
+		f = FioFOpenFile(filename.substr(0, filename.rfind('.')), "rb", SCENARIO_DIR, &size, &path);
 		if (f == nullptr) return false;
 
-		/* calculate md5sum */
-		while ((len = fread(buffer, 1, (size > sizeof(buffer)) ? sizeof(buffer) : size, f)) != 0 && size != 0) {
-			size -= len;
-			checksum.Append(buffer, len);
+		/* calculate md5sum, unless the scenario did not change since it was last calculated */
+		FileMD5IndexKey key(path);
+		if (!_scenario_md5_index.Find(key, id.md5sum)) {
+			while ((len = fread(buffer, 1, (size > sizeof(buffer)) ? sizeof(buffer) : size, f)) != 0 && size != 0) {
+				size -= len;
+				checksum.Append(buffer, len);
+			}
+			checksum.Finish(id.md5sum);
+			_scenario_md5_index.Add(key, id.md5sum);
 		}
-		checksum.Finish(id.md5sum);
 
 		FioFCloseFile(f);
 
@@ -1015,6 +1015,18 @@ void ShowFrametimeGraphWindow(PerformanceElement elem)
 	AllocateWindowDescFront<FrametimeGraphWindow>(&_frametime_graph_window_desc, elem, true);
 }
 
+/**
+ * Get the average processing time of a performance element, e.g. for reporting it to an admin.
+ * @param elem The element to get the time of.
+ * @param count The maximum number of most recent data points to average over.
+ * @return The average time in milliseconds, or a negative value when there is no data for the element.
+ */
+double GetPerformanceAverageDurationMilliseconds(PerformanceElement elem, int count)
+{
+	if (_pf_data[elem].num_valid == 0) return -1;
+	return _pf_data[elem].GetAverageDurationMilliseconds(count);
+}
+
 /** Print performance statistics to game console */
 void ConPrintFramerate()
 {
@@ -121,5 +121,6 @@ public:
 };
 
 void ShowFramerateWindow();
+double GetPerformanceAverageDurationMilliseconds(PerformanceElement elem, int count);
 
 #endif /* FRAMERATE_TYPE_H */
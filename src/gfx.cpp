@@ -106,9 +106,32 @@ extern uint _dirty_block_colour;
 static bool _whole_screen_dirty = false;
 bool _gfx_draw_active = false;
 
-static std::vector<Rect> _dirty_blocks;
+static std::vector<Rect> _dirty_blocks;          ///< Non-overlapping screen rectangles to redraw.
 static std::vector<Rect> _pending_dirty_blocks;
 
+/**
+ * Estimated cost of setting up the redraw of one rectangle, in pixels.
+ * Rectangles are merged into their bounding box when that adds at most this many pixels to the area to redraw.
+ */
+static const int DIRTY_RECT_SETUP_COST = 64 * 64;
+
+/** Counters of the work done to redraw the dirty areas of the screen. */
+struct DirtyBlockStats {
+	uint64 frames;           ///< Number of calls to DrawDirtyBlocks.
+	uint64 rects_marked;     ///< Number of screen rectangles marked dirty.
+	uint64 pixels_marked;    ///< Sum of the areas of the screen rectangles marked dirty, overlaps included.
+	uint64 rects_merged;     ///< Number of screen rectangles merged into a bounding box.
+	uint64 pixels_merged;    ///< Number of clean screen pixels added to the redraw by merging.
+	uint64 rects_drawn;      ///< Number of screen rectangles redrawn.
+	uint64 pixels_drawn;     ///< Number of screen pixels redrawn.
+	uint64 pixels_overdrawn; ///< Number of screen pixels redrawn a second time in the same frame, for areas marked dirty during drawing.
+	uint64 vp_blocks_dirty;  ///< Number of dirty viewport blocks.
+	uint64 vp_blocks_merged; ///< Number of clean viewport blocks drawn to save drawing a separate rectangle.
+	uint64 vp_rects_drawn;   ///< Number of viewport rectangles drawn.
+	uint64 vp_pixels_drawn;  ///< Number of viewport pixels drawn, excluding the areas occluded by other windows or dirty rectangles.
+};
+static DirtyBlockStats _dirty_block_stats;
+
 enum GfxDebugFlags {
 	GDF_SHOW_WINDOW_DIRTY,
 	GDF_SHOW_WIDGET_DIRTY,
@@ -1523,6 +1546,8 @@ static void DrawDirtyViewport(uint occlusion, int left, int top, int right, int
 		}
 	}
 
+	_dirty_block_stats.vp_pixels_drawn += (uint64)(right - left) * (bottom - top);
+
 	if (_game_mode == GM_MENU) {
 		RedrawScreenRect(left, top, right, bottom);
 	} else {
@@ -1545,6 +1570,105 @@ static void DrawOverlappedWindowWithClipping(Window *w, int left, int top, int r
 	DrawOverlappedWindow(w, std::max(0, left), std::max(0, top), std::min(_screen.width, right), std::min(_screen.height, bottom), flags);
 }
 
+/**
+ * Draw the dirty blocks of a viewport as a set of non-overlapping rectangles.
+ * Dirty blocks are coalesced downwards and to the right first. The rectangle is then
+ * grown over clean blocks, as long as the clean area drawn in addition is cheaper
+ * than setting up the drawing of the dirty blocks it takes in as separate rectangles.
+ * @param vp The viewport to draw.
+ */
+static void DrawDirtyViewportBlocks(Viewport *vp)
+{
+	enum BlockState : byte {
+		BS_CLEAN,
+		BS_DIRTY,
+		BS_DRAWN,
+	};
+	static std::vector<BlockState> state;
+
+	const uint grid_w = vp->dirty_blocks_per_row;
+	const uint grid_h = vp->dirty_blocks_per_column;
+	const uint merge_budget = DIRTY_RECT_SETUP_COST >> (vp->GetDirtyBlockWidthShift() + vp->GetDirtyBlockHeightShift());
+
+	state.resize(grid_w * grid_h);
+	for (uint i = 0; i < grid_w * grid_h; i++) {
+		state[i] = vp->dirty_blocks[i] ? BS_DIRTY : BS_CLEAN;
+	}
+
+	/* Count the dirty blocks in a part of a column or row, return UINT_MAX if it includes already drawn blocks */
+	auto count_column = [&](uint x, uint top, uint bottom) -> uint {
+		uint dirty = 0;
+		for (uint p = x * grid_h + top; p < x * grid_h + bottom; p++) {
+			if (state[p] == BS_DRAWN) return UINT_MAX;
+			if (state[p] == BS_DIRTY) dirty++;
+		}
+		return dirty;
+	};
+	auto count_row = [&](uint y, uint left, uint right) -> uint {
+		uint dirty = 0;
+		for (uint p = left * grid_h + y; p < right * grid_h + y; p += grid_h) {
+			if (state[p] == BS_DRAWN) return UINT_MAX;
+			if (state[p] == BS_DIRTY) dirty++;
+		}
+		return dirty;
+	};
+
+	uint pos = 0;
+	for (uint x = 0; x < grid_w; x++) {
+		for (uint y = 0; y < grid_h; y++, pos++) {
+			if (state[pos] != BS_DIRTY) continue;
+
+			uint left = x;
+			uint top = y;
+			uint right = x + 1;
+			uint bottom = y + 1;
+
+			/* First try coalescing downwards */
+			while (bottom != grid_h && state[pos + bottom - y] == BS_DIRTY) bottom++;
+
+			/* Try coalescing to the right too, as long as full lines of dirty blocks follow. */
+			while (right != grid_w && count_column(right, top, bottom) == bottom - top) right++;
+
+			/* Grow over clean blocks where that takes in dirty blocks, preferring the direction with fewest clean blocks per dirty block. */
+			uint merged = 0;
+			for (;;) {
+				uint dirty_r = (right != grid_w) ? count_column(right, top, bottom) : UINT_MAX;
+				uint dirty_b = (bottom != grid_h) ? count_row(bottom, left, right) : UINT_MAX;
+				uint clean_r = (bottom - top) - dirty_r;
+				uint clean_b = (right - left) - dirty_b;
+				bool grow_r = dirty_r != UINT_MAX && dirty_r > 0 && merged + clean_r <= merge_budget;
+				bool grow_b = dirty_b != UINT_MAX && dirty_b > 0 && merged + clean_b <= merge_budget;
+				if (grow_r && (!grow_b || clean_r * dirty_b <= clean_b * dirty_r)) {
+					right++;
+					merged += clean_r;
+				} else if (grow_b) {
+					bottom++;
+					merged += clean_b;
+				} else {
+					break;
+				}
+			}
+
+			for (uint bx = left; bx < right; bx++) {
+				for (uint p = bx * grid_h + top; p < bx * grid_h + bottom; p++) {
+					if (state[p] == BS_DIRTY) _dirty_block_stats.vp_blocks_dirty++;
+					state[p] = BS_DRAWN;
+				}
+			}
+			_dirty_block_stats.vp_blocks_merged += merged;
+			_dirty_block_stats.vp_rects_drawn++;
+
+			int draw_left = std::max<int>(0, ((left == 0) ? 0 : vp->dirty_block_left_margin + (left << vp->GetDirtyBlockWidthShift())) + vp->left);
+			int draw_top = std::max<int>(0, (top << vp->GetDirtyBlockHeightShift()) + vp->top);
+			int draw_right = std::min<int>(_screen.width, std::min<int>((right << vp->GetDirtyBlockWidthShift()) + vp->dirty_block_left_margin, vp->width) + vp->left);
+			int draw_bottom = std::min<int>(_screen.height, std::min<int>(bottom << vp->GetDirtyBlockHeightShift(), vp->height) + vp->top);
+			if (draw_left < draw_right && draw_top < draw_bottom) {
+				DrawDirtyViewport(0, draw_left, draw_top, draw_right, draw_bottom);
+			}
+		}
+	}
+}
+
 /**
  * Repaints the rectangle blocks which are marked as 'dirty'.
  *
@@ -1560,9 +1684,12 @@ void DrawDirtyBlocks()
 	ViewportPrepareVehicleRoute();
 
 	_gfx_draw_active = true;
+	_dirty_block_stats.frames++;
 
 	if (_whole_screen_dirty) {
 		RedrawScreenRect(0, 0, _screen.width, _screen.height);
+		_dirty_block_stats.rects_drawn++;
+		_dirty_block_stats.pixels_drawn += (uint64)_screen.width * _screen.height;
 		for (Window *w : Window::IterateFromBack()) {
 			w->flags &= ~(WF_DIRTY | WF_WIDGETS_DIRTY | WF_DRAG_DIRTIED);
 		}
@@ -1659,65 +1786,8 @@ void DrawDirtyBlocks()
 						}
 					}
 
-					const uint grid_w = vp->dirty_blocks_per_row;
-					const uint grid_h = vp->dirty_blocks_per_column;
-
-					uint pos = 0;
-					uint x = 0;
-					do {
-						uint y = 0;
-						do {
-							if (vp->dirty_blocks[pos]) {
-								uint left = x;
-								uint top = y;
-								uint right = x + 1;
-								uint bottom = y;
-								uint p = pos;
-
-								/* First try coalescing downwards */
-								do {
-									vp->dirty_blocks[p] = false;
-									p++;
-									bottom++;
-								} while (bottom != grid_h && vp->dirty_blocks[p]);
-
-								/* Try coalescing to the right too. */
-								uint block_h = (bottom - y);
-								p = pos;
-
-								while (right != grid_w) {
-									uint p2 = (p += grid_h);
-									uint check_h = block_h;
-									/* Check if a full line of dirty flags is set. */
-									do {
-										if (!vp->dirty_blocks[p2]) goto no_more_coalesc;
-										p2++;
-									} while (--check_h != 0);
-
-									/* Wohoo, can combine it one step to the right!
-									 * Do that, and clear the bits. */
-									right++;
-
-									check_h = block_h;
-									p2 = p;
-									do {
-										vp->dirty_blocks[p2] = false;
-										p2++;
-									} while (--check_h != 0);
-								}
-								no_more_coalesc:
-
-								assert(_cur_dpi == &bk);
-								int draw_left = std::max<int>(0, ((left == 0) ? 0 : vp->dirty_block_left_margin + (left << vp->GetDirtyBlockWidthShift())) + vp->left);
-								int draw_top = std::max<int>(0, (top << vp->GetDirtyBlockHeightShift()) + vp->top);
-								int draw_right = std::min<int>(_screen.width, std::min<int>((right << vp->GetDirtyBlockWidthShift()) + vp->dirty_block_left_margin, vp->width) + vp->left);
-								int draw_bottom = std::min<int>(_screen.height, std::min<int>(bottom << vp->GetDirtyBlockHeightShift(), vp->height) + vp->top);
-								if (draw_left < draw_right && draw_top < draw_bottom) {
-									DrawDirtyViewport(0, draw_left, draw_top, draw_right, draw_bottom);
-								}
-							}
-						} while (pos++, ++y != grid_h);
-					} while (++x != grid_w);
+					assert(_cur_dpi == &bk);
+					DrawDirtyViewportBlocks(vp);
 
 					_transparency_opt = to_backup;
 					w->viewport->ClearDirty();
@@ -1729,6 +1799,8 @@ void DrawDirtyBlocks()
 
 		for (const Rect &r : _dirty_blocks) {
 			RedrawScreenRect(r.left, r.top, r.right, r.bottom);
+			_dirty_block_stats.rects_drawn++;
+			_dirty_block_stats.pixels_drawn += (uint64)(r.right - r.left) * (r.bottom - r.top);
 		}
 		if (unlikely(HasBit(_gfx_debug_flags, GDF_SHOW_RECT_DIRTY))) {
 			for (const Rect &r : _dirty_blocks) {
@@ -1745,6 +1817,8 @@ void DrawDirtyBlocks()
 		_pending_dirty_blocks.clear();
 		for (const Rect &r : _dirty_blocks) {
 			RedrawScreenRect(r.left, r.top, r.right, r.bottom);
+			_dirty_block_stats.rects_drawn++;
+			_dirty_block_stats.pixels_overdrawn += (uint64)(r.right - r.left) * (r.bottom - r.top);
 		}
 		_dirty_blocks.clear();
 	}
@@ -1804,6 +1878,82 @@ void UnsetDirtyBlocks(int left, int top, int right, int bottom)
 	}
 }
 
+/**
+ * Get the area of a dirty rectangle, whose right and bottom edges are exclusive.
+ * @param r The rectangle.
+ * @return The number of pixels in the rectangle.
+ */
+static inline int RectArea(const Rect &r)
+{
+	return (r.right - r.left) * (r.bottom - r.top);
+}
+
+/**
+ * Get the area of the overlap of two dirty rectangles, whose right and bottom edges are exclusive.
+ * @param a The first rectangle.
+ * @param b The second rectangle.
+ * @return The number of pixels in both rectangles, 0 when they do not overlap.
+ */
+static inline int RectIntersectionArea(const Rect &a, const Rect &b)
+{
+	return std::max(0, std::min(a.right, b.right) - std::max(a.left, b.left)) * std::max(0, std::min(a.bottom, b.bottom) - std::max(a.top, b.top));
+}
+
+/**
+ * Grow a rectangle which is about to be marked dirty into its bounding box with the dirty
+ * rectangles it touches, when redrawing the clean area this adds is estimated to be cheaper
+ * than setting up the redraw of the separate rectangles. The dirty rectangles which end up
+ * within the bounding box are removed.
+ * @param[in,out] rect The rectangle to mark dirty.
+ */
+static void MergeDirtyBlocks(Rect &rect)
+{
+	static std::vector<uint> absorbed;
+
+	for (uint i = 0; i < _dirty_blocks.size();) {
+		const Rect &r = _dirty_blocks[i];
+		if (rect.left > r.right || rect.right < r.left || rect.top > r.bottom || rect.bottom < r.top) {
+			i++;
+			continue;
+		}
+
+		/* Take in all dirty rectangles intersecting the bounding box, growing it as needed */
+		Rect bbox = { std::min(rect.left, r.left), std::min(rect.top, r.top), std::max(rect.right, r.right), std::max(rect.bottom, r.bottom) };
+		int covered;
+		bool grown;
+		do {
+			grown = false;
+			absorbed.clear();
+			covered = RectArea(rect);
+			for (uint j = 0; j < _dirty_blocks.size(); j++) {
+				const Rect &d = _dirty_blocks[j];
+				if (RectIntersectionArea(bbox, d) == 0) continue;
+				absorbed.push_back(j);
+				covered += RectArea(d) - RectIntersectionArea(rect, d);
+				if (d.left < bbox.left || d.right > bbox.right || d.top < bbox.top || d.bottom > bbox.bottom) {
+					bbox = { std::min(bbox.left, d.left), std::min(bbox.top, d.top), std::max(bbox.right, d.right), std::max(bbox.bottom, d.bottom) };
+					grown = true;
+				}
+			}
+		} while (grown);
+
+		int extra = RectArea(bbox) - covered;
+		if (extra > DIRTY_RECT_SETUP_COST * (int)absorbed.size()) {
+			i++;
+			continue;
+		}
+
+		_dirty_block_stats.rects_merged += absorbed.size();
+		_dirty_block_stats.pixels_merged += extra;
+		for (auto it = absorbed.rbegin(); it != absorbed.rend(); ++it) {
+			_dirty_blocks[*it] = _dirty_blocks.back();
+			_dirty_blocks.pop_back();
+		}
+		rect = bbox;
+		i = 0;
+	}
+}
+
 static void AddDirtyBlocks(uint start, int left, int top, int right, int bottom)
 {
 	if (bottom <= top || right <= left) return;
@@ -1832,6 +1982,7 @@ static void AddDirtyBlocks(uint start, int left, int top, int right, int bottom)
 				start--;
 				continue;
 			}
+
 			if (left < r.left && right > r.left) {
 				int middle = r.left;
 				AddDirtyBlocks(start, left, top, middle, bottom);
@@ -1884,8 +2035,14 @@ void SetDirtyBlocks(int left, int top, int right, int bottom)
 	if (top < 0) top = 0;
 	if (right > _screen.width) right = _screen.width;
 	if (bottom > _screen.height) bottom = _screen.height;
+	if (bottom <= top || right <= left) return;
+
+	_dirty_block_stats.rects_marked++;
+	_dirty_block_stats.pixels_marked += (uint64)(right - left) * (bottom - top);
 
-	AddDirtyBlocks(0, left, top, right, bottom);
+	Rect rect = { left, top, right, bottom };
+	MergeDirtyBlocks(rect);
+	AddDirtyBlocks(0, rect.left, rect.top, rect.right, rect.bottom);
 }
 
 void SetPendingDirtyBlocks(int left, int top, int right, int bottom)
@@ -1893,6 +2050,25 @@ void SetPendingDirtyBlocks(int left, int top, int right, int bottom)
 	_pending_dirty_blocks.push_back({ left, top, right, bottom });
 }
 
+void DumpDirtyBlockStats(char *b, const char *last)
+{
+	const DirtyBlockStats &st = _dirty_block_stats;
+	b += seprintf(b, last, "Frames: " OTTD_PRINTF64U "\n", st.frames);
+	b += seprintf(b, last, "Screen rects: marked: " OTTD_PRINTF64U ", merged: " OTTD_PRINTF64U ", drawn: " OTTD_PRINTF64U "\n", st.rects_marked, st.rects_merged, st.rects_drawn);
+	b += seprintf(b, last, "Screen pixels: marked: " OTTD_PRINTF64U ", drawn: " OTTD_PRINTF64U ", added by merging: " OTTD_PRINTF64U ", overdrawn: " OTTD_PRINTF64U "\n",
+			st.pixels_marked, st.pixels_drawn, st.pixels_merged, st.pixels_overdrawn);
+	if (st.pixels_drawn > 0) {
+		b += seprintf(b, last, "Screen pixels marked per pixel drawn: %.2f\n", (double)st.pixels_marked / st.pixels_drawn);
+	}
+	b += seprintf(b, last, "Viewport blocks: dirty: " OTTD_PRINTF64U ", clean blocks merged: " OTTD_PRINTF64U "\n", st.vp_blocks_dirty, st.vp_blocks_merged);
+	b += seprintf(b, last, "Viewport rects drawn: " OTTD_PRINTF64U ", pixels drawn: " OTTD_PRINTF64U "\n", st.vp_rects_drawn, st.vp_pixels_drawn);
+}
+
+void ResetDirtyBlockStats()
+{
+	_dirty_block_stats = {};
+}
+
 /**
  * This function mark the whole screen as dirty. This results in repainting
  * the whole screen. Use this with care as this function will break the
@@ -1902,6 +2078,9 @@ void SetPendingDirtyBlocks(int left, int top, int right, int bottom)
 void MarkWholeScreenDirty()
 {
 	_whole_screen_dirty = true;
+
+	extern void ClearViewportTileSpriteCaches();
+	ClearViewportTileSpriteCaches();
 }
 
 /**
@@ -325,9 +325,13 @@ static bool SwitchNewGRFBlitter()
 		{ "8bpp-optimized",  2,  8,  8,  8,  8 },
 		{ "40bpp-anim",      2,  8, 32,  8, 32 },
 #ifdef WITH_SSE
+		{ "32bpp-avx512",    0, 32, 32,  8, 32 },
+		{ "32bpp-avx2",      0, 32, 32,  8, 32 },
 		{ "32bpp-sse4",      0, 32, 32,  8, 32 },
 		{ "32bpp-ssse3",     0, 32, 32,  8, 32 },
 		{ "32bpp-sse2",      0, 32, 32,  8, 32 },
+		{ "32bpp-avx512-anim", 1, 32, 32,  8, 32 },
+		{ "32bpp-avx2-anim", 1, 32, 32,  8, 32 },
 		{ "32bpp-sse4-anim", 1, 32, 32,  8, 32 },
 #endif
 		{ "32bpp-optimized", 0,  8, 32,  8, 32 },
@@ -221,7 +221,12 @@ private:
 		/* invalidate cached values for name sorter - group names could change */
 		_last_group[0] = _last_group[1] = nullptr;
 
-		list.Sort(&GroupNameSorter);
+		list.SortByKey([](const Group * const &g) {
+			SetDParam(0, g->index);
+			char name[64];
+			GetString(name, STR_GROUP_NAME, lastof(name));
+			return std::make_pair(GetNatSortKey(name), g->index);
+		});
 
 		AddChildren(&list, INVALID_GROUP, 0);
 
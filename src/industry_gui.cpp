@@ -1410,7 +1410,12 @@ protected:
 		                             this->cargo_filter[this->produced_cargo_filter_criteria]);
 
 		this->industries.Filter(filter);
-		this->industries.Sort();
+		if (this->industries.SortType() == 0) {
+			/* Sort by name, using the name of each industry only once. */
+			this->industries.SortByKey([](const Industry * const &i) { return std::make_pair(GetNatSortKey(i->GetCachedName()), i->index); });
+		} else {
+			this->industries.Sort();
+		}
 
 		this->vscroll->SetCount((uint)this->industries.size()); // Update scrollbar as well.
 
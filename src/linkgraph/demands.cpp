@@ -261,16 +261,23 @@ void DemandCalculator::CalcDemand(LinkGraphJob &job, const std::vector<bool> &re
 	uint num_supplies = 0;
 	uint num_demands = 0;
 
+	uint num_accepting = 0;
+
+	/* Demands kept from the previous calculation have already been
+	 * delivered, so only the remaining supply has to be distributed. */
 	for (NodeID node = 0; node < job.Size(); node++) {
 		if (!reachable_nodes[node]) continue;
 		scaler.AddNode(job[node]);
-		if (job[node].Supply() > 0) {
+		if (job[node].UndeliveredSupply() > 0) {
 			supplies.push(node);
 			num_supplies++;
 		}
 		if (job[node].Demand() > 0) {
-			demands.push(node);
-			num_demands++;
+			num_accepting++;
+			if (scaler.HasDemandLeft(job[node])) {
+				demands.push(node);
+				num_demands++;
+			}
 		}
 	}
 
@@ -279,7 +286,7 @@ void DemandCalculator::CalcDemand(LinkGraphJob &job, const std::vector<bool> &re
 	/* Mean acceptance attributed to each node. If the distribution is
 	 * symmetric this is relative to remote supply, otherwise it is
 	 * relative to remote demand. */
-	scaler.SetDemandPerNode(num_demands);
+	scaler.SetDemandPerNode(num_accepting);
 
 	uint chance = 0;
 
@@ -361,7 +368,7 @@ void DemandCalculator::CalcMinimisedDistanceDemand(LinkGraphJob &job, const std:
 	for (NodeID node = 0; node < job.Size(); node++) {
 		if (!reachable_nodes[node]) continue;
 		scaler.AddNode(job[node]);
-		if (job[node].Supply() > 0) {
+		if (job[node].UndeliveredSupply() > 0) {
 			supplies.push_back(node);
 		}
 		if (job[node].Demand() > 0) {
@@ -399,6 +406,125 @@ void DemandCalculator::CalcMinimisedDistanceDemand(LinkGraphJob &job, const std:
 	}
 }
 
+/**
+ * Find the nodes whose demands have to be recalculated, comparing the job with
+ * the demands calculated by the previous job.
+ * @param job Job to calculate the demands for.
+ * @param supply_age Number of days the supplies of the job have been collected over.
+ * @return Changed nodes, or an empty vector if all demands have to be calculated from scratch.
+ */
+std::vector<bool> DemandCalculator::FindChangedNodes(LinkGraphJob &job, Date supply_age)
+{
+	const LinkGraphSettings &settings = job.Settings();
+	const LinkGraph::DemandCache *cache = job.PreviousDemands();
+	const uint size = job.Size();
+
+	/* Recalculate everything from time to time, so that the errors of
+	 * keeping demands of nodes which changed only a little don't add up. */
+	if (cache == nullptr || cache->incremental_runs + 1U >= settings.demand_recalc_interval) return {};
+	if (cache->distribution_type != settings.GetDistributionType(job.Cargo()) || cache->accuracy != settings.accuracy ||
+			cache->demand_size != settings.demand_size || cache->demand_distance != settings.demand_distance) {
+		return {};
+	}
+	if (cache->nodes.size() != size) return {};
+
+	std::vector<bool> changed_nodes(size);
+	for (NodeID node = 0; node < size; node++) {
+		const LinkGraph::DemandCache::CachedNode &cached = cache->nodes[node];
+		Node job_node = job[node];
+
+		/* Nodes have been added, removed or moved. */
+		if (cached.station != job_node.Station() || cached.xy != job_node.XY()) return {};
+
+		/* Compare the supplies per day, as they are collected over different periods. */
+		int64 old_supply = (int64)cached.supply * supply_age;
+		int64 new_supply = (int64)job_node.Supply() * cache->supply_age;
+		changed_nodes[node] = cached.accepting != (job_node.Demand() > 0) ||
+				(old_supply == 0) != (new_supply == 0) ||
+				abs(new_supply - old_supply) * 100 > old_supply * settings.demand_recalc_threshold;
+	}
+	return changed_nodes;
+}
+
+/**
+ * Keep the demands of the previous calculation between unchanged nodes of a
+ * component, scaled to the current supplies. Demands towards changed or
+ * unreachable nodes are dropped, so that the supply is distributed anew.
+ * Components which were merged since the previous calculation are recalculated
+ * completely, as their nodes would otherwise keep their supply within the old components.
+ * @param job Job to calculate the demands for.
+ * @param reachable_nodes Bitmap of nodes in the component.
+ * @param component Lowest node ID in the component.
+ * @param changed_nodes Bitmap of nodes whose demands have to be recalculated.
+ * @param receive If the destinations have to keep track of the demand they receive.
+ */
+void DemandCalculator::SeedDemands(LinkGraphJob &job, const std::vector<bool> &reachable_nodes, NodeID component, const std::vector<bool> &changed_nodes, bool receive)
+{
+	const LinkGraph::DemandCache *cache = job.PreviousDemands();
+
+	uint num_nodes = 0;
+	uint num_changed = 0;
+	for (NodeID node = 0; node < job.Size(); node++) {
+		if (!reachable_nodes[node]) continue;
+		/* The component was merged with another one, or lost its lowest node. */
+		if (cache->nodes[node].component != component) return;
+		num_nodes++;
+		if (changed_nodes[node]) num_changed++;
+	}
+	/* If too many nodes have changed, recalculate the whole component. */
+	if (num_changed * 100 > num_nodes * MAX_CHANGED_NODES_PERCENT) return;
+
+	for (NodeID node = 0; node < job.Size(); node++) {
+		if (!reachable_nodes[node] || changed_nodes[node]) continue;
+		const LinkGraph::DemandCache::CachedNode &cached = cache->nodes[node];
+		Node from = job[node];
+		if (cached.supply == 0) continue;
+		for (const LinkGraph::DemandCache::Demand &demand : cached.demands) {
+			if (!reachable_nodes[demand.dest] || changed_nodes[demand.dest]) continue;
+			uint amount = std::min<uint>((uint)((uint64)demand.demand * from.Supply() / cached.supply), from.UndeliveredSupply());
+			if (amount == 0) continue;
+			from.DeliverSupply(demand.dest, amount);
+			if (receive) job[demand.dest].ReceiveDemand(amount);
+		}
+	}
+}
+
+/**
+ * Store the calculated demands in the job, so that the next job for the same
+ * link graph can start from them.
+ * @param job Job the demands have been calculated for.
+ * @param components Lowest node ID in the connected component of each node.
+ * @param supply_age Number of days the supplies of the job have been collected over.
+ * @param incremental_runs Number of incremental calculations since the last full one.
+ */
+void DemandCalculator::StoreDemands(LinkGraphJob &job, const std::vector<NodeID> &components, Date supply_age, uint16 incremental_runs)
+{
+	const LinkGraphSettings &settings = job.Settings();
+	std::shared_ptr<LinkGraph::DemandCache> cache = std::make_shared<LinkGraph::DemandCache>();
+	cache->supply_age = supply_age;
+	cache->incremental_runs = incremental_runs;
+	cache->distribution_type = settings.GetDistributionType(job.Cargo());
+	cache->accuracy = settings.accuracy;
+	cache->demand_size = settings.demand_size;
+	cache->demand_distance = settings.demand_distance;
+	cache->nodes.resize(job.Size());
+	for (NodeID node = 0; node < job.Size(); node++) {
+		Node job_node = job[node];
+		LinkGraph::DemandCache::CachedNode &cached = cache->nodes[node];
+		cached.station = job_node.Station();
+		cached.xy = job_node.XY();
+		cached.supply = job_node.Supply();
+		cached.accepting = job_node.Demand() > 0;
+		cached.component = components[node];
+		const LinkGraphJob::DemandAnnotationVector &demands = job_node.Demands();
+		cached.demands.reserve(demands.size());
+		for (const DemandAnnotation &demand : demands) {
+			if (demand.demand > 0) cached.demands.push_back({ demand.dest, demand.demand });
+		}
+	}
+	job.SetDemandCache(std::move(cache));
+}
+
 /**
  * Create the DemandCalculator and immediately do the calculation.
  * @param job Job to calculate the demands for.
@@ -418,44 +544,53 @@ DemandCalculator::DemandCalculator(LinkGraphJob &job) :
 	}
 
 	const uint size = job.Size();
+	const DistributionType distribution_type = settings.GetDistributionType(cargo);
 
-	/* Symmetric edge matrix
-	 * Storage order: e01  e02 e12  e03 e13 e23  e04 e14 e24 e34  ... */
-	auto se_index = [](uint i, uint j) -> uint {
-		if (j < i) std::swap(i, j);
-		return i + (j * (j - 1) / 2);
-	};
-	std::vector<bool> symmetric_edges(se_index(0, size));
+	/* Keep the demands of the previous calculation for nodes which haven't
+	 * changed much since then, unless it's time for a full recalculation. */
+	const Date supply_age = std::max<Date>((Date)(job.StartDateTicks() / DAY_TICKS) - job.LastCompression() + 1, 1);
+	const std::vector<bool> changed_nodes = this->FindChangedNodes(job, supply_age);
 
+	/* Nodes connected by an edge in either direction, so that the connected
+	 * components can be found in time linear to the number of edges. */
+	std::vector<std::vector<NodeID>> neighbours(size);
 	for (NodeID node_id = 0; node_id < size; ++node_id) {
 		Node from = job[node_id];
 		for (EdgeIterator it(from.Begin()); it != from.End(); ++it) {
-			symmetric_edges[se_index(node_id, it->first)] = true;
+			neighbours[node_id].push_back(it->first);
+			neighbours[it->first].push_back(node_id);
 		}
 	}
 	uint first_unseen = 0;
 	std::vector<bool> reachable_nodes(size);
+	std::vector<NodeID> components(size, INVALID_NODE);
 	do {
 		reachable_nodes.assign(size, false);
 		std::vector<NodeID> queue;
 		queue.push_back(first_unseen);
 		reachable_nodes[first_unseen] = true;
+		NodeID component = first_unseen;
 		while (!queue.empty()) {
 			NodeID from = queue.back();
 			queue.pop_back();
-			for (NodeID to = 0; to < size; ++to) {
-				if (from == to) continue;
-				if (symmetric_edges[se_index(from, to)]) {
-					std::vector<bool>::reference bit = reachable_nodes[to];
-					if (!bit) {
-						bit = true;
-						queue.push_back(to);
-					}
+			component = std::min(component, from);
+			for (NodeID to : neighbours[from]) {
+				std::vector<bool>::reference bit = reachable_nodes[to];
+				if (!bit) {
+					bit = true;
+					queue.push_back(to);
 				}
 			}
 		}
+		for (NodeID node = 0; node < size; node++) {
+			if (reachable_nodes[node]) components[node] = component;
+		}
 
-		switch (settings.GetDistributionType(cargo)) {
+		if (!changed_nodes.empty()) {
+			this->SeedDemands(job, reachable_nodes, component, changed_nodes, distribution_type == DT_ASYMMETRIC_EQ);
+		}
+
+		switch (distribution_type) {
 			case DT_SYMMETRIC:
 				this->CalcDemand<SymmetricScaler>(job, reachable_nodes, SymmetricScaler(settings.demand_size));
 				break;
@@ -477,4 +612,6 @@ DemandCalculator::DemandCalculator(LinkGraphJob &job) :
 			first_unseen++;
 		}
 	} while (first_unseen < size);
+
+	this->StoreDemands(job, components, supply_age, changed_nodes.empty() ? 0 : job.PreviousDemands()->incremental_runs + 1);
 }
@@ -18,6 +18,13 @@ private:
 	int32 mod_dist;     ///< Distance modifier, determines how much demands decrease with distance.
 	int32 accuracy;     ///< Accuracy of the calculation.
 
+	/** Maximum percentage of changed nodes in a component for which the previous demands are still reused. */
+	static const uint MAX_CHANGED_NODES_PERCENT = 25;
+
+	std::vector<bool> FindChangedNodes(LinkGraphJob &job, Date supply_age);
+	void SeedDemands(LinkGraphJob &job, const std::vector<bool> &reachable_nodes, NodeID component, const std::vector<bool> &changed_nodes, bool receive);
+	void StoreDemands(LinkGraphJob &job, const std::vector<NodeID> &components, Date supply_age, uint16 incremental_runs);
+
 	template<class Tscaler>
 	void CalcDemand(LinkGraphJob &job, const std::vector<bool> &reachable_nodes, Tscaler scaler);
 
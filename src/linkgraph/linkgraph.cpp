@@ -17,6 +17,12 @@
 LinkGraphPool _link_graph_pool("LinkGraph");
 INSTANTIATE_POOL_METHODS(LinkGraph)
 
+/* Edge returned when looking up a link which doesn't exist. */
+/* static */ const LinkGraph::BaseEdge LinkGraph::empty_edge = { 0, 0, INVALID_DATE, INVALID_DATE, INVALID_NODE };
+
+/* Edges of nodes which don't have any. */
+/* static */ const LinkGraph::EdgeVector LinkGraph::SharedEdgeVector::empty;
+
 /**
  * Create a node or clear it.
  * @param xy Location of the associated station.
@@ -30,18 +36,20 @@ inline void LinkGraph::BaseNode::Init(TileIndex xy, StationID st, uint demand)
 	this->demand = demand;
 	this->station = st;
 	this->last_update = INVALID_DATE;
+	this->edges.Clear();
 }
 
 /**
  * Create an edge.
+ * @param dest_node Destination of the edge.
  */
-inline void LinkGraph::BaseEdge::Init()
+void LinkGraph::BaseEdge::Init(NodeID dest_node)
 {
 	this->capacity = 0;
 	this->usage = 0;
 	this->last_unrestricted_update = INVALID_DATE;
 	this->last_restricted_update = INVALID_DATE;
-	this->next_edge = INVALID_NODE;
+	this->dest_node = dest_node;
 }
 
 /**
@@ -52,11 +60,10 @@ inline void LinkGraph::BaseEdge::Init()
 void LinkGraph::ShiftDates(int interval)
 {
 	this->last_compression += interval;
-	for (NodeID node1 = 0; node1 < this->Size(); ++node1) {
-		BaseNode &source = this->nodes[node1];
+	for (BaseNode &source : this->nodes) {
 		if (source.last_update != INVALID_DATE) source.last_update += interval;
-		for (NodeID node2 = 0; node2 < this->Size(); ++node2) {
-			BaseEdge &edge = this->edges[node1][node2];
+		if (source.edges.Get().empty()) continue;
+		for (BaseEdge &edge : source.edges.GetMutable()) {
 			if (edge.last_unrestricted_update != INVALID_DATE) edge.last_unrestricted_update += interval;
 			if (edge.last_restricted_update != INVALID_DATE) edge.last_restricted_update += interval;
 		}
@@ -66,10 +73,10 @@ void LinkGraph::ShiftDates(int interval)
 void LinkGraph::Compress()
 {
 	this->last_compression = (_date + this->last_compression) / 2;
-	for (NodeID node1 = 0; node1 < this->Size(); ++node1) {
-		this->nodes[node1].supply /= 2;
-		for (NodeID node2 = 0; node2 < this->Size(); ++node2) {
-			BaseEdge &edge = this->edges[node1][node2];
+	for (BaseNode &node : this->nodes) {
+		node.supply /= 2;
+		if (node.edges.Get().empty()) continue;
+		for (BaseEdge &edge : node.edges.GetMutable()) {
 			if (edge.capacity > 0) {
 				edge.capacity = std::max(1U, edge.capacity / 2);
 				edge.usage /= 2;
@@ -87,27 +94,23 @@ void LinkGraph::Merge(LinkGraph *other)
 	Date age = _date - this->last_compression + 1;
 	Date other_age = _date - other->last_compression + 1;
 	NodeID first = this->Size();
+	this->nodes.reserve(first + other->Size());
 	for (NodeID node1 = 0; node1 < other->Size(); ++node1) {
 		Station *st = Station::Get(other->nodes[node1].station);
 		NodeID new_node = this->AddNode(st);
 		this->nodes[new_node].supply = LinkGraph::Scale(other->nodes[node1].supply, age, other_age);
 		st->goods[this->cargo].link_graph = this->index;
 		st->goods[this->cargo].node = new_node;
-		for (NodeID node2 = 0; node2 < node1; ++node2) {
-			BaseEdge &forward = this->edges[new_node][first + node2];
-			BaseEdge &backward = this->edges[first + node2][new_node];
-			forward = other->edges[node1][node2];
-			backward = other->edges[node2][node1];
-			forward.capacity = LinkGraph::Scale(forward.capacity, age, other_age);
-			forward.usage = LinkGraph::Scale(forward.usage, age, other_age);
-			if (forward.next_edge != INVALID_NODE) forward.next_edge += first;
-			backward.capacity = LinkGraph::Scale(backward.capacity, age, other_age);
-			backward.usage = LinkGraph::Scale(backward.usage, age, other_age);
-			if (backward.next_edge != INVALID_NODE) backward.next_edge += first;
+
+		/* All destinations are shifted by the same offset, so the edges stay sorted. */
+		if (other->nodes[node1].edges.Get().empty()) continue;
+		SharedEdgeVector &new_edges = this->nodes[new_node].edges;
+		new_edges = std::move(other->nodes[node1].edges);
+		for (BaseEdge &edge : new_edges.GetMutable()) {
+			edge.capacity = LinkGraph::Scale(edge.capacity, age, other_age);
+			edge.usage = LinkGraph::Scale(edge.usage, age, other_age);
+			edge.dest_node += first;
 		}
-		BaseEdge &new_start = this->edges[new_node][new_node];
-		new_start = other->edges[node1][node1];
-		if (new_start.next_edge != INVALID_NODE) new_start.next_edge += first;
 	}
 	delete other;
 }
@@ -123,35 +126,28 @@ void LinkGraph::RemoveNode(NodeID id)
 	NodeID last_node = this->Size() - 1;
 	for (NodeID i = 0; i <= last_node; ++i) {
 		(*this)[i].RemoveEdge(id);
-		BaseEdge *node_edges = this->edges[i];
-		NodeID prev = i;
-		NodeID next = node_edges[i].next_edge;
-		while (next != INVALID_NODE) {
-			if (next == last_node) {
-				node_edges[prev].next_edge = id;
-				break;
-			}
-			prev = next;
-			next = node_edges[prev].next_edge;
+		/* An edge towards the last node is always the last one of the list.
+		 * It has to be renumbered and moved to its new sorted position. */
+		const EdgeVector &shared_edges = this->nodes[i].edges.Get();
+		if (id != last_node && !shared_edges.empty() && shared_edges.back().dest_node == last_node) {
+			EdgeVector &node_edges = this->nodes[i].edges.GetMutable();
+			BaseEdge edge = node_edges.back();
+			node_edges.pop_back();
+			edge.dest_node = id;
+			node_edges.insert(std::lower_bound(node_edges.begin(), node_edges.end(), id,
+					[](const BaseEdge &edge, NodeID to) { return edge.dest_node < to; }), edge);
 		}
-		node_edges[id] = node_edges[last_node];
 	}
 	Station::Get(this->nodes[last_node].station)->goods[this->cargo].node = id;
 	/* Erase node by swapping with the last element. Node index is referenced
 	 * directly from station goods entries so the order and position must remain. */
-	this->nodes[id] = this->nodes.back();
+	if (id != last_node) this->nodes[id] = std::move(this->nodes.back());
 	this->nodes.pop_back();
-	this->edges.EraseColumn(id);
-	/* Not doing EraseRow here, as having the extra invalid row doesn't hurt
-	 * and removing it would trigger a lot of memmove. The data has already
-	 * been copied around in the loop above. */
 }
 
 /**
- * Add a node to the component and create empty edges associated with it. Set
- * the station's last_component to this component. Calculate the distances to all
- * other nodes. The distances to _all_ nodes are important as the demand
- * calculator relies on their availability.
+ * Add a node to the component. Set the station's last_component to this
+ * component. The new node doesn't have any edges yet.
  * @param st New node's station.
  * @return New node's ID.
  */
@@ -161,22 +157,10 @@ NodeID LinkGraph::AddNode(const Station *st)
 
 	NodeID new_node = this->Size();
 	this->nodes.emplace_back();
-	/* Avoid reducing the height of the matrix as that is expensive and we
-	 * most likely will increase it again later which is again expensive. */
-	this->edges.Resize(new_node + 1U, std::max(new_node + 1U, this->edges.Height()));
 
 	this->nodes[new_node].Init(st->xy, st->index,
 			HasBit(good.status, GoodsEntry::GES_ACCEPTANCE));
 
-	BaseEdge *new_edges = this->edges[new_node];
-
-	/* Reset the first edge starting at the new node */
-	new_edges[new_node].next_edge = INVALID_NODE;
-
-	for (NodeID i = 0; i <= new_node; ++i) {
-		new_edges[i].Init();
-		this->edges[i][new_node].Init();
-	}
 	return new_node;
 }
 
@@ -191,12 +175,14 @@ NodeID LinkGraph::AddNode(const Station *st)
 void LinkGraph::Node::AddEdge(NodeID to, uint capacity, uint usage, EdgeUpdateMode mode)
 {
 	assert(this->index != to);
-	BaseEdge &edge = this->edges[to];
-	BaseEdge &first = this->edges[this->index];
+	EdgeVector &edges = this->node.edges.GetMutable();
+	EdgeVector::iterator it = std::lower_bound(edges.begin(), edges.end(), to,
+			[](const BaseEdge &edge, NodeID to) { return edge.dest_node < to; });
+	assert(it == edges.end() || it->dest_node != to);
+	BaseEdge &edge = *edges.emplace(it);
+	edge.Init(to);
 	edge.capacity = capacity;
 	edge.usage = usage;
-	edge.next_edge = first.next_edge;
-	first.next_edge = to;
 	if (mode & EUM_UNRESTRICTED)  edge.last_unrestricted_update = _date;
 	if (mode & EUM_RESTRICTED) edge.last_restricted_update = _date;
 }
@@ -212,10 +198,11 @@ void LinkGraph::Node::UpdateEdge(NodeID to, uint capacity, uint usage, EdgeUpdat
 {
 	assert(capacity > 0);
 	assert(usage <= capacity);
-	if (this->edges[to].capacity == 0) {
+	BaseEdge *edge = this->FindMutableEdge(to);
+	if (edge == nullptr) {
 		this->AddEdge(to, capacity, usage, mode);
 	} else {
-		(*this)[to].Update(capacity, usage, mode);
+		Edge(*edge).Update(capacity, usage, mode);
 	}
 }
 
@@ -226,25 +213,11 @@ void LinkGraph::Node::UpdateEdge(NodeID to, uint capacity, uint usage, EdgeUpdat
 void LinkGraph::Node::RemoveEdge(NodeID to)
 {
 	if (this->index == to) return;
-	BaseEdge &edge = this->edges[to];
-	edge.capacity = 0;
-	edge.last_unrestricted_update = INVALID_DATE;
-	edge.last_restricted_update = INVALID_DATE;
-	edge.usage = 0;
-
-	NodeID prev = this->index;
-	NodeID next = this->edges[this->index].next_edge;
-	while (next != INVALID_NODE) {
-		if (next == to) {
-			/* Will be removed, skip it. */
-			this->edges[prev].next_edge = edge.next_edge;
-			edge.next_edge = INVALID_NODE;
-			break;
-		} else {
-			prev = next;
-			next = this->edges[next].next_edge;
-		}
-	}
+	const BaseEdge *edge = this->FindEdge(to);
+	if (edge == nullptr) return;
+	size_t offset = edge - this->node.edges.Get().data();
+	EdgeVector &edges = this->node.edges.GetMutable();
+	edges.erase(edges.begin() + offset);
 }
 
 /**
@@ -273,19 +246,16 @@ void LinkGraph::Edge::Update(uint capacity, uint usage, EdgeUpdateMode mode)
 }
 
 /**
- * Resize the component and fill it with empty nodes and edges. Used when
- * loading from save games. The component is expected to be empty before.
+ * Resize the component and fill it with empty nodes without any edges. Used
+ * when loading from save games. The component is expected to be empty before.
  * @param size New size of the component.
  */
 void LinkGraph::Init(uint size)
 {
 	assert(this->Size() == 0);
-	this->edges.Resize(size, size);
 	this->nodes.resize(size);
 
 	for (uint i = 0; i < size; ++i) {
 		this->nodes[i].Init();
-		BaseEdge *column = this->edges[i];
-		for (uint j = 0; j < size; ++j) column[j].Init();
 	}
 }
@@ -12,13 +12,15 @@
 
 #include "../core/pool_type.hpp"
 #include "../core/smallmap_type.hpp"
-#include "../core/smallmatrix_type.hpp"
 #include "../core/bitmath_func.hpp"
 #include "../station_base.h"
 #include "../cargotype.h"
 #include "../date_func.h"
 #include "linkgraph_type.h"
 #include <utility>
+#include <vector>
+#include <memory>
+#include <algorithm>
 
 struct SaveLoad;
 class LinkGraph;
@@ -40,6 +42,60 @@ extern LinkGraphPool _link_graph_pool;
 class LinkGraph : public LinkGraphPool::PoolItem<&_link_graph_pool> {
 public:
 
+	/**
+	 * An edge in the link graph. Corresponds to a link between two stations.
+	 * Only edges which actually exist are stored, in the edge list of their
+	 * source node.
+	 */
+	struct BaseEdge {
+		uint capacity;                 ///< Capacity of the link.
+		uint usage;                    ///< Usage of the link.
+		Date last_unrestricted_update; ///< When the unrestricted part of the link was last updated.
+		Date last_restricted_update;   ///< When the restricted part of the link was last updated.
+		NodeID dest_node;              ///< Destination of the edge.
+		void Init(NodeID dest_node = INVALID_NODE);
+	};
+
+	typedef std::vector<BaseEdge> EdgeVector;
+
+	/**
+	 * Outgoing edges of a node, shared between a link graph and the snapshots
+	 * taken of it for link graph jobs. The edges are only copied when they are
+	 * modified while a snapshot still refers to them. Snapshots are only taken
+	 * and released in the main thread, so the use count is reliable there.
+	 */
+	class SharedEdgeVector {
+		std::shared_ptr<EdgeVector> edges; ///< Actual edges, or nullptr if there are none.
+		static const EdgeVector empty;     ///< Returned if there are no edges.
+
+	public:
+		/**
+		 * Get the edges for reading.
+		 * @return Edges.
+		 */
+		const EdgeVector &Get() const { return this->edges != nullptr ? *this->edges : SharedEdgeVector::empty; }
+
+		/**
+		 * Get the edges for modification. This copies them if they are still
+		 * shared with a snapshot.
+		 * @return Edges which aren't shared with anyone else.
+		 */
+		EdgeVector &GetMutable()
+		{
+			if (this->edges == nullptr) {
+				this->edges = std::make_shared<EdgeVector>();
+			} else if (this->edges.use_count() > 1) {
+				this->edges = std::make_shared<EdgeVector>(*this->edges);
+			}
+			return *this->edges;
+		}
+
+		/**
+		 * Remove all edges.
+		 */
+		void Clear() { this->edges.reset(); }
+	};
+
 	/**
 	 * Node of the link graph. contains all relevant information from the associated
 	 * station. It's copied so that the link graph job can work on its own data set
@@ -51,24 +107,10 @@ public:
 		StationID station;       ///< Station ID.
 		TileIndex xy;            ///< Location of the station referred to by the node.
 		Date last_update;        ///< When the supply was last updated.
+		SharedEdgeVector edges;  ///< Outgoing edges, sorted by destination node.
 		void Init(TileIndex xy = INVALID_TILE, StationID st = INVALID_STATION, uint demand = 0);
 	};
 
-	/**
-	 * An edge in the link graph. Corresponds to a link between two stations or at
-	 * least the distance between them. Edges from one node to itself contain the
-	 * ID of the opposite Node of the first active edge (i.e. not just distance) in
-	 * the column as next_edge.
-	 */
-	struct BaseEdge {
-		uint capacity;                 ///< Capacity of the link.
-		uint usage;                    ///< Usage of the link.
-		Date last_unrestricted_update; ///< When the unrestricted part of the link was last updated.
-		Date last_restricted_update;   ///< When the restricted part of the link was last updated.
-		NodeID next_edge;              ///< Destination of next valid edge starting at the same source node.
-		void Init();
-	};
-
 	/**
 	 * Wrapper for an edge (const or not) allowing retrieval, but no modification.
 	 * @tparam Tedge Actual edge class, may be "const BaseEdge" or just "BaseEdge".
@@ -126,19 +168,29 @@ public:
 	class NodeWrapper {
 	protected:
 		Tnode &node;  ///< Node being wrapped.
-		Tedge *edges; ///< Outgoing edges for wrapped node.
 		NodeID index; ///< ID of wrapped node.
 
+		/**
+		 * Find the outgoing edge towards another node.
+		 * @param to ID of the destination node.
+		 * @return The edge or nullptr if there is no edge towards "to".
+		 */
+		const BaseEdge *FindEdge(NodeID to) const
+		{
+			const EdgeVector &edges = this->node.edges.Get();
+			auto it = std::lower_bound(edges.begin(), edges.end(), to,
+					[](const BaseEdge &edge, NodeID to) { return edge.dest_node < to; });
+			return (it != edges.end() && it->dest_node == to) ? &*it : nullptr;
+		}
+
 	public:
 
 		/**
 		 * Wrap a node.
 		 * @param node Node to be wrapped.
-		 * @param edges Outgoing edges for node to be wrapped.
 		 * @param index ID of node to be wrapped.
 		 */
-		NodeWrapper(Tnode &node, Tedge *edges, NodeID index) : node(node),
-			edges(edges), index(index) {}
+		NodeWrapper(Tnode &node, NodeID index) : node(node), index(index) {}
 
 		/**
 		 * Get supply of wrapped node.
@@ -169,20 +221,32 @@ public:
 		 * @return Location of the station.
 		 */
 		TileIndex XY() const { return this->node.xy; }
+
+		/**
+		 * Check if there is an edge from this node to another one.
+		 * @param to ID of the destination node.
+		 * @return If the edge exists.
+		 */
+		bool HasEdgeTo(NodeID to) const { return this->FindEdge(to) != nullptr; }
+
+		/**
+		 * Get the number of outgoing edges of the node.
+		 * @return Number of edges.
+		 */
+		uint EdgeCount() const { return (uint)this->node.edges.Get().size(); }
 	};
 
 	/**
-	 * Base class for iterating across outgoing edges of a node. Only the real
-	 * edges (those with capacity) are iterated. The ones with only distance
-	 * information are skipped.
+	 * Base class for iterating across outgoing edges of a node. The edges are
+	 * iterated in order of their destination nodes.
 	 * @tparam Tedge Actual edge class. May be "BaseEdge" or "const BaseEdge".
 	 * @tparam Titer Actual iterator class.
 	 */
 	template <class Tedge, class Tedge_wrapper, class Titer>
 	class BaseEdgeIterator {
 	protected:
-		Tedge *base;    ///< Array of edges being iterated.
-		NodeID current; ///< Current offset in edges array.
+		Tedge *base;  ///< Array of edges being iterated.
+		uint current; ///< Current offset in edges array.
 
 		/**
 		 * A "fake" pointer to enable operator-> on temporaries. As the objects
@@ -210,11 +274,11 @@ public:
 		/**
 		 * Constructor.
 		 * @param base Array of edges to be iterated.
-		 * @param current ID of current node (to locate the first edge).
+		 * @param current Offset of the current edge in the array.
 		 */
-		BaseEdgeIterator (Tedge *base, NodeID current) :
+		BaseEdgeIterator (Tedge *base, uint current) :
 			base(base),
-			current(current == INVALID_NODE ? current : base[current].next_edge)
+			current(current)
 		{}
 
 		/**
@@ -223,7 +287,7 @@ public:
 		 */
 		Titer &operator++()
 		{
-			this->current = this->base[this->current].next_edge;
+			++this->current;
 			return static_cast<Titer &>(*this);
 		}
 
@@ -234,7 +298,7 @@ public:
 		Titer operator++(int)
 		{
 			Titer ret(static_cast<Titer &>(*this));
-			this->current = this->base[this->current].next_edge;
+			++this->current;
 			return ret;
 		}
 
@@ -243,7 +307,7 @@ public:
 		 * child class.
 		 * @tparam Tother Class of other iterator.
 		 * @param other Instance of other iterator.
-		 * @return If the iterators have the same edge array and current node.
+		 * @return If the iterators have the same edge array and current offset.
 		 */
 		template<class Tother>
 		bool operator==(const Tother &other)
@@ -256,7 +320,7 @@ public:
 		 * may be of a child class.
 		 * @tparam Tother Class of other iterator.
 		 * @param other Instance of other iterator.
-		 * @return If either the edge arrays or the current nodes differ.
+		 * @return If either the edge arrays or the current offsets differ.
 		 */
 		template<class Tother>
 		bool operator!=(const Tother &other)
@@ -270,7 +334,7 @@ public:
 		 */
 		std::pair<NodeID, Tedge_wrapper> operator*() const
 		{
-			return std::pair<NodeID, Tedge_wrapper>(this->current, Tedge_wrapper(this->base[this->current]));
+			return std::pair<NodeID, Tedge_wrapper>(this->base[this->current].dest_node, Tedge_wrapper(this->base[this->current]));
 		}
 
 		/**
@@ -311,9 +375,9 @@ public:
 		/**
 		 * Constructor.
 		 * @param edges Array of edges to be iterated over.
-		 * @param current ID of current edge's end node.
+		 * @param current Offset of the current edge in the array.
 		 */
-		ConstEdgeIterator(const BaseEdge *edges, NodeID current) :
+		ConstEdgeIterator(const BaseEdge *edges, uint current) :
 			BaseEdgeIterator<const BaseEdge, ConstEdge, ConstEdgeIterator>(edges, current) {}
 	};
 
@@ -326,9 +390,9 @@ public:
 		/**
 		 * Constructor.
 		 * @param edges Array of edges to be iterated over.
-		 * @param current ID of current edge's end node.
+		 * @param current Offset of the current edge in the array.
 		 */
-		EdgeIterator(BaseEdge *edges, NodeID current) :
+		EdgeIterator(BaseEdge *edges, uint current) :
 			BaseEdgeIterator<BaseEdge, Edge, EdgeIterator>(edges, current) {}
 	};
 
@@ -344,28 +408,33 @@ public:
 		 * @param node ID of the node.
 		 */
 		ConstNode(const LinkGraph *lg, NodeID node) :
-			NodeWrapper<const BaseNode, const BaseEdge>(lg->nodes[node], lg->edges[node], node)
+			NodeWrapper<const BaseNode, const BaseEdge>(lg->nodes[node], node)
 		{}
 
 		/**
 		 * Get a ConstEdge. This is not a reference as the wrapper objects are
-		 * not actually persistent.
+		 * not actually persistent. If there is no edge towards the given node
+		 * an empty edge without capacity is returned.
 		 * @param to ID of end node of edge.
 		 * @return Constant edge wrapper.
 		 */
-		ConstEdge operator[](NodeID to) const { return ConstEdge(this->edges[to]); }
+		ConstEdge operator[](NodeID to) const
+		{
+			const BaseEdge *edge = this->FindEdge(to);
+			return ConstEdge(edge != nullptr ? *edge : LinkGraph::empty_edge);
+		}
 
 		/**
 		 * Get an iterator pointing to the start of the edges array.
 		 * @return Constant edge iterator.
 		 */
-		ConstEdgeIterator Begin() const { return ConstEdgeIterator(this->edges, this->index); }
+		ConstEdgeIterator Begin() const { return ConstEdgeIterator(this->node.edges.Get().data(), 0); }
 
 		/**
 		 * Get an iterator pointing beyond the end of the edges array.
 		 * @return Constant edge iterator.
 		 */
-		ConstEdgeIterator End() const { return ConstEdgeIterator(this->edges, INVALID_NODE); }
+		ConstEdgeIterator End() const { return ConstEdgeIterator(this->node.edges.Get().data(), this->EdgeCount()); }
 	};
 
 	/**
@@ -379,28 +448,46 @@ public:
 		 * @param node ID of the node.
 		 */
 		Node(LinkGraph *lg, NodeID node) :
-			NodeWrapper<BaseNode, BaseEdge>(lg->nodes[node], lg->edges[node], node)
+			NodeWrapper<BaseNode, BaseEdge>(lg->nodes[node], node)
 		{}
 
 		/**
 		 * Get an Edge. This is not a reference as the wrapper objects are not
-		 * actually persistent.
+		 * actually persistent. The edge has to exist.
 		 * @param to ID of end node of edge.
 		 * @return Edge wrapper.
 		 */
-		Edge operator[](NodeID to) { return Edge(this->edges[to]); }
+		Edge operator[](NodeID to)
+		{
+			BaseEdge *edge = this->FindMutableEdge(to);
+			assert(edge != nullptr);
+			return Edge(*edge);
+		}
 
 		/**
 		 * Get an iterator pointing to the start of the edges array.
 		 * @return Edge iterator.
 		 */
-		EdgeIterator Begin() { return EdgeIterator(this->edges, this->index); }
+		EdgeIterator Begin() { return EdgeIterator(this->node.edges.GetMutable().data(), 0); }
 
 		/**
 		 * Get an iterator pointing beyond the end of the edges array.
 		 * @return Constant edge iterator.
 		 */
-		EdgeIterator End() { return EdgeIterator(this->edges, INVALID_NODE); }
+		EdgeIterator End() { return EdgeIterator(this->node.edges.GetMutable().data(), this->EdgeCount()); }
+
+		/**
+		 * Find the outgoing edge towards another node for modification.
+		 * @param to ID of the destination node.
+		 * @return The edge or nullptr if there is no edge towards "to".
+		 */
+		BaseEdge *FindMutableEdge(NodeID to)
+		{
+			const BaseEdge *edge = this->FindEdge(to);
+			if (edge == nullptr) return nullptr;
+			size_t offset = edge - this->node.edges.Get().data();
+			return &this->node.edges.GetMutable()[offset];
+		}
 
 		/**
 		 * Update the node's supply and set last_update to the current date.
@@ -436,7 +523,41 @@ public:
 	};
 
 	typedef std::vector<BaseNode> NodeVector;
-	typedef SmallMatrix<BaseEdge> EdgeMatrix;
+
+	/**
+	 * Demands calculated by a link graph job, so that the next job only has
+	 * to recalculate the demands of nodes which changed significantly. Once
+	 * created it isn't modified anymore and can be shared between a link
+	 * graph and the jobs copied from it.
+	 */
+	struct DemandCache {
+		/** Demand from a node towards another one. */
+		struct Demand {
+			NodeID dest; ///< Node the demand is directed to.
+			uint demand; ///< Transport demand between the nodes.
+		};
+
+		/** State of a node at the time its demands were calculated. */
+		struct CachedNode {
+			StationID station;           ///< Station of the node.
+			TileIndex xy;                ///< Location of the station.
+			uint supply;                 ///< Supply of the node.
+			bool accepting;              ///< If the node accepted the cargo.
+			NodeID component;            ///< Lowest node ID in the connected component of the node.
+			std::vector<Demand> demands; ///< Demands towards other nodes, sorted by destination.
+		};
+
+		std::vector<CachedNode> nodes; ///< Nodes of the link graph, indexed by node ID.
+		Date supply_age;               ///< Number of days the supplies have been collected over.
+		uint16 incremental_runs;       ///< Number of incremental calculations since the last full one.
+		uint8 distribution_type;       ///< Distribution type used for the calculation.
+		uint8 accuracy;                ///< Accuracy used for the calculation.
+		uint8 demand_size;             ///< Demand size setting used for the calculation.
+		uint8 demand_distance;         ///< Demand distance setting used for the calculation.
+	};
+
+	/** Edge returned when looking up a link which doesn't exist. */
+	static const BaseEdge empty_edge;
 
 	/** Minimum effective distance for timeout calculation. */
 	static const uint MIN_TIMEOUT_DISTANCE = 32;
@@ -523,6 +644,18 @@ public:
 	NodeID AddNode(const Station *st);
 	void RemoveNode(NodeID id);
 
+	/**
+	 * Get the demands calculated by the last finished job for this link graph.
+	 * @return Demand cache or nullptr if there is none.
+	 */
+	inline const DemandCache *GetDemandCache() const { return this->demand_cache.get(); }
+
+	/**
+	 * Set the demands calculated by a job for this link graph.
+	 * @param cache New demand cache.
+	 */
+	inline void SetDemandCache(std::shared_ptr<const DemandCache> cache) { this->demand_cache = std::move(cache); }
+
 	inline uint64 CalculateCostEstimate() const {
 		uint64 size_squared = this->Size() * this->Size();
 		return size_squared * FindLastBit(size_squared * size_squared); // N^2 * 4log_2(N)
@@ -538,8 +671,8 @@ protected:
 
 	CargoID cargo;         ///< Cargo of this component's link graph.
 	Date last_compression; ///< Last time the capacities and supplies were compressed.
-	NodeVector nodes;      ///< Nodes in the component.
-	EdgeMatrix edges;      ///< Edges in the component.
+	NodeVector nodes;      ///< Nodes in the component, each with its outgoing edges.
+	std::shared_ptr<const DemandCache> demand_cache; ///< Demands calculated by the last finished job.
 };
 
 #endif /* LINKGRAPH_H */
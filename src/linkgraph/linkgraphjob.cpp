@@ -103,6 +103,8 @@ void LinkGraphJob::FinaliseJob()
 	/* Link graph has been merged into another one. */
 	if (!LinkGraph::IsValidID(this->link_graph.index)) return;
 
+	LinkGraph::Get(this->link_graph.index)->SetDemandCache(std::move(this->demand_cache));
+
 	uint size = this->Size();
 	for (NodeID node_id = 0; node_id < size; ++node_id) {
 		Node from = (*this)[node_id];
@@ -122,11 +124,11 @@ void LinkGraphJob::FinaliseJob()
 			continue;
 		}
 
-		LinkGraph *lg = LinkGraph::Get(ge.link_graph);
+		const LinkGraph *lg = LinkGraph::Get(ge.link_graph);
 		FlowStatMap &flows = from.Flows();
 
 		for (EdgeIterator it(from.Begin()); it != from.End(); ++it) {
-			if (from[it->first].Flow() == 0) continue;
+			if (it->second.Flow() == 0) continue;
 			StationID to = (*this)[it->first].Station();
 			Station *st2 = Station::GetIfValid(to);
 			if (st2 == nullptr || st2->goods[this->Cargo()].link_graph != this->link_graph.index ||
@@ -189,13 +191,8 @@ void LinkGraphJob::Init()
 {
 	uint size = this->Size();
 	this->nodes.resize(size);
-	this->edges.Resize(size, size);
 	for (uint i = 0; i < size; ++i) {
-		this->nodes[i].Init(this->link_graph[i].Supply());
-		EdgeAnnotation *node_edges = this->edges[i];
-		for (uint j = 0; j < size; ++j) {
-			node_edges[j].Init();
-		}
+		this->nodes[i].Init(this->link_graph[i].Supply(), this->link_graph[i].EdgeCount());
 	}
 }
 
@@ -204,20 +201,34 @@ void LinkGraphJob::Init()
  */
 void LinkGraphJob::EdgeAnnotation::Init()
 {
-	this->demand = 0;
 	this->flow = 0;
-	this->unsatisfied_demand = 0;
 }
 
 /**
  * Initialize a Linkgraph job node. The underlying memory is expected to be
  * freshly allocated, without any constructors having been called.
  * @param supply Initial undelivered supply.
+ * @param num_edges Number of outgoing edges of the node.
  */
-void LinkGraphJob::NodeAnnotation::Init(uint supply)
+void LinkGraphJob::NodeAnnotation::Init(uint supply, uint num_edges)
 {
 	this->undelivered_supply = supply;
 	this->received_demand = 0;
+	this->edges.resize(num_edges);
+	for (EdgeAnnotation &edge : this->edges) edge.Init();
+}
+
+/**
+ * Get the demand towards another node, creating an empty one if there is none yet.
+ * @param to Destination of the demand.
+ * @return Demand annotation for the given destination.
+ */
+LinkGraphJob::DemandAnnotation &LinkGraphJob::NodeAnnotation::GetDemand(NodeID to)
+{
+	DemandAnnotationVector::iterator it = std::lower_bound(this->demands.begin(), this->demands.end(), to,
+			[](const DemandAnnotation &demand, NodeID to) { return demand.dest < to; });
+	if (it == this->demands.end() || it->dest != to) it = this->demands.insert(it, { to, 0, 0 });
+	return *it;
 }
 
 /**
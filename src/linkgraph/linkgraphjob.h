@@ -31,13 +31,34 @@ extern LinkGraphJobPool _link_graph_job_pool;
  * Class for calculation jobs to be run on link graphs.
  */
 class LinkGraphJob : public LinkGraphJobPool::PoolItem<&_link_graph_job_pool>{
+public:
+	/**
+	 * Transport demand from a node towards another one. Demands are kept apart
+	 * from the edges as they also exist between nodes which aren't adjacent.
+	 */
+	struct DemandAnnotation {
+		NodeID dest;             ///< Node the demand is directed to.
+		uint demand;             ///< Transport demand between the nodes.
+		uint unsatisfied_demand; ///< Demand that hasn't been satisfied by flows yet.
+
+		/**
+		 * Satisfy some demand.
+		 * @param amount Demand to be satisfied.
+		 */
+		void SatisfyDemand(uint amount)
+		{
+			assert(amount <= this->unsatisfied_demand);
+			this->unsatisfied_demand -= amount;
+		}
+	};
+
+	typedef std::vector<DemandAnnotation> DemandAnnotationVector;
+
 private:
 	/**
 	 * Annotation for a link graph edge.
 	 */
 	struct EdgeAnnotation {
-		uint demand;             ///< Transport demand between the nodes.
-		uint unsatisfied_demand; ///< Demand over this edge that hasn't been satisfied yet.
 		uint flow;               ///< Planned flow over this edge.
 		void Init();
 	};
@@ -46,15 +67,17 @@ private:
 	 * Annotation for a link graph node.
 	 */
 	struct NodeAnnotation {
-		uint undelivered_supply; ///< Amount of supply that hasn't been distributed yet.
-		uint received_demand;    ///< Received demand towards this node.
-		PathList paths;          ///< Paths through this node, sorted so that those with flow == 0 are in the back.
-		FlowStatMap flows;       ///< Planned flows to other nodes.
-		void Init(uint supply);
+		uint undelivered_supply;           ///< Amount of supply that hasn't been distributed yet.
+		uint received_demand;              ///< Received demand towards this node.
+		PathList paths;                    ///< Paths through this node, sorted so that those with flow == 0 are in the back.
+		FlowStatMap flows;                 ///< Planned flows to other nodes.
+		std::vector<EdgeAnnotation> edges; ///< Annotations for the outgoing edges, in the same order as the edges of the link graph node.
+		DemandAnnotationVector demands;    ///< Demands towards other nodes, sorted by destination.
+		void Init(uint supply, uint num_edges);
+		DemandAnnotation &GetDemand(NodeID to);
 	};
 
 	typedef std::vector<NodeAnnotation> NodeAnnotationVector;
-	typedef SmallMatrix<EdgeAnnotation> EdgeAnnotationMatrix;
 
 	friend const SaveLoad *GetLinkGraphJobDesc();
 	friend void GetLinkGraphJobDayLengthScaleAfterLoad(LinkGraphJob *lgj);
@@ -67,8 +90,8 @@ protected:
 	const LinkGraphSettings settings; ///< Copy of _settings_game.linkgraph at spawn time.
 	DateTicks join_date_ticks;        ///< Date when the job is to be joined.
 	DateTicks start_date_ticks;       ///< Date when the job was started.
-	NodeAnnotationVector nodes;       ///< Extra node data necessary for link graph calculation.
-	EdgeAnnotationMatrix edges;       ///< Extra edge data necessary for link graph calculation.
+	NodeAnnotationVector nodes;       ///< Extra node and edge data necessary for link graph calculation.
+	std::shared_ptr<const LinkGraph::DemandCache> demand_cache; ///< Demands calculated by this job, to be stored in the link graph when joining.
 	std::atomic<bool> job_completed;  ///< Is the job still running. This is accessed by multiple threads and reads may be stale.
 	std::atomic<bool> job_aborted;    ///< Has the job been aborted. This is accessed by multiple threads and reads may be stale.
 
@@ -96,18 +119,6 @@ public:
 		Edge(const LinkGraph::BaseEdge &edge, EdgeAnnotation &anno) :
 				LinkGraph::ConstEdge(edge), anno(anno) {}
 
-		/**
-		 * Get the transport demand between end the points of the edge.
-		 * @return Demand.
-		 */
-		uint Demand() const { return this->anno.demand; }
-
-		/**
-		 * Get the transport demand that hasn't been satisfied by flows, yet.
-		 * @return Unsatisfied demand.
-		 */
-		uint UnsatisfiedDemand() const { return this->anno.unsatisfied_demand; }
-
 		/**
 		 * Get the total flow on the edge.
 		 * @return Flow.
@@ -129,26 +140,6 @@ public:
 			assert(flow <= this->anno.flow);
 			this->anno.flow -= flow;
 		}
-
-		/**
-		 * Add some (not yet satisfied) demand.
-		 * @param demand Demand to be added.
-		 */
-		void AddDemand(uint demand)
-		{
-			this->anno.demand += demand;
-			this->anno.unsatisfied_demand += demand;
-		}
-
-		/**
-		 * Satisfy some demand.
-		 * @param demand Demand to be satisfied.
-		 */
-		void SatisfyDemand(uint demand)
-		{
-			assert(demand <= this->anno.unsatisfied_demand);
-			this->anno.unsatisfied_demand -= demand;
-		}
 	};
 
 	/**
@@ -163,7 +154,7 @@ public:
 		 * @param base_anno Array of annotations to be iterated.
 		 * @param current Start offset of iteration.
 		 */
-		EdgeIterator(const LinkGraph::BaseEdge *base, EdgeAnnotation *base_anno, NodeID current) :
+		EdgeIterator(const LinkGraph::BaseEdge *base, EdgeAnnotation *base_anno, uint current) :
 				LinkGraph::BaseEdgeIterator<const LinkGraph::BaseEdge, Edge, EdgeIterator>(base, current),
 				base_anno(base_anno) {}
 
@@ -174,7 +165,7 @@ public:
 		 */
 		std::pair<NodeID, Edge> operator*() const
 		{
-			return std::pair<NodeID, Edge>(this->current, Edge(this->base[this->current], this->base_anno[this->current]));
+			return std::pair<NodeID, Edge>(this->base[this->current].dest_node, Edge(this->base[this->current], this->base_anno[this->current]));
 		}
 
 		/**
@@ -204,30 +195,46 @@ public:
 		 */
 		Node (LinkGraphJob *lgj, NodeID node) :
 			LinkGraph::ConstNode(&lgj->link_graph, node),
-			node_anno(lgj->nodes[node]), edge_annos(lgj->edges[node])
+			node_anno(lgj->nodes[node]), edge_annos(lgj->nodes[node].edges.data())
 		{}
 
 		/**
 		 * Retrieve an edge starting at this node. Mind that this returns an
-		 * object, not a reference.
+		 * object, not a reference. The edge has to exist.
 		 * @param to Remote end of the edge.
 		 * @return Edge between this node and "to".
 		 */
-		Edge operator[](NodeID to) const { return Edge(this->edges[to], this->edge_annos[to]); }
+		Edge operator[](NodeID to) const
+		{
+			const LinkGraph::BaseEdge *edge = this->FindEdge(to);
+			assert(edge != nullptr);
+			return Edge(*edge, this->edge_annos[edge - this->node.edges.Get().data()]);
+		}
 
 		/**
-		 * Iterator for the "begin" of the edge array. Only edges with capacity
-		 * are iterated. The others are skipped.
+		 * Iterator for the "begin" of the edge array.
 		 * @return Iterator pointing to the first edge.
 		 */
-		EdgeIterator Begin() const { return EdgeIterator(this->edges, this->edge_annos, index); }
+		EdgeIterator Begin() const { return EdgeIterator(this->node.edges.Get().data(), this->edge_annos, 0); }
 
 		/**
-		 * Iterator for the "end" of the edge array. Only edges with capacity
-		 * are iterated. The others are skipped.
+		 * Iterator for the "end" of the edge array.
 		 * @return Iterator pointing beyond the last edge.
 		 */
-		EdgeIterator End() const { return EdgeIterator(this->edges, this->edge_annos, INVALID_NODE); }
+		EdgeIterator End() const { return EdgeIterator(this->node.edges.Get().data(), this->edge_annos, this->EdgeCount()); }
+
+		/**
+		 * Get the demands from this node towards other nodes, sorted by
+		 * destination. Only pairs of nodes with demand are included.
+		 * @return Demands.
+		 */
+		DemandAnnotationVector &Demands() { return this->node_anno.demands; }
+
+		/**
+		 * Get a constant version of the demands from this node.
+		 * @return Demands.
+		 */
+		const DemandAnnotationVector &Demands() const { return this->node_anno.demands; }
 
 		/**
 		 * Get amount of supply that hasn't been delivered, yet.
@@ -267,14 +274,17 @@ public:
 		const PathList &Paths() const { return this->node_anno.paths; }
 
 		/**
-		 * Deliver some supply, adding demand to the respective edge.
+		 * Deliver some supply, adding demand towards the destination.
 		 * @param to Destination for supply.
 		 * @param amount Amount of supply to be delivered.
 		 */
 		void DeliverSupply(NodeID to, uint amount)
 		{
+			if (amount == 0) return;
 			this->node_anno.undelivered_supply -= amount;
-			(*this)[to].AddDemand(amount);
+			DemandAnnotation &demand = this->node_anno.GetDemand(to);
+			demand.demand += amount;
+			demand.unsatisfied_demand += amount;
 		}
 
 		/**
@@ -384,6 +394,18 @@ public:
 	 */
 	inline LinkGraphID LinkGraphIndex() const { return this->link_graph.index; }
 
+	/**
+	 * Get the demands calculated by the previous job for the underlying link graph.
+	 * @return Demand cache or nullptr if there is none.
+	 */
+	inline const LinkGraph::DemandCache *PreviousDemands() const { return this->link_graph.GetDemandCache(); }
+
+	/**
+	 * Set the demands calculated by this job.
+	 * @param cache Demand cache to be stored in the link graph when the job is finalised.
+	 */
+	inline void SetDemandCache(std::shared_ptr<const LinkGraph::DemandCache> cache) { this->demand_cache = std::move(cache); }
+
 	/**
 	 * Get a reference to the underlying link graph. Only use this for save/load.
 	 * @return Link graph.
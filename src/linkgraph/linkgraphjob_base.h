@@ -16,6 +16,7 @@
 
 typedef LinkGraphJob::Node Node;
 typedef LinkGraphJob::Edge Edge;
+typedef LinkGraphJob::DemandAnnotation DemandAnnotation;
 typedef LinkGraphJob::EdgeIterator EdgeIterator;
 
 #endif /* LINKGRAPHJOB_BASE_H */
@@ -77,6 +77,18 @@ public:
 	 * @param lg Link graph to be removed.
 	 */
 	void Unqueue(LinkGraph *lg) { this->schedule.remove(lg); }
+
+	/**
+	 * Get the number of link graphs waiting for a job to be spawned.
+	 * @return Size of the queue.
+	 */
+	size_t GetQueueSize() const { return this->schedule.size(); }
+
+	/**
+	 * Get the jobs which are currently running.
+	 * @return The running jobs, in the order they will be joined.
+	 */
+	const JobList &GetRunningJobs() const { return this->running; }
 };
 
 class LinkGraphJobGroup : public std::enable_shared_from_this<LinkGraphJobGroup> {
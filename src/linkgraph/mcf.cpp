@@ -106,8 +106,7 @@ public:
 };
 
 /**
- * Iterator class for getting the edges in the order of their next_edge
- * members.
+ * Iterator class for getting the outgoing edges of a node from the link graph.
  */
 class GraphEdgeIterator {
 private:
@@ -122,7 +121,7 @@ public:
 	 * @param job Job to iterate on.
 	 */
 	GraphEdgeIterator(LinkGraphJob &job) : job(job),
-		i(nullptr, nullptr, INVALID_NODE), end(nullptr, nullptr, INVALID_NODE)
+		i(nullptr, nullptr, 0), end(nullptr, nullptr, 0)
 	{}
 
 	/**
@@ -351,20 +350,20 @@ void MultiCommodityFlow::CleanupPaths(NodeID source_id, PathVector &paths)
 
 /**
  * Push flow along a path and update the unsatisfied_demand of the associated
- * edge.
- * @param edge Edge whose ends the path connects.
+ * demand.
+ * @param demand Demand between the ends of the path.
  * @param path End of the path the flow should be pushed on.
  * @param accuracy Accuracy of the calculation.
  * @param max_saturation If < UINT_MAX only push flow up to the given
  *                       saturation, otherwise the path can be "overloaded".
  */
-uint MultiCommodityFlow::PushFlow(Edge &edge, Path *path, uint accuracy,
+uint MultiCommodityFlow::PushFlow(DemandAnnotation &demand, Path *path, uint accuracy,
 		uint max_saturation)
 {
-	assert(edge.UnsatisfiedDemand() > 0);
-	uint flow = Clamp(edge.Demand() / accuracy, 1, edge.UnsatisfiedDemand());
+	assert(demand.unsatisfied_demand > 0);
+	uint flow = Clamp(demand.demand / accuracy, 1, demand.unsatisfied_demand);
 	flow = path->AddFlow(flow, this->job, max_saturation);
-	edge.SatisfyDemand(flow);
+	demand.SatisfyDemand(flow);
 	return flow;
 }
 
@@ -534,24 +533,23 @@ MCF1stPass::MCF1stPass(LinkGraphJob &job) : MultiCommodityFlow(job)
 			this->Dijkstra<DistanceAnnotation, GraphEdgeIterator>(source, paths);
 
 			bool source_demand_left = false;
-			for (NodeID dest = 0; dest < size; ++dest) {
-				Edge edge = job[source][dest];
-				if (edge.UnsatisfiedDemand() > 0) {
-					Path *path = paths[dest];
+			for (DemandAnnotation &demand : job[source].Demands()) {
+				if (demand.unsatisfied_demand > 0) {
+					Path *path = paths[demand.dest];
 					assert(path != nullptr);
 					/* Generally only allow paths that don't exceed the
 					 * available capacity. But if no demand has been assigned
 					 * yet, make an exception and allow any valid path *once*. */
-					if (path->GetFreeCapacity() > 0 && this->PushFlow(edge, path,
+					if (path->GetFreeCapacity() > 0 && this->PushFlow(demand, path,
 							accuracy, this->max_saturation) > 0) {
 						/* If a path has been found there is a chance we can
 						 * find more. */
-						more_loops = more_loops || (edge.UnsatisfiedDemand() > 0);
-					} else if (edge.UnsatisfiedDemand() == edge.Demand() &&
+						more_loops = more_loops || (demand.unsatisfied_demand > 0);
+					} else if (demand.unsatisfied_demand == demand.demand &&
 							path->GetFreeCapacity() > INT_MIN) {
-						this->PushFlow(edge, path, accuracy, UINT_MAX);
+						this->PushFlow(demand, path, accuracy, UINT_MAX);
 					}
-					if (edge.UnsatisfiedDemand() > 0) source_demand_left = true;
+					if (demand.unsatisfied_demand > 0) source_demand_left = true;
 				}
 			}
 			if (!source_demand_left) finished_sources[source] = true;
@@ -581,12 +579,11 @@ MCF2ndPass::MCF2ndPass(LinkGraphJob &job) : MultiCommodityFlow(job)
 			this->Dijkstra<CapacityAnnotation, FlowEdgeIterator>(source, paths);
 
 			bool source_demand_left = false;
-			for (NodeID dest = 0; dest < size; ++dest) {
-				Edge edge = this->job[source][dest];
-				Path *path = paths[dest];
-				if (edge.UnsatisfiedDemand() > 0 && path->GetFreeCapacity() > INT_MIN) {
-					this->PushFlow(edge, path, accuracy, UINT_MAX);
-					if (edge.UnsatisfiedDemand() > 0) {
+			for (DemandAnnotation &demand : this->job[source].Demands()) {
+				Path *path = paths[demand.dest];
+				if (demand.unsatisfied_demand > 0 && path->GetFreeCapacity() > INT_MIN) {
+					this->PushFlow(demand, path, accuracy, UINT_MAX);
+					if (demand.unsatisfied_demand > 0) {
 						demand_left = true;
 						source_demand_left = true;
 					}
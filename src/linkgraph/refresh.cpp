@@ -31,6 +31,53 @@
 
 	CargoTypes have_cargo_mask = v->GetLastLoadingStationValidCargoMask();
 
+	/* Look for a plan made for the same situation by a vehicle sharing the orders. */
+	std::shared_ptr<LinkRefreshPlanCache> &cache = v->orders.list->link_refresh_cache;
+	if (cache != nullptr) {
+		for (const LinkRefreshPlanCache::Entry &entry : cache->entries) {
+			if (entry.cargo_mask != cargo_mask || entry.have_cargo_mask != have_cargo_mask || entry.order_index != v->cur_implicit_order_index) continue;
+
+			auto part = entry.consist.begin();
+			const Vehicle *u = v;
+			for (; u != nullptr && part != entry.consist.end(); u = u->Next(), ++part) {
+				if (part->cargo != u->cargo_type || part->capacity != u->cargo_cap || part->remaining != u->refit_cap) break;
+			}
+			if (u != nullptr || part != entry.consist.end()) continue;
+
+			LinkRefresher::ExecutePlan(v, entry.plan, allow_merge, is_full_loading);
+			return;
+		}
+	}
+
+	RefreshPlan plan;
+	LinkRefresher::PlanRefresh(v, cargo_mask, have_cargo_mask, &plan);
+	LinkRefresher::ExecutePlan(v, plan, allow_merge, is_full_loading);
+
+	/* Capacities after refits depend on the individual vehicle, so those plans can't be shared. */
+	if (plan.has_refit) return;
+
+	if (cache == nullptr) cache = std::make_shared<LinkRefreshPlanCache>();
+	if (cache->entries.size() >= LinkRefreshPlanCache::MAX_ENTRIES) cache->entries.erase(cache->entries.begin());
+	cache->entries.emplace_back();
+	LinkRefreshPlanCache::Entry &entry = cache->entries.back();
+	entry.cargo_mask = cargo_mask;
+	entry.have_cargo_mask = have_cargo_mask;
+	entry.order_index = v->cur_implicit_order_index;
+	for (const Vehicle *u = v; u != nullptr; u = u->Next()) {
+		entry.consist.push_back({ u->cargo_type, u->cargo_cap, u->refit_cap });
+	}
+	entry.plan = std::move(plan);
+}
+
+/**
+ * Predict the links the given vehicle will visit, without refreshing them yet.
+ * @param v Vehicle to predict the links for.
+ * @param cargo_mask Mask of cargoes to refresh.
+ * @param have_cargo_mask Mask of cargoes the vehicle could load at the last loading station.
+ * @param plan Plan to add the links to.
+ */
+/* static */ void LinkRefresher::PlanRefresh(Vehicle *v, CargoTypes cargo_mask, CargoTypes have_cargo_mask, RefreshPlan *plan)
+{
 	/* Scan orders for cargo-specific load/unload, and run LinkRefresher separately for each set of cargoes where they differ. */
 	while (cargo_mask != 0) {
 		CargoTypes iter_cargo_mask = cargo_mask;
@@ -53,7 +100,7 @@
 		const Order *first = v->orders.list->GetNextDecisionNode(v->GetOrder(v->cur_implicit_order_index), 0, iter_cargo_mask);
 		if (first != nullptr) {
 			HopSet seen_hops;
-			LinkRefresher refresher(v, &seen_hops, allow_merge, is_full_loading, iter_cargo_mask);
+			LinkRefresher refresher(v, &seen_hops, plan, iter_cargo_mask);
 
 			refresher.RefreshLinks(first, first, (iter_cargo_mask & have_cargo_mask) ? 1 << HAS_CARGO : 0);
 		}
@@ -62,6 +109,51 @@
 	}
 }
 
+/**
+ * Refresh the links of a plan.
+ * @param v Vehicle refreshing the links.
+ * @param plan Links to be refreshed.
+ * @param allow_merge If the refresher is allowed to merge or extend link graphs.
+ * @param is_full_loading If the vehicle is full loading.
+ */
+/* static */ void LinkRefresher::ExecutePlan(Vehicle *v, const RefreshPlan &plan, bool allow_merge, bool is_full_loading)
+{
+	for (const PlannedLink &link : plan.links) {
+		Station *st = Station::GetIfValid(link.from);
+		if (st == nullptr) continue;
+		CargoID c = link.cargo;
+
+		/* If not allowed to merge link graphs, make sure the stations are
+		 * already in the same link graph. */
+		if (!allow_merge && st->goods[c].link_graph != Station::Get(link.to)->goods[c].link_graph) {
+			continue;
+		}
+
+		/* If the vehicle is currently full loading, increase the capacities at the station
+		 * where it is loading by an estimate of what it would have transported if it wasn't
+		 * loading. Don't do that if the vehicle has been waiting for longer than the entire
+		 * order list is supposed to take, though. If that is the case the total duration is
+		 * probably far off and we'd greatly overestimate the capacity by increasing.*/
+		if (is_full_loading && v->orders.list != nullptr &&
+				st->index == v->last_station_visited &&
+				v->orders.list->GetTotalDuration() >
+				(Ticks)v->current_order_time) {
+			uint effective_capacity = link.capacity * v->load_unload_ticks;
+			if (effective_capacity > (uint)v->orders.list->GetTotalDuration()) {
+				IncreaseStats(st, c, link.to, effective_capacity /
+						v->orders.list->GetTotalDuration(), 0,
+						EUM_INCREASE | link.restricted_mode);
+			} else if (RandomRange(v->orders.list->GetTotalDuration()) < effective_capacity) {
+				IncreaseStats(st, c, link.to, 1, 0, EUM_INCREASE | link.restricted_mode);
+			} else {
+				IncreaseStats(st, c, link.to, link.capacity, 0, EUM_REFRESH | link.restricted_mode);
+			}
+		} else {
+			IncreaseStats(st, c, link.to, link.capacity, 0, EUM_REFRESH | link.restricted_mode);
+		}
+	}
+}
+
 /**
  * Comparison operator to allow hops to be used in a std::set.
  * @param other Other hop to be compared with.
@@ -87,12 +179,12 @@ bool LinkRefresher::Hop::operator<(const Hop &other) const
  * @param vehicle Vehicle to refresh links for.
  * @param seen_hops Set of hops already seen. This is shared between this
  *                  refresher and all its children.
- * @param allow_merge If the refresher is allowed to merge or extend link graphs.
- * @param is_full_loading If the vehicle is full loading.
+ * @param plan Plan to add the links to. This is shared between this
+ *             refresher and all its children.
+ * @param cargo_mask Mask of cargoes to refresh.
  */
-LinkRefresher::LinkRefresher(Vehicle *vehicle, HopSet *seen_hops, bool allow_merge, bool is_full_loading, CargoTypes cargo_mask) :
-	vehicle(vehicle), seen_hops(seen_hops), cargo(CT_INVALID), allow_merge(allow_merge),
-	is_full_loading(is_full_loading), cargo_mask(cargo_mask)
+LinkRefresher::LinkRefresher(Vehicle *vehicle, HopSet *seen_hops, RefreshPlan *plan, CargoTypes cargo_mask) :
+	vehicle(vehicle), seen_hops(seen_hops), plan(plan), cargo(CT_INVALID), cargo_mask(cargo_mask)
 {
 	memset(this->capacities, 0, sizeof(this->capacities));
 
@@ -113,6 +205,7 @@ LinkRefresher::LinkRefresher(Vehicle *vehicle, HopSet *seen_hops, bool allow_mer
  */
 bool LinkRefresher::HandleRefit(CargoID refit_cargo)
 {
+	this->plan->has_refit = true;
 	this->cargo = refit_cargo;
 	RefitList::iterator refit_it = this->refit_capacities.begin();
 	bool any_refit = false;
@@ -230,56 +323,29 @@ const Order *LinkRefresher::PredictNextOrder(const Order *cur, const Order *next
 }
 
 /**
- * Refresh link stats for the given pair of orders.
+ * Plan refreshing the link stats for the given pair of orders.
  * @param cur Last stop where the consist could interact with cargo.
  * @param next Next order to be processed.
  */
 void LinkRefresher::RefreshStats(const Order *cur, const Order *next)
 {
 	StationID next_station = next->GetDestination();
-	Station *st = Station::GetIfValid(cur->GetDestination());
-	if (st != nullptr && next_station != INVALID_STATION && next_station != st->index) {
-		for (CargoID c = 0; c < NUM_CARGO; c++) {
-			/* Refresh the link and give it a minimum capacity. */
+	StationID cur_station = cur->GetDestination();
+	if (next_station == INVALID_STATION || next_station == cur_station) return;
 
-			if (!HasBit(this->cargo_mask, c)) continue;
+	for (CargoID c = 0; c < NUM_CARGO; c++) {
+		/* Refresh the link and give it a minimum capacity. */
 
-			uint cargo_quantity = this->capacities[c];
-			if (cargo_quantity == 0) continue;
+		if (!HasBit(this->cargo_mask, c)) continue;
 
-			/* If not allowed to merge link graphs, make sure the stations are
-			 * already in the same link graph. */
-			if (!this->allow_merge && st->goods[c].link_graph != Station::Get(next_station)->goods[c].link_graph) {
-				continue;
-			}
+		uint cargo_quantity = this->capacities[c];
+		if (cargo_quantity == 0) continue;
 
-			/* A link is at least partly restricted if a vehicle can't load at its source. */
-			EdgeUpdateMode restricted_mode = (cur->GetCargoLoadType(c) & OLFB_NO_LOAD) == 0 ?
-						EUM_UNRESTRICTED : EUM_RESTRICTED;
-
-			/* If the vehicle is currently full loading, increase the capacities at the station
-			 * where it is loading by an estimate of what it would have transported if it wasn't
-			 * loading. Don't do that if the vehicle has been waiting for longer than the entire
-			 * order list is supposed to take, though. If that is the case the total duration is
-			 * probably far off and we'd greatly overestimate the capacity by increasing.*/
-			if (this->is_full_loading && this->vehicle->orders.list != nullptr &&
-					st->index == vehicle->last_station_visited &&
-					this->vehicle->orders.list->GetTotalDuration() >
-					(Ticks)this->vehicle->current_order_time) {
-				uint effective_capacity = cargo_quantity * this->vehicle->load_unload_ticks;
-				if (effective_capacity > (uint)this->vehicle->orders.list->GetTotalDuration()) {
-					IncreaseStats(st, c, next_station, effective_capacity /
-							this->vehicle->orders.list->GetTotalDuration(), 0,
-							EUM_INCREASE | restricted_mode);
-				} else if (RandomRange(this->vehicle->orders.list->GetTotalDuration()) < effective_capacity) {
-					IncreaseStats(st, c, next_station, 1, 0, EUM_INCREASE | restricted_mode);
-				} else {
-					IncreaseStats(st, c, next_station, cargo_quantity, 0, EUM_REFRESH | restricted_mode);
-				}
-			} else {
-				IncreaseStats(st, c, next_station, cargo_quantity, 0, EUM_REFRESH | restricted_mode);
-			}
-		}
+		/* A link is at least partly restricted if a vehicle can't load at its source. */
+		EdgeUpdateMode restricted_mode = (cur->GetCargoLoadType(c) & OLFB_NO_LOAD) == 0 ?
+					EUM_UNRESTRICTED : EUM_RESTRICTED;
+
+		this->plan->links.push_back({ cur_station, next_station, c, restricted_mode, cargo_quantity });
 	}
 }
 
@@ -12,6 +12,7 @@
 
 #include "../cargo_type.h"
 #include "../vehicle_base.h"
+#include "linkgraph_type.h"
 #include "../3rdparty/cpp-btree/btree_set.h"
 #include <vector>
 #include <map>
@@ -21,6 +22,25 @@
  */
 class LinkRefresher {
 public:
+	/**
+	 * A link to be refreshed, as predicted from the orders.
+	 */
+	struct PlannedLink {
+		StationID from;                 ///< Station the link starts at.
+		StationID to;                   ///< Station the link leads to.
+		CargoID cargo;                  ///< Cargo to refresh the link for.
+		EdgeUpdateMode restricted_mode; ///< If the link is restricted or not.
+		uint capacity;                  ///< Capacity the consist has for the cargo on the link.
+	};
+
+	/**
+	 * Links to be refreshed for a vehicle, in the order they are refreshed in.
+	 */
+	struct RefreshPlan {
+		std::vector<PlannedLink> links; ///< Links to be refreshed.
+		bool has_refit = false;         ///< If refit capacities have been calculated. Those depend on the individual vehicle.
+	};
+
 	static void Run(Vehicle *v, bool allow_merge = true, bool is_full_loading = false, CargoTypes cargo_mask = ALL_CARGOTYPES);
 
 protected:
@@ -84,12 +104,14 @@ protected:
 	uint capacities[NUM_CARGO]; ///< Current added capacities per cargo ID in the consist.
 	RefitList refit_capacities; ///< Current state of capacity remaining from previous refits versus overall capacity per vehicle in the consist.
 	HopSet *seen_hops;          ///< Hops already seen. If the same hop is seen twice we stop the algorithm. This is shared between all Refreshers of the same run.
+	RefreshPlan *plan;          ///< Plan the links to be refreshed are added to. This is shared between all Refreshers of the same run.
 	CargoID cargo;              ///< Cargo given in last refit order.
-	bool allow_merge;           ///< If the refresher is allowed to merge or extend link graphs.
-	bool is_full_loading;       ///< If the vehicle is full loading.
 	CargoTypes cargo_mask;      ///< Bit-mask of cargo IDs to refresh.
 
-	LinkRefresher(Vehicle *v, HopSet *seen_hops, bool allow_merge, bool is_full_loading, CargoTypes cargo_mask);
+	LinkRefresher(Vehicle *v, HopSet *seen_hops, RefreshPlan *plan, CargoTypes cargo_mask);
+
+	static void PlanRefresh(Vehicle *v, CargoTypes cargo_mask, CargoTypes have_cargo_mask, RefreshPlan *plan);
+	static void ExecutePlan(Vehicle *v, const RefreshPlan &plan, bool allow_merge, bool is_full_loading);
 
 	bool HandleRefit(CargoID refit_cargo);
 	void ResetRefit();
@@ -99,4 +121,38 @@ protected:
 	void RefreshLinks(const Order *cur, const Order *next, uint8 flags, uint num_hops = 0);
 };
 
+/**
+ * Refresh plans cached for an order list. The links predicted for a vehicle
+ * only depend on the orders, the order the vehicle is at, the cargoes it
+ * carries and the capacities of its parts. So unless refits have to be
+ * evaluated, the plan can be reused for all vehicles sharing the orders and
+ * only has to be executed when they leave a station.
+ */
+struct LinkRefreshPlanCache {
+	/**
+	 * Capacity of a part of a consist, as used by the link refresher.
+	 */
+	struct ConsistPart {
+		CargoID cargo;    ///< Cargo type of the part.
+		uint16 capacity;  ///< Capacity of the part.
+		uint16 remaining; ///< Capacity remaining from before the last refit.
+	};
+
+	/**
+	 * A plan and the state of the vehicle it was created for.
+	 */
+	struct Entry {
+		CargoTypes cargo_mask;            ///< Cargoes to refresh.
+		CargoTypes have_cargo_mask;       ///< Cargoes the vehicle could load at the last loading station.
+		VehicleOrderID order_index;       ///< Implicit order index of the vehicle.
+		std::vector<ConsistPart> consist; ///< Capacities of the consist.
+		LinkRefresher::RefreshPlan plan;  ///< Links to be refreshed.
+	};
+
+	/** Maximum number of plans cached per order list. */
+	static const uint MAX_ENTRIES = 64;
+
+	std::vector<Entry> entries; ///< Cached plans, oldest first.
+};
+
 #endif /* REFRESH_H */
@@ -38,6 +38,7 @@
 #include "zoning.h"
 #include "cargopacket.h"
 #include "tbtr_template_vehicle_func.h"
+#include "departures_func.h"
 
 #include "safeguards.h"
 
@@ -77,6 +78,8 @@ void InitializeGame(uint size_x, uint size_y, bool reset_date, bool reset_settin
 	AllocateMap(size_x, size_y);
 
 	ViewportMapClearTunnelCache();
+	ViewportMapInvalidateColourCaches();
+	ClearViewportTileSpriteCaches();
 	ClearCommandLog();
 	ClearDesyncMsgLog();
 
@@ -123,6 +126,7 @@ void InitializeGame(uint size_x, uint size_y, bool reset_date, bool reset_settin
 	ClearAllSignalSpeedRestrictions();
 
 	ClearZoningCaches();
+	InvalidateDepartureCache();
 	IntialiseOrderDestinationRefcountMap();
 
 	ResetPersistentNewGRFData();
@@ -75,6 +75,19 @@ void Packet::PrepareToSend()
 	this->buffer.shrink_to_fit();
 }
 
+/**
+ * Finalise a packet and turn it into an immutable packet which can be queued to multiple sockets.
+ * @param packet The packet to share, it must not be written to afterwards.
+ * @return The shared packet.
+ */
+/* static */ SharedPacket Packet::Share(std::unique_ptr<Packet> packet)
+{
+	assert(packet != nullptr);
+
+	packet->PrepareToSend();
+	return SharedPacket(std::move(packet));
+}
+
 /**
  * Is it safe to write to the packet, i.e. didn't we run over the buffer?
  * @param bytes_to_write The amount of bytes we want to try to write.
@@ -19,6 +19,7 @@
 #include <string>
 #include <functional>
 #include <limits>
+#include <memory>
 
 typedef uint16 PacketSize; ///< Size of the whole packet.
 typedef uint8  PacketType; ///< Identifier for the packet
@@ -94,6 +95,8 @@ public:
 
 	size_t RemainingBytesToTransfer() const;
 
+	static std::shared_ptr<const Packet> Share(std::unique_ptr<Packet> packet);
+
 	const byte *GetBufferData() const { return this->buffer.data(); }
 	PacketSize GetRawPos() const { return this->pos; }
 	void ReserveBuffer(size_t size) { this->buffer.reserve(size); }
@@ -195,4 +198,11 @@ public:
 	}
 };
 
+/**
+ * Immutable, reference counted packet which has been prepared for sending.
+ * The same instance can be queued to the send queue of any number of sockets,
+ * so the packet only needs to be serialised once when broadcasting.
+ */
+typedef std::shared_ptr<const Packet> SharedPacket;
+
 #endif /* NETWORK_CORE_PACKET_H */
@@ -0,0 +1,275 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file stream_compression.cpp Compression of the byte stream of a TCP connection.
+ *
+ * The stream is a raw deflate stream, i.e. without zlib header, which is
+ * primed with a preset dictionary that is known by both sides.
+ */
+
+#include "../../stdafx.h"
+#include "../../debug.h"
+
+#include "stream_compression.h"
+
+#include <chrono>
+
+#if defined(WITH_ZLIB)
+#include <zlib.h>
+#endif
+
+#include "../../safeguards.h"
+
+/** Amount by which the output buffers are grown when (de)compressing. */
+static const size_t STREAM_COMPRESSION_CHUNK_SIZE = 4096;
+
+/**
+ * Get the number of microseconds since a given moment.
+ * @param start The moment to measure from.
+ * @return The elapsed time.
+ */
+static uint64 GetMicrosecondsSince(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+#if defined(WITH_ZLIB)
+
+struct NetworkStreamCompressor::Impl {
+	z_stream z; ///< The deflate state.
+};
+
+struct NetworkStreamDecompressor::Impl {
+	z_stream z; ///< The inflate state.
+};
+
+/**
+ * Whether stream compression is available in this build.
+ * @return True iff compressing and decompressing streams is supported.
+ */
+/* static */ bool NetworkStreamCompressor::IsSupported()
+{
+	return true;
+}
+
+/**
+ * Create a new stream compressor.
+ * @param dictionary The preset dictionary, which must be the same on both sides of the connection.
+ */
+NetworkStreamCompressor::NetworkStreamCompressor(const std::vector<byte> &dictionary) : impl(new Impl()), output_sent(0), need_flush(false)
+{
+	memset(&this->impl->z, 0, sizeof(this->impl->z));
+
+	/* A negative window size means a raw deflate stream; the connection has its own framing. */
+	if (deflateInit2(&this->impl->z, 6, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK) error("deflateInit2 failed");
+	if (!dictionary.empty() && deflateSetDictionary(&this->impl->z, dictionary.data(), (uInt)dictionary.size()) != Z_OK) error("deflateSetDictionary failed");
+}
+
+NetworkStreamCompressor::~NetworkStreamCompressor()
+{
+	deflateEnd(&this->impl->z);
+}
+
+/**
+ * Run the compressor over the given data, appending the result to the output buffer.
+ * @param data The data to compress.
+ * @param size The number of bytes of data.
+ * @param flush Whether to make all data so far decodable by the other side.
+ * @return False when compression failed.
+ */
+bool NetworkStreamCompressor::Compress(const byte *data, size_t size, bool flush)
+{
+	auto start = std::chrono::steady_clock::now();
+	z_stream &z = this->impl->z;
+
+	z.next_in = const_cast<byte *>(data);
+	z.avail_in = (uInt)size;
+
+	for (;;) {
+		size_t used = this->output.size();
+		this->output.resize(used + STREAM_COMPRESSION_CHUNK_SIZE);
+		z.next_out = this->output.data() + used;
+		z.avail_out = STREAM_COMPRESSION_CHUNK_SIZE;
+
+		int r = deflate(&z, flush ? Z_SYNC_FLUSH : Z_NO_FLUSH);
+		this->output.resize(this->output.size() - z.avail_out);
+		this->stats.compressed_bytes += STREAM_COMPRESSION_CHUNK_SIZE - z.avail_out;
+
+		if (r != Z_OK && r != Z_BUF_ERROR) {
+			DEBUG(net, 0, "Stream compression failed with error %d", r);
+			return false;
+		}
+		/* All input consumed and, when flushing, all pending output written. */
+		if (z.avail_in == 0 && z.avail_out != 0) break;
+	}
+
+	this->stats.time_us += GetMicrosecondsSince(start);
+	return true;
+}
+
+/**
+ * Add data to the compressed stream.
+ * @param data The data to add.
+ * @param size The number of bytes of data.
+ * @return False when compression failed.
+ */
+bool NetworkStreamCompressor::Write(const byte *data, size_t size)
+{
+	if (size == 0) return true;
+
+	this->stats.raw_bytes += size;
+	this->need_flush = true;
+	return this->Compress(data, size, false);
+}
+
+/**
+ * Make sure all data written so far can be decompressed by the other side,
+ * once the pending output has been sent.
+ * @return False when compression failed.
+ */
+bool NetworkStreamCompressor::Flush()
+{
+	if (!this->need_flush) return true;
+
+	this->need_flush = false;
+	return this->Compress(nullptr, 0, true);
+}
+
+/**
+ * Mark a part of the pending output as sent.
+ * @param bytes The number of bytes which have been sent.
+ */
+void NetworkStreamCompressor::ConsumeOutput(size_t bytes)
+{
+	assert(bytes <= this->GetPendingOutputSize());
+
+	this->output_sent += bytes;
+	if (this->output_sent == this->output.size()) {
+		this->output.clear();
+		this->output_sent = 0;
+	} else if (this->output_sent >= this->output.size() / 2) {
+		this->output.erase(this->output.begin(), this->output.begin() + this->output_sent);
+		this->output_sent = 0;
+	}
+}
+
+/**
+ * Create a new stream decompressor.
+ * @param dictionary The preset dictionary, which must be the same on both sides of the connection.
+ */
+NetworkStreamDecompressor::NetworkStreamDecompressor(const std::vector<byte> &dictionary) : impl(new Impl()), input_used(0), failed(false)
+{
+	memset(&this->impl->z, 0, sizeof(this->impl->z));
+
+	if (inflateInit2(&this->impl->z, -15) != Z_OK) error("inflateInit2 failed");
+	/* Raw inflate streams do not ask for the dictionary, so it is set straight away. */
+	if (!dictionary.empty() && inflateSetDictionary(&this->impl->z, dictionary.data(), (uInt)dictionary.size()) != Z_OK) error("inflateSetDictionary failed");
+}
+
+NetworkStreamDecompressor::~NetworkStreamDecompressor()
+{
+	inflateEnd(&this->impl->z);
+}
+
+/**
+ * Decompress data from the stream.
+ * @param buffer The buffer to decompress into.
+ * @param amount The maximum number of bytes to decompress.
+ * @return The number of bytes written to the buffer, 0 when more input is needed or -1 when the stream is corrupt.
+ */
+ssize_t NetworkStreamDecompressor::Read(byte *buffer, size_t amount)
+{
+	if (this->failed) return -1;
+
+	auto start = std::chrono::steady_clock::now();
+	z_stream &z = this->impl->z;
+
+	z.next_in = this->input.data() + this->input_used;
+	z.avail_in = (uInt)(this->input.size() - this->input_used);
+	z.next_out = buffer;
+	z.avail_out = (uInt)amount;
+
+	/* Even without new input there might be output left from the previous call, e.g. in the middle of a match. */
+	int r = inflate(&z, Z_SYNC_FLUSH);
+	if (r != Z_OK && r != Z_BUF_ERROR) {
+		DEBUG(net, 0, "Stream decompression failed with error %d", r);
+		this->failed = true;
+		return -1;
+	}
+
+	this->input_used = this->input.size() - z.avail_in;
+	if (this->input_used == this->input.size()) {
+		this->input.clear();
+		this->input_used = 0;
+	} else if (this->input_used >= this->input.size() / 2) {
+		this->input.erase(this->input.begin(), this->input.begin() + this->input_used);
+		this->input_used = 0;
+	}
+
+	size_t produced = amount - z.avail_out;
+	this->stats.raw_bytes += produced;
+	this->stats.time_us += GetMicrosecondsSince(start);
+	return produced;
+}
+
+#else /* WITH_ZLIB */
+
+struct NetworkStreamCompressor::Impl {};
+struct NetworkStreamDecompressor::Impl {};
+
+/* static */ bool NetworkStreamCompressor::IsSupported()
+{
+	return false;
+}
+
+NetworkStreamCompressor::NetworkStreamCompressor(const std::vector<byte> &dictionary) : output_sent(0), need_flush(false)
+{
+	NOT_REACHED();
+}
+
+NetworkStreamCompressor::~NetworkStreamCompressor() {}
+
+bool NetworkStreamCompressor::Write(const byte *data, size_t size)
+{
+	return false;
+}
+
+bool NetworkStreamCompressor::Flush()
+{
+	return false;
+}
+
+void NetworkStreamCompressor::ConsumeOutput(size_t bytes)
+{
+	NOT_REACHED();
+}
+
+NetworkStreamDecompressor::NetworkStreamDecompressor(const std::vector<byte> &dictionary) : input_used(0), failed(true)
+{
+	NOT_REACHED();
+}
+
+NetworkStreamDecompressor::~NetworkStreamDecompressor() {}
+
+ssize_t NetworkStreamDecompressor::Read(byte *buffer, size_t amount)
+{
+	return -1;
+}
+
+#endif /* WITH_ZLIB */
+
+/**
+ * Add received compressed data to the stream.
+ * @param data The received data.
+ * @param size The number of bytes of data.
+ */
+void NetworkStreamDecompressor::AddInput(const byte *data, size_t size)
+{
+	this->input.insert(this->input.end(), data, data + size);
+	this->stats.compressed_bytes += size;
+}
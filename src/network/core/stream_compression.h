@@ -0,0 +1,105 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file stream_compression.h Compression of the byte stream of a TCP connection.
+ */
+
+#ifndef NETWORK_CORE_STREAM_COMPRESSION_H
+#define NETWORK_CORE_STREAM_COMPRESSION_H
+
+#include "os_abstraction.h"
+#include <vector>
+#include <memory>
+
+/** Statistics of one direction of a compressed stream. */
+struct NetworkStreamCompressionStats {
+	uint64 raw_bytes = 0;        ///< Number of bytes of packet data, i.e. before compression or after decompression.
+	uint64 compressed_bytes = 0; ///< Number of bytes which went over the wire.
+	uint64 time_us = 0;          ///< Time spent on (de)compressing, in microseconds.
+
+	/**
+	 * Get the size on the wire relative to the size of the packet data.
+	 * @return The compression ratio, 1 when nothing has been transferred yet.
+	 */
+	double GetRatio() const
+	{
+		return this->raw_bytes == 0 ? 1.0 : (double)this->compressed_bytes / (double)this->raw_bytes;
+	}
+};
+
+/**
+ * Compressor for the outgoing byte stream of a connection.
+ * Data is compressed as a single stream, with a shared preset dictionary, and
+ * made decodable by the other side whenever it is flushed.
+ */
+class NetworkStreamCompressor {
+	struct Impl;
+	std::unique_ptr<Impl> impl;     ///< Implementation specific state.
+	std::vector<byte> output;       ///< Compressed data which has not been sent yet.
+	size_t output_sent;             ///< Number of bytes at the start of #output which have been sent.
+	bool need_flush;                ///< Whether data has been written since the last flush.
+
+	bool Compress(const byte *data, size_t size, bool flush);
+
+public:
+	NetworkStreamCompressionStats stats; ///< Statistics of this stream.
+
+	NetworkStreamCompressor(const std::vector<byte> &dictionary);
+	~NetworkStreamCompressor();
+
+	bool Write(const byte *data, size_t size);
+	bool Flush();
+
+	/**
+	 * Whether there is compressed data which still has to be sent.
+	 * @return True iff there is pending output.
+	 */
+	bool HasPendingOutput() const { return this->output_sent < this->output.size(); }
+
+	/**
+	 * Get the compressed data which still has to be sent.
+	 * @return Pointer to the first unsent byte.
+	 */
+	const byte *GetPendingOutput() const { return this->output.data() + this->output_sent; }
+
+	/**
+	 * Get the amount of compressed data which still has to be sent.
+	 * @return The number of unsent bytes.
+	 */
+	size_t GetPendingOutputSize() const { return this->output.size() - this->output_sent; }
+
+	void ConsumeOutput(size_t bytes);
+
+	static bool IsSupported();
+};
+
+/** Decompressor for the incoming byte stream of a connection. */
+class NetworkStreamDecompressor {
+	struct Impl;
+	std::unique_ptr<Impl> impl;     ///< Implementation specific state.
+	std::vector<byte> input;        ///< Compressed data which has been received but not yet decompressed.
+	size_t input_used;              ///< Number of bytes at the start of #input which have been decompressed.
+	bool failed;                    ///< Whether the stream is corrupt.
+
+public:
+	NetworkStreamCompressionStats stats; ///< Statistics of this stream.
+
+	NetworkStreamDecompressor(const std::vector<byte> &dictionary);
+	~NetworkStreamDecompressor();
+
+	void AddInput(const byte *data, size_t size);
+	ssize_t Read(byte *buffer, size_t amount);
+
+	/**
+	 * Whether decompressing the stream failed.
+	 * @return True iff the stream is corrupt.
+	 */
+	bool HasFailed() const { return this->failed; }
+};
+
+#endif /* NETWORK_CORE_STREAM_COMPRESSION_H */
@@ -22,7 +22,7 @@
  */
 NetworkTCPSocketHandler::NetworkTCPSocketHandler(SOCKET s) :
 		NetworkSocketHandler(),
-		sock(s), writable(false)
+		packet_queue_front_sent(0), send_compression_start_after(nullptr), sock(s), writable(false)
 {
 }
 
@@ -41,8 +41,23 @@ NetworkRecvStatus NetworkTCPSocketHandler::CloseConnection(bool error)
 
 	/* Free all pending and partially received packets */
 	this->packet_queue.clear();
+	this->packet_queue_front_sent = 0;
 	this->packet_recv.reset();
 
+	if (this->send_compression != nullptr) {
+		const NetworkStreamCompressionStats &stats = this->send_compression->stats;
+		DEBUG(net, 3, "Sent stream compression: " OTTD_PRINTF64U " bytes to " OTTD_PRINTF64U " bytes (%.1f%%) in " OTTD_PRINTF64U " us",
+				stats.raw_bytes, stats.compressed_bytes, stats.GetRatio() * 100, stats.time_us);
+	}
+	if (this->recv_compression != nullptr) {
+		const NetworkStreamCompressionStats &stats = this->recv_compression->stats;
+		DEBUG(net, 3, "Received stream compression: " OTTD_PRINTF64U " bytes from " OTTD_PRINTF64U " bytes (%.1f%%) in " OTTD_PRINTF64U " us",
+				stats.raw_bytes, stats.compressed_bytes, stats.GetRatio() * 100, stats.time_us);
+	}
+	this->send_compression.reset();
+	this->send_compression_start_after = nullptr;
+	this->recv_compression.reset();
+
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
@@ -56,7 +71,18 @@ void NetworkTCPSocketHandler::SendPacket(std::unique_ptr<Packet> packet)
 {
 	assert(packet != nullptr);
 
-	packet->PrepareToSend();
+	this->packet_queue.push_back(Packet::Share(std::move(packet)));
+}
+
+/**
+ * This function puts an already prepared packet, which may also be queued
+ * on other sockets, in the send-queue.
+ * @param packet the shared packet to send
+ * @see NetworkTCPSocketHandler::SendPacket
+ */
+void NetworkTCPSocketHandler::SendSharedPacket(SharedPacket packet)
+{
+	assert(packet != nullptr);
 
 	this->packet_queue.push_back(std::move(packet));
 }
@@ -71,13 +97,13 @@ void NetworkTCPSocketHandler::SendPrependPacket(std::unique_ptr<Packet> packet,
 {
 	assert(packet != nullptr);
 
-	packet->PrepareToSend();
+	SharedPacket shared = Packet::Share(std::move(packet));
 
 	if (queue_after_packet_type >= 0) {
 		for (auto iter = this->packet_queue.begin(); iter != this->packet_queue.end(); ++iter) {
 			if ((*iter)->GetPacketType() == queue_after_packet_type) {
 				++iter;
-				this->packet_queue.insert(iter, std::move(packet));
+				this->packet_queue.insert(iter, std::move(shared));
 				return;
 			}
 		}
@@ -87,9 +113,35 @@ void NetworkTCPSocketHandler::SendPrependPacket(std::unique_ptr<Packet> packet,
 	 * If the queue is non-empty, swap packet with the first packet in the queue.
 	 * The insert the packet (either the incoming packet or the previous first packet) at the front. */
 	if (!this->packet_queue.empty()) {
-		packet.swap(this->packet_queue.front());
+		shared.swap(this->packet_queue.front());
 	}
-	this->packet_queue.push_front(std::move(packet));
+	this->packet_queue.push_front(std::move(shared));
+}
+
+/**
+ * Compress the outgoing stream from the end of the current send queue onwards.
+ * All packets which are already in the queue are still sent uncompressed.
+ * @param dictionary The preset dictionary, which must be the same on both sides of the connection.
+ */
+void NetworkTCPSocketHandler::StartSendCompression(const std::vector<byte> &dictionary)
+{
+	assert(this->send_compression == nullptr);
+	assert(NetworkStreamCompressor::IsSupported());
+
+	this->send_compression.reset(new NetworkStreamCompressor(dictionary));
+	this->send_compression_start_after = this->packet_queue.empty() ? nullptr : this->packet_queue.back().get();
+}
+
+/**
+ * Decompress the incoming stream from the next received packet onwards.
+ * @param dictionary The preset dictionary, which must be the same on both sides of the connection.
+ */
+void NetworkTCPSocketHandler::StartReceiveCompression(const std::vector<byte> &dictionary)
+{
+	assert(this->recv_compression == nullptr);
+	assert(NetworkStreamCompressor::IsSupported());
+
+	this->recv_compression.reset(new NetworkStreamDecompressor(dictionary));
 }
 
 /**
@@ -110,9 +162,13 @@ SendPacketsState NetworkTCPSocketHandler::SendPackets(bool closing_down)
 	if (!this->writable) return SPS_NONE_SENT;
 	if (!this->IsConnected()) return SPS_CLOSED;
 
+	if (this->send_compression != nullptr && this->send_compression_start_after == nullptr) return this->SendCompressedPackets(closing_down);
+
 	while (!this->packet_queue.empty()) {
-		Packet *p = this->packet_queue.front().get();
-		res = p->TransferOut<int>(send, this->sock, 0);
+		/* The packet itself is shared between sockets, so keep track of the send position here. */
+		const Packet *p = this->packet_queue.front().get();
+		assert(this->packet_queue_front_sent < p->Size());
+		res = send(this->sock, reinterpret_cast<const char *>(p->GetBufferData() + this->packet_queue_front_sent), static_cast<int>(p->Size() - this->packet_queue_front_sent), 0);
 		if (res == -1) {
 			int err = NetworkGetLastError();
 			if (err != EWOULDBLOCK) {
@@ -131,11 +187,21 @@ SendPacketsState NetworkTCPSocketHandler::SendPackets(bool closing_down)
 			return SPS_CLOSED;
 		}
 
+		this->packet_queue_front_sent += res;
+
 		/* Is this packet sent? */
-		if (p->RemainingBytesToTransfer() == 0) {
+		if (this->packet_queue_front_sent == p->Size()) {
 			/* Go to the next packet */
 			if (_debug_net_level >= 5) this->LogSentPacket(*p);
+			bool start_compression = (p == this->send_compression_start_after);
+			this->packet_queue_front_sent = 0;
 			this->packet_queue.pop_front();
+
+			if (start_compression) {
+				/* Everything after this packet goes through the compressor. */
+				this->send_compression_start_after = nullptr;
+				return this->SendCompressedPackets(closing_down);
+			}
 		} else {
 			return SPS_PARTLY_SENT;
 		}
@@ -144,6 +210,85 @@ SendPacketsState NetworkTCPSocketHandler::SendPackets(bool closing_down)
 	return SPS_ALL_SENT;
 }
 
+/**
+ * Sends all the buffered packets out for this client through the stream compressor.
+ * All queued packets are compressed and flushed at once, so latency is not
+ * increased by waiting for more data to compress.
+ * @param closing_down Whether we are closing down the connection.
+ * @return The state of sending the packets.
+ * @see NetworkTCPSocketHandler::SendPackets
+ */
+SendPacketsState NetworkTCPSocketHandler::SendCompressedPackets(bool closing_down)
+{
+	NetworkStreamCompressor *compressor = this->send_compression.get();
+
+	while (!this->packet_queue.empty()) {
+		const Packet *p = this->packet_queue.front().get();
+		if (!compressor->Write(p->GetBufferData(), p->Size())) {
+			if (!closing_down) this->CloseConnection();
+			return SPS_CLOSED;
+		}
+		if (_debug_net_level >= 5) this->LogSentPacket(*p);
+		this->packet_queue.pop_front();
+	}
+
+	if (!compressor->Flush()) {
+		if (!closing_down) this->CloseConnection();
+		return SPS_CLOSED;
+	}
+
+	while (compressor->HasPendingOutput()) {
+		ssize_t res = send(this->sock, reinterpret_cast<const char *>(compressor->GetPendingOutput()), static_cast<int>(compressor->GetPendingOutputSize()), 0);
+		if (res == -1) {
+			int err = NetworkGetLastError();
+			if (err != EWOULDBLOCK) {
+				/* Something went wrong.. close client! */
+				if (!closing_down) {
+					DEBUG(net, 0, "send failed with error %s", NetworkGetErrorString(err));
+					this->CloseConnection();
+				}
+				return SPS_CLOSED;
+			}
+			return SPS_PARTLY_SENT;
+		}
+		if (res == 0) {
+			/* Client/server has left us :( */
+			if (!closing_down) this->CloseConnection();
+			return SPS_CLOSED;
+		}
+
+		compressor->ConsumeOutput(res);
+	}
+
+	return SPS_ALL_SENT;
+}
+
+/**
+ * Transfer function for receiving data from a socket with a compressed incoming stream.
+ * It has the same semantics as recv, except that a corrupt stream is reported as a closed connection.
+ * @param handler The socket handler to receive for.
+ * @param buffer The buffer to decompress the data into.
+ * @param amount The maximum number of bytes to receive.
+ * @param flags The flags passed to recv.
+ * @return The number of bytes received, 0 when the connection has been closed or -1 upon errors.
+ */
+/* static */ ssize_t NetworkTCPSocketHandler::ReceiveDecompressed(NetworkTCPSocketHandler *handler, char *buffer, int amount, int flags)
+{
+	NetworkStreamDecompressor *decompressor = handler->recv_compression.get();
+
+	for (;;) {
+		ssize_t res = decompressor->Read(reinterpret_cast<byte *>(buffer), amount);
+		if (res > 0) return res;
+		if (res < 0) return 0;
+
+		/* The decompressor needs more data before it can produce anything. */
+		byte input[4096];
+		ssize_t received = recv(handler->sock, reinterpret_cast<char *>(input), sizeof(input), flags);
+		if (received <= 0) return received;
+		decompressor->AddInput(input, received);
+	}
+}
+
 /**
  * Receives a packet for the given client
  * @return The received packet (or nullptr when it didn't receive one)
@@ -163,7 +308,7 @@ std::unique_ptr<Packet> NetworkTCPSocketHandler::ReceivePacket()
 	/* Read packet size */
 	if (!p->HasPacketSizeData()) {
 		while (p->RemainingBytesToTransfer() != 0) {
-			res = p->TransferIn<int>(recv, this->sock, 0);
+			res = (this->recv_compression != nullptr) ? p->TransferIn<int>(ReceiveDecompressed, this, 0) : p->TransferIn<int>(recv, this->sock, 0);
 			if (res == -1) {
 				int err = NetworkGetLastError();
 				if (err != EWOULDBLOCK) {
@@ -192,7 +337,7 @@ std::unique_ptr<Packet> NetworkTCPSocketHandler::ReceivePacket()
 
 	/* Read rest of packet */
 	while (p->RemainingBytesToTransfer() != 0) {
-		res = p->TransferIn<int>(recv, this->sock, 0);
+		res = (this->recv_compression != nullptr) ? p->TransferIn<int>(ReceiveDecompressed, this, 0) : p->TransferIn<int>(recv, this->sock, 0);
 		if (res == -1) {
 			int err = NetworkGetLastError();
 			if (err != EWOULDBLOCK) {
@@ -14,6 +14,7 @@
 
 #include "address.h"
 #include "packet.h"
+#include "stream_compression.h"
 
 #include <deque>
 #include <memory>
@@ -30,8 +31,16 @@ enum SendPacketsState {
 /** Base socket handler for all TCP sockets */
 class NetworkTCPSocketHandler : public NetworkSocketHandler {
 private:
-	std::deque<std::unique_ptr<Packet>> packet_queue; ///< Packets that are awaiting delivery
-	std::unique_ptr<Packet> packet_recv;              ///< Partially received packet
+	std::deque<SharedPacket> packet_queue;  ///< Packets that are awaiting delivery
+	size_t packet_queue_front_sent;         ///< Number of bytes of the first packet in the queue which have already been sent
+	std::unique_ptr<Packet> packet_recv;    ///< Partially received packet
+
+	std::unique_ptr<NetworkStreamCompressor> send_compression;     ///< Compressor of the outgoing stream, if any
+	const Packet *send_compression_start_after;                   ///< Queued packet after which the outgoing stream is compressed, or nullptr when compression is active
+	std::unique_ptr<NetworkStreamDecompressor> recv_compression;   ///< Decompressor of the incoming stream, if any
+
+	SendPacketsState SendCompressedPackets(bool closing_down);
+	static ssize_t ReceiveDecompressed(NetworkTCPSocketHandler *handler, char *buffer, int amount, int flags);
 public:
 	SOCKET sock;              ///< The socket currently connected to
 	bool writable;            ///< Can we write to this socket?
@@ -45,6 +54,7 @@ public:
 	NetworkRecvStatus CloseConnection(bool error = true) override;
 	void SendPacket(std::unique_ptr<Packet> packet);
 	void SendPrependPacket(std::unique_ptr<Packet> packet, int queue_after_packet_type);
+	void SendSharedPacket(SharedPacket packet);
 
 	void SendPacket(Packet *packet)
 	{
@@ -53,6 +63,21 @@ public:
 
 	SendPacketsState SendPackets(bool closing_down = false);
 
+	void StartSendCompression(const std::vector<byte> &dictionary);
+	void StartReceiveCompression(const std::vector<byte> &dictionary);
+
+	/**
+	 * Get the statistics of the compression of the outgoing stream.
+	 * @return The statistics, or nullptr when the outgoing stream is not compressed.
+	 */
+	const NetworkStreamCompressionStats *GetSendCompressionStats() const { return this->send_compression != nullptr ? &this->send_compression->stats : nullptr; }
+
+	/**
+	 * Get the statistics of the decompression of the incoming stream.
+	 * @return The statistics, or nullptr when the incoming stream is not compressed.
+	 */
+	const NetworkStreamCompressionStats *GetReceiveCompressionStats() const { return this->recv_compression != nullptr ? &this->recv_compression->stats : nullptr; }
+
 	virtual std::unique_ptr<Packet> ReceivePacket();
 	virtual void LogSentPacket(const Packet &pkt);
 
@@ -62,7 +87,7 @@ public:
 	 * Whether there is something pending in the send queue.
 	 * @return true when something is pending in the send queue.
 	 */
-	bool HasSendQueue() { return !this->packet_queue.empty(); }
+	bool HasSendQueue() { return !this->packet_queue.empty() || (this->send_compression != nullptr && this->send_compression->HasPendingOutput()); }
 
 	NetworkTCPSocketHandler(SOCKET s = INVALID_SOCKET);
 	~NetworkTCPSocketHandler();
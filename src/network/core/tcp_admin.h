@@ -30,6 +30,7 @@ enum PacketAdminType {
 	ADMIN_PACKET_ADMIN_RCON,             ///< The admin sends a remote console command.
 	ADMIN_PACKET_ADMIN_GAMESCRIPT,       ///< The admin sends a JSON string for the GameScript.
 	ADMIN_PACKET_ADMIN_PING,             ///< The admin sends a ping to the server, expecting a ping-reply (PONG) packet.
+	ADMIN_PACKET_ADMIN_STATS_FILTER,     ///< The admin tells the server which parts of the stats stream it wants to receive.
 
 	ADMIN_PACKET_SERVER_FULL = 100,      ///< The server tells the admin it cannot accept the admin.
 	ADMIN_PACKET_SERVER_BANNED,          ///< The server tells the admin it is banned.
@@ -59,6 +60,7 @@ enum PacketAdminType {
 	ADMIN_PACKET_SERVER_GAMESCRIPT,      ///< The server gives the admin information from the GameScript in JSON.
 	ADMIN_PACKET_SERVER_RCON_END,        ///< The server indicates that the remote console command has completed.
 	ADMIN_PACKET_SERVER_PONG,            ///< The server replies to a ping request from the admin.
+	ADMIN_PACKET_SERVER_STATS_STREAM,    ///< The server gives the admin the changes in the statistics since the previous stream packet.
 
 	INVALID_ADMIN_PACKET = 0xFF,         ///< An invalid marker for admin packets.
 };
@@ -82,6 +84,7 @@ enum AdminUpdateType {
 	ADMIN_UPDATE_CMD_NAMES,       ///< The admin would like a list of all DoCommand names.
 	ADMIN_UPDATE_CMD_LOGGING,     ///< The admin would like to have DoCommand information.
 	ADMIN_UPDATE_GAMESCRIPT,      ///< The admin would like to have gamescript messages.
+	ADMIN_UPDATE_STATS_STREAM,    ///< The admin would like to have the batched statistics stream.
 	ADMIN_UPDATE_END,             ///< Must ALWAYS be on the end of this list!! (period)
 };
 
@@ -97,6 +100,27 @@ enum AdminUpdateFrequency {
 };
 DECLARE_ENUM_AS_BIT_SET(AdminUpdateFrequency)
 
+/** Sections of the statistics stream an admin can subscribe to. */
+enum AdminStatsSection {
+	ADMIN_STATS_COMPANY_MONEY    = 0x01, ///< Money, loan and income of companies.
+	ADMIN_STATS_COMPANY_VEHICLES = 0x02, ///< Number of vehicles of companies, per vehicle type.
+	ADMIN_STATS_TICK_TIME        = 0x04, ///< Processing times of the game loop and its parts.
+	ADMIN_STATS_LINKGRAPH_JOBS   = 0x08, ///< Status of the link graph jobs.
+
+	ADMIN_STATS_ALL              = 0x0F, ///< All sections.
+};
+DECLARE_ENUM_AS_BIT_SET(AdminStatsSection)
+
+/** Fields of a company in the statistics stream, marking which of them have changed. */
+enum AdminStatsCompanyField {
+	ADMIN_STATS_FIELD_MONEY    = 0x01, ///< The amount of money.
+	ADMIN_STATS_FIELD_LOAN     = 0x02, ///< The loan.
+	ADMIN_STATS_FIELD_INCOME   = 0x04, ///< The income of the current year.
+	ADMIN_STATS_FIELD_VEHICLES = 0x08, ///< The number of vehicles.
+	ADMIN_STATS_FIELD_REMOVED  = 0x80, ///< The company does not exist (anymore).
+};
+DECLARE_ENUM_AS_BIT_SET(AdminStatsCompanyField)
+
 /** Reasons for removing a company - communicated to admins. */
 enum AdminCompanyRemoveReason {
 	ADMIN_CRR_MANUAL,    ///< The company is manually removed.
@@ -187,6 +211,17 @@ protected:
 	 */
 	virtual NetworkRecvStatus Receive_ADMIN_PING(Packet *p);
 
+	/**
+	 * Select what is sent in the statistics stream (see #ADMIN_UPDATE_STATS_STREAM).
+	 * The next stream packet will contain the complete state for the selection.
+	 * uint8   Sections to send (see #AdminStatsSection).
+	 * uint16  Bitmask of the companies to send the company sections for.
+	 * uint16  Interval in ticks between stream packets when #ADMIN_FREQUENCY_AUTOMATIC is registered; 0 for the default of a day.
+	 * @param p The packet that was just received.
+	 * @return The state the network should have.
+	 */
+	virtual NetworkRecvStatus Receive_ADMIN_STATS_FILTER(Packet *p);
+
 	/**
 	 * The server is full (connection gets closed).
 	 * @param p The packet that was just received.
@@ -477,6 +512,35 @@ protected:
 	 */
 	virtual NetworkRecvStatus Receive_SERVER_RCON_END(Packet *p);
 
+	/**
+	 * Send the changes in the statistics since the previous stream packet to the admin.
+	 * uint32  Current game date.
+	 * uint16  Current tick within the day.
+	 * uint8   Sections contained in this packet (see #AdminStatsSection).
+	 * For the company sections, a list of changed companies, each consisting of:
+	 *   uint8   ID of the company; INVALID_COMPANY terminates the list.
+	 *   uint8   Changed fields (see #AdminStatsCompanyField).
+	 *   uint64  Money, if changed.
+	 *   uint64  Loan, if changed.
+	 *   uint64  Income of the current year, if changed.
+	 *   uint16  Number of trains, road vehicles, ships and aircraft, if changed (4 times).
+	 * For #ADMIN_STATS_TICK_TIME:
+	 *   uint8   Number of timings, followed for each by:
+	 *   uint8   Performance element (see #PerformanceElement).
+	 *   uint32  Average processing time over the recent ticks in microseconds.
+	 * For #ADMIN_STATS_LINKGRAPH_JOBS:
+	 *   uint16  Number of link graphs waiting for a job.
+	 *   uint16  Number of running jobs, followed for each by:
+	 *   uint16  ID of the job.
+	 *   uint8   Cargo of the link graph.
+	 *   uint16  Number of nodes of the link graph.
+	 *   uint32  Number of ticks until the job is due to be joined (signed).
+	 *   bool    Whether the job has completed.
+	 * @param p The packet that was just received.
+	 * @return The state the network should have.
+	 */
+	virtual NetworkRecvStatus Receive_SERVER_STATS_STREAM(Packet *p);
+
 	NetworkRecvStatus HandlePacket(Packet *p);
 public:
 	NetworkRecvStatus CloseConnection(bool error = true) override;
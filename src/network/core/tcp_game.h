@@ -125,6 +125,7 @@ enum PacketGameType {
 	PACKET_CLIENT_DESYNC_LOG,            ///< A client reports a desync log
 	PACKET_SERVER_DESYNC_LOG,            ///< A server reports a desync log
 	PACKET_CLIENT_DESYNC_MSG,            ///< A client reports a desync message
+	PACKET_CLIENT_STATE_CHECKSUM_REQUEST, ///< A client requests a node of the checksum tree of the game state
 
 	PACKET_END,                          ///< Must ALWAYS be on the end of this list!! (period)
 };
@@ -362,6 +363,16 @@ protected:
 	 * uint32  Frame counter.
 	 * uint32  General seed 1.
 	 * uint32  General seed 2 (dependent on compile settings, not default).
+	 * uint64  State checksum.
+	 * Optionally followed by the checksum tree of the game state:
+	 * uint64  Checksums of the children of the root node of each subsystem (#SCS_END * #STATE_CHECKSUM_CHILDREN).
+	 * uint8   Number of requested nodes, each followed by:
+	 * uint8   Subsystem of the node.
+	 * uint8   Depth of the node.
+	 * uint32  Value of the node.
+	 * bool    Whether the node is a leaf; if so followed by a uint8 number of entities and
+	 *         a uint32 key and uint64 checksum of each entity, otherwise by the uint64
+	 *         checksums of the children of the node.
 	 * @param p The packet that was just received.
 	 */
 	virtual NetworkRecvStatus Receive_SERVER_SYNC(Packet *p);
@@ -452,6 +463,16 @@ protected:
 	virtual NetworkRecvStatus Receive_SERVER_DESYNC_LOG(Packet *p);
 	virtual NetworkRecvStatus Receive_CLIENT_DESYNC_MSG(Packet *p);
 
+	/**
+	 * The client requests the contents of a node of the checksum tree of the game state,
+	 * to be sent with the next sync packet:
+	 * uint8   Subsystem of the node.
+	 * uint8   Depth of the node.
+	 * uint32  Value of the node.
+	 * @param p The packet that was just received.
+	 */
+	virtual NetworkRecvStatus Receive_CLIENT_STATE_CHECKSUM_REQUEST(Packet *p);
+
 	/**
 	 * Notification that a client left the game:
 	 * uint32  ID of the client.
@@ -583,7 +604,7 @@ public:
 	NetworkRecvStatus ReceivePackets();
 
 	const char *ReceiveCommand(Packet *p, CommandPacket *cp);
-	void SendCommand(Packet *p, const CommandPacket *cp);
+	static void SendCommand(Packet *p, const CommandPacket *cp);
 
 	virtual std::string GetDebugInfo() const;
 	virtual void LogSentPacket(const Packet &pkt) override;
@@ -20,6 +20,9 @@
 #include "../map_func.h"
 #include "../rev.h"
 #include "../game/game.hpp"
+#include "../framerate_type.h"
+#include "../linkgraph/linkgraphschedule.h"
+#include "../linkgraph/linkgraphjob.h"
 
 #include "../safeguards.h"
 
@@ -52,6 +55,7 @@ static const AdminUpdateFrequency _admin_update_type_frequencies[] = {
 	ADMIN_FREQUENCY_POLL,                                                                                                                                  ///< ADMIN_UPDATE_CMD_NAMES
 	                       ADMIN_FREQUENCY_AUTOMATIC,                                                                                                      ///< ADMIN_UPDATE_CMD_LOGGING
 	                       ADMIN_FREQUENCY_AUTOMATIC,                                                                                                      ///< ADMIN_UPDATE_GAMESCRIPT
+	ADMIN_FREQUENCY_POLL | ADMIN_FREQUENCY_DAILY |                                                                   ADMIN_FREQUENCY_AUTOMATIC, ///< ADMIN_UPDATE_STATS_STREAM
 };
 /** Sanity check. */
 static_assert(lengthof(_admin_update_type_frequencies) == ADMIN_UPDATE_END);
@@ -462,6 +466,174 @@ NetworkRecvStatus ServerNetworkAdminSocketHandler::SendCompanyStats()
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
+/** Performance elements of which the timings are sent in the statistics stream. */
+static const PerformanceElement _admin_stats_tick_time_elements[] = {
+	PFE_GAMELOOP, PFE_GL_ECONOMY, PFE_GL_TRAINS, PFE_GL_ROADVEHS, PFE_GL_SHIPS, PFE_GL_AIRCRAFT, PFE_GL_LANDSCAPE, PFE_GL_LINKGRAPH, PFE_ALLSCRIPTS,
+};
+
+/** Number of most recent ticks the timings in the statistics stream are averaged over. */
+static const int ADMIN_STATS_TICK_TIME_POINTS = 32;
+
+/** Number of bytes a single link graph job takes in the statistics stream. */
+static const size_t ADMIN_STATS_JOB_SIZE = sizeof(uint16) + sizeof(uint8) + sizeof(uint16) + sizeof(uint32) + sizeof(bool);
+
+/**
+ * Copy of the game state that is sent in the statistics stream.
+ * It is gathered once per tick for all admins; encoding the stream packets
+ * only reads this plain data and never the game state itself.
+ */
+struct AdminStatsSnapshot {
+	/** State of a running link graph job. */
+	struct Job {
+		LinkGraphJobID id;       ///< ID of the job.
+		CargoID cargo;           ///< Cargo of the link graph.
+		uint16 size;             ///< Number of nodes of the link graph.
+		int32 ticks_until_join;  ///< Number of ticks until the job is due to be joined.
+		bool completed;          ///< Whether the job has finished its calculations.
+	};
+
+	Date date;                                                    ///< Date of the snapshot.
+	DateFract date_fract;                                         ///< Tick within the day of the snapshot.
+	AdminStatsCompany companies[MAX_COMPANIES];                   ///< Statistics per company.
+	std::vector<std::pair<PerformanceElement, uint32>> tick_times; ///< Average processing time in microseconds per performance element.
+	uint16 queued_link_graphs;                                    ///< Number of link graphs waiting for a job.
+	std::vector<Job> jobs;                                        ///< The running link graph jobs.
+
+	void Gather(AdminStatsSection sections);
+};
+
+/**
+ * Copy the current game state into the snapshot.
+ * @param sections The sections of the statistics stream that are going to be sent.
+ */
+void AdminStatsSnapshot::Gather(AdminStatsSection sections)
+{
+	this->date = _date;
+	this->date_fract = _date_fract;
+
+	for (AdminStatsCompany &stats : this->companies) stats = AdminStatsCompany();
+	if (sections & (ADMIN_STATS_COMPANY_MONEY | ADMIN_STATS_COMPANY_VEHICLES)) {
+		for (const Company *company : Company::Iterate()) {
+			AdminStatsCompany &stats = this->companies[company->index];
+			stats.valid = true;
+			stats.money = company->money;
+			stats.loan = company->current_loan;
+			for (uint i = 0; i < lengthof(company->yearly_expenses[0]); i++) {
+				stats.income -= company->yearly_expenses[0][i];
+			}
+			for (VehicleType type = VEH_BEGIN; type < VEH_COMPANY_END; type++) {
+				stats.num_vehicle[type] = company->group_all[type].num_vehicle;
+			}
+		}
+	}
+
+	this->tick_times.clear();
+	if (sections & ADMIN_STATS_TICK_TIME) {
+		for (PerformanceElement e : _admin_stats_tick_time_elements) {
+			double ms = GetPerformanceAverageDurationMilliseconds(e, ADMIN_STATS_TICK_TIME_POINTS);
+			if (ms < 0) continue;
+			this->tick_times.emplace_back(e, (uint32)(ms * 1000));
+		}
+	}
+
+	this->queued_link_graphs = 0;
+	this->jobs.clear();
+	if (sections & ADMIN_STATS_LINKGRAPH_JOBS) {
+		this->queued_link_graphs = (uint16)std::min<size_t>(UINT16_MAX, LinkGraphSchedule::instance.GetQueueSize());
+		DateTicks now = (_date * DAY_TICKS) + _date_fract;
+		for (const auto &job : LinkGraphSchedule::instance.GetRunningJobs()) {
+			this->jobs.push_back({ job->index, job->Cargo(), (uint16)std::min<uint>(UINT16_MAX, job->Size()), job->JoinDateTicks() - now, job->IsJobCompleted() });
+		}
+	}
+}
+
+/**
+ * Encode a statistics stream packet.
+ * Only the snapshot is read, so this does not need to run in the game loop.
+ * @param p The packet to write to.
+ * @param snapshot The current statistics.
+ * @param filter The selection of the admin the packet is for.
+ * @param sent The company statistics the admin has received so far; updated with what is written.
+ */
+static void WriteAdminStatsStream(Packet *p, const AdminStatsSnapshot &snapshot, const AdminStatsFilter &filter, AdminStatsCompany *sent)
+{
+	p->Send_uint32(snapshot.date);
+	p->Send_uint16(snapshot.date_fract);
+	p->Send_uint8(filter.sections);
+
+	if (filter.sections & (ADMIN_STATS_COMPANY_MONEY | ADMIN_STATS_COMPANY_VEHICLES)) {
+		for (CompanyID c = COMPANY_FIRST; c < MAX_COMPANIES; c++) {
+			if (!HasBit(filter.companies, c)) continue;
+
+			const AdminStatsCompany &cur = snapshot.companies[c];
+			AdminStatsCompany &prev = sent[c];
+
+			AdminStatsCompanyField changed = (AdminStatsCompanyField)0;
+			if (!cur.valid) {
+				if (prev.valid) changed = ADMIN_STATS_FIELD_REMOVED;
+			} else {
+				if (filter.sections & ADMIN_STATS_COMPANY_MONEY) {
+					if (!prev.valid || cur.money != prev.money) changed |= ADMIN_STATS_FIELD_MONEY;
+					if (!prev.valid || cur.loan != prev.loan) changed |= ADMIN_STATS_FIELD_LOAN;
+					if (!prev.valid || cur.income != prev.income) changed |= ADMIN_STATS_FIELD_INCOME;
+				}
+				if (filter.sections & ADMIN_STATS_COMPANY_VEHICLES) {
+					if (!prev.valid || memcmp(cur.num_vehicle, prev.num_vehicle, sizeof(cur.num_vehicle)) != 0) changed |= ADMIN_STATS_FIELD_VEHICLES;
+				}
+			}
+			prev = cur;
+			if (changed == 0) continue;
+
+			p->Send_uint8(c);
+			p->Send_uint8(changed);
+			if (changed & ADMIN_STATS_FIELD_MONEY) p->Send_uint64(cur.money);
+			if (changed & ADMIN_STATS_FIELD_LOAN) p->Send_uint64(cur.loan);
+			if (changed & ADMIN_STATS_FIELD_INCOME) p->Send_uint64(cur.income);
+			if (changed & ADMIN_STATS_FIELD_VEHICLES) {
+				for (uint16 num : cur.num_vehicle) p->Send_uint16(num);
+			}
+		}
+		p->Send_uint8(INVALID_COMPANY);
+	}
+
+	if (filter.sections & ADMIN_STATS_TICK_TIME) {
+		p->Send_uint8((uint8)snapshot.tick_times.size());
+		for (const auto &it : snapshot.tick_times) {
+			p->Send_uint8(it.first);
+			p->Send_uint32(it.second);
+		}
+	}
+
+	if (filter.sections & ADMIN_STATS_LINKGRAPH_JOBS) {
+		p->Send_uint16(snapshot.queued_link_graphs);
+
+		/* Send as many jobs as fit; the list is ordered by join date, so the most imminent ones are sent. */
+		size_t count = std::min<size_t>(snapshot.jobs.size(), (TCP_MTU - p->Size() - sizeof(uint16)) / ADMIN_STATS_JOB_SIZE);
+		p->Send_uint16((uint16)count);
+		for (size_t i = 0; i < count; i++) {
+			const AdminStatsSnapshot::Job &job = snapshot.jobs[i];
+			p->Send_uint16(job.id);
+			p->Send_uint8(job.cargo);
+			p->Send_uint16(job.size);
+			p->Send_uint32(job.ticks_until_join);
+			p->Send_bool(job.completed);
+		}
+	}
+}
+
+/**
+ * Send the changes in the statistics since the last stream packet.
+ * @param snapshot The current statistics.
+ */
+NetworkRecvStatus ServerNetworkAdminSocketHandler::SendStatsStream(const AdminStatsSnapshot &snapshot)
+{
+	Packet *p = new Packet(ADMIN_PACKET_SERVER_STATS_STREAM, TCP_MTU);
+	WriteAdminStatsStream(p, snapshot, this->stats_filter, this->stats_sent);
+	this->SendPacket(p);
+
+	return NETWORK_RECV_STATUS_OKAY;
+}
+
 /**
  * Send a chat message.
  * @param action The action associated with the message.
@@ -555,6 +727,28 @@ NetworkRecvStatus ServerNetworkAdminSocketHandler::Receive_ADMIN_PING(Packet *p)
 	return this->SendPong(d1);
 }
 
+NetworkRecvStatus ServerNetworkAdminSocketHandler::Receive_ADMIN_STATS_FILTER(Packet *p)
+{
+	if (this->status == ADMIN_STATUS_INACTIVE) return this->SendError(NETWORK_ERROR_NOT_EXPECTED);
+
+	AdminStatsSection sections = (AdminStatsSection)p->Recv_uint8();
+	CompanyMask companies = p->Recv_uint16();
+	uint16 interval = p->Recv_uint16();
+
+	if ((sections & ~ADMIN_STATS_ALL) != 0) {
+		DEBUG(net, 3, "[admin] Not supported stats sections %d from '%s' (%s).", sections, this->admin_name, this->admin_version);
+		return this->SendError(NETWORK_ERROR_ILLEGAL_PACKET);
+	}
+
+	this->stats_filter.sections = sections;
+	this->stats_filter.companies = companies;
+	this->stats_filter.interval = (interval == 0) ? DAY_TICKS : interval;
+	this->ResetStatsStream();
+	this->stats_ticks_left = 0;
+
+	return NETWORK_RECV_STATUS_OKAY;
+}
+
 /**
  * Send console output of other clients.
  * @param origin The origin of the string.
@@ -714,6 +908,10 @@ NetworkRecvStatus ServerNetworkAdminSocketHandler::Receive_ADMIN_UPDATE_FREQUENC
 	this->update_frequency[type] = freq;
 
 	if (type == ADMIN_UPDATE_CONSOLE) DebugReconsiderSendRemoteMessages();
+	if (type == ADMIN_UPDATE_STATS_STREAM) {
+		this->ResetStatsStream();
+		this->stats_ticks_left = 0;
+	}
 
 	return NETWORK_RECV_STATUS_OKAY;
 }
@@ -775,6 +973,15 @@ NetworkRecvStatus ServerNetworkAdminSocketHandler::Receive_ADMIN_POLL(Packet *p)
 			this->SendCmdNames();
 			break;
 
+		case ADMIN_UPDATE_STATS_STREAM: {
+			/* The admin is requesting the complete statistics. */
+			AdminStatsSnapshot snapshot;
+			snapshot.Gather(this->stats_filter.sections);
+			this->ResetStatsStream();
+			this->SendStatsStream(snapshot);
+			break;
+		}
+
 		default:
 			/* An unsupported "poll" update type. */
 			DEBUG(net, 3, "[admin] Not supported poll %d (%d) from '%s' (%s).", type, d1, this->admin_name, this->admin_version);
@@ -1023,9 +1230,41 @@ void NetworkAdminUpdate(AdminUpdateFrequency freq)
 						as->SendCompanyStats();
 						break;
 
+					case ADMIN_UPDATE_STATS_STREAM: {
+						AdminStatsSnapshot snapshot;
+						snapshot.Gather(as->stats_filter.sections);
+						as->SendStatsStream(snapshot);
+						break;
+					}
+
 					default: NOT_REACHED();
 				}
 			}
 		}
 	}
 }
+
+/**
+ * Send the statistics stream to the admins which asked for it automatically,
+ * every so many ticks as set in their filter. The game state is gathered
+ * only once per tick, for all admins that are due.
+ */
+void NetworkAdminStatsStreamTick()
+{
+	AdminStatsSection sections = (AdminStatsSection)0;
+	for (ServerNetworkAdminSocketHandler *as : ServerNetworkAdminSocketHandler::IterateActive()) {
+		if (!(as->update_frequency[ADMIN_UPDATE_STATS_STREAM] & ADMIN_FREQUENCY_AUTOMATIC)) continue;
+		if (as->stats_ticks_left > 0) as->stats_ticks_left--;
+		if (as->stats_ticks_left == 0) sections |= as->stats_filter.sections;
+	}
+	if (sections == 0) return;
+
+	AdminStatsSnapshot snapshot;
+	snapshot.Gather(sections);
+
+	for (ServerNetworkAdminSocketHandler *as : ServerNetworkAdminSocketHandler::IterateActive()) {
+		if (!(as->update_frequency[ADMIN_UPDATE_STATS_STREAM] & ADMIN_FREQUENCY_AUTOMATIC) || as->stats_ticks_left != 0) continue;
+		as->SendStatsStream(snapshot);
+		as->stats_ticks_left = as->stats_filter.interval;
+	}
+}
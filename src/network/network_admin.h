@@ -13,9 +13,30 @@
 #include "network_internal.h"
 #include "core/tcp_listen.h"
 #include "core/tcp_admin.h"
+#include "../date_type.h"
+#include "../economy_type.h"
+#include "../vehicle_type.h"
 
 extern AdminIndex _redirect_console_to_admin;
 
+/** Selection of the statistics stream an admin has subscribed to. */
+struct AdminStatsFilter {
+	AdminStatsSection sections = ADMIN_STATS_ALL;    ///< Sections to send.
+	CompanyMask companies = (CompanyMask)UINT16_MAX; ///< Companies to send the company sections for.
+	uint16 interval = DAY_TICKS;                     ///< Number of ticks between automatic stream packets.
+};
+
+/** Statistics of a single company as sent in the statistics stream. */
+struct AdminStatsCompany {
+	bool valid = false;                         ///< Whether the company exists.
+	Money money = 0;                            ///< Amount of money.
+	Money loan = 0;                             ///< Amount of money borrowed.
+	Money income = 0;                           ///< Income of the current year.
+	uint16 num_vehicle[VEH_COMPANY_END] = {};   ///< Number of vehicles per vehicle type.
+};
+
+struct AdminStatsSnapshot;
+
 class ServerNetworkAdminSocketHandler;
 /** Pool with all admin connections. */
 typedef Pool<ServerNetworkAdminSocketHandler, AdminIndex, 2, MAX_ADMINS, PT_NADMIN> NetworkAdminSocketPool;
@@ -32,6 +53,7 @@ protected:
 	NetworkRecvStatus Receive_ADMIN_RCON(Packet *p) override;
 	NetworkRecvStatus Receive_ADMIN_GAMESCRIPT(Packet *p) override;
 	NetworkRecvStatus Receive_ADMIN_PING(Packet *p) override;
+	NetworkRecvStatus Receive_ADMIN_STATS_FILTER(Packet *p) override;
 
 	NetworkRecvStatus SendProtocol();
 	NetworkRecvStatus SendPong(uint32 d1);
@@ -39,10 +61,21 @@ public:
 	AdminUpdateFrequency update_frequency[ADMIN_UPDATE_END]; ///< Admin requested update intervals.
 	std::chrono::steady_clock::time_point connect_time;      ///< Time of connection.
 	NetworkAddress address;                                  ///< Address of the admin.
+	AdminStatsFilter stats_filter;                           ///< Selection of the statistics stream.
+	AdminStatsCompany stats_sent[MAX_COMPANIES];             ///< Company statistics as last sent in the statistics stream.
+	uint16 stats_ticks_left = 0;                             ///< Ticks until the next automatic statistics stream packet.
 
 	ServerNetworkAdminSocketHandler(SOCKET s);
 	~ServerNetworkAdminSocketHandler();
 
+	/**
+	 * Forget what has been sent in the statistics stream, so the next stream packet contains the complete state.
+	 */
+	void ResetStatsStream()
+	{
+		for (AdminStatsCompany &stats : this->stats_sent) stats = AdminStatsCompany();
+	}
+
 	NetworkRecvStatus SendError(NetworkErrorCode error);
 	NetworkRecvStatus SendWelcome();
 	NetworkRecvStatus SendNewGame();
@@ -68,6 +101,7 @@ public:
 	NetworkRecvStatus SendCmdNames();
 	NetworkRecvStatus SendCmdLogging(ClientID client_id, const CommandPacket *cp);
 	NetworkRecvStatus SendRconEnd(const char *command);
+	NetworkRecvStatus SendStatsStream(const AdminStatsSnapshot &snapshot);
 
 	static void Send();
 	static void AcceptConnection(SOCKET s, const NetworkAddress &address);
@@ -112,5 +146,6 @@ void NetworkServerSendAdminRcon(AdminIndex admin_index, TextColour colour_code,
 void NetworkAdminConsole(const char *origin, const char *string);
 void NetworkAdminGameScript(const char *json);
 void NetworkAdminCmdLogging(const NetworkClientSocket *owner, const CommandPacket *cp);
+void NetworkAdminStatsStreamTick();
 
 #endif /* NETWORK_ADMIN_H */
@@ -33,6 +33,7 @@
 #include "../core/checksum_func.hpp"
 #include "../fileio_func.h"
 #include "../debug_settings.h"
+#include "../state_checksum.h"
 
 #include "table/strings.h"
 
@@ -144,6 +145,22 @@ void ClientNetworkEmergencySave()
 	SaveOrLoad(filename, SLO_SAVE, DFT_GAME_FILE, AUTOSAVE_DIR, false, SMF_ZSTD_OK);
 }
 
+/** Checksum tree of the game state received from the server, for the next sync frame. */
+struct SyncStateChecksumTree {
+	bool valid = false;                                                       ///< Whether a checksum tree was received.
+	StateChecksumTree tree;                                                   ///< Checksums of the children of the root nodes.
+	std::vector<std::pair<StateChecksumNode, StateChecksumNodeContents>> nodes; ///< Contents of the requested nodes.
+};
+
+static SyncStateChecksumTree _sync_state_checksum_tree; ///< Checksum tree for the next sync frame.
+static StateChecksumNode _state_checksum_request;        ///< Node of the checksum tree requested from the server.
+static bool _state_checksum_request_pending = false;     ///< Whether #_state_checksum_request is pending.
+static bool _state_checksum_entity_found = false;        ///< Whether the first diverging entity has been reported.
+static uint _state_checksum_desync_syncs_left = 0;       ///< Number of sync frames to stay connected after a desync, to locate it. 0 when not desynced.
+
+/** Maximum number of sync frames to stay connected after a desync, to descend the checksum tree with a retry per level. */
+static const uint STATE_CHECKSUM_DESYNC_MAX_SYNCS = 2 * STATE_CHECKSUM_MAX_DEPTH + 2;
+
 
 /**
  * Create a new socket for the client side of the game connection.
@@ -155,6 +172,11 @@ ClientNetworkGameSocketHandler::ClientNetworkGameSocketHandler (SOCKET s)
 {
 	assert(ClientNetworkGameSocketHandler::my_client == nullptr);
 	ClientNetworkGameSocketHandler::my_client = this;
+
+	_sync_state_checksum_tree.valid = false;
+	_state_checksum_request_pending = false;
+	_state_checksum_entity_found = false;
+	_state_checksum_desync_syncs_left = 0;
 }
 
 /** Clear whatever we assigned. */
@@ -294,6 +316,130 @@ void ClientNetworkGameSocketHandler::ClientError(NetworkRecvStatus res)
 	my_client->CheckConnection();
 }
 
+/**
+ * Report a difference between the game state of the server and of this client.
+ * @param msg The message.
+ */
+static void ReportStateChecksumMismatch(const char *msg)
+{
+	DEBUG(desync, 0, "State checksum mismatch: %s", msg);
+	MyClient::SendDesyncMessage(msg);
+}
+
+/**
+ * Request the contents of a node of the checksum tree from the server.
+ * @param node The node.
+ */
+static void RequestStateChecksumNode(const StateChecksumNode &node)
+{
+	_state_checksum_request = node;
+	_state_checksum_request_pending = true;
+	MyClient::SendStateChecksumRequest(node);
+}
+
+/**
+ * Compare the contents of a node of the checksum tree received from the server with the local game state.
+ * Either request the first diverging child, or report the first diverging entity.
+ * @param node The node.
+ * @param remote The contents of the node at the server.
+ */
+static void CompareStateChecksumNode(const StateChecksumNode &node, const StateChecksumNodeContents &remote)
+{
+	StateChecksumNodeContents local;
+	CalculateStateChecksumNode(node, local);
+	_state_checksum_request_pending = false;
+
+	char buffer[256];
+	const char *subsystem = GetStateChecksumSubsystemName(node.subsystem);
+	if (remote.leaf != local.leaf) {
+		seprintf(buffer, lastof(buffer), "%s: different number of entities in node with depth %u, value 0x%X", subsystem, node.depth, node.value);
+		ReportStateChecksumMismatch(buffer);
+		_state_checksum_entity_found = true;
+		return;
+	}
+
+	if (!remote.leaf) {
+		for (uint c = 0; c < STATE_CHECKSUM_CHILDREN; c++) {
+			if (remote.children[c] != local.children[c]) {
+				RequestStateChecksumNode(node.GetChild(c));
+				return;
+			}
+		}
+		DEBUG(desync, 1, "State checksums of %s match again", subsystem);
+		return;
+	}
+
+	/* Find the entity with the lowest key which differs, or which only exists on one side. */
+	auto r = remote.entities.begin();
+	auto l = local.entities.begin();
+	while (r != remote.entities.end() || l != local.entities.end()) {
+		const char *difference = nullptr;
+		uint32 key;
+		if (l == local.entities.end() || (r != remote.entities.end() && r->first < l->first)) {
+			key = r->first;
+			difference = "missing on client";
+		} else if (r == remote.entities.end() || l->first < r->first) {
+			key = l->first;
+			difference = "missing on server";
+		} else {
+			key = r->first;
+			if (r->second != l->second) difference = "differs";
+		}
+
+		if (difference != nullptr) {
+			char *b = buffer + seprintf(buffer, lastof(buffer), "%s: ", subsystem);
+			b = DescribeStateChecksumEntity(b, lastof(buffer), node.subsystem, key);
+			seprintf(b, lastof(buffer), " %s", difference);
+			ReportStateChecksumMismatch(buffer);
+			_state_checksum_entity_found = true;
+			return;
+		}
+		++r;
+		++l;
+	}
+	DEBUG(desync, 1, "State checksums of %s match again", subsystem);
+}
+
+/**
+ * Compare the checksum tree of the game state received from the server for this sync frame with the local game state.
+ * A difference is reported per subsystem, and then located by descending the tree
+ * at the following sync frames, until the first diverging entity is found.
+ */
+static void CheckStateChecksumTree()
+{
+	SyncStateChecksumTree &sync = _sync_state_checksum_tree;
+	if (!sync.valid) return;
+	sync.valid = false;
+
+	if (_state_checksum_request_pending) {
+		for (const auto &it : sync.nodes) {
+			if (it.first == _state_checksum_request) {
+				CompareStateChecksumNode(it.first, it.second);
+				return;
+			}
+		}
+		/* The server did not answer the request in time, ask again. */
+		MyClient::SendStateChecksumRequest(_state_checksum_request);
+		return;
+	}
+	if (_state_checksum_entity_found) return;
+
+	StateChecksumTree local;
+	CalculateStateChecksumTree(local);
+	for (uint s = 0; s < SCS_END; s++) {
+		for (uint c = 0; c < STATE_CHECKSUM_CHILDREN; c++) {
+			if (sync.tree.subsystems[s][c] == local.subsystems[s][c]) continue;
+
+			char buffer[128];
+			seprintf(buffer, lastof(buffer), "%s, node 0x%X", GetStateChecksumSubsystemName((StateChecksumSubsystem)s), c);
+			ReportStateChecksumMismatch(buffer);
+			const StateChecksumNode root = { (StateChecksumSubsystem)s, 0, 0 };
+			RequestStateChecksumNode(root.GetChild(c));
+			return;
+		}
+	}
+}
+
 /**
  * Actual game loop for the client.
  * @return Whether everything went okay, or not.
@@ -311,30 +457,43 @@ void ClientNetworkGameSocketHandler::ClientError(NetworkRecvStatus res)
 	if (_sync_frame != 0) {
 		if (_sync_frame == _frame_counter) {
 #ifdef NETWORK_SEND_DOUBLE_SEED
-			if (_sync_seed_1 != _random.state[0] || _sync_seed_2 != _random.state[1] || (_sync_state_checksum != _state_checksum.state && !HasChickenBit(DCBF_MP_NO_STATE_CSUM_CHECK))) {
+			if (_sync_seed_1 != _random.state[0] || _sync_seed_2 != _random.state[1] || (_sync_state_checksum != _state_checksum.state && !HasChickenBit(DCBF_MP_NO_STATE_CSUM_CHECK)) || _state_checksum_desync_syncs_left != 0) {
 #else
-			if (_sync_seed_1 != _random.state[0] || (_sync_state_checksum != _state_checksum.state && !HasChickenBit(DCBF_MP_NO_STATE_CSUM_CHECK))) {
+			if (_sync_seed_1 != _random.state[0] || (_sync_state_checksum != _state_checksum.state && !HasChickenBit(DCBF_MP_NO_STATE_CSUM_CHECK)) || _state_checksum_desync_syncs_left != 0) {
 #endif
-				DesyncExtraInfo info;
-				if (_sync_seed_1 != _random.state[0]) info.flags |= DesyncExtraInfo::DEIF_RAND1;
+				if (_state_checksum_desync_syncs_left == 0) {
+					DesyncExtraInfo info;
+					if (_sync_seed_1 != _random.state[0]) info.flags |= DesyncExtraInfo::DEIF_RAND1;
 #ifdef NETWORK_SEND_DOUBLE_SEED
-				if (_sync_seed_2 != _random.state[1]) info.flags |= DesyncExtraInfo::DEIF_RAND2;
-				info.flags |= DesyncExtraInfo::DEIF_DBL_RAND;
+					if (_sync_seed_2 != _random.state[1]) info.flags |= DesyncExtraInfo::DEIF_RAND2;
+					info.flags |= DesyncExtraInfo::DEIF_DBL_RAND;
 #endif
-				if (_sync_state_checksum != _state_checksum.state) info.flags |= DesyncExtraInfo::DEIF_STATE;
-
-				NetworkError(STR_NETWORK_ERROR_DESYNC);
-				DEBUG(desync, 1, "sync_err: date{%08x; %02x; %02x} {%x, " OTTD_PRINTFHEX64 "} != {%x, " OTTD_PRINTFHEX64 "}"
-						, _date, _date_fract, _tick_skip_counter, _sync_seed_1, _sync_state_checksum, _random.state[0], _state_checksum.state);
-				DEBUG(net, 0, "Sync error detected!");
-
-				std::string desync_log;
-				info.log_file = &(my_client->desync_log_file);
-				CrashLog::DesyncCrashLog(nullptr, &desync_log, info);
-				my_client->SendDesyncLog(desync_log);
-				my_client->ClientError(NETWORK_RECV_STATUS_DESYNC);
-				return false;
+					if (_sync_state_checksum != _state_checksum.state) info.flags |= DesyncExtraInfo::DEIF_STATE;
+
+					DEBUG(desync, 1, "sync_err: date{%08x; %02x; %02x} {%x, " OTTD_PRINTFHEX64 "} != {%x, " OTTD_PRINTFHEX64 "}"
+							, _date, _date_fract, _tick_skip_counter, _sync_seed_1, _sync_state_checksum, _random.state[0], _state_checksum.state);
+					DEBUG(net, 0, "Sync error detected!");
+
+					std::string desync_log;
+					info.log_file = &(my_client->desync_log_file);
+					CrashLog::DesyncCrashLog(nullptr, &desync_log, info);
+					my_client->SendDesyncLog(desync_log);
+					_state_checksum_desync_syncs_left = STATE_CHECKSUM_DESYNC_MAX_SYNCS;
+				}
+
+				/* When the server sends the checksum tree, stay connected for some more
+				 * sync frames, so the tree can be descended to the first diverging entity. */
+				CheckStateChecksumTree();
+				if (!_state_checksum_request_pending || --_state_checksum_desync_syncs_left == 0) {
+					_state_checksum_desync_syncs_left = 0;
+					NetworkError(STR_NETWORK_ERROR_DESYNC);
+					my_client->ClientError(NETWORK_RECV_STATUS_DESYNC);
+					return false;
+				}
+				_sync_frame = 0;
+				return true;
 			}
+			CheckStateChecksumTree();
 			_last_sync_date = _date;
 			_last_sync_date_fract = _date_fract;
 			_last_sync_tick_skip_counter = _tick_skip_counter;
@@ -492,6 +651,7 @@ NetworkRecvStatus ClientNetworkGameSocketHandler::SendGetMap()
 #else
 	p->Send_bool(false);
 #endif
+	p->Send_bool(_settings_client.network.compress_game_stream && NetworkStreamCompressor::IsSupported());
 	my_client->SendPacket(p);
 	return NETWORK_RECV_STATUS_OKAY;
 }
@@ -586,6 +746,20 @@ NetworkRecvStatus ClientNetworkGameSocketHandler::SendDesyncMessage(const char *
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
+/**
+ * Request the contents of a node of the checksum tree of the game state, with the next sync packet.
+ * @param node The node.
+ */
+NetworkRecvStatus ClientNetworkGameSocketHandler::SendStateChecksumRequest(const StateChecksumNode &node)
+{
+	Packet *p = new Packet(PACKET_CLIENT_STATE_CHECKSUM_REQUEST, SHRT_MAX);
+	p->Send_uint8(node.subsystem);
+	p->Send_uint8(node.depth);
+	p->Send_uint32(node.value);
+	my_client->SendPacket(p);
+	return NETWORK_RECV_STATUS_OKAY;
+}
+
 /**
  * Tell the server that we like to change the password of the company.
  * @param password The new password.
@@ -949,6 +1123,8 @@ NetworkRecvStatus ClientNetworkGameSocketHandler::Receive_SERVER_MAP_BEGIN(Packe
 	this->savegame = new PacketReader();
 
 	_frame_counter = _frame_counter_server = _frame_counter_max = p->Recv_uint32();
+	this->compress_game_stream = p->Recv_bool();
+	if (this->compress_game_stream && !NetworkStreamCompressor::IsSupported()) return NETWORK_RECV_STATUS_MALFORMED_PACKET;
 
 	_network_join_bytes = 0;
 	_network_join_bytes_total = 0;
@@ -989,6 +1165,9 @@ NetworkRecvStatus ClientNetworkGameSocketHandler::Receive_SERVER_MAP_DONE(Packet
 	if (this->status != STATUS_MAP) return NETWORK_RECV_STATUS_MALFORMED_PACKET;
 	if (this->savegame == nullptr) return NETWORK_RECV_STATUS_MALFORMED_PACKET;
 
+	/* The server compresses everything it sends after this packet. */
+	if (this->compress_game_stream) this->StartReceiveCompression(GetNetworkGameStreamDictionary());
+
 	_network_join_status = NETWORK_JOIN_STATUS_PROCESSING;
 	SetWindowDirty(WC_NETWORK_STATUS_WINDOW, WN_NETWORK_STATUS_WINDOW_JOIN);
 
@@ -1088,6 +1267,41 @@ NetworkRecvStatus ClientNetworkGameSocketHandler::Receive_SERVER_SYNC(Packet *p)
 #endif
 	_sync_state_checksum = p->Recv_uint64();
 
+	SyncStateChecksumTree &sync = _sync_state_checksum_tree;
+	sync.valid = p->CanReadFromPacket(sizeof(uint64));
+	sync.nodes.clear();
+	if (sync.valid) {
+		for (uint s = 0; s < SCS_END; s++) {
+			for (uint c = 0; c < STATE_CHECKSUM_CHILDREN; c++) {
+				sync.tree.subsystems[s][c] = p->Recv_uint64();
+			}
+		}
+
+		uint8 count = p->Recv_uint8();
+		for (uint i = 0; i < count; i++) {
+			StateChecksumNode node;
+			node.subsystem = (StateChecksumSubsystem)p->Recv_uint8();
+			node.depth = p->Recv_uint8();
+			node.value = p->Recv_uint32();
+			if (!node.IsValid()) return NETWORK_RECV_STATUS_MALFORMED_PACKET;
+
+			StateChecksumNodeContents contents;
+			contents.leaf = p->Recv_bool();
+			if (contents.leaf) {
+				uint8 entities = p->Recv_uint8();
+				for (uint j = 0; j < entities; j++) {
+					uint32 key = p->Recv_uint32();
+					contents.entities.emplace_back(key, p->Recv_uint64());
+				}
+			} else {
+				for (uint c = 0; c < STATE_CHECKSUM_CHILDREN; c++) {
+					contents.children[c] = p->Recv_uint64();
+				}
+			}
+			sync.nodes.emplace_back(node, std::move(contents));
+		}
+	}
+
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
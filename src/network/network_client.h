@@ -12,6 +12,8 @@
 
 #include "network_internal.h"
 
+struct StateChecksumNode;
+
 /** Class for handling the client side of the game connection. */
 class ClientNetworkGameSocketHandler : public NetworkGameSocketHandler {
 private:
@@ -39,6 +41,7 @@ private:
 	FILE *desync_log_file = nullptr;
 	std::string server_desync_log;
 	bool emergency_save_done = false;
+	bool compress_game_stream = false; ///< The server compresses the game stream after the map download.
 
 	static const char *GetServerStatusName(ServerStatus status);
 
@@ -97,6 +100,7 @@ public:
 	static NetworkRecvStatus SendError(NetworkErrorCode errorno, NetworkRecvStatus recvstatus = NETWORK_RECV_STATUS_OKAY);
 	static NetworkRecvStatus SendDesyncLog(const std::string &log);
 	static NetworkRecvStatus SendDesyncMessage(const char *msg);
+	static NetworkRecvStatus SendStateChecksumRequest(const StateChecksumNode &node);
 	static NetworkRecvStatus SendQuit();
 	static NetworkRecvStatus SendAck();
 
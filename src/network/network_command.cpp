@@ -202,7 +202,7 @@ void NetworkSyncCommandQueue(NetworkClientSocket *cs)
 	for (CommandPacket *p = _local_execution_queue.Peek(); p != nullptr; p = p->next) {
 		CommandPacket c = *p;
 		c.callback = 0;
-		cs->outgoing_queue.Append(std::move(c));
+		cs->outgoing_queue.push_back(Packet::Share(ServerNetworkGameSocketHandler::NewCommandPacket(&c)));
 	}
 }
 
@@ -258,13 +258,25 @@ static void DistributeCommandPacket(CommandPacket &cp, const NetworkClientSocket
 	CommandCallback *callback = cp.callback;
 	cp.frame = _frame_counter_max + 1;
 
+	/* Every client except the owner receives exactly the same bytes, so serialise that version once. */
+	SharedPacket shared;
+
 	for (NetworkClientSocket *cs : NetworkClientSocket::Iterate()) {
 		if (cs->status >= NetworkClientSocket::STATUS_MAP) {
 			/* Callbacks are only send back to the client who sent them in the
 			 *  first place. This filters that out. */
-			cp.callback = (cs != owner) ? nullptr : callback;
-			cp.my_cmd = (cs == owner);
-			cs->outgoing_queue.Append(cp);
+			if (cs == owner) {
+				cp.callback = callback;
+				cp.my_cmd = true;
+				cs->outgoing_queue.push_back(Packet::Share(ServerNetworkGameSocketHandler::NewCommandPacket(&cp)));
+			} else {
+				if (shared == nullptr) {
+					cp.callback = nullptr;
+					cp.my_cmd = false;
+					shared = Packet::Share(ServerNetworkGameSocketHandler::NewCommandPacket(&cp));
+				}
+				cs->outgoing_queue.push_back(shared);
+			}
 		}
 	}
 
@@ -306,6 +318,63 @@ void NetworkDistributeCommands()
 	}
 }
 
+/**
+ * Get the preset dictionary for compressing the game stream after joining.
+ * It consists of the packets which make up most of that stream: frames, syncs
+ * and commands of the commands which are sent most often, with the most common
+ * last as those are the cheapest to refer to. It is generated from the packet
+ * layout itself, so it is the same on the server and the client.
+ * @return The dictionary.
+ */
+const std::vector<byte> &GetNetworkGameStreamDictionary()
+{
+	static std::vector<byte> dictionary;
+	if (!dictionary.empty()) return dictionary;
+
+	auto append = [&](Packet &p) {
+		p.PrepareToSend();
+		dictionary.insert(dictionary.end(), p.GetBufferData(), p.GetBufferData() + p.Size());
+	};
+
+	static const Commands commands[] = {
+		CMD_INSERT_ORDER,
+		CMD_START_STOP_VEHICLE,
+		CMD_TERRAFORM_LAND,
+		CMD_LANDSCAPE_CLEAR,
+		CMD_CLEAR_AREA,
+		CMD_BUILD_LONG_ROAD,
+		CMD_BUILD_SIGNAL_TRACK,
+		CMD_BUILD_SINGLE_RAIL,
+		CMD_BUILD_RAILROAD_TRACK,
+	};
+	for (Commands cmd : commands) {
+		CommandPacket cp;
+		cp.company = COMPANY_FIRST;
+		cp.tile = 0;
+		cp.p1 = 0;
+		cp.p2 = 0;
+		cp.p3 = 0;
+		cp.cmd = cmd;
+		cp.callback = nullptr;
+		cp.binary_length = 0;
+		std::unique_ptr<Packet> p = ServerNetworkGameSocketHandler::NewCommandPacket(&cp);
+		append(*p);
+	}
+
+	Packet sync(PACKET_SERVER_SYNC, SHRT_MAX);
+	sync.Send_uint32(0);
+	sync.Send_uint32(0);
+	sync.Send_uint64(0);
+	append(sync);
+
+	Packet frame(PACKET_SERVER_FRAME, SHRT_MAX);
+	frame.Send_uint32(0);
+	frame.Send_uint32(0);
+	append(frame);
+
+	return dictionary;
+}
+
 /**
  * Receives a command from the network.
  * @param p the packet to read from.
@@ -29,6 +29,7 @@
 #include "../core/random_func.hpp"
 #include "../rev.h"
 #include "../crashlog.h"
+#include "../state_checksum.h"
 #include <mutex>
 #include <condition_variable>
 #if defined(__MINGW32__)
@@ -626,9 +627,12 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendMap()
 		WaitTillSaved();
 		this->savegame = new PacketWriter(this);
 
+		this->compress_game_stream = this->supports_stream_compression && _settings_client.network.compress_game_stream && NetworkStreamCompressor::IsSupported();
+
 		/* Now send the _frame_counter and how many packets are coming */
 		Packet *p = new Packet(PACKET_SERVER_MAP_BEGIN, SHRT_MAX);
 		p->Send_uint32(_frame_counter);
+		p->Send_bool(this->compress_game_stream);
 		this->SendPacket(p);
 
 		NetworkSyncCommandQueue(this);
@@ -650,6 +654,9 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendMap()
 			this->savegame->Destroy();
 			this->savegame = nullptr;
 
+			/* Everything after PACKET_SERVER_MAP_DONE is compressed, when the client asked for that. */
+			if (this->compress_game_stream) this->StartSendCompression(GetNetworkGameStreamDictionary());
+
 			/* Set the status to DONE_MAP, no we will wait for the client
 			 *  to send it is ready (maybe that happens like never ;)) */
 			this->status = STATUS_DONE_MAP;
@@ -674,10 +681,13 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendJoin(ClientID client_id)
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
-/** Tell the client that they may run to a particular frame. */
-NetworkRecvStatus ServerNetworkGameSocketHandler::SendFrame()
+/**
+ * Create the part of the frame packet which is the same for every client.
+ * @return The new packet.
+ */
+static std::unique_ptr<Packet> NewFramePacket()
 {
-	Packet *p = new Packet(PACKET_SERVER_FRAME, SHRT_MAX);
+	std::unique_ptr<Packet> p(new Packet(PACKET_SERVER_FRAME, SHRT_MAX));
 	p->Send_uint32(_frame_counter);
 	p->Send_uint32(_frame_counter_max);
 #ifdef ENABLE_NETWORK_SYNC_EVERY_FRAME
@@ -687,46 +697,124 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendFrame()
 #endif
 	p->Send_uint64(_sync_state_checksum);
 #endif
+	return p;
+}
 
-	/* If token equals 0, we need to make a new token and send that. */
+/**
+ * Tell the client that they may run to a particular frame.
+ * @param shared_frame Frame packet shared between all clients which do not need a new token, it is created when still nullptr.
+ */
+NetworkRecvStatus ServerNetworkGameSocketHandler::SendFrame(SharedPacket &shared_frame)
+{
+	/* If token equals 0, we need to make a new token and send that.
+	 * This makes the packet specific to this client, so it can not be shared. */
 	if (this->last_token == 0) {
+		std::unique_ptr<Packet> p = NewFramePacket();
 		this->last_token = InteractiveRandomRange(UINT8_MAX - 1) + 1;
 		p->Send_uint8(this->last_token);
+		this->SendPacket(std::move(p));
+		return NETWORK_RECV_STATUS_OKAY;
 	}
 
-	this->SendPacket(p);
+	if (shared_frame == nullptr) shared_frame = Packet::Share(NewFramePacket());
+	this->SendSharedPacket(shared_frame);
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
-/** Request the client to sync. */
-NetworkRecvStatus ServerNetworkGameSocketHandler::SendSync()
+/** Tell the client that they may run to a particular frame. */
+NetworkRecvStatus ServerNetworkGameSocketHandler::SendFrame()
 {
-	Packet *p = new Packet(PACKET_SERVER_SYNC, SHRT_MAX);
-	p->Send_uint32(_frame_counter);
-	p->Send_uint32(_sync_seed_1);
+	SharedPacket shared_frame;
+	return this->SendFrame(shared_frame);
+}
+
+/** Nodes of the checksum tree of the game state requested by clients, to be sent with the next sync packet. */
+static std::vector<StateChecksumNode> _state_checksum_requests;
+
+/** Maximum number of nodes of the checksum tree sent with a sync packet. */
+static const uint MAX_STATE_CHECKSUM_REQUESTS = 16;
+
+/**
+ * Append the checksum tree of the game state, and the contents of the nodes requested by clients, to a sync packet.
+ * @param p The sync packet.
+ */
+static void SendStateChecksumTree(Packet *p)
+{
+	StateChecksumTree tree;
+	CalculateStateChecksumTree(tree);
+	for (uint s = 0; s < SCS_END; s++) {
+		for (uint c = 0; c < STATE_CHECKSUM_CHILDREN; c++) {
+			p->Send_uint64(tree.subsystems[s][c]);
+		}
+	}
+
+	p->Send_uint8((uint8)_state_checksum_requests.size());
+	StateChecksumNodeContents contents;
+	for (const StateChecksumNode &node : _state_checksum_requests) {
+		CalculateStateChecksumNode(node, contents);
+		p->Send_uint8(node.subsystem);
+		p->Send_uint8(node.depth);
+		p->Send_uint32(node.value);
+		p->Send_bool(contents.leaf);
+		if (contents.leaf) {
+			p->Send_uint8((uint8)contents.entities.size());
+			for (const auto &entity : contents.entities) {
+				p->Send_uint32(entity.first);
+				p->Send_uint64(entity.second);
+			}
+		} else {
+			for (uint c = 0; c < STATE_CHECKSUM_CHILDREN; c++) {
+				p->Send_uint64(contents.children[c]);
+			}
+		}
+	}
+	_state_checksum_requests.clear();
+}
+
+/**
+ * Request the client to sync.
+ * @param shared_sync Sync packet shared between all clients, it is created when still nullptr.
+ */
+NetworkRecvStatus ServerNetworkGameSocketHandler::SendSync(SharedPacket &shared_sync)
+{
+	if (shared_sync == nullptr) {
+		std::unique_ptr<Packet> p(new Packet(PACKET_SERVER_SYNC, SHRT_MAX));
+		p->Send_uint32(_frame_counter);
+		p->Send_uint32(_sync_seed_1);
 
 #ifdef NETWORK_SEND_DOUBLE_SEED
-	p->Send_uint32(_sync_seed_2);
+		p->Send_uint32(_sync_seed_2);
 #endif
-	p->Send_uint64(_sync_state_checksum);
-	this->SendPacket(p);
+		p->Send_uint64(_sync_state_checksum);
+		if (_settings_client.network.sync_state_checksum_tree) SendStateChecksumTree(p.get());
+		shared_sync = Packet::Share(std::move(p));
+	}
+
+	this->SendSharedPacket(shared_sync);
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
+/** Request the client to sync. */
+NetworkRecvStatus ServerNetworkGameSocketHandler::SendSync()
+{
+	SharedPacket shared_sync;
+	return this->SendSync(shared_sync);
+}
+
 /**
- * Send a command to the client to execute.
+ * Create the packet for sending a command to a client to execute.
  * @param cp The command to send.
+ * @return The new packet, ready to be shared between clients.
  */
-NetworkRecvStatus ServerNetworkGameSocketHandler::SendCommand(const CommandPacket *cp)
+/* static */ std::unique_ptr<Packet> ServerNetworkGameSocketHandler::NewCommandPacket(const CommandPacket *cp)
 {
-	Packet *p = new Packet(PACKET_SERVER_COMMAND, SHRT_MAX);
+	std::unique_ptr<Packet> p(new Packet(PACKET_SERVER_COMMAND, SHRT_MAX));
 
-	this->NetworkGameSocketHandler::SendCommand(p, cp);
+	NetworkGameSocketHandler::SendCommand(p.get(), cp);
 	p->Send_uint32(cp->frame);
 	p->Send_bool  (cp->my_cmd);
 
-	this->SendPacket(p);
-	return NETWORK_RECV_STATUS_OKAY;
+	return p;
 }
 
 /**
@@ -1049,6 +1137,7 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::Receive_CLIENT_GETMAP(Packet *
 	}
 
 	this->supports_zstd = p->Recv_bool();
+	this->supports_stream_compression = p->Recv_bool();
 
 	/* Check if someone else is receiving the map */
 	for (NetworkClientSocket *new_cs : NetworkClientSocket::Iterate()) {
@@ -1253,6 +1342,29 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::Receive_CLIENT_DESYNC_MSG(Pack
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
+NetworkRecvStatus ServerNetworkGameSocketHandler::Receive_CLIENT_STATE_CHECKSUM_REQUEST(Packet *p)
+{
+	if (this->status < STATUS_AUTHORIZED) {
+		/* Illegal call, return error and ignore the packet */
+		return this->SendError(NETWORK_ERROR_NOT_AUTHORIZED);
+	}
+
+	StateChecksumNode node;
+	node.subsystem = (StateChecksumSubsystem)p->Recv_uint8();
+	node.depth = p->Recv_uint8();
+	node.value = p->Recv_uint32();
+	if (!node.IsValid()) return NETWORK_RECV_STATUS_MALFORMED_PACKET;
+
+	if (!_settings_client.network.sync_state_checksum_tree) return NETWORK_RECV_STATUS_OKAY;
+
+	DEBUG(desync, 2, "Client-id %d requested state checksum node: %s, depth %u, value 0x%X", this->client_id, GetStateChecksumSubsystemName(node.subsystem), node.depth, node.value);
+	if (_state_checksum_requests.size() < MAX_STATE_CHECKSUM_REQUESTS &&
+			std::find(_state_checksum_requests.begin(), _state_checksum_requests.end(), node) == _state_checksum_requests.end()) {
+		_state_checksum_requests.push_back(node);
+	}
+	return NETWORK_RECV_STATUS_OKAY;
+}
+
 NetworkRecvStatus ServerNetworkGameSocketHandler::Receive_CLIENT_QUIT(Packet *p)
 {
 	/* The client wants to leave. Display this and report it to the other
@@ -1899,10 +2011,10 @@ void NetworkServerSetCompanyPassword(CompanyID company_id, const char *password,
  */
 static void NetworkHandleCommandQueue(NetworkClientSocket *cs)
 {
-	std::unique_ptr<CommandPacket> cp;
-	while ((cp = cs->outgoing_queue.Pop()) != nullptr) {
-		cs->SendCommand(cp.get());
+	for (SharedPacket &p : cs->outgoing_queue) {
+		cs->SendSharedPacket(std::move(p));
 	}
+	cs->outgoing_queue.clear();
 }
 
 /**
@@ -1922,6 +2034,10 @@ void NetworkServer_Tick(bool send_frame)
 	}
 #endif
 
+	/* The frame and sync packets are the same for most clients, so only serialise them once. */
+	SharedPacket shared_frame;
+	SharedPacket shared_sync;
+
 	/* Now we are done with the frame, inform the clients that they can
 	 *  do their frame! */
 	for (NetworkClientSocket *cs : NetworkClientSocket::Iterate()) {
@@ -2035,15 +2151,17 @@ void NetworkServer_Tick(bool send_frame)
 			NetworkHandleCommandQueue(cs);
 
 			/* Send an updated _frame_counter_max to the client */
-			if (send_frame) cs->SendFrame();
+			if (send_frame) cs->SendFrame(shared_frame);
 
 #ifndef ENABLE_NETWORK_SYNC_EVERY_FRAME
 			/* Send a sync-check packet */
-			if (send_sync) cs->SendSync();
+			if (send_sync) cs->SendSync(shared_sync);
 #endif
 		}
 	}
 
+	NetworkAdminStatsStreamTick();
+
 	/* See if we need to advertise */
 	NetworkUDPAdvertise();
 }
@@ -2108,6 +2226,12 @@ void NetworkServerShowStatusToConsole()
 			cs->client_id, ci->client_name, status, lag,
 			ci->client_playas + (Company::IsValidID(ci->client_playas) ? 1 : 0),
 			cs->GetClientIP());
+
+		const NetworkStreamCompressionStats *stats = cs->GetSendCompressionStats();
+		if (stats != nullptr) {
+			IConsolePrintF(CC_INFO, "    stream compression: " OTTD_PRINTF64U " bytes to " OTTD_PRINTF64U " bytes (%.1f%%), " OTTD_PRINTF64U " ms",
+				stats->raw_bytes, stats->compressed_bytes, stats->GetRatio() * 100, stats->time_us / 1000);
+		}
 	}
 }
 
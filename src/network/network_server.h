@@ -39,6 +39,7 @@ protected:
 	NetworkRecvStatus Receive_CLIENT_ERROR(Packet *p) override;
 	NetworkRecvStatus Receive_CLIENT_DESYNC_LOG(Packet *p) override;
 	NetworkRecvStatus Receive_CLIENT_DESYNC_MSG(Packet *p) override;
+	NetworkRecvStatus Receive_CLIENT_STATE_CHECKSUM_REQUEST(Packet *p) override;
 	NetworkRecvStatus Receive_CLIENT_RCON(Packet *p) override;
 	NetworkRecvStatus Receive_CLIENT_NEWGRFS_CHECKED(Packet *p) override;
 	NetworkRecvStatus Receive_CLIENT_MOVE(Packet *p) override;
@@ -72,13 +73,15 @@ public:
 	byte last_token;             ///< The last random token we did send to verify the client is listening
 	uint32 last_token_frame;     ///< The last frame we received the right token
 	ClientStatus status;         ///< Status of this client
-	CommandQueue outgoing_queue; ///< The command-queue awaiting delivery
+	std::vector<SharedPacket> outgoing_queue; ///< The serialised commands awaiting delivery
 	size_t receive_limit;        ///< Amount of bytes that we can receive at this moment
 	uint32 server_hash_bits;     ///< Server password hash entropy bits
 	uint32 rcon_hash_bits;       ///< Rcon password hash entropy bits
 	uint32 settings_hash_bits;   ///< Settings password hash entropy bits
 	bool settings_authed = false;///< Authorised to control all game settings
 	bool supports_zstd = false;  ///< Client supports zstd compression
+	bool supports_stream_compression = false; ///< Client requested compression of the game stream after the map download
+	bool compress_game_stream = false;        ///< The game stream to this client is compressed after the map download
 
 	struct PacketWriter *savegame; ///< Writer used to write the savegame.
 	NetworkAddress client_address; ///< IP-address of the client (so they can be banned)
@@ -109,8 +112,11 @@ public:
 	NetworkRecvStatus SendChat(NetworkAction action, ClientID client_id, bool self_send, const char *msg, NetworkTextMessageData data);
 	NetworkRecvStatus SendJoin(ClientID client_id);
 	NetworkRecvStatus SendFrame();
+	NetworkRecvStatus SendFrame(SharedPacket &shared_frame);
 	NetworkRecvStatus SendSync();
-	NetworkRecvStatus SendCommand(const CommandPacket *cp);
+	NetworkRecvStatus SendSync(SharedPacket &shared_sync);
+
+	static std::unique_ptr<Packet> NewCommandPacket(const CommandPacket *cp);
 	NetworkRecvStatus SendCompanyUpdate();
 	NetworkRecvStatus SendConfigUpdate();
 	NetworkRecvStatus SendSettingsAccessUpdate(bool ok);
@@ -34,6 +34,7 @@
 #include "newgrf_airport.h"
 #include "newgrf_object.h"
 #include "newgrf_newsignals.h"
+#include "newgrf_load_cache.h"
 #include "rev.h"
 #include "fios.h"
 #include "strings_func.h"
@@ -9931,7 +9932,7 @@ static void FinaliseAirportsArray()
  * XXX: We consider GRF files trusted. It would be trivial to exploit OTTD by
  * a crafted invalid GRF file. We should tell that to the user somehow, or
  * better make this more robust in the future. */
-static void DecodeSpecialSprite(byte *buf, uint num, GrfLoadingStage stage)
+static void DecodeSpecialSprite(byte *buf, uint num, GrfLoadingStage stage, bool preloaded = false)
 {
 	/* XXX: There is a difference between staged loading in TTDPatch and
 	 * here.  In TTDPatch, for some reason actions 1 and 2 are carried out
@@ -9974,15 +9975,15 @@ static void DecodeSpecialSprite(byte *buf, uint num, GrfLoadingStage stage)
 	GRFLineToSpriteOverride::iterator it = _grf_line_to_action6_sprite_override.find(location);
 	if (it == _grf_line_to_action6_sprite_override.end()) {
 		/* No preloaded sprite to work with; read the
-		 * pseudo sprite content. */
-		_cur.file->ReadBlock(buf, num);
+		 * pseudo sprite content, unless it came from the load cache. */
+		if (!preloaded) _cur.file->ReadBlock(buf, num);
 	} else {
 		/* Use the preloaded sprite data. */
 		buf = it->second;
 		grfmsg(7, "DecodeSpecialSprite: Using preloaded pseudo sprite data");
 
 		/* Skip the real (original) content of this action. */
-		_cur.file->SeekTo(num, SEEK_CUR);
+		if (!preloaded) _cur.file->SeekTo(num, SEEK_CUR);
 	}
 
 	ByteReader br(buf, buf + num);
@@ -10009,6 +10010,108 @@ static void DecodeSpecialSprite(byte *buf, uint num, GrfLoadingStage stage)
 	}
 }
 
+/**
+ * Process the sprites of a NewGRF from the current position of the file until the end of the sprite stream.
+ * @param stage The loading stage of the NewGRF.
+ * @param file  The file to load the GRF data from.
+ */
+static void LoadNewGRFSpritesFromFile(GrfLoadingStage stage, SpriteFile &file)
+{
+	byte grf_container_version = file.GetContainerVersion();
+	ReusableBuffer<byte> buf;
+	uint32 num;
+
+	while ((num = (grf_container_version >= 2 ? file.ReadDword() : file.ReadWord())) != 0) {
+		byte type = file.ReadByte();
+		_cur.nfo_line++;
+
+		if (type == 0xFF) {
+			if (_cur.skip_sprites == 0) {
+				DecodeSpecialSprite(buf.Allocate(num), num, stage);
+
+				/* Stop all processing if we are to skip the remaining sprites */
+				if (_cur.skip_sprites == -1) break;
+
+				continue;
+			} else {
+				file.SkipBytes(num);
+			}
+		} else {
+			if (_cur.skip_sprites == 0) {
+				grfmsg(0, "LoadNewGRFFile: Unexpected sprite, disabling");
+				DisableGrf(STR_NEWGRF_ERROR_UNEXPECTED_SPRITE);
+				break;
+			}
+
+			if (grf_container_version >= 2 && type == 0xFD) {
+				/* Reference to data section. Container version >= 2 only. */
+				file.SkipBytes(num);
+			} else {
+				file.SkipBytes(7);
+				SkipSpriteData(file, type, num - 8);
+			}
+		}
+
+		if (_cur.skip_sprites > 0) _cur.skip_sprites--;
+	}
+}
+
+/**
+ * Process the sprites of a NewGRF using its pre-parsed sprite stream.
+ * This behaves exactly like #LoadNewGRFSpritesFromFile, but the file is only
+ * accessed by the action handlers themselves, e.g. to load real sprites.
+ * @param stage The loading stage of the NewGRF.
+ * @param file  The file of the NewGRF.
+ * @param cache The pre-parsed sprite stream of the file.
+ */
+static void LoadNewGRFSpritesFromCache(GrfLoadingStage stage, SpriteFile &file, const GRFLoadCache &cache)
+{
+	const size_t base = file.GetContentBegin();
+	ReusableBuffer<byte> buf;
+
+	size_t i = 0;
+	while (i < cache.sprites.size()) {
+		const GRFLoadCacheSprite &sprite = cache.sprites[i];
+		_cur.nfo_line++;
+
+		if (sprite.type == 0xFF) {
+			if (_cur.skip_sprites == 0) {
+				/* Handlers expect the file to be positioned just after the pseudo sprite. */
+				file.SeekTo(base + sprite.next_pos, SEEK_SET);
+				byte *data = buf.Allocate(sprite.num);
+				memcpy(data, cache.data.data() + sprite.data_offset, sprite.num);
+				DecodeSpecialSprite(data, sprite.num, stage, true);
+
+				/* Stop all processing if we are to skip the remaining sprites */
+				if (_cur.skip_sprites == -1) break;
+
+				/* Handlers may have read the following sprites or jumped to a label, so continue where the file is now. */
+				size_t pos = file.GetPos() - base;
+				if (pos == sprite.next_pos) {
+					i++;
+				} else if (pos == cache.end_pos) {
+					break;
+				} else {
+					i = cache.FindSprite(pos);
+					if (i == SIZE_MAX) {
+						/* Not at the start of a sprite; let the file tell what comes next. */
+						LoadNewGRFSpritesFromFile(stage, file);
+						return;
+					}
+				}
+				continue;
+			}
+		} else if (_cur.skip_sprites == 0) {
+			grfmsg(0, "LoadNewGRFFile: Unexpected sprite, disabling");
+			DisableGrf(STR_NEWGRF_ERROR_UNEXPECTED_SPRITE);
+			break;
+		}
+
+		if (_cur.skip_sprites > 0) _cur.skip_sprites--;
+		i++;
+	}
+}
+
 /**
  * Load a particular NewGRF from a SpriteFile.
  * @param config The configuration of the to be loaded NewGRF.
@@ -10028,6 +10131,17 @@ static void LoadNewGRFFileFromFile(GRFConfig *config, GrfLoadingStage stage, Spr
 		return;
 	}
 
+	const GRFLoadCache *cache = GetGRFLoadCache(config, file);
+	if (cache != nullptr) {
+		/* We need the sprite offsets in the init stage for NewGRF sounds
+		 * and in the activation stage for real sprites. */
+		if (stage == GLS_INIT || stage == GLS_ACTIVATION) SetGRFSpriteOffsets(cache->sprite_offsets, file.GetContentBegin());
+
+		_cur.ClearDataForNextFile();
+		LoadNewGRFSpritesFromCache(stage, file, *cache);
+		return;
+	}
+
 	if (stage == GLS_INIT || stage == GLS_ACTIVATION) {
 		/* We need the sprite offsets in the init stage for NewGRF sounds
 		 * and in the activation stage for real sprites. */
@@ -10059,41 +10173,7 @@ static void LoadNewGRFFileFromFile(GRFConfig *config, GrfLoadingStage stage, Spr
 
 	_cur.ClearDataForNextFile();
 
-	ReusableBuffer<byte> buf;
-
-	while ((num = (grf_container_version >= 2 ? file.ReadDword() : file.ReadWord())) != 0) {
-		byte type = file.ReadByte();
-		_cur.nfo_line++;
-
-		if (type == 0xFF) {
-			if (_cur.skip_sprites == 0) {
-				DecodeSpecialSprite(buf.Allocate(num), num, stage);
-
-				/* Stop all processing if we are to skip the remaining sprites */
-				if (_cur.skip_sprites == -1) break;
-
-				continue;
-			} else {
-				file.SkipBytes(num);
-			}
-		} else {
-			if (_cur.skip_sprites == 0) {
-				grfmsg(0, "LoadNewGRFFile: Unexpected sprite, disabling");
-				DisableGrf(STR_NEWGRF_ERROR_UNEXPECTED_SPRITE);
-				break;
-			}
-
-			if (grf_container_version >= 2 && type == 0xFD) {
-				/* Reference to data section. Container version >= 2 only. */
-				file.SkipBytes(num);
-			} else {
-				file.SkipBytes(7);
-				SkipSpriteData(file, type, num - 8);
-			}
-		}
-
-		if (_cur.skip_sprites > 0) _cur.skip_sprites--;
-	}
+	LoadNewGRFSpritesFromFile(stage, file);
 }
 
 /**
@@ -10548,6 +10628,7 @@ void LoadNewGRF(uint load_index, uint num_baseset)
 
 	/* Pseudo sprite processing is finished; free temporary stuff */
 	_cur.ClearDataForNextFile();
+	ClearGRFLoadCaches();
 
 	/* Call any functions that should be run after GRFs have been loaded. */
 	AfterLoadGRFs();
@@ -26,6 +26,7 @@
 
 #include "fileio_func.h"
 #include "fios.h"
+#include "file_md5_index.h"
 
 #include "thread.h"
 #include <mutex>
@@ -336,8 +337,12 @@ struct GRFMD5SumState {
 	GRFConfig *config;
 	size_t size;
 	FILE *f;
+	FileMD5IndexKey key;
 };
 
+/** Index of the MD5 sums of NewGRFs, so unchanged files need not be hashed at every scan. */
+static FileMD5Index _grf_md5_index("newgrf_md5.idx");
+
 static uint _grf_md5_parallel = 0;
 static uint _grf_md5_threads = 0;
 static std::mutex _grf_md5_lock;
@@ -358,6 +363,7 @@ static void CalcGRFMD5SumFromState(const GRFMD5SumState &state)
 		checksum.Append(buffer, len);
 	}
 	checksum.Finish(state.config->ident.md5sum);
+	_grf_md5_index.Add(state.key, state.config->ident.md5sum);
 
 	FioFCloseFile(state.f);
 }
@@ -409,11 +415,19 @@ void CalcGRFMD5ThreadingEnd()
 static bool CalcGRFMD5Sum(GRFConfig *config, Subdirectory subdir)
 {
 	size_t size;
+	std::string path;
 
 	/* open the file */
-	FILE *f = FioFOpenFile(config->filename, "rb", subdir, &size);
+	FILE *f = FioFOpenFile(config->filename, "rb", subdir, &size, &path);
 	if (f == nullptr) return false;
 
+	/* use the indexed md5sum when the file did not change since it was calculated */
+	FileMD5IndexKey key(path);
+	if (_grf_md5_index.Find(key, config->ident.md5sum)) {
+		FioFCloseFile(f);
+		return true;
+	}
+
 	long start = ftell(f);
 	size = std::min(size, GRFGetSizeOfDataSection(f));
 
@@ -423,7 +437,7 @@ static bool CalcGRFMD5Sum(GRFConfig *config, Subdirectory subdir)
 	}
 
 	/* calculate md5sum */
-	GRFMD5SumState state { config, size, f };
+	GRFMD5SumState state { config, size, f, std::move(key) };
 	if (_grf_md5_parallel == 0) {
 		CalcGRFMD5SumFromState(state);
 		return true;
@@ -689,6 +703,7 @@ public:
 		fs.grfs.clear();
 		int ret = fs.Scan(".grf", NEWGRF_DIR);
 		CalcGRFMD5ThreadingEnd();
+		if (!_exit_game) _grf_md5_index.Save();
 
 		for (GRFConfig *c : fs.grfs) {
 			bool added = true;
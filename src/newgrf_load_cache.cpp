@@ -0,0 +1,341 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file newgrf_load_cache.cpp Cache of the pre-parsed sprite stream of NewGRF files.
+ *
+ * A NewGRF is read once per loading stage. Every time the whole sprite stream
+ * is walked, pseudo sprites are read and compressed real sprites are decoded
+ * just to find their end. The cache stores the result of one such walk, keyed
+ * by the MD5 sum of the file, both in memory and on disk in the personal
+ * directory. As the key is the content of the file, a changed file never
+ * matches an old cache entry.
+ */
+
+#include "stdafx.h"
+#include "debug.h"
+#include "fileio_func.h"
+#include "newgrf_config.h"
+#include "newgrf_load_cache.h"
+#include "string_func.h"
+#include "core/endian_func.hpp"
+
+#include <map>
+#include <memory>
+#include <array>
+
+#include "safeguards.h"
+
+/** Magic at the start of a cache file. */
+static const char GRF_LOAD_CACHE_MAGIC[8] = { 'O', 'T', 'T', 'D', 'G', 'R', 'F', 'C' };
+/** Version of the format of the cache files; increase when changing the format. */
+static const uint32 GRF_LOAD_CACHE_VERSION = 1;
+
+typedef std::array<uint8, 16> GRFLoadCacheKey;
+
+/** The caches which have been loaded or created during the current run of the loading stages. */
+static std::map<GRFLoadCacheKey, std::unique_ptr<GRFLoadCache>> _grf_load_caches;
+
+/**
+ * Find the sprite whose header is at the given position.
+ * @param pos Position relative to the begin of the content of the file.
+ * @return Index of the sprite, or SIZE_MAX when no sprite starts at the position.
+ */
+size_t GRFLoadCache::FindSprite(size_t pos) const
+{
+	auto it = std::lower_bound(this->sprites.begin(), this->sprites.end(), pos, [](const GRFLoadCacheSprite &sprite, size_t pos) {
+		return sprite.pos < pos;
+	});
+	if (it == this->sprites.end() || it->pos != pos) return SIZE_MAX;
+	return it - this->sprites.begin();
+}
+
+/**
+ * Walk the sprite stream of a NewGRF, like the loading stages do, and record everything they read.
+ * @param file The file to read.
+ * @return The cache, or nullptr when the file is not in a format the loading stages accept.
+ */
+static std::unique_ptr<GRFLoadCache> BuildGRFLoadCache(SpriteFile &file)
+{
+	const size_t base = file.GetContentBegin();
+	const byte container_version = file.GetContainerVersion();
+	file.SeekToBegin();
+
+	std::unique_ptr<GRFLoadCache> cache(new GRFLoadCache());
+
+	if (container_version >= 2) {
+		ReadGRFSpriteOffsets(file);
+		cache->sprite_offsets = GetGRFSpriteOffsets(base);
+
+		if (file.ReadByte() != 0) return nullptr; // Unsupported compression.
+	}
+
+	uint32 num = container_version >= 2 ? file.ReadDword() : file.ReadWord();
+	if (num != 4 || file.ReadByte() != 0xFF) return nullptr;
+	file.ReadDword();
+
+	for (;;) {
+		size_t pos = file.GetPos() - base;
+		num = container_version >= 2 ? file.ReadDword() : file.ReadWord();
+		if (num == 0) {
+			cache->end_pos = (uint32)pos;
+			break;
+		}
+
+		GRFLoadCacheSprite sprite;
+		sprite.pos = (uint32)pos;
+		sprite.num = num;
+		sprite.type = file.ReadByte();
+		sprite.data_offset = 0;
+
+		if (sprite.type == 0xFF) {
+			sprite.data_offset = (uint32)cache->data.size();
+			cache->data.resize(cache->data.size() + num);
+			file.ReadBlock(cache->data.data() + sprite.data_offset, num);
+		} else if (container_version >= 2 && sprite.type == 0xFD) {
+			file.SkipBytes(num);
+		} else {
+			file.SkipBytes(7);
+			SkipSpriteData(file, sprite.type, num - 8);
+		}
+
+		sprite.next_pos = (uint32)(file.GetPos() - base);
+		cache->sprites.push_back(sprite);
+	}
+
+	file.SeekToBegin();
+	return cache;
+}
+
+/**
+ * Get the name of the file the cache of a NewGRF is stored in.
+ * @param key The MD5 sum of the NewGRF.
+ * @return The filename.
+ */
+static std::string GetGRFLoadCacheFilename(const GRFLoadCacheKey &key)
+{
+	char md5[33];
+	md5sumToString(md5, lastof(md5), key.data());
+	return _personal_dir + "cache" PATHSEP "newgrf" PATHSEP + md5 + ".grfcache";
+}
+
+/** Helper for writing the cache file in little endian format. */
+struct GRFLoadCacheWriter {
+	std::vector<byte> buffer; ///< The data to write.
+
+	void Write(const void *data, size_t size)
+	{
+		const byte *bytes = (const byte *)data;
+		this->buffer.insert(this->buffer.end(), bytes, bytes + size);
+	}
+
+	void WriteByte(byte value) { this->buffer.push_back(value); }
+
+	void WriteDword(uint32 value)
+	{
+		value = TO_LE32(value);
+		this->Write(&value, sizeof(value));
+	}
+};
+
+/** Helper for reading the cache file in little endian format, which checks against reading past the end. */
+struct GRFLoadCacheReader {
+	const byte *pos; ///< Current position.
+	const byte *end; ///< End of the data.
+	bool failed;     ///< Whether an attempt was made to read past the end.
+
+	GRFLoadCacheReader(const std::vector<byte> &data) : pos(data.data()), end(data.data() + data.size()), failed(false) {}
+
+	bool Read(void *data, size_t size)
+	{
+		if ((size_t)(this->end - this->pos) < size) {
+			this->failed = true;
+			return false;
+		}
+		memcpy(data, this->pos, size);
+		this->pos += size;
+		return true;
+	}
+
+	byte ReadByte()
+	{
+		byte value = 0;
+		this->Read(&value, sizeof(value));
+		return value;
+	}
+
+	uint32 ReadDword()
+	{
+		uint32 value = 0;
+		this->Read(&value, sizeof(value));
+		return FROM_LE32(value);
+	}
+};
+
+/**
+ * Store a cache on disk. Failing to do so is not an error; it only makes the next start slower.
+ * @param key The MD5 sum of the NewGRF.
+ * @param container_version The container version of the NewGRF.
+ * @param cache The cache to store.
+ */
+static void SaveGRFLoadCache(const GRFLoadCacheKey &key, byte container_version, const GRFLoadCache &cache)
+{
+	if (_personal_dir.empty()) return;
+
+	GRFLoadCacheWriter w;
+	w.Write(GRF_LOAD_CACHE_MAGIC, sizeof(GRF_LOAD_CACHE_MAGIC));
+	w.WriteDword(GRF_LOAD_CACHE_VERSION);
+	w.Write(key.data(), key.size());
+	w.WriteByte(container_version);
+	w.WriteDword(cache.end_pos);
+
+	w.WriteDword((uint32)cache.sprites.size());
+	for (const GRFLoadCacheSprite &sprite : cache.sprites) {
+		w.WriteDword(sprite.pos);
+		w.WriteDword(sprite.next_pos);
+		w.WriteDword(sprite.num);
+		w.WriteDword(sprite.data_offset);
+		w.WriteByte(sprite.type);
+	}
+
+	w.WriteDword((uint32)cache.sprite_offsets.size());
+	for (const auto &it : cache.sprite_offsets) {
+		w.WriteDword(it.first);
+		w.WriteDword((uint32)it.second.file_pos);
+		w.WriteDword(it.second.count);
+		w.WriteByte(it.second.has_non_palette ? 1 : 0);
+	}
+
+	w.WriteDword((uint32)cache.data.size());
+	w.Write(cache.data.data(), cache.data.size());
+
+	std::string filename = GetGRFLoadCacheFilename(key);
+	FioCreateDirectory(_personal_dir + "cache" PATHSEP);
+	FioCreateDirectory(_personal_dir + "cache" PATHSEP "newgrf" PATHSEP);
+
+	/* A partially written file is rejected when loading, as its data does not add up. */
+	FILE *f = FioFOpenFile(filename, "wb", NO_DIRECTORY);
+	if (f == nullptr) {
+		DEBUG(grf, 1, "Could not create NewGRF load cache file %s", filename.c_str());
+		return;
+	}
+	if (fwrite(w.buffer.data(), 1, w.buffer.size(), f) != w.buffer.size()) {
+		DEBUG(grf, 1, "Could not write NewGRF load cache file %s", filename.c_str());
+	}
+	FioFCloseFile(f);
+}
+
+/**
+ * Load a cache from disk.
+ * @param key The MD5 sum of the NewGRF.
+ * @param file The NewGRF to validate the cache against.
+ * @return The cache, or nullptr when there is no valid cache on disk.
+ */
+static std::unique_ptr<GRFLoadCache> LoadGRFLoadCache(const GRFLoadCacheKey &key, SpriteFile &file)
+{
+	if (_personal_dir.empty()) return nullptr;
+
+	std::string filename = GetGRFLoadCacheFilename(key);
+	size_t size;
+	FILE *f = FioFOpenFile(filename, "rb", NO_DIRECTORY, &size);
+	if (f == nullptr) return nullptr;
+
+	/* Read the whole file at once; it is parsed from memory. */
+	std::vector<byte> data(size);
+	if (fread(data.data(), 1, data.size(), f) != data.size()) data.clear();
+	FioFCloseFile(f);
+
+	GRFLoadCacheReader r(data);
+	char magic[sizeof(GRF_LOAD_CACHE_MAGIC)];
+	GRFLoadCacheKey stored_key;
+	if (!r.Read(magic, sizeof(magic)) || memcmp(magic, GRF_LOAD_CACHE_MAGIC, sizeof(magic)) != 0) return nullptr;
+	if (r.ReadDword() != GRF_LOAD_CACHE_VERSION) return nullptr;
+	if (!r.Read(stored_key.data(), stored_key.size()) || stored_key != key) return nullptr;
+	if (r.ReadByte() != file.GetContainerVersion()) return nullptr;
+
+	std::unique_ptr<GRFLoadCache> cache(new GRFLoadCache());
+	cache->end_pos = r.ReadDword();
+
+	uint32 count = r.ReadDword();
+	if (r.failed || count > data.size()) return nullptr;
+	cache->sprites.resize(count);
+	for (GRFLoadCacheSprite &sprite : cache->sprites) {
+		sprite.pos = r.ReadDword();
+		sprite.next_pos = r.ReadDword();
+		sprite.num = r.ReadDword();
+		sprite.data_offset = r.ReadDword();
+		sprite.type = r.ReadByte();
+	}
+
+	count = r.ReadDword();
+	if (r.failed || count > data.size()) return nullptr;
+	cache->sprite_offsets.resize(count);
+	for (auto &it : cache->sprite_offsets) {
+		it.first = r.ReadDword();
+		it.second.file_pos = r.ReadDword();
+		it.second.count = r.ReadDword();
+		it.second.has_non_palette = r.ReadByte() != 0;
+	}
+
+	count = r.ReadDword();
+	if (r.failed || count > data.size()) return nullptr;
+	cache->data.resize(count);
+	if (!r.Read(cache->data.data(), count)) return nullptr;
+
+	/* Make sure the data is consistent, so loading never reads outside of it. */
+	for (const GRFLoadCacheSprite &sprite : cache->sprites) {
+		if (sprite.type == 0xFF && (uint64)sprite.data_offset + sprite.num > cache->data.size()) return nullptr;
+	}
+
+	/* Cheap check whether the cache matches the file: the sprite stream must end where the cache says it does. */
+	const size_t base = file.GetContentBegin();
+	file.SeekTo(base + cache->end_pos, SEEK_SET);
+	uint32 terminator = file.GetContainerVersion() >= 2 ? file.ReadDword() : file.ReadWord();
+	file.SeekToBegin();
+	if (terminator != 0) return nullptr;
+
+	return cache;
+}
+
+/**
+ * Get the pre-parsed sprite stream of a NewGRF. When it is not known yet, it is
+ * loaded from disk, or created from the file and then stored on disk.
+ * @param config The NewGRF to get the cache of.
+ * @param file The opened file of the NewGRF.
+ * @return The cache, or nullptr when the NewGRF cannot be cached.
+ */
+const GRFLoadCache *GetGRFLoadCache(const GRFConfig *config, SpriteFile &file)
+{
+	GRFLoadCacheKey key;
+	std::copy(std::begin(config->ident.md5sum), std::end(config->ident.md5sum), key.begin());
+
+	/* Without a known MD5 sum there is nothing to identify the content with. */
+	if (std::all_of(key.begin(), key.end(), [](uint8 b) { return b == 0; })) return nullptr;
+
+	auto it = _grf_load_caches.find(key);
+	if (it != _grf_load_caches.end()) return it->second.get();
+
+	std::unique_ptr<GRFLoadCache> cache = LoadGRFLoadCache(key, file);
+	if (cache != nullptr) {
+		DEBUG(grf, 3, "Using NewGRF load cache for '%s'", config->GetDisplayPath());
+	} else {
+		/* Files which cannot be cached are remembered as such, so they are not walked again for every stage. */
+		cache = BuildGRFLoadCache(file);
+		if (cache != nullptr) SaveGRFLoadCache(key, file.GetContainerVersion(), *cache);
+	}
+
+	return _grf_load_caches.emplace(key, std::move(cache)).first->second.get();
+}
+
+/**
+ * Free the in-memory caches. They are only needed while running the loading
+ * stages; the next load reads them from disk again.
+ */
+void ClearGRFLoadCaches()
+{
+	_grf_load_caches.clear();
+}
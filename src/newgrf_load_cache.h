@@ -0,0 +1,44 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file newgrf_load_cache.h Cache of the pre-parsed sprite stream of NewGRF files. */
+
+#ifndef NEWGRF_LOAD_CACHE_H
+#define NEWGRF_LOAD_CACHE_H
+
+#include "spritecache.h"
+#include <vector>
+
+struct GRFConfig;
+
+/** A sprite in the sprite stream of a NewGRF. */
+struct GRFLoadCacheSprite {
+	uint32 pos;         ///< Position of the header of the sprite, relative to the begin of the content of the file.
+	uint32 next_pos;    ///< Position of the header of the next sprite, relative to the begin of the content of the file.
+	uint32 num;         ///< Size of the sprite as given in its header.
+	uint32 data_offset; ///< Offset of the content of a pseudo sprite in #GRFLoadCache::data.
+	byte type;          ///< Type of the sprite, 0xFF for pseudo sprites.
+};
+
+/**
+ * Pre-parsed sprite stream of a NewGRF file.
+ * It contains everything that is read from the file in the loading stages,
+ * except for real sprites, so the stages can be run without (re)reading the file.
+ */
+struct GRFLoadCache {
+	uint32 end_pos;                                                ///< Position of the terminator of the sprite stream, relative to the begin of the content.
+	std::vector<GRFLoadCacheSprite> sprites;                       ///< All sprites after the sprite count, in file order.
+	std::vector<byte> data;                                        ///< The content of all pseudo sprites.
+	std::vector<std::pair<uint32, GrfSpriteOffset>> sprite_offsets; ///< Offsets of the sprite section, relative to the begin of the content.
+
+	size_t FindSprite(size_t pos) const;
+};
+
+const GRFLoadCache *GetGRFLoadCache(const GRFConfig *config, SpriteFile &file);
+void ClearGRFLoadCaches();
+
+#endif /* NEWGRF_LOAD_CACHE_H */
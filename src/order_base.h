@@ -588,6 +588,7 @@ private:
 	friend void AfterLoadVehicles(bool part_of_load); ///< For instantiating the shared vehicle chain
 	friend const struct SaveLoad *GetOrderListDescription(); ///< Saving and loading of order lists.
 	friend void Ptrs_ORDL(); ///< Saving and loading of order lists.
+	friend class LinkRefresher; ///< For caching refresh plans.
 
 	StationID GetBestLoadableNext(const Vehicle *v, const Order *o1, const Order *o2) const;
 	void ReindexOrderList();
@@ -610,6 +611,8 @@ private:
 	int32 scheduled_dispatch_last_dispatch;    ///< Last vehicle dispatched offset
 	int32 scheduled_dispatch_max_delay;        ///< Maximum allowed delay
 
+	std::shared_ptr<struct LinkRefreshPlanCache> link_refresh_cache; ///< NOSAVE: Link refresh plans of vehicles sharing this order list.
+
 public:
 	/** Default constructor producing an invalid order list. */
 	OrderList(VehicleOrderID num_orders = INVALID_VEH_ORDER_ID)
@@ -632,6 +635,11 @@ public:
 
 	void RecalculateTimetableDuration();
 
+	/**
+	 * Discard the cached link refresh plans, as the orders have changed.
+	 */
+	inline void InvalidateLinkRefreshCache() { this->link_refresh_cache.reset(); }
+
 	/**
 	 * Get the first order of the order chain.
 	 * @return the first order of the chain.
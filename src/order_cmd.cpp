@@ -37,6 +37,7 @@
 #include "order_cmd.h"
 #include "vehiclelist.h"
 #include "tracerestrict.h"
+#include "departures_func.h"
 
 #include "table/strings.h"
 
@@ -337,6 +338,7 @@ Order::Order(uint64 packed)
 void InvalidateVehicleOrder(const Vehicle *v, int data)
 {
 	SetWindowDirty(WC_VEHICLE_VIEW, v->index);
+	InvalidateDepartureCache(v);
 
 	if (data != 0) {
 		/* Calls SetDirty() too */
@@ -404,6 +406,8 @@ void CargoStationIDStackSet::FillNextStoppingStation(const Vehicle *v, const Ord
 
 void OrderList::ReindexOrderList()
 {
+	/* The orders have been inserted, deleted or moved. */
+	this->InvalidateLinkRefreshCache();
 	this->order_index.clear();
 	for (Order *o = this->first; o != nullptr; o = o->next) {
 		this->order_index.push_back(o);
@@ -435,6 +439,7 @@ void OrderList::Initialize(Order *chain, Vehicle *v)
 	this->timetable_duration = 0;
 	this->total_duration = 0;
 	this->order_index.clear();
+	this->InvalidateLinkRefreshCache();
 
 	VehicleType type = v->type;
 	Owner owner = v->owner;
@@ -492,6 +497,7 @@ void OrderList::FreeChain(bool keep_orderlist)
 		this->num_manual_orders = 0;
 		this->timetable_duration = 0;
 		this->order_index.clear();
+		this->InvalidateLinkRefreshCache();
 	} else {
 		delete this;
 	}
@@ -1278,7 +1284,7 @@ void InsertOrder(Vehicle *v, Order *new_o, VehicleOrderID sel_ord)
 
 	/* Make sure to rebuild the whole list */
 	InvalidateWindowClassesData(GetWindowClassForVehicleType(v->type), 0);
-	InvalidateWindowClassesData(WC_DEPARTURES_BOARD, 0);
+	InvalidateDepartureBoards();
 }
 
 /**
@@ -1297,7 +1303,7 @@ static CommandCost DecloneOrder(Vehicle *dst, DoCommandFlag flags)
 		DeleteVehicleOrders(dst);
 		InvalidateVehicleOrder(dst, VIWD_REMOVE_ALL_ORDERS);
 		InvalidateWindowClassesData(GetWindowClassForVehicleType(dst->type), 0);
-		InvalidateWindowClassesData(WC_DEPARTURES_BOARD, 0);
+		InvalidateDepartureBoards();
 		CheckMarkDirtyFocusedRoutePaths(dst);
 	}
 	return CommandCost();
@@ -1434,7 +1440,7 @@ void DeleteOrder(Vehicle *v, VehicleOrderID sel_ord)
 	}
 
 	InvalidateWindowClassesData(GetWindowClassForVehicleType(v->type), 0);
-	InvalidateWindowClassesData(WC_DEPARTURES_BOARD, 0);
+	InvalidateDepartureBoards();
 }
 
 /**
@@ -2127,6 +2133,7 @@ CommandCost CmdModifyOrder(TileIndex tile, DoCommandFlag flags, uint32 p1, uint3
 			}
 			InvalidateVehicleOrder(u, VIWD_MODIFY_ORDERS);
 		}
+		v->orders.list->InvalidateLinkRefreshCache();
 		CheckMarkDirtyFocusedRoutePaths(v);
 	}
 
@@ -2310,7 +2317,7 @@ CommandCost CmdCloneOrder(TileIndex tile, DoCommandFlag flags, uint32 p1, uint32
 
 
 				InvalidateWindowClassesData(GetWindowClassForVehicleType(dst->type), 0);
-				InvalidateWindowClassesData(WC_DEPARTURES_BOARD, 0);
+				InvalidateDepartureBoards();
 				CheckMarkDirtyFocusedRoutePaths(dst);
 
 				CheckAdvanceVehicleOrdersAfterClone(dst, flags);
@@ -2412,7 +2419,7 @@ CommandCost CmdCloneOrder(TileIndex tile, DoCommandFlag flags, uint32 p1, uint32
 				InvalidateVehicleOrder(dst, VIWD_REMOVE_ALL_ORDERS);
 
 				InvalidateWindowClassesData(GetWindowClassForVehicleType(dst->type), 0);
-				InvalidateWindowClassesData(WC_DEPARTURES_BOARD, 0);
+				InvalidateDepartureBoards();
 				CheckMarkDirtyFocusedRoutePaths(dst);
 
 				CheckAdvanceVehicleOrdersAfterClone(dst, flags);
@@ -2478,6 +2485,7 @@ CommandCost CmdOrderRefit(TileIndex tile, DoCommandFlag flags, uint32 p1, uint32
 				u->current_order.SetRefit(cargo);
 			}
 		}
+		v->orders.list->InvalidateLinkRefreshCache();
 		CheckMarkDirtyFocusedRoutePaths(v);
 	}
 
@@ -2628,7 +2636,7 @@ bool Vehicle::HasDepotOrder() const
 void DeleteVehicleOrders(Vehicle *v, bool keep_orderlist, bool reset_order_indices)
 {
 	DeleteOrderWarnings(v);
-	InvalidateWindowClassesData(WC_DEPARTURES_BOARD, 0);
+	InvalidateDepartureBoards();
 
 	if (v->IsOrderListShared()) {
 		/* Remove ourself from the shared order list. */
@@ -3221,5 +3229,5 @@ void ShiftOrderDates(int interval)
 	SetWindowClassesDirty(WC_VEHICLE_ORDERS);
 	SetWindowClassesDirty(WC_VEHICLE_TIMETABLE);
 	SetWindowClassesDirty(WC_SCHDISPATCH_SLOTS);
-	InvalidateWindowClassesData(WC_DEPARTURES_BOARD, 0);
+	InvalidateDepartureBoards();
 }
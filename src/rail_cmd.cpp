@@ -2773,6 +2773,8 @@ void MarkSingleSignalDirty(TileIndex tile, Trackdir td)
 		0,  // TRACKDIR_RVREV_NW
 	};
 
+	InvalidateViewportTileSpriteCache(tile);
+
 	uint x, y;
 	GetSignalXY(tile, trackdir_to_pos[td], x, y);
 	Point pt = RemapCoords(x, y, GetSaveSlopeZ(x, y, TrackdirToTrack(td)));
@@ -30,6 +30,9 @@ RandomAccessFile::RandomAccessFile(const std::string &filename, Subdirectory sub
 	long pos = ftell(this->file_handle);
 	if (pos < 0) usererror("Cannot read file '%s'", filename.c_str());
 
+	this->pos = 0;
+	this->buffer = this->buffer_end = this->buffer_start;
+
 	/* Store the filename without path and extension */
 	auto t = filename.rfind(PATHSEPCHAR);
 	std::string name_without_path = filename.substr(t != std::string::npos ? t + 1 : 0);
@@ -84,6 +87,13 @@ void RandomAccessFile::SeekTo(size_t pos, int mode)
 {
 	if (mode == SEEK_CUR) pos += this->GetPos();
 
+	/* When the new position is within the read buffer, there is no need to go to the file. */
+	size_t buffer_begin_pos = this->pos - (this->buffer_end - this->buffer_start);
+	if (pos >= buffer_begin_pos && pos <= this->pos) {
+		this->buffer = this->buffer_start + (pos - buffer_begin_pos);
+		return;
+	}
+
 	this->pos = pos;
 	if (fseek(this->file_handle, this->pos, SEEK_SET) < 0) {
 		DEBUG(misc, 0, "Seeking in %s failed", this->filename.c_str());
@@ -137,8 +147,14 @@ uint32 RandomAccessFile::ReadDwordIntl()
  */
 void RandomAccessFile::ReadBlock(void *ptr, size_t size)
 {
-	this->SeekTo(this->GetPos(), SEEK_SET);
-	this->pos += fread(ptr, 1, size, this->file_handle);
+	/* First use what is left in the read buffer, then read the remainder directly from the file. */
+	size_t buffered = std::min<size_t>(size, this->buffer_end - this->buffer);
+	memcpy(ptr, this->buffer, buffered);
+	this->buffer += buffered;
+	if (buffered == size) return;
+
+	this->buffer = this->buffer_end = this->buffer_start;
+	this->pos += fread((byte *)ptr + buffered, 1, size - buffered, this->file_handle);
 }
 
 /**
@@ -1093,7 +1093,7 @@ struct BuildRoadStationWindow : public PickerWindowBase {
 
 		this->FinishInitNested(TRANSPORT_ROAD);
 
-		this->window_class = (rs == ROADSTOP_BUS) ? WC_BUS_STATION : WC_TRUCK_STATION;
+		this->ChangeWindowClass((rs == ROADSTOP_BUS) ? WC_BUS_STATION : WC_TRUCK_STATION);
 	}
 
 	virtual ~BuildRoadStationWindow()
@@ -65,6 +65,7 @@
 #include "../settings_func.h"
 #include "../animated_tile.h"
 #include "../company_func.h"
+#include "../thread.h"
 
 
 #include "saveload_internal.h"
@@ -680,7 +681,7 @@ bool AfterLoadGame()
 		_settings_game.construction.map_height_limit = 15;
 
 		/* In old savegame versions, the heightlevel was coded in bits 0..3 of the type field */
-		for (TileIndex t = 0; t < map_size; t++) {
+		RunParallelTilePass([](TileIndex t) {
 			_m[t].height = GB(_m[t].type, 0, 4);
 			SB(_m[t].type, 0, 2, GB(_me[t].m6, 0, 2));
 			SB(_me[t].m6, 0, 2, 0);
@@ -690,9 +691,9 @@ bool AfterLoadGame()
 			} else {
 				SB(_m[t].type, 2, 2, 0);
 			}
-		}
+		});
 	} else if (IsSavegameVersionBefore(SLV_194) && SlXvIsFeaturePresent(XSLFI_HEIGHT_8_BIT)) {
-		for (TileIndex t = 0; t < map_size; t++) {
+		RunParallelTilePass([](TileIndex t) {
 			SB(_m[t].type, 0, 2, GB(_me[t].m6, 0, 2));
 			SB(_me[t].m6, 0, 2, 0);
 			if (MayHaveBridgeAbove(t)) {
@@ -701,7 +702,7 @@ bool AfterLoadGame()
 			} else {
 				SB(_m[t].type, 2, 2, 0);
 			}
-		}
+		});
 	}
 
 	/* in version 2.1 of the savegame, town owner was unified. */
@@ -1314,7 +1315,7 @@ bool AfterLoadGame()
 			if (has_extra_bit) rt |= (GB(_m[t].m1, 7, 1) << 4);
 			SetRailType(t, (RailType)rt);
 		};
-		for (TileIndex t = 0; t < map_size; t++) {
+		RunParallelTilePass([&](TileIndex t) {
 			switch (GetTileType(t)) {
 				case MP_RAILWAY:
 					update_railtype(t);
@@ -1341,7 +1342,7 @@ bool AfterLoadGame()
 				default:
 					break;
 			}
-		}
+		});
 	}
 
 	if (IsSavegameVersionBefore(SLV_42)) {
@@ -1507,11 +1508,11 @@ bool AfterLoadGame()
 
 	if (SlXvIsFeatureMissing(XSLFI_DUAL_RAIL_TYPES)) {
 		/* Introduced dual rail types. */
-		for (TileIndex t = 0; t < map_size; t++) {
+		RunParallelTilePass([](TileIndex t) {
 			if (IsPlainRailTile(t) || (IsRailTunnelBridgeTile(t) && IsBridge(t))) {
 				SetSecondaryRailType(t, GetRailType(t));
 			}
-		}
+		});
 	}
 
 	if (SlXvIsFeaturePresent(XSLFI_SIG_TUNNEL_BRIDGE, 1, 6)) {
@@ -1537,20 +1538,20 @@ bool AfterLoadGame()
 
 	if (!SlXvIsFeaturePresent(XSLFI_CUSTOM_BRIDGE_HEADS, 2)) {
 		/* change map bits for rail bridge heads */
-		for (TileIndex t = 0; t < map_size; t++) {
+		RunParallelTilePass([](TileIndex t) {
 			if (IsBridgeTile(t) && GetTunnelBridgeTransportType(t) == TRANSPORT_RAIL) {
 				SetCustomBridgeHeadTrackBits(t, DiagDirToDiagTrackBits(GetTunnelBridgeDirection(t)));
 				SetBridgeReservationTrackBits(t, HasBit(_m[t].m5, 4) ? DiagDirToDiagTrackBits(GetTunnelBridgeDirection(t)) : TRACK_BIT_NONE);
 				ClrBit(_m[t].m5, 4);
 			}
-		}
+		});
 	}
 
 	if (!SlXvIsFeaturePresent(XSLFI_CUSTOM_BRIDGE_HEADS, 3)) {
 		/* fence/ground type support for custom rail bridges */
-		for (TileIndex t = 0; t < map_size; t++) {
+		RunParallelTilePass([](TileIndex t) {
 			if (IsTileType(t, MP_TUNNELBRIDGE)) SB(_me[t].m7, 6, 2, 0);
-		}
+		});
 	}
 
 	if (SlXvIsFeaturePresent(XSLFI_CUSTOM_BRIDGE_HEADS, 1, 3)) {
@@ -3639,11 +3640,11 @@ bool AfterLoadGame()
 
 	if (SlXvIsFeatureMissing(XSLFI_CUSTOM_BRIDGE_HEADS)) {
 		/* ensure that previously unused custom bridge-head bits are cleared */
-		for (TileIndex t = 0; t < map_size; t++) {
+		RunParallelTilePass([](TileIndex t) {
 			if (IsBridgeTile(t) && GetTunnelBridgeTransportType(t) == TRANSPORT_ROAD) {
 				SB(_m[t].m2, 0, 8, 0);
 			}
-		}
+		});
 	}
 
 	if (IsSavegameVersionBefore(SLV_SHIPS_STOP_IN_LOCKS)) {
@@ -3705,9 +3706,9 @@ bool AfterLoadGame()
 
 	if (IsSavegameVersionBefore(SLV_TREES_WATER_CLASS) && !SlXvIsFeaturePresent(XSLFI_CHUNNEL, 2)) {
 		/* Update water class for trees. */
-		for (TileIndex t = 0; t < map_size; t++) {
+		RunParallelTilePass([](TileIndex t) {
 			if (IsTileType(t, MP_TREES)) SetWaterClass(t, GetTreeGround(t) == TREE_GROUND_SHORE ? WATER_CLASS_SEA : WATER_CLASS_INVALID);
-		}
+		});
 	}
 
 	/* Update structures for multitile docks */
@@ -3883,11 +3884,11 @@ bool AfterLoadGame()
 	}
 
 	if (SlXvIsFeatureMissing(XSLFI_ONE_WAY_DT_ROAD_STOP)) {
-		for (TileIndex t = 0; t < map_size; t++) {
+		RunParallelTilePass([](TileIndex t) {
 			if (IsDriveThroughStopTile(t)) {
 				SetDriveThroughStopDisallowedRoadDirections(t, DRD_NONE);
 			}
-		}
+		});
 	}
 
 	if (SlXvIsFeatureMissing(XSLFI_ONE_WAY_ROAD_STATE)) {
@@ -3913,12 +3914,12 @@ bool AfterLoadGame()
 	}
 
 	if (SlXvIsFeatureMissing(XSLFI_MORE_HOUSES)) {
-		for (TileIndex t = 0; t < map_size; t++) {
+		RunParallelTilePass([](TileIndex t) {
 			if (IsTileType(t, MP_HOUSE)) {
 				/* Move upper bit of house ID from bit 6 of m3 to bits 6..5 of m3. */
 				SB(_m[t].m3, 5, 2, GB(_m[t].m3, 6, 1));
 			}
-		}
+		});
 	}
 
 	if (SlXvIsFeatureMissing(XSLFI_CUSTOM_TOWN_ZONE)) {
@@ -3930,11 +3931,11 @@ bool AfterLoadGame()
 	}
 
 	if (!SlXvIsFeaturePresent(XSLFI_WATER_FLOODING, 2)) {
-		for (TileIndex t = 0; t < map_size; t++) {
+		RunParallelTilePass([](TileIndex t) {
 			if (IsTileType(t, MP_WATER)) {
 				SetNonFloodingWaterTile(t, false);
 			}
-		}
+		});
 	}
 
 	InitializeRoadGUI();
@@ -4032,8 +4033,7 @@ void ReloadNewGRFData()
 	}
 
 	/* Restore correct railtype for all rail tiles.*/
-	const TileIndex map_size = MapSize();
-	for (TileIndex t = 0; t < map_size; t++) {
+	RunParallelTilePass([&](TileIndex t) {
 		if (GetTileType(t) == MP_RAILWAY ||
 				IsLevelCrossingTile(t) ||
 				IsRailStationTile(t) ||
@@ -4043,7 +4043,7 @@ void ReloadNewGRFData()
 			RailType secondary = GetTileSecondaryRailTypeIfValid(t);
 			if (secondary != INVALID_RAILTYPE) SetSecondaryRailType(t, rail_type_translate_map[secondary]);
 		}
-	}
+	});
 
 	/* Update company statistics. */
 	AfterLoadCompanyStats();
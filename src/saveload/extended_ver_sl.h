@@ -109,6 +109,7 @@ enum SlXvFeatureIndex {
 	XSLFI_TRAIN_SPEED_ADAPTATION,                 ///< Train speed adaptation
 	XSLFI_EXTRA_STATION_NAMES,                    ///< Extra station names
 	XSLFI_DEPOT_ORDER_EXTRA_FLAGS,                ///< Depot order extra flags
+	XSLFI_LINKGRAPH_DEMAND_CACHE,                 ///< Linkgraph demand cache for incremental demand calculation
 
 	XSLFI_RIFF_HEADER_60_BIT,                     ///< Size field in RIFF chunk header is 60 bit
 	XSLFI_HEIGHT_8_BIT,                           ///< Map tile height is 8 bit instead of 4 bit, but savegame version may be before this became true in trunk
@@ -59,7 +59,8 @@ void AfterLoadLabelMaps()
 			if (secondary != INVALID_RAILTYPE) SetSecondaryRailType(t, railtype_conversion_map[secondary]);
 		};
 
-		for (TileIndex t = 0; t < MapSize(); t++) {
+		/* Runs on every load of a savegame with a different set of rail types, so use all cores on large maps. */
+		RunParallelTilePass([&](TileIndex t) {
 			switch (GetTileType(t)) {
 				case MP_RAILWAY:
 					convert(t);
@@ -86,7 +87,7 @@ void AfterLoadLabelMaps()
 				default:
 					break;
 			}
-		}
+		});
 	}
 
 	ResetLabelMaps();
@@ -20,6 +20,19 @@
 typedef LinkGraph::BaseNode Node;
 typedef LinkGraph::BaseEdge Edge;
 
+/**
+ * Link graph edge as stored in the savegame. The outgoing edges of a node are
+ * stored as a linked list via next_edge, which starts at a dummy entry for the
+ * edge from the node to itself.
+ */
+struct SaveLoadEdge {
+	uint capacity;                 ///< Capacity of the link.
+	uint usage;                    ///< Usage of the link.
+	Date last_unrestricted_update; ///< When the unrestricted part of the link was last updated.
+	Date last_restricted_update;   ///< When the restricted part of the link was last updated.
+	NodeID next_edge;              ///< Destination of next valid edge starting at the same source node.
+};
+
 const SettingDesc *GetSettingDescription(uint index);
 
 static uint16 _num_nodes;
@@ -129,11 +142,11 @@ static const SaveLoad _node_desc[] = {
  */
 static const SaveLoad _edge_desc[] = {
 	SLE_CONDNULL(4, SL_MIN_VERSION, SLV_191), // distance
-	     SLE_VAR(Edge, capacity,                 SLE_UINT32),
-	     SLE_VAR(Edge, usage,                    SLE_UINT32),
-	     SLE_VAR(Edge, last_unrestricted_update, SLE_INT32),
-	 SLE_CONDVAR(Edge, last_restricted_update,   SLE_INT32, SLV_187, SL_MAX_VERSION),
-	     SLE_VAR(Edge, next_edge,                SLE_UINT16),
+	     SLE_VAR(SaveLoadEdge, capacity,                 SLE_UINT32),
+	     SLE_VAR(SaveLoadEdge, usage,                    SLE_UINT32),
+	     SLE_VAR(SaveLoadEdge, last_unrestricted_update, SLE_INT32),
+	 SLE_CONDVAR(SaveLoadEdge, last_restricted_update,   SLE_INT32, SLV_187, SL_MAX_VERSION),
+	     SLE_VAR(SaveLoadEdge, next_edge,                SLE_UINT16),
 	     SLE_END()
 };
 
@@ -158,9 +171,41 @@ void Save_LinkGraph(LinkGraph &lg)
 	for (NodeID from = 0; from < size; ++from) {
 		Node *node = &lg.nodes[from];
 		SlObjectSaveFiltered(node, _filtered_node_desc.data());
-		/* ... but as that wasted a lot of space we save a sparse matrix now. */
-		for (NodeID to = from; to != INVALID_NODE; to = lg.edges[from][to].next_edge) {
-			SlObjectSaveFiltered(&lg.edges[from][to], _filtered_edge_desc.data());
+		/* The edges are saved as a list linked by next_edge, starting at the node itself. */
+		const LinkGraph::EdgeVector &edges = node->edges.Get();
+		SaveLoadEdge edge = { 0, 0, INVALID_DATE, INVALID_DATE, edges.empty() ? INVALID_NODE : edges.front().dest_node };
+		SlObjectSaveFiltered(&edge, _filtered_edge_desc.data());
+		for (auto it = edges.begin(); it != edges.end(); ++it) {
+			edge.capacity = it->capacity;
+			edge.usage = it->usage;
+			edge.last_unrestricted_update = it->last_unrestricted_update;
+			edge.last_restricted_update = it->last_restricted_update;
+			edge.next_edge = (it + 1) != edges.end() ? (it + 1)->dest_node : INVALID_NODE;
+			SlObjectSaveFiltered(&edge, _filtered_edge_desc.data());
+		}
+	}
+
+	/* The demands of the last calculation are needed to continue incremental demand calculation the same way everywhere. */
+	const LinkGraph::DemandCache *cache = lg.GetDemandCache();
+	SlWriteByte(cache != nullptr ? 1 : 0);
+	if (cache == nullptr) return;
+	SlWriteUint32(cache->supply_age);
+	SlWriteUint16(cache->incremental_runs);
+	SlWriteByte(cache->distribution_type);
+	SlWriteByte(cache->accuracy);
+	SlWriteByte(cache->demand_size);
+	SlWriteByte(cache->demand_distance);
+	SlWriteUint16((uint16)cache->nodes.size());
+	for (const LinkGraph::DemandCache::CachedNode &node : cache->nodes) {
+		SlWriteUint16(node.station);
+		SlWriteUint32(node.xy);
+		SlWriteUint32(node.supply);
+		SlWriteByte(node.accepting ? 1 : 0);
+		SlWriteUint16(node.component);
+		SlWriteUint16((uint16)node.demands.size());
+		for (const LinkGraph::DemandCache::Demand &demand : node.demands) {
+			SlWriteUint16(demand.dest);
+			SlWriteUint32(demand.demand);
 		}
 	}
 }
@@ -172,21 +217,76 @@ void Save_LinkGraph(LinkGraph &lg)
 void Load_LinkGraph(LinkGraph &lg)
 {
 	uint size = lg.Size();
+	std::vector<SaveLoadEdge> matrix_row;
 	for (NodeID from = 0; from < size; ++from) {
 		Node *node = &lg.nodes[from];
 		SlObjectLoadFiltered(node, _filtered_node_desc.data());
+
+		/* Convert the linked list of edges to the node's sorted edge vector. */
+		LinkGraph::EdgeVector edges;
+		auto add_edge = [&](NodeID to, const SaveLoadEdge &edge) {
+			if (edges.size() >= size) SlErrorCorrupt("Link graph structure overflow");
+			edges.emplace_back();
+			Edge &new_edge = edges.back();
+			new_edge.capacity = edge.capacity;
+			new_edge.usage = edge.usage;
+			new_edge.last_unrestricted_update = edge.last_unrestricted_update;
+			new_edge.last_restricted_update = IsSavegameVersionBefore(SLV_187) ? INVALID_DATE : edge.last_restricted_update;
+			new_edge.dest_node = to;
+		};
+
 		if (IsSavegameVersionBefore(SLV_191)) {
 			/* We used to save the full matrix ... */
+			matrix_row.resize(size);
 			for (NodeID to = 0; to < size; ++to) {
-				SlObjectLoadFiltered(&lg.edges[from][to], _filtered_edge_desc.data());
+				SlObjectLoadFiltered(&matrix_row[to], _filtered_edge_desc.data());
+			}
+			for (NodeID to = matrix_row[from].next_edge; to != INVALID_NODE; to = matrix_row[to].next_edge) {
+				if (to >= size || to == from) SlErrorCorrupt("Link graph structure overflow");
+				add_edge(to, matrix_row[to]);
 			}
 		} else {
 			/* ... but as that wasted a lot of space we save a sparse matrix now. */
-			for (NodeID to = from; to != INVALID_NODE; to = lg.edges[from][to].next_edge) {
-				if (to >= size) SlErrorCorrupt("Link graph structure overflow");
-				SlObjectLoadFiltered(&lg.edges[from][to], _filtered_edge_desc.data());
+			SaveLoadEdge edge;
+			SlObjectLoadFiltered(&edge, _filtered_edge_desc.data());
+			for (NodeID to = edge.next_edge; to != INVALID_NODE; to = edge.next_edge) {
+				if (to >= size || to == from) SlErrorCorrupt("Link graph structure overflow");
+				SlObjectLoadFiltered(&edge, _filtered_edge_desc.data());
+				add_edge(to, edge);
+			}
+		}
+
+		std::sort(edges.begin(), edges.end(), [](const Edge &a, const Edge &b) { return a.dest_node < b.dest_node; });
+		for (size_t i = 1; i < edges.size(); i++) {
+			if (edges[i - 1].dest_node == edges[i].dest_node) SlErrorCorrupt("Link graph duplicate edge");
+		}
+		if (!edges.empty()) node->edges.GetMutable() = std::move(edges);
+	}
+
+	if (SlXvIsFeaturePresent(XSLFI_LINKGRAPH_DEMAND_CACHE) && SlReadByte() != 0) {
+		std::shared_ptr<LinkGraph::DemandCache> cache = std::make_shared<LinkGraph::DemandCache>();
+		cache->supply_age = (Date)SlReadUint32();
+		cache->incremental_runs = SlReadUint16();
+		cache->distribution_type = SlReadByte();
+		cache->accuracy = SlReadByte();
+		cache->demand_size = SlReadByte();
+		cache->demand_distance = SlReadByte();
+		cache->nodes.resize(SlReadUint16());
+		for (LinkGraph::DemandCache::CachedNode &node : cache->nodes) {
+			node.station = SlReadUint16();
+			node.xy = SlReadUint32();
+			node.supply = SlReadUint32();
+			node.accepting = SlReadByte() != 0;
+			/* Without the components the next calculation can't tell whether they merged, so it has to start from scratch. */
+			node.component = SlXvIsFeaturePresent(XSLFI_LINKGRAPH_DEMAND_CACHE, 2) ? SlReadUint16() : INVALID_NODE;
+			node.demands.resize(SlReadUint16());
+			for (LinkGraph::DemandCache::Demand &demand : node.demands) {
+				demand.dest = SlReadUint16();
+				demand.demand = SlReadUint32();
+				if (demand.dest >= cache->nodes.size()) SlErrorCorrupt("Link graph demand cache overflow");
 			}
 		}
+		lg.demand_cache = std::move(cache);
 	}
 }
 
@@ -56,17 +56,67 @@ static void Check_MAPS()
 
 static const uint MAP_SL_BUF_SIZE = 4096;
 
-static void Load_MAPT()
+/**
+ * Load a per-field map chunk of 8-bit values, scattering the values straight from the
+ * decompressed read buffer into the given map array field, without an intermediate copy.
+ * The field is a template parameter so the stride and offset of the stores are known at
+ * compile time and the inner loop can be vectorised.
+ * @param map The map array to load into, either _m or _me.
+ */
+template <typename T, byte T::*field>
+static void LoadMapByteField(T *map)
 {
-	std::array<byte, MAP_SL_BUF_SIZE> buf;
-	TileIndex size = MapSize();
+	ReadBuffer *reader = ReadBuffer::GetCurrent();
+	const TileIndex size = MapSize();
 
 	for (TileIndex i = 0; i != size;) {
-		SlArray(buf.data(), MAP_SL_BUF_SIZE, SLE_UINT8);
-		for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) _m[i++].type = buf[j];
+		if (reader->bufp == reader->bufe) reader->AcquireBytes();
+		const TileIndex count = (TileIndex)std::min<size_t>(size - i, reader->bufe - reader->bufp);
+		const byte *src = reader->bufp;
+		T *dst = map + i;
+		for (TileIndex j = 0; j != count; j++) {
+			dst[j].*field = src[j];
+		}
+		reader->bufp += count;
+		i += count;
+	}
+}
+
+/**
+ * Load a per-field map chunk of big endian 16-bit values, scattering the values straight from the
+ * decompressed read buffer into the given map array field, without an intermediate copy.
+ * @param map The map array to load into, either _m or _me.
+ */
+template <typename T, uint16 T::*field>
+static void LoadMapUint16Field(T *map)
+{
+	ReadBuffer *reader = ReadBuffer::GetCurrent();
+	const TileIndex size = MapSize();
+
+	for (TileIndex i = 0; i != size;) {
+		const size_t available = (reader->bufe - reader->bufp) / 2;
+		if (available == 0) {
+			/* The next value may straddle the end of the buffer. */
+			reader->CheckBytes(2);
+			map[i++].*field = reader->RawReadUint16();
+			continue;
+		}
+		const TileIndex count = (TileIndex)std::min<size_t>(size - i, available);
+		const byte *src = reader->bufp;
+		T *dst = map + i;
+		for (TileIndex j = 0; j != count; j++) {
+			dst[j].*field = (src[j * 2] << 8) | src[j * 2 + 1];
+		}
+		reader->bufp += count * 2;
+		i += count;
 	}
 }
 
+static void Load_MAPT()
+{
+	LoadMapByteField<Tile, &Tile::type>(_m);
+}
+
 static void Check_MAPH_common()
 {
 	if (_sl_maybe_chillpp && (SlGetFieldLength() == 0 || SlGetFieldLength() == _map_dim_x * _map_dim_y * 2)) {
@@ -99,117 +149,76 @@ static void Load_MAPH()
 		return;
 	}
 
-	std::array<byte, MAP_SL_BUF_SIZE> buf;
-	TileIndex size = MapSize();
-
-	for (TileIndex i = 0; i != size;) {
-		SlArray(buf.data(), MAP_SL_BUF_SIZE, SLE_UINT8);
-		for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) _m[i++].height = buf[j];
-	}
+	LoadMapByteField<Tile, &Tile::height>(_m);
 }
 
 static void Load_MAP1()
 {
-	std::array<byte, MAP_SL_BUF_SIZE> buf;
-	TileIndex size = MapSize();
-
-	for (TileIndex i = 0; i != size;) {
-		SlArray(buf.data(), MAP_SL_BUF_SIZE, SLE_UINT8);
-		for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) _m[i++].m1 = buf[j];
-	}
+	LoadMapByteField<Tile, &Tile::m1>(_m);
 }
 
 static void Load_MAP2()
 {
+	if (!IsSavegameVersionBefore(SLV_5)) {
+		LoadMapUint16Field<Tile, &Tile::m2>(_m);
+		return;
+	}
+
 	std::array<uint16, MAP_SL_BUF_SIZE> buf;
 	TileIndex size = MapSize();
 
 	for (TileIndex i = 0; i != size;) {
-		SlArray(buf.data(), MAP_SL_BUF_SIZE,
-			/* In those versions the m2 was 8 bits */
-			IsSavegameVersionBefore(SLV_5) ? SLE_FILE_U8 | SLE_VAR_U16 : SLE_UINT16
-		);
+		/* In those versions the m2 was 8 bits */
+		SlArray(buf.data(), MAP_SL_BUF_SIZE, SLE_FILE_U8 | SLE_VAR_U16);
 		for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) _m[i++].m2 = buf[j];
 	}
 }
 
 static void Load_MAP3()
 {
-	std::array<byte, MAP_SL_BUF_SIZE> buf;
-	TileIndex size = MapSize();
-
-	for (TileIndex i = 0; i != size;) {
-		SlArray(buf.data(), MAP_SL_BUF_SIZE, SLE_UINT8);
-		for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) _m[i++].m3 = buf[j];
-	}
+	LoadMapByteField<Tile, &Tile::m3>(_m);
 }
 
 static void Load_MAP4()
 {
-	std::array<byte, MAP_SL_BUF_SIZE> buf;
-	TileIndex size = MapSize();
-
-	for (TileIndex i = 0; i != size;) {
-		SlArray(buf.data(), MAP_SL_BUF_SIZE, SLE_UINT8);
-		for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) _m[i++].m4 = buf[j];
-	}
+	LoadMapByteField<Tile, &Tile::m4>(_m);
 }
 
 static void Load_MAP5()
 {
-	std::array<byte, MAP_SL_BUF_SIZE> buf;
-	TileIndex size = MapSize();
-
-	for (TileIndex i = 0; i != size;) {
-		SlArray(buf.data(), MAP_SL_BUF_SIZE, SLE_UINT8);
-		for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) _m[i++].m5 = buf[j];
-	}
+	LoadMapByteField<Tile, &Tile::m5>(_m);
 }
 
 static void Load_MAP6()
 {
+	if (!IsSavegameVersionBefore(SLV_42)) {
+		LoadMapByteField<TileExtended, &TileExtended::m6>(_me);
+		return;
+	}
+
 	std::array<byte, MAP_SL_BUF_SIZE> buf;
 	TileIndex size = MapSize();
 
-	if (IsSavegameVersionBefore(SLV_42)) {
-		for (TileIndex i = 0; i != size;) {
-			/* 1024, otherwise we overflow on 64x64 maps! */
-			SlArray(buf.data(), 1024, SLE_UINT8);
-			for (uint j = 0; j != 1024; j++) {
-				_me[i++].m6 = GB(buf[j], 0, 2);
-				_me[i++].m6 = GB(buf[j], 2, 2);
-				_me[i++].m6 = GB(buf[j], 4, 2);
-				_me[i++].m6 = GB(buf[j], 6, 2);
-			}
-		}
-	} else {
-		for (TileIndex i = 0; i != size;) {
-			SlArray(buf.data(), MAP_SL_BUF_SIZE, SLE_UINT8);
-			for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) _me[i++].m6 = buf[j];
+	for (TileIndex i = 0; i != size;) {
+		/* 1024, otherwise we overflow on 64x64 maps! */
+		SlArray(buf.data(), 1024, SLE_UINT8);
+		for (uint j = 0; j != 1024; j++) {
+			_me[i++].m6 = GB(buf[j], 0, 2);
+			_me[i++].m6 = GB(buf[j], 2, 2);
+			_me[i++].m6 = GB(buf[j], 4, 2);
+			_me[i++].m6 = GB(buf[j], 6, 2);
 		}
 	}
 }
 
 static void Load_MAP7()
 {
-	std::array<byte, MAP_SL_BUF_SIZE> buf;
-	TileIndex size = MapSize();
-
-	for (TileIndex i = 0; i != size;) {
-		SlArray(buf.data(), MAP_SL_BUF_SIZE, SLE_UINT8);
-		for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) _me[i++].m7 = buf[j];
-	}
+	LoadMapByteField<TileExtended, &TileExtended::m7>(_me);
 }
 
 static void Load_MAP8()
 {
-	std::array<uint16, MAP_SL_BUF_SIZE> buf;
-	TileIndex size = MapSize();
-
-	for (TileIndex i = 0; i != size;) {
-		SlArray(buf.data(), MAP_SL_BUF_SIZE, SLE_UINT16);
-		for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) _me[i++].m8 = buf[j];
-	}
+	LoadMapUint16Field<TileExtended, &TileExtended::m8>(_me);
 }
 
 static void Load_WMAP()
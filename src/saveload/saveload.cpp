@@ -45,7 +45,9 @@
 #include "../error.h"
 #include "../scope.h"
 #include <atomic>
+#include <chrono>
 #include <deque>
+#include <map>
 #include <string>
 #ifdef __EMSCRIPTEN__
 #	include <emscripten.h>
@@ -71,6 +73,11 @@
 #include "../3rdparty/mingw-std-threads/mingw.condition_variable.h"
 #endif
 
+#if defined(UNIX) && !defined(__EMSCRIPTEN__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 #include "../safeguards.h"
 
 extern const SaveLoadVersion SAVEGAME_VERSION = (SaveLoadVersion)(SL_MAX_VERSION - 1); ///< Current savegame version of OpenTTD.
@@ -104,16 +111,40 @@ enum NeedLength {
 	NL_WANTLENGTH = 1, ///< writing length and data
 };
 
+ReadBuffer::ReadBuffer(LoadFilter *reader) : bufp(nullptr), bufe(nullptr), reader(reader), read(0)
+{
+	this->use_spans = reader->SupportsReadSpan();
+}
+
+/**
+ * Get the next bytes from the filter, either in place or copied into #buf.
+ * @param data Output for the location of the bytes.
+ * @param max_len The maximum number of bytes to get.
+ * @return The number of bytes, never zero.
+ */
+size_t ReadBuffer::AcquireSpan(const byte **data, size_t max_len)
+{
+	size_t len;
+	if (this->use_spans) {
+		len = this->reader->ReadSpan(data, max_len);
+	} else {
+		len = this->reader->Read(this->buf, std::min(max_len, lengthof(this->buf)));
+		*data = this->buf;
+	}
+	if (len == 0) SlErrorCorrupt("Unexpected end of chunk");
+	this->read += len;
+	return len;
+}
+
 void ReadBuffer::SkipBytesSlowPath(size_t bytes)
 {
 	bytes -= (this->bufe - this->bufp);
 	while (true) {
-		size_t len = this->reader->Read(this->buf, lengthof(this->buf));
-		if (len == 0) SlErrorCorrupt("Unexpected end of chunk");
-		this->read += len;
+		const byte *data;
+		size_t len = this->AcquireSpan(&data, std::max(bytes, lengthof(this->buf)));
 		if (len >= bytes) {
-			this->bufp = this->buf + bytes;
-			this->bufe = this->buf + len;
+			this->bufp = data + bytes;
+			this->bufe = data + len;
 			return;
 		} else {
 			bytes -= len;
@@ -124,6 +155,22 @@ void ReadBuffer::SkipBytesSlowPath(size_t bytes)
 void ReadBuffer::AcquireBytes()
 {
 	size_t remainder = this->bufe - this->bufp;
+	if (this->use_spans) {
+		/* Use the bytes in place if they directly follow the remaining ones, which is the case when reading from a mapped file. */
+		const byte *data;
+		size_t len = this->AcquireSpan(&data, lengthof(this->buf) - remainder);
+		if (remainder == 0 || data == this->bufe) {
+			if (remainder == 0) this->bufp = data;
+			this->bufe = data + len;
+		} else {
+			memmove(this->buf, this->bufp, remainder);
+			memcpy(this->buf + remainder, data, len);
+			this->bufp = this->buf;
+			this->bufe = this->buf + remainder + len;
+		}
+		return;
+	}
+
 	if (remainder) {
 		memmove(this->buf, this->bufp, remainder);
 	}
@@ -210,6 +257,118 @@ size_t MemoryDumper::GetSize() const
 	return this->completed_block_bytes + (this->bufe ? (MEMORY_CHUNK_SIZE - (this->bufe - this->buf)) : 0);
 }
 
+/** How a save relates to delta savegames. */
+enum DeltaSaveMode : byte {
+	DSM_NONE,        ///< Normal save.
+	DSM_RECORD_BASE, ///< Full save, which is recorded as the base of the following delta saves.
+	DSM_WRITE_DELTA, ///< Delta save against the recorded base.
+};
+
+/**
+ * Get the current time for profiling savegames.
+ * @return The time in microseconds.
+ */
+static inline uint64 SlProfileTime()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/** Load filter which counts the bytes read through it and the time spent reading them. */
+struct ProfileLoadFilter : LoadFilter {
+	size_t bytes = 0;   ///< Number of bytes read.
+	uint64 time_us = 0; ///< Time spent reading, in microseconds.
+
+	/**
+	 * Initialise this filter.
+	 * @param chain The next filter in this chain.
+	 */
+	ProfileLoadFilter(LoadFilter *chain) : LoadFilter(chain)
+	{
+	}
+
+	size_t Read(byte *buf, size_t len) override
+	{
+		const uint64 start = SlProfileTime();
+		size_t read = this->chain->Read(buf, len);
+		this->time_us += SlProfileTime() - start;
+		this->bytes += read;
+		return read;
+	}
+
+	bool SupportsReadSpan() const override
+	{
+		return this->chain->SupportsReadSpan();
+	}
+
+	size_t ReadSpan(const byte **buf, size_t len) override
+	{
+		const uint64 start = SlProfileTime();
+		size_t read = this->chain->ReadSpan(buf, len);
+		this->time_us += SlProfileTime() - start;
+		this->bytes += read;
+		return read;
+	}
+
+	void Reset() override
+	{
+		this->bytes = 0;
+		this->chain->Reset();
+	}
+};
+
+/** Save filter which counts the bytes written through it and the time spent writing them. */
+struct ProfileSaveFilter : SaveFilter {
+	size_t bytes = 0;   ///< Number of bytes written.
+	uint64 time_us = 0; ///< Time spent writing, in microseconds.
+
+	/**
+	 * Initialise this filter.
+	 * @param chain The next filter in this chain.
+	 */
+	ProfileSaveFilter(SaveFilter *chain) : SaveFilter(chain)
+	{
+	}
+
+	void Write(byte *buf, size_t len) override
+	{
+		const uint64 start = SlProfileTime();
+		this->chain->Write(buf, len);
+		this->time_us += SlProfileTime() - start;
+		this->bytes += len;
+	}
+
+	void Finish() override
+	{
+		const uint64 start = SlProfileTime();
+		this->chain->Finish();
+		this->time_us += SlProfileTime() - start;
+	}
+};
+
+/** Profile of a single chunk of a savegame save or load. */
+struct SaveLoadChunkProfile {
+	uint32 id;               ///< Id of the chunk.
+	uint64 time_us;          ///< Time spent in the chunk, in microseconds.
+	uint64 filter_time_us;   ///< Part of #time_us spent waiting for the load filters (decompression, file reading).
+	size_t bytes;            ///< Uncompressed size of the chunk.
+	size_t compressed_bytes; ///< Approximate compressed size of the chunk, only known when saving.
+	uint items;              ///< Number of array items of the chunk.
+};
+
+/** Profile of a savegame save or load. */
+struct SaveLoadProfile {
+	bool valid = false;                       ///< Whether the profile has been recorded.
+	bool delta = false;                       ///< Whether a delta savegame was saved or loaded.
+	const char *format = nullptr;             ///< Name of the compression format when saving.
+	std::vector<SaveLoadChunkProfile> chunks; ///< Profile of each chunk, in order.
+	uint64 chunks_time_us = 0;                ///< Time spent saving or loading all chunks.
+	uint64 filter_time_us = 0;                ///< Time spent in the compression or decompression filters.
+	uint64 write_time_us = 0;                 ///< Time spent writing the compressed savegame, only known when saving.
+	uint64 post_time_us = 0;                  ///< Time spent fixing pointers and in AfterLoadGame when loading.
+	size_t bytes = 0;                         ///< Uncompressed size of the savegame.
+	size_t compressed_bytes = 0;              ///< Size of the savegame file or stream.
+};
+
 /** The saveload struct, containing reader-writer functions, buffer, version, etc. */
 struct SaveLoadParams {
 	SaveLoadAction action;               ///< are we doing a save or a load atm.
@@ -232,6 +391,15 @@ struct SaveLoadParams {
 	uint16 game_speed;                   ///< The game speed when saving started.
 	bool saveinprogress;                 ///< Whether there is currently a save in progress.
 	SaveModeFlags save_flags;            ///< Save mode flags
+
+	DeltaSaveMode delta_mode;            ///< Whether the current save is written as or recorded for delta saves.
+	std::string delta_name;              ///< Name of the file the current save is written to, when recording it as delta base.
+	std::vector<std::pair<uint32, size_t>> save_chunk_offsets; ///< Id and offset in the chunk stream of each saved chunk.
+
+	SaveLoadProfile profile;             ///< Profile of the current save or load.
+	uint profile_items;                  ///< Number of array items of the current chunk.
+	ProfileLoadFilter *profile_file;     ///< Filter counting the bytes read from the savegame file, owned by #lf.
+	ProfileLoadFilter *profile_stream;   ///< Filter timing the reads of the chunk stream, owned by #lf.
 };
 
 static SaveLoadParams _sl; ///< Parameters used for/at saveload.
@@ -725,6 +893,7 @@ void SlSetArrayIndex(uint index)
 {
 	_sl.need_length = NL_WANTLENGTH;
 	_sl.array_index = index;
+	_sl.profile_items++;
 }
 
 static size_t _next_offs;
@@ -762,7 +931,10 @@ int SlIterateArray()
 				return -1; // error
 		}
 
-		if (length != 0) return index;
+		if (length != 0) {
+			_sl.profile_items++;
+			return index;
+		}
 	}
 }
 
@@ -1174,6 +1346,37 @@ static inline size_t SlCalcArrayLen(size_t length, VarType conv)
 	return SlCalcConvFileLen(conv) * length;
 }
 
+/**
+ * Load an array of integers which have the same size in the savegame and in memory,
+ * decoding them directly from the read buffer instead of reading them one by one.
+ * @param array The array to load into.
+ * @param length The number of elements of the array.
+ */
+template <typename T>
+static void SlLoadArrayInPlace(T *array, size_t length)
+{
+	ReadBuffer *reader = _sl.reader;
+	while (length > 0) {
+		if ((size_t)(reader->bufe - reader->bufp) < sizeof(T)) reader->CheckBytes(sizeof(T));
+		const size_t count = std::min<size_t>(length, (reader->bufe - reader->bufp) / sizeof(T));
+		const byte *src = reader->bufp;
+		for (size_t i = 0; i < count; i++, src += sizeof(T)) {
+			T value;
+			memcpy(&value, src, sizeof(T));
+			if constexpr (sizeof(T) == 2) {
+				array[i] = (T)FROM_BE16((uint16)value);
+			} else if constexpr (sizeof(T) == 4) {
+				array[i] = (T)FROM_BE32((uint32)value);
+			} else {
+				array[i] = (T)FROM_BE64((uint64)value);
+			}
+		}
+		reader->bufp = src;
+		array += count;
+		length -= count;
+	}
+}
+
 /**
  * Save/Load an array.
  * @param array The array being manipulated
@@ -1211,6 +1414,12 @@ void SlArray(void *array, size_t length, VarType conv)
 	 * conversion is needed, use specialized copy-copy function to speed up things */
 	if (conv == SLE_INT8 || conv == SLE_UINT8) {
 		SlCopyBytes(array, length);
+	} else if (_sl.action != SLA_SAVE && (conv == SLE_INT16 || conv == SLE_UINT16)) {
+		SlLoadArrayInPlace((uint16 *)array, length);
+	} else if (_sl.action != SLA_SAVE && (conv == SLE_INT32 || conv == SLE_UINT32)) {
+		SlLoadArrayInPlace((uint32 *)array, length);
+	} else if (_sl.action != SLA_SAVE && (conv == SLE_INT64 || conv == SLE_UINT64)) {
+		SlLoadArrayInPlace((uint64 *)array, length);
 	} else {
 		byte *a = (byte*)array;
 		byte mem_size = SlCalcConvMemLen(conv);
@@ -2204,11 +2413,13 @@ static void SlSaveChunk(const ChunkHandler *ch)
 	/* Don't save any chunk information if there is no save handler. */
 	if (proc == nullptr) return;
 
+	_sl.save_chunk_offsets.emplace_back(ch->id, SlGetBytesWritten());
 	SlWriteUint32(ch->id);
 	DEBUG(sl, 2, "Saving chunk %c%c%c%c", ch->id >> 24, ch->id >> 16, ch->id >> 8, ch->id);
 
-	size_t written = 0;
-	if (_debug_sl_level >= 3) written = SlGetBytesWritten();
+	const size_t written = SlGetBytesWritten();
+	const uint64 start = SlProfileTime();
+	_sl.profile_items = 0;
 
 	_sl.block_mode = ch->flags & CH_TYPE_MASK;
 	switch (ch->flags & CH_TYPE_MASK) {
@@ -2230,6 +2441,8 @@ static void SlSaveChunk(const ChunkHandler *ch)
 		default: NOT_REACHED();
 	}
 
+	_sl.profile.chunks.push_back({ ch->id, SlProfileTime() - start, 0, SlGetBytesWritten() - written, 0, _sl.profile_items });
+
 	DEBUG(sl, 3, "Saved chunk %c%c%c%c (" PRINTF_SIZE " bytes)", ch->id >> 24, ch->id >> 16, ch->id >> 8, ch->id, SlGetBytesWritten() - written);
 }
 
@@ -2241,6 +2454,7 @@ static void SlSaveChunks()
 	}
 
 	/* Terminator */
+	_sl.save_chunk_offsets.emplace_back(0, SlGetBytesWritten());
 	SlWriteUint32(0);
 }
 
@@ -2261,8 +2475,10 @@ static void SlLoadChunks()
 {
 	for (uint32 id = SlReadUint32(); id != 0; id = SlReadUint32()) {
 		DEBUG(sl, 2, "Loading chunk %c%c%c%c", id >> 24, id >> 16, id >> 8, id);
-		size_t read = 0;
-		if (_debug_sl_level >= 3) read = SlGetBytesRead();
+		const size_t read = SlGetBytesRead();
+		const uint64 start = SlProfileTime();
+		const uint64 filter_start = _sl.profile_stream->time_us;
+		_sl.profile_items = 0;
 
 		if (SlXvIsChunkDiscardable(id)) {
 			DEBUG(sl, 1, "Discarding chunk %c%c%c%c", id >> 24, id >> 16, id >> 8, id);
@@ -2275,6 +2491,7 @@ static void SlLoadChunks()
 				SlLoadChunk(ch);
 			}
 		}
+		_sl.profile.chunks.push_back({ id, SlProfileTime() - start, _sl.profile_stream->time_us - filter_start, SlGetBytesRead() - read, 0, _sl.profile_items });
 		DEBUG(sl, 3, "Loaded chunk %c%c%c%c (" PRINTF_SIZE " bytes)", id >> 24, id >> 16, id >> 8, id, SlGetBytesRead() - read);
 	}
 }
@@ -2357,6 +2574,82 @@ struct FileReader : LoadFilter {
 	}
 };
 
+#if defined(UNIX) && !defined(__EMSCRIPTEN__)
+/** Reader mapping the whole file into memory, so its contents can be used in place. */
+struct MMapFileReader : LoadFilter {
+	FILE *file;        ///< The file to read from.
+	const byte *data;  ///< The mapped file.
+	size_t size;       ///< The size of the mapped file.
+	size_t begin;      ///< The begin of the file.
+	size_t pos;        ///< The position we're at reading the file.
+
+	/**
+	 * Create the file reader, so it reads from a specific mapped file.
+	 * @param file The file to read from.
+	 * @param data The mapped file.
+	 * @param size The size of the mapped file.
+	 */
+	MMapFileReader(FILE *file, const byte *data, size_t size) : LoadFilter(nullptr), file(file), data(data), size(size)
+	{
+		this->begin = this->pos = std::min<size_t>(ftell(file), size);
+	}
+
+	/** Make sure everything is cleaned up. */
+	~MMapFileReader()
+	{
+		munmap(const_cast<byte *>(this->data), this->size);
+		fclose(this->file);
+	}
+
+	size_t Read(byte *buf, size_t size) override
+	{
+		size = std::min(size, this->size - this->pos);
+		memcpy(buf, this->data + this->pos, size);
+		this->pos += size;
+		return size;
+	}
+
+	bool SupportsReadSpan() const override
+	{
+		return true;
+	}
+
+	size_t ReadSpan(const byte **buf, size_t size) override
+	{
+		size = std::min(size, this->size - this->pos);
+		*buf = this->data + this->pos;
+		this->pos += size;
+		return size;
+	}
+
+	void Reset() override
+	{
+		this->pos = this->begin;
+	}
+};
+#endif
+
+/**
+ * Create the reader for a savegame file, mapping it into memory when possible.
+ * @param file The file to read from.
+ * @return The reader, owning the file.
+ */
+static LoadFilter *CreateFileReader(FILE *file)
+{
+#if defined(UNIX) && !defined(__EMSCRIPTEN__)
+	struct stat st;
+	if (fstat(fileno(file), &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+		void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+		if (data != MAP_FAILED) {
+			madvise(data, st.st_size, MADV_SEQUENTIAL);
+			return new MMapFileReader(file, static_cast<const byte *>(data), st.st_size);
+		}
+		DEBUG(sl, 1, "Could not map savegame file into memory, reading it instead");
+	}
+#endif
+	return new FileReader(file);
+}
+
 /** Yes, simply writing to a file. */
 struct FileWriter : SaveFilter {
 	FILE *file; ///< The file to write to.
@@ -2505,6 +2798,16 @@ struct NoCompLoadFilter : LoadFilter {
 	{
 		return this->chain->Read(buf, size);
 	}
+
+	bool SupportsReadSpan() const override
+	{
+		return this->chain->SupportsReadSpan();
+	}
+
+	size_t ReadSpan(const byte **buf, size_t size) override
+	{
+		return this->chain->ReadSpan(buf, size);
+	}
 };
 
 /** Filter without any compression. */
@@ -2689,8 +2992,13 @@ struct LZMALoadFilter : LoadFilter {
 		do {
 			/* read more bytes from the file? */
 			if (this->lzma.avail_in == 0) {
-				this->lzma.next_in  = this->fread_buf;
-				this->lzma.avail_in = this->chain->Read(this->fread_buf, sizeof(this->fread_buf));
+				if (this->chain->SupportsReadSpan()) {
+					/* Decompress straight from the mapped file. */
+					this->lzma.avail_in = this->chain->ReadSpan(&this->lzma.next_in, sizeof(this->fread_buf));
+				} else {
+					this->lzma.next_in  = this->fread_buf;
+					this->lzma.avail_in = this->chain->Read(this->fread_buf, sizeof(this->fread_buf));
+				}
 			}
 
 			/* inflate the data */
@@ -2802,7 +3110,15 @@ struct ZSTDLoadFilter : LoadFilter {
 		do {
 			/* read more bytes from the file? */
 			if (this->input.pos == this->input.size) {
-				this->input.size = this->chain->Read(this->fread_buf, sizeof(this->fread_buf));
+				if (this->chain->SupportsReadSpan()) {
+					/* Decompress straight from the mapped file. */
+					const byte *span;
+					this->input.size = this->chain->ReadSpan(&span, sizeof(this->fread_buf));
+					this->input.src = span;
+				} else {
+					this->input.size = this->chain->Read(this->fread_buf, sizeof(this->fread_buf));
+					this->input.src = this->fread_buf;
+				}
 				this->input.pos = 0;
 				if (this->input.size == 0) break;
 			}
@@ -2998,6 +3314,595 @@ static const SaveLoadFormat *GetSavegameFormat(char *s, byte *compression_level,
 	return def;
 }
 
+/*******************************************
+ ************* DELTA SAVEGAMES *************
+ *******************************************/
+
+/** Tag identifying a delta savegame, which only stores the parts which changed since a full savegame. */
+static const uint32 SAVEGAME_DELTA_TAG = TO_BE32X('OTDL');
+/** Version of the contents of delta savegames. */
+static const byte DELTA_SAVE_FORMAT_VERSION = 1;
+/** Size of the blocks in which the chunks of delta savegames are compared against the base savegame. */
+static const size_t DELTA_SAVE_BLOCK_SIZE = 64 * 1024;
+
+/** Types of the segments of a delta savegame. */
+enum DeltaSegmentType : byte {
+	DST_END  = 0, ///< End of the delta savegame.
+	DST_COPY = 1, ///< Copy a range of the chunk stream of the base savegame.
+	DST_DATA = 2, ///< Data stored in the delta savegame itself.
+};
+
+/**
+ * Streaming 64-bit hash of a sequence of bytes.
+ * The result does not depend on how the sequence is split up when adding it.
+ */
+struct DeltaHasher {
+	uint64 state = 0x9E3779B97F4A7C15ULL; ///< Current state of the hash.
+	uint64 pending = 0;                   ///< Bytes not yet mixed into the state, in little endian order.
+	uint pending_bytes = 0;               ///< Number of bytes in #pending.
+	uint64 length = 0;                    ///< Total number of added bytes.
+
+	inline void Mix(uint64 word)
+	{
+		this->state = ROL(this->state ^ (word * 0xC2B2AE3D27D4EB4FULL), 31) * 0x9E3779B185EBCA87ULL;
+	}
+
+	inline void AddByte(byte b)
+	{
+		this->pending |= (uint64)b << (8 * this->pending_bytes);
+		if (++this->pending_bytes == 8) {
+			this->Mix(this->pending);
+			this->pending = 0;
+			this->pending_bytes = 0;
+		}
+	}
+
+	void Add(const byte *data, size_t length)
+	{
+		this->length += length;
+		for (; length > 0 && this->pending_bytes != 0; length--) this->AddByte(*data++);
+		for (; length >= 8; length -= 8, data += 8) {
+			uint64 word;
+			memcpy(&word, data, sizeof(word));
+			this->Mix(FROM_LE64(word));
+		}
+		for (; length > 0; length--) this->AddByte(*data++);
+	}
+
+	uint64 Finish()
+	{
+		this->Mix(this->pending);
+		this->Mix(this->length);
+		return this->state ^ (this->state >> 29);
+	}
+};
+
+/** Full savegame against which the following delta savegames are written. */
+struct DeltaSaveBase {
+	/** A chunk of the base savegame. */
+	struct Chunk {
+		uint32 id;                        ///< Id of the chunk.
+		size_t offset;                    ///< Offset of the chunk in the chunk stream.
+		size_t length;                    ///< Length of the chunk in the chunk stream.
+		std::vector<uint64> block_hashes; ///< Hashes of the blocks of #DELTA_SAVE_BLOCK_SIZE bytes of the chunk.
+	};
+
+	std::string name;          ///< Name of the base savegame in the autosave directory, empty if there is none.
+	size_t size = 0;           ///< Size of the (uncompressed) chunk stream of the base savegame.
+	uint64 hash = 0;           ///< Hash of the chunk stream of the base savegame.
+	std::vector<Chunk> chunks; ///< Chunks of the base savegame, in order.
+	uint deltas_written = 0;   ///< Number of delta savegames written against this base.
+
+	void Clear()
+	{
+		this->name.clear();
+		this->size = 0;
+		this->hash = 0;
+		this->chunks.clear();
+		this->deltas_written = 0;
+	}
+};
+
+/** The base of delta savegames. Only accessed by the saving thread while a save is in progress. */
+static DeltaSaveBase _delta_save_base;
+
+/**
+ * Name of the base savegame of each delta savegame written in this session, by the name of the delta savegame.
+ * Kept when loading a game, as the delta savegames in the autosave directory stay valid.
+ */
+static std::map<std::string, std::string> _delta_save_bases;
+
+/** Random access to the chunk stream held by a finalised memory dumper. */
+struct DumperStreamView {
+	const MemoryDumper *dumper;       ///< The memory dumper holding the chunk stream.
+	std::vector<size_t> block_offsets; ///< Offset in the chunk stream of each block of the dumper.
+	size_t size = 0;                   ///< Size of the chunk stream.
+
+	DumperStreamView(const MemoryDumper *dumper) : dumper(dumper)
+	{
+		for (const MemoryDumper::BufferInfo &block : dumper->blocks) {
+			this->block_offsets.push_back(this->size);
+			this->size += block.size;
+		}
+	}
+
+	/**
+	 * Call a procedure for all pieces of contiguous memory of a range of the chunk stream.
+	 * @param offset Start of the range.
+	 * @param length Length of the range.
+	 * @param proc Procedure to call with the data and length of each piece.
+	 */
+	template <typename F>
+	void Iterate(size_t offset, size_t length, F proc) const
+	{
+		size_t block = std::upper_bound(this->block_offsets.begin(), this->block_offsets.end(), offset) - this->block_offsets.begin() - 1;
+		while (length > 0) {
+			const MemoryDumper::BufferInfo &info = this->dumper->blocks[block];
+			size_t start = offset - this->block_offsets[block];
+			size_t to_do = std::min(info.size - start, length);
+			if (to_do > 0) proc(info.data + start, to_do);
+			offset += to_do;
+			length -= to_do;
+			block++;
+		}
+	}
+
+	uint64 Hash(size_t offset, size_t length) const
+	{
+		DeltaHasher hasher;
+		this->Iterate(offset, length, [&](const byte *data, size_t len) { hasher.Add(data, len); });
+		return hasher.Finish();
+	}
+
+	/**
+	 * Get the range of a saved chunk in the chunk stream.
+	 * @param index Index of the chunk in #SaveLoadParams::save_chunk_offsets.
+	 * @return Offset and length of the chunk.
+	 */
+	std::pair<size_t, size_t> GetChunkRange(size_t index) const
+	{
+		size_t offset = _sl.save_chunk_offsets[index].second;
+		size_t end = (index + 1 < _sl.save_chunk_offsets.size()) ? _sl.save_chunk_offsets[index + 1].second : this->size;
+		return { offset, end - offset };
+	}
+};
+
+/**
+ * Decide whether a save to the autosave directory is written as a delta savegame,
+ * recorded as the base of following delta savegames, or neither.
+ * A base which delta savegames still refer to, the current one or an older one, is
+ * never overwritten by a delta savegame; instead a new base is saved. The delta savegames
+ * of an overwritten base cannot be loaded anymore, they are the oldest autosaves.
+ * @param filename Name of the savegame to write.
+ */
+static void PrepareDeltaSave(const std::string &filename)
+{
+	DeltaSaveBase &base = _delta_save_base;
+	if (filename == base.name) base.Clear();
+
+	/* The savegame previously written under this name is replaced, so it no longer refers to a base,
+	 * and the delta savegames referring to it can no longer be loaded. */
+	_delta_save_bases.erase(filename);
+	bool is_base = false;
+	for (auto it = _delta_save_bases.begin(); it != _delta_save_bases.end();) {
+		if (it->second == filename) {
+			is_base = true;
+			it = _delta_save_bases.erase(it);
+		} else {
+			++it;
+		}
+	}
+
+	if (!(_sl.save_flags & SMF_DELTA) || _settings_client.gui.autosave_deltas == 0) return;
+
+	if (!base.name.empty() && base.deltas_written < _settings_client.gui.autosave_deltas && !is_base) {
+		base.deltas_written++;
+		_sl.delta_mode = DSM_WRITE_DELTA;
+		_delta_save_bases[filename] = base.name;
+	} else {
+		base.Clear();
+		_sl.delta_mode = DSM_RECORD_BASE;
+		_sl.delta_name = filename;
+	}
+}
+
+/** Record the just written savegame as the base of the following delta savegames. */
+static void RecordDeltaSaveBase()
+{
+	DeltaSaveBase &base = _delta_save_base;
+	base.Clear();
+
+	DumperStreamView view(_sl.dumper);
+	base.size = view.size;
+	base.hash = view.Hash(0, view.size);
+	for (size_t i = 0; i < _sl.save_chunk_offsets.size(); i++) {
+		std::pair<size_t, size_t> range = view.GetChunkRange(i);
+		DeltaSaveBase::Chunk chunk{ _sl.save_chunk_offsets[i].first, range.first, range.second, {} };
+		for (size_t block = 0; block < range.second; block += DELTA_SAVE_BLOCK_SIZE) {
+			chunk.block_hashes.push_back(view.Hash(range.first + block, std::min(DELTA_SAVE_BLOCK_SIZE, range.second - block)));
+		}
+		base.chunks.push_back(std::move(chunk));
+	}
+	base.name = _sl.delta_name;
+}
+
+/**
+ * Write the chunk stream in the memory dumper as delta against the recorded base savegame.
+ * Blocks of each chunk which have the same contents as the block at the same position of
+ * the same chunk in the base savegame are copied from there; all other data is stored.
+ * @param writer The filter to write the delta savegame to.
+ */
+static void WriteDeltaSave(SaveFilter *writer)
+{
+	const DeltaSaveBase &base = _delta_save_base;
+	_sl.dumper->FinaliseBlock();
+	DumperStreamView view(_sl.dumper);
+
+	std::vector<byte> buffer;
+	auto put_uint64 = [&](uint64 value) {
+		for (int shift = 56; shift >= 0; shift -= 8) buffer.push_back(GB(value, shift, 8));
+	};
+
+	buffer.push_back(DELTA_SAVE_FORMAT_VERSION);
+	buffer.push_back(GB(base.name.size(), 8, 8));
+	buffer.push_back(GB(base.name.size(), 0, 8));
+	buffer.insert(buffer.end(), base.name.begin(), base.name.end());
+	put_uint64(base.size);
+	put_uint64(base.hash);
+
+	/* Adjacent segments of the same type are merged before writing. */
+	DeltaSegmentType pending_type = DST_END;
+	size_t pending_offset = 0;
+	size_t pending_length = 0;
+	size_t stored_bytes = 0;
+	auto flush_pending = [&]() {
+		if (pending_type == DST_END) return;
+		buffer.push_back(pending_type);
+		if (pending_type == DST_COPY) put_uint64(pending_offset);
+		put_uint64(pending_length);
+		writer->Write(buffer.data(), buffer.size());
+		buffer.clear();
+		if (pending_type == DST_DATA) {
+			view.Iterate(pending_offset, pending_length, [&](byte *data, size_t len) { writer->Write(data, len); });
+			stored_bytes += pending_length;
+		}
+	};
+	auto add_segment = [&](DeltaSegmentType type, size_t offset, size_t length) {
+		if (type == pending_type && pending_offset + pending_length == offset) {
+			pending_length += length;
+			return;
+		}
+		flush_pending();
+		pending_type = type;
+		pending_offset = offset;
+		pending_length = length;
+	};
+
+	/* The base savegame is read sequentially when loading, so the copied ranges have to be increasing. */
+	size_t base_position = 0;
+	size_t next_base_chunk = 0;
+	for (size_t i = 0; i < _sl.save_chunk_offsets.size(); i++) {
+		const uint32 id = _sl.save_chunk_offsets[i].first;
+		std::pair<size_t, size_t> range = view.GetChunkRange(i);
+
+		/* Chunks are always saved in the same order. */
+		const DeltaSaveBase::Chunk *base_chunk = nullptr;
+		for (size_t j = next_base_chunk; j < base.chunks.size(); j++) {
+			if (base.chunks[j].id == id) {
+				base_chunk = &base.chunks[j];
+				next_base_chunk = j + 1;
+				break;
+			}
+		}
+
+		for (size_t block = 0; block < range.second; block += DELTA_SAVE_BLOCK_SIZE) {
+			const size_t length = std::min(DELTA_SAVE_BLOCK_SIZE, range.second - block);
+			if (base_chunk != nullptr && block < base_chunk->length &&
+					std::min(DELTA_SAVE_BLOCK_SIZE, base_chunk->length - block) == length &&
+					base_chunk->offset + block >= base_position &&
+					view.Hash(range.first + block, length) == base_chunk->block_hashes[block / DELTA_SAVE_BLOCK_SIZE]) {
+				add_segment(DST_COPY, base_chunk->offset + block, length);
+				base_position = base_chunk->offset + block + length;
+			} else {
+				add_segment(DST_DATA, range.first + block, length);
+			}
+		}
+	}
+	flush_pending();
+
+	buffer.push_back(DST_END);
+	writer->Write(buffer.data(), buffer.size());
+	writer->Finish();
+
+	DEBUG(sl, 2, "Delta save against '%s': stored " PRINTF_SIZE " of " PRINTF_SIZE " bytes", base.name.c_str(), stored_bytes, view.size);
+}
+
+/**
+ * Read exactly the given number of bytes from a load filter.
+ * @param filter The filter to read from.
+ * @param buf The buffer to read into.
+ * @param size The number of bytes to read.
+ */
+static void DeltaReadExact(LoadFilter *filter, byte *buf, size_t size)
+{
+	while (size > 0) {
+		size_t read = filter->Read(buf, size);
+		if (read == 0) SlErrorCorrupt("Unexpected end of delta savegame");
+		buf += read;
+		size -= read;
+	}
+}
+
+static uint64 DeltaReadUint64(LoadFilter *filter)
+{
+	byte buf[8];
+	DeltaReadExact(filter, buf, sizeof(buf));
+	uint64 value = 0;
+	for (byte b : buf) value = (value << 8) | b;
+	return value;
+}
+
+/** Filter composing the chunk stream of a delta savegame from its own data and its base savegame. */
+struct DeltaLoadFilter : LoadFilter {
+	std::unique_ptr<LoadFilter> base;     ///< The (uncompressed) chunk stream of the base savegame.
+	uint64 base_size;                     ///< Expected size of the chunk stream of the base savegame.
+	uint64 base_hash;                     ///< Expected hash of the chunk stream of the base savegame.
+	uint64 base_position = 0;             ///< Number of bytes read so far from the base savegame.
+	DeltaHasher hasher;                   ///< Hash of the bytes read so far from the base savegame.
+	DeltaSegmentType segment = DST_END;   ///< Type of the current segment.
+	uint64 remaining = 0;                 ///< Remaining bytes of the current segment.
+	bool finished = false;                ///< Whether the end of the delta savegame has been reached.
+
+	/**
+	 * Initialise this filter.
+	 * @param chain The (uncompressed) contents of the delta savegame, positioned after the base savegame information.
+	 * @param base The chunk stream of the base savegame.
+	 * @param base_size Expected size of the chunk stream of the base savegame.
+	 * @param base_hash Expected hash of the chunk stream of the base savegame.
+	 */
+	DeltaLoadFilter(LoadFilter *chain, std::unique_ptr<LoadFilter> base, uint64 base_size, uint64 base_hash) :
+			LoadFilter(chain), base(std::move(base)), base_size(base_size), base_hash(base_hash)
+	{
+	}
+
+	void ReadBase(byte *buf, size_t size)
+	{
+		DeltaReadExact(this->base.get(), buf, size);
+		this->hasher.Add(buf, size);
+		this->base_position += size;
+	}
+
+	/** Skip the given number of bytes of the base savegame. */
+	void SkipBase(uint64 size)
+	{
+		byte buf[4096];
+		while (size > 0) {
+			size_t to_read = (size_t)std::min<uint64>(size, sizeof(buf));
+			this->ReadBase(buf, to_read);
+			size -= to_read;
+		}
+	}
+
+	/** Read the rest of the base savegame and check that it is the one the delta savegame was written against. */
+	void VerifyBase()
+	{
+		byte buf[4096];
+		for (;;) {
+			size_t read = this->base->Read(buf, sizeof(buf));
+			if (read == 0) break;
+			this->hasher.Add(buf, read);
+			this->base_position += read;
+		}
+		if (this->base_position != this->base_size || this->hasher.Finish() != this->base_hash) {
+			SlError(STR_GAME_SAVELOAD_ERROR_BROKEN_SAVEGAME, "Base savegame of the delta savegame has been changed");
+		}
+	}
+
+	/**
+	 * Start the next segment of the delta savegame.
+	 * @return False if the end of the delta savegame has been reached.
+	 */
+	bool NextSegment()
+	{
+		if (this->finished) return false;
+
+		byte type;
+		DeltaReadExact(this->chain, &type, 1);
+		switch (type) {
+			case DST_END:
+				this->VerifyBase();
+				this->finished = true;
+				return false;
+
+			case DST_COPY: {
+				uint64 offset = DeltaReadUint64(this->chain);
+				if (offset < this->base_position) SlErrorCorrupt("Invalid delta savegame copy segment");
+				this->SkipBase(offset - this->base_position);
+				break;
+			}
+
+			case DST_DATA:
+				break;
+
+			default:
+				SlErrorCorrupt("Invalid delta savegame segment");
+		}
+		this->segment = (DeltaSegmentType)type;
+		this->remaining = DeltaReadUint64(this->chain);
+		return true;
+	}
+
+	size_t Read(byte *buf, size_t size) override
+	{
+		size_t read = 0;
+		while (read < size) {
+			if (this->remaining == 0) {
+				if (!this->NextSegment()) break;
+				continue;
+			}
+			size_t to_read = (size_t)std::min<uint64>(size - read, this->remaining);
+			if (this->segment == DST_COPY) {
+				this->ReadBase(buf + read, to_read);
+			} else {
+				DeltaReadExact(this->chain, buf + read, to_read);
+			}
+			read += to_read;
+			this->remaining -= to_read;
+		}
+		/* Advance to the end as soon as possible, so the base savegame is always verified. */
+		while (this->remaining == 0 && this->NextSegment()) {}
+		return read;
+	}
+};
+
+/**
+ * Create the filter composing the chunk stream of a delta savegame.
+ * @param chain The (uncompressed) contents of the delta savegame.
+ * @param version The savegame version in the header of the delta savegame.
+ * @return The new filter.
+ */
+static LoadFilter *CreateDeltaLoadFilter(LoadFilter *chain, uint32 version)
+{
+	byte format_version;
+	DeltaReadExact(chain, &format_version, 1);
+	if (format_version != DELTA_SAVE_FORMAT_VERSION) SlErrorCorrupt("Unknown delta savegame format version");
+
+	byte name_length[2];
+	DeltaReadExact(chain, name_length, 2);
+	std::string name;
+	name.resize((name_length[0] << 8) | name_length[1]);
+	DeltaReadExact(chain, (byte *)name.data(), name.size());
+	uint64 base_size = DeltaReadUint64(chain);
+	uint64 base_hash = DeltaReadUint64(chain);
+
+	DEBUG(sl, 1, "Loading delta savegame against base savegame '%s'", name.c_str());
+
+	FILE *fh = FioFOpenFile(name, "rb", AUTOSAVE_DIR);
+	if (fh == nullptr) SlError(STR_GAME_SAVELOAD_ERROR_FILE_NOT_READABLE, "Base savegame of the delta savegame not found");
+	std::unique_ptr<LoadFilter> base(CreateFileReader(fh));
+
+	uint32 hdr[2];
+	DeltaReadExact(base.get(), (byte *)hdr, sizeof(hdr));
+	if (hdr[1] != version) SlError(STR_GAME_SAVELOAD_ERROR_BROKEN_SAVEGAME, "Base savegame of the delta savegame has a different version");
+
+	const SaveLoadFormat *fmt = _saveload_formats;
+	while (fmt != endof(_saveload_formats) && (fmt->tag != hdr[0] || fmt->init_load == nullptr)) fmt++;
+	if (fmt == endof(_saveload_formats)) SlError(STR_GAME_SAVELOAD_ERROR_BROKEN_SAVEGAME, "Unknown compression format of the base savegame");
+
+	base.reset(fmt->init_load(base.release()));
+	return new DeltaLoadFilter(chain, std::move(base), base_size, base_hash);
+}
+
+/*******************************************
+ ************ SAVEGAME PROFILING ************
+ *******************************************/
+
+static std::mutex _sl_profile_mutex;           ///< Mutex protecting the profiles of the last save and load.
+static SaveLoadProfile _sl_last_save_profile;  ///< Profile of the last save.
+static SaveLoadProfile _sl_last_load_profile;  ///< Profile of the last load.
+
+/**
+ * Write a savegame profile to a buffer.
+ * @param b The buffer to write to.
+ * @param last The last element in the buffer.
+ * @param save Whether the profile is of a save.
+ * @param profile The profile to write.
+ * @param chunks Whether to include the profile of each chunk.
+ * @return Pointer to the terminating '\0' in the buffer.
+ */
+static char *FormatSaveLoadProfile(char *b, const char *last, bool save, const SaveLoadProfile &profile, bool chunks)
+{
+	if (!profile.valid) return b + seprintf(b, last, "No %s profiled\n", save ? "save" : "load");
+
+	if (save) {
+		b += seprintf(b, last, "Save%s: %s, " PRINTF_SIZE " bytes, " PRINTF_SIZE " bytes compressed (%.1f%%)\n",
+				profile.delta ? " (delta)" : "", profile.format, profile.bytes, profile.compressed_bytes,
+				profile.bytes > 0 ? (100.0 * profile.compressed_bytes) / profile.bytes : 0.0);
+		b += seprintf(b, last, "  Chunks: %.3f ms, compression: %.3f ms, writing: %.3f ms\n",
+				profile.chunks_time_us / 1000.0, profile.filter_time_us / 1000.0, profile.write_time_us / 1000.0);
+	} else {
+		b += seprintf(b, last, "Load%s: " PRINTF_SIZE " bytes, " PRINTF_SIZE " bytes compressed (%.1f%%)\n",
+				profile.delta ? " (delta)" : "", profile.bytes, profile.compressed_bytes,
+				profile.bytes > 0 ? (100.0 * profile.compressed_bytes) / profile.bytes : 0.0);
+		b += seprintf(b, last, "  Chunks: %.3f ms, of which reading and decompression: %.3f ms, pointers and after load: %.3f ms\n",
+				profile.chunks_time_us / 1000.0, profile.filter_time_us / 1000.0, profile.post_time_us / 1000.0);
+	}
+	if (!chunks) return b;
+
+	if (save) {
+		b += seprintf(b, last, "  Chunk     Time (ms)        Bytes   Compressed      Items\n");
+	} else {
+		b += seprintf(b, last, "  Chunk     Time (ms)   Read (ms)        Bytes      Items\n");
+	}
+	for (const SaveLoadChunkProfile &chunk : profile.chunks) {
+		b += seprintf(b, last, "  %c%c%c%c  %12.3f", chunk.id >> 24, chunk.id >> 16, chunk.id >> 8, chunk.id, chunk.time_us / 1000.0);
+		if (save) {
+			b += seprintf(b, last, " %12u %12u %10u\n", (uint)chunk.bytes, (uint)chunk.compressed_bytes, chunk.items);
+		} else {
+			b += seprintf(b, last, " %11.3f %12u %10u\n", chunk.filter_time_us / 1000.0, (uint)chunk.bytes, chunk.items);
+		}
+	}
+	return b;
+}
+
+/**
+ * Publish the profile of the current save or load as that of the last one, and write it to the debug output.
+ * @param save Whether the profile is of a save.
+ */
+static void PublishSaveLoadProfile(bool save)
+{
+	_sl.profile.valid = true;
+
+	if (_debug_sl_level >= 1) {
+		char buffer[32768];
+		FormatSaveLoadProfile(buffer, lastof(buffer), save, _sl.profile, _debug_sl_level >= 2);
+		for (char *line = buffer; *line != '\0';) {
+			char *end = strchr(line, '\n');
+			if (end != nullptr) *end = '\0';
+			DEBUG(sl, 1, "%s", line);
+			if (end == nullptr) break;
+			line = end + 1;
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(_sl_profile_mutex);
+	(save ? _sl_last_save_profile : _sl_last_load_profile) = std::move(_sl.profile);
+}
+
+/**
+ * Write the profiles of the last save and load to a buffer.
+ * @param b The buffer to write to.
+ * @param last The last element in the buffer.
+ */
+void DumpSaveLoadStats(char *b, const char *last)
+{
+	std::lock_guard<std::mutex> lock(_sl_profile_mutex);
+	b = FormatSaveLoadProfile(b, last, true, _sl_last_save_profile, true);
+	b += seprintf(b, last, "\n");
+	FormatSaveLoadProfile(b, last, false, _sl_last_load_profile, true);
+}
+
+/**
+ * Write the chunk stream in the memory dumper, recording the compressed size of each chunk.
+ * The compressed sizes are approximate, as compressors buffer their input.
+ * @param writer The filter to write the chunk stream to.
+ * @param counter The filter counting the bytes written by the compressor.
+ */
+static void WriteSaveChunks(SaveFilter *writer, const ProfileSaveFilter *counter)
+{
+	_sl.dumper->FinaliseBlock();
+	DumperStreamView view(_sl.dumper);
+
+	for (size_t i = 0; i < _sl.save_chunk_offsets.size(); i++) {
+		const size_t before = counter->bytes;
+		std::pair<size_t, size_t> range = view.GetChunkRange(i);
+		view.Iterate(range.first, range.second, [&](byte *data, size_t len) { writer->Write(data, len); });
+		if (i < _sl.profile.chunks.size()) _sl.profile.chunks[i].compressed_bytes = counter->bytes - before;
+	}
+
+	writer->Finish();
+}
+
 /* actual loader/saver function */
 void InitializeGame(uint size_x, uint size_y, bool reset_date, bool reset_settings);
 extern bool AfterLoadGame();
@@ -3029,8 +3934,12 @@ static inline void ClearSaveLoadState()
 
 	delete _sl.lf;
 	_sl.lf = nullptr;
+	_sl.profile_file = nullptr;
+	_sl.profile_stream = nullptr;
 
 	_sl.save_flags = SMF_NONE;
+	_sl.delta_mode = DSM_NONE;
+	_sl.save_chunk_offsets.clear();
 
 	GamelogStopAnyAction();
 }
@@ -3101,13 +4010,35 @@ static SaveOrLoadResult SaveFileToDisk(bool threaded)
 
 		DEBUG(sl, 3, "Using compression format: %s, level: %u", fmt->name, compression);
 
-		/* We have written our stuff to memory, now write it to file! */
-		uint32 hdr[2] = { fmt->tag, TO_BE32((uint32) (SAVEGAME_VERSION | SAVEGAME_VERSION_EXT) << 16) };
-		_sl.sf->Write((byte*)hdr, sizeof(hdr));
+		ProfileSaveFilter *counter = new ProfileSaveFilter(_sl.sf);
+		_sl.sf = counter;
 
-		_sl.sf = fmt->init_write(_sl.sf, compression);
-		_sl.dumper->Flush(_sl.sf);
+		const uint64 start = SlProfileTime();
+		if (_sl.delta_mode == DSM_WRITE_DELTA) {
+			/* The tag of the compression format of the contents follows the header of a delta savegame. */
+			uint32 hdr[3] = { SAVEGAME_DELTA_TAG, TO_BE32((uint32) (SAVEGAME_VERSION | SAVEGAME_VERSION_EXT) << 16), fmt->tag };
+			_sl.sf->Write((byte*)hdr, sizeof(hdr));
 
+			_sl.sf = fmt->init_write(_sl.sf, compression);
+			WriteDeltaSave(_sl.sf);
+		} else {
+			/* We have written our stuff to memory, now write it to file! */
+			uint32 hdr[2] = { fmt->tag, TO_BE32((uint32) (SAVEGAME_VERSION | SAVEGAME_VERSION_EXT) << 16) };
+			_sl.sf->Write((byte*)hdr, sizeof(hdr));
+
+			_sl.sf = fmt->init_write(_sl.sf, compression);
+			WriteSaveChunks(_sl.sf, counter);
+		}
+
+		_sl.profile.delta = (_sl.delta_mode == DSM_WRITE_DELTA);
+		_sl.profile.format = fmt->name;
+		_sl.profile.write_time_us = counter->time_us;
+		_sl.profile.filter_time_us = SlProfileTime() - start - counter->time_us;
+		_sl.profile.compressed_bytes = counter->bytes;
+
+		if (_sl.delta_mode == DSM_RECORD_BASE) RecordDeltaSaveBase();
+
+		PublishSaveLoadProfile(true);
 		ClearSaveLoadState();
 
 		if (threaded) SetAsyncSaveFinish(SaveFileDone);
@@ -3164,7 +4095,12 @@ static SaveOrLoadResult DoSave(SaveFilter *writer, bool threaded)
 	SlXvSetCurrentState();
 
 	SaveViewportBeforeSaveGame();
+	_sl.save_chunk_offsets.clear();
+	_sl.profile = SaveLoadProfile();
+	const uint64 start = SlProfileTime();
 	SlSaveChunks();
+	_sl.profile.chunks_time_us = SlProfileTime() - start;
+	_sl.profile.bytes = SlGetBytesWritten();
 
 	SaveFileStart();
 
@@ -3318,7 +4254,9 @@ struct ThreadedLoadFilter : LoadFilter {
  */
 static SaveOrLoadResult DoLoad(LoadFilter *reader, bool load_check)
 {
-	_sl.lf = reader;
+	_sl.profile = SaveLoadProfile();
+	_sl.profile_file = new ProfileLoadFilter(reader);
+	_sl.lf = _sl.profile_file;
 
 	if (load_check) {
 		/* Clear previous check data */
@@ -3336,11 +4274,19 @@ static SaveOrLoadResult DoLoad(LoadFilter *reader, bool load_check)
 	uint32 hdr[2];
 	if (_sl.lf->Read((byte*)hdr, sizeof(hdr)) != sizeof(hdr)) SlError(STR_GAME_SAVELOAD_ERROR_FILE_NOT_READABLE);
 
+	const bool is_delta = (hdr[0] == SAVEGAME_DELTA_TAG);
+	if (is_delta) {
+		/* The contents of a delta savegame are compressed with the format of the following tag. */
+		if (_sl.lf->Read((byte*)hdr, sizeof(hdr[0])) != sizeof(hdr[0])) SlError(STR_GAME_SAVELOAD_ERROR_FILE_NOT_READABLE);
+	}
+
 	/* see if we have any loader for this type. */
 	const SaveLoadFormat *fmt = _saveload_formats;
 	for (;;) {
 		/* No loader found, treat as version 0 and use LZO format */
 		if (fmt == endof(_saveload_formats)) {
+			if (is_delta) SlErrorCorrupt("Unknown compression format of delta savegame");
+
 			DEBUG(sl, 0, "Unknown savegame type, trying to load it as the buggy format");
 			_sl.lf->Reset();
 			_sl_version = SL_MIN_VERSION;
@@ -3396,9 +4342,13 @@ static SaveOrLoadResult DoLoad(LoadFilter *reader, bool load_check)
 	}
 
 	_sl.lf = fmt->init_load(_sl.lf);
-	if (!(fmt->flags & SLF_NO_THREADED_LOAD)) {
+	/* Reading in place from a mapped uncompressed file is faster than copying it on another thread. */
+	if (!(fmt->flags & SLF_NO_THREADED_LOAD) && !_sl.lf->SupportsReadSpan()) {
 		_sl.lf = new ThreadedLoadFilter(_sl.lf);
 	}
+	if (is_delta) _sl.lf = CreateDeltaLoadFilter(_sl.lf, hdr[1]);
+	_sl.profile_stream = new ProfileLoadFilter(_sl.lf);
+	_sl.lf = _sl.profile_stream;
 	_sl.reader = new ReadBuffer(_sl.lf);
 	_next_offs = 0;
 
@@ -3444,10 +4394,17 @@ static SaveOrLoadResult DoLoad(LoadFilter *reader, bool load_check)
 		SlLoadCheckChunks();
 	} else {
 		/* Load chunks and resolve references */
+		const uint64 start = SlProfileTime();
 		SlLoadChunks();
+		_sl.profile.chunks_time_us = SlProfileTime() - start;
 		SlFixPointers();
+		_sl.profile.post_time_us = SlProfileTime() - start - _sl.profile.chunks_time_us;
 	}
 
+	_sl.profile.delta = is_delta;
+	_sl.profile.filter_time_us = _sl.profile_stream->time_us;
+	_sl.profile.bytes = SlGetBytesRead();
+	_sl.profile.compressed_bytes = _sl.profile_file->bytes;
 	ClearSaveLoadState();
 
 	_savegame_type = SGT_OTTD;
@@ -3460,13 +4417,17 @@ static SaveOrLoadResult DoLoad(LoadFilter *reader, bool load_check)
 
 		/* After loading fix up savegame for any internal changes that
 		 * might have occurred since then. If it fails, load back the old game. */
+		const uint64 start = SlProfileTime();
 		if (!AfterLoadGame()) {
 			GamelogStopAction();
 			return SL_REINIT;
 		}
+		_sl.profile.post_time_us += SlProfileTime() - start;
 
 		GamelogStopAction();
 		SlXvSetCurrentState();
+
+		PublishSaveLoadProfile(false);
 	}
 
 	return SL_OK;
@@ -3567,13 +4528,16 @@ SaveOrLoadResult SaveOrLoad(const std::string &filename, SaveLoadOperation fop,
 			DEBUG(desync, 1, "save: date{%08x; %02x; %02x}; %s", _date, _date_fract, _tick_skip_counter, filename.c_str());
 			if (!_settings_client.gui.threaded_saves) threaded = false;
 
+			if (sb == AUTOSAVE_DIR) PrepareDeltaSave(filename);
+
 			return DoSave(new FileWriter(fh), threaded);
 		}
 
 		/* LOAD game */
 		assert(fop == SLO_LOAD || fop == SLO_CHECK);
+		if (fop == SLO_LOAD) _delta_save_base.Clear();
 		DEBUG(desync, 1, "load: %s", filename.c_str());
-		return DoLoad(new FileReader(fh), fop == SLO_CHECK);
+		return DoLoad(CreateFileReader(fh), fop == SLO_CHECK);
 	} catch (...) {
 		/* This code may be executed both for old and new save games. */
 		ClearSaveLoadState();
@@ -393,6 +393,7 @@ enum SaveModeFlags : byte {
 	SMF_NONE             = 0,
 	SMF_NET_SERVER       = 1 << 0, ///< Network server save
 	SMF_ZSTD_OK          = 1 << 1, ///< Zstd OK
+	SMF_DELTA            = 1 << 2, ///< Autosave which may be written as delta against the previous full autosave
 };
 DECLARE_ENUM_AS_BIT_SET(SaveModeFlags);
 
@@ -27,18 +27,17 @@ static const size_t MEMORY_CHUNK_SIZE = 128 * 1024;
 /** A buffer for reading (and buffering) savegame data. */
 struct ReadBuffer {
 	byte buf[MEMORY_CHUNK_SIZE]; ///< Buffer we're going to read from.
-	byte *bufp;                  ///< Location we're at reading the buffer.
-	byte *bufe;                  ///< End of the buffer we can read from.
+	const byte *bufp;            ///< Location we're at reading the buffer.
+	const byte *bufe;            ///< End of the buffer we can read from.
 	LoadFilter *reader;          ///< The filter used to actually read.
 	size_t read;                 ///< The amount of read bytes so far from the filter.
+	bool use_spans;              ///< Whether bytes are read in place from the filter, instead of being copied into #buf.
 
 	/**
 	 * Initialise our variables.
 	 * @param reader The filter to actually read data.
 	 */
-	ReadBuffer(LoadFilter *reader) : bufp(nullptr), bufe(nullptr), reader(reader), read(0)
-	{
-	}
+	ReadBuffer(LoadFilter *reader);
 
 	static ReadBuffer *GetCurrent();
 
@@ -47,7 +46,7 @@ struct ReadBuffer {
 
 	inline void SkipBytes(size_t bytes)
 	{
-		byte *b = this->bufp + bytes;
+		const byte *b = this->bufp + bytes;
 		if (likely(b <= this->bufe)) {
 			this->bufp = b;
 		} else {
@@ -60,6 +59,8 @@ struct ReadBuffer {
 		return *this->bufp++;
 	}
 
+	size_t AcquireSpan(const byte **data, size_t max_len);
+
 	inline byte ReadByte()
 	{
 		if (unlikely(this->bufp == this->bufe)) {
@@ -37,6 +37,28 @@ struct LoadFilter {
 	 */
 	virtual size_t Read(byte *buf, size_t len) = 0;
 
+	/**
+	 * Whether this filter can provide the savegame data in place, see #ReadSpan.
+	 * @return True if #ReadSpan is supported.
+	 */
+	virtual bool SupportsReadSpan() const
+	{
+		return false;
+	}
+
+	/**
+	 * Read a given number of bytes from the savegame without copying them.
+	 * The returned bytes stay valid until the filter is destroyed.
+	 * Only supported when #SupportsReadSpan returns true.
+	 * @param buf Output for the location of the bytes.
+	 * @param len The maximum number of bytes to read.
+	 * @return The number of actually read bytes.
+	 */
+	virtual size_t ReadSpan(const byte **buf, size_t len)
+	{
+		NOT_REACHED();
+	}
+
 	/**
 	 * Reset this filter to read from the beginning of the file.
 	 */
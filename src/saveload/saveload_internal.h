@@ -13,8 +13,12 @@
 #include "../company_manager_face.h"
 #include "../order_base.h"
 #include "../engine_type.h"
+#include "../map_func.h"
+#include "../thread.h"
 #include "saveload.h"
 
+#include <vector>
+
 void InitializeOldNames();
 StringID RemapOldStringID(StringID s);
 std::string CopyFromOldName(StringID id);
@@ -66,4 +70,44 @@ CompanyManagerFace ConvertFromOldCompanyManagerFace(uint32 face);
 
 Order UnpackOldOrder(uint16 packed);
 
+/** Minimum number of tiles per thread when running a tile pass in parallel. */
+static const uint AFTERLOAD_PARALLEL_MIN_TILES = 1 << 16;
+
+/**
+ * Run a per-tile conversion or cache update pass over the whole map.
+ * The map is split into contiguous ranges of tiles which are processed by multiple threads.
+ * Therefore the pass may only read and modify the map array of the tile it is called for,
+ * it must not look at other tiles, modify any other state or raise savegame errors.
+ * Passes which do not fulfil this have to use a plain sequential loop.
+ * @param proc Procedure to call for each tile of the map.
+ */
+template <typename F>
+void RunParallelTilePass(F proc)
+{
+	const TileIndex map_size = MapSize();
+
+	auto run = [&](TileIndex begin, TileIndex end) {
+		for (TileIndex t = begin; t < end; t++) {
+			proc(t);
+		}
+	};
+
+	uint threads = Clamp<uint>(std::thread::hardware_concurrency(), 1, 16);
+	threads = std::max<uint>(1, std::min<uint>(threads, map_size / AFTERLOAD_PARALLEL_MIN_TILES));
+	std::vector<std::thread> workers;
+	TileIndex per_thread = CeilDiv(map_size, threads);
+	for (uint i = 1; i < threads; i++) {
+		TileIndex begin = std::min<TileIndex>(map_size, i * per_thread);
+		TileIndex end = std::min<TileIndex>(map_size, begin + per_thread);
+		std::thread worker;
+		if (!StartNewThread(&worker, "ottd:afterload", std::ref(run), TileIndex(begin), TileIndex(end))) {
+			run(begin, end);
+			continue;
+		}
+		workers.push_back(std::move(worker));
+	}
+	run(0, std::min<TileIndex>(map_size, per_thread));
+	for (std::thread &worker : workers) worker.join();
+}
+
 #endif /* SAVELOAD_INTERNAL_H */
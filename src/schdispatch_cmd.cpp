@@ -20,6 +20,7 @@
 #include "settings_type.h"
 #include "schdispatch.h"
 #include "vehicle_gui.h"
+#include "departures_func.h"
 
 #include <algorithm>
 
@@ -53,6 +54,7 @@ CommandCost CmdScheduledDispatch(TileIndex tile, DoCommandFlag flags, uint32 p1,
 	if (ret.Failed()) return ret;
 
 	if (flags & DC_EXEC) {
+		InvalidateDepartureCache(v);
 		for (Vehicle *v2 = v->FirstShared(); v2 != nullptr; v2 = v2->NextShared()) {
 			if (HasBit(p2, 0)) {
 				SetBit(v2->vehicle_flags, VF_SCHEDULED_DISPATCH);
@@ -89,6 +91,7 @@ CommandCost CmdScheduledDispatchAdd(TileIndex tile, DoCommandFlag flags, uint32
 	if (v->orders.list == nullptr) return CMD_ERROR;
 
 	if (flags & DC_EXEC) {
+		InvalidateDepartureCache(v);
 		v->orders.list->AddScheduledDispatch(p2);
 		SetWindowDirty(WC_SCHDISPATCH_SLOTS, v->index);
 	}
@@ -118,6 +121,7 @@ CommandCost CmdScheduledDispatchRemove(TileIndex tile, DoCommandFlag flags, uint
 	if (v->orders.list == nullptr) return CMD_ERROR;
 
 	if (flags & DC_EXEC) {
+		InvalidateDepartureCache(v);
 		v->orders.list->RemoveScheduledDispatch(p2);
 		SetWindowDirty(WC_SCHDISPATCH_SLOTS, v->index);
 	}
@@ -148,6 +152,7 @@ CommandCost CmdScheduledDispatchSetDuration(TileIndex tile, DoCommandFlag flags,
 	if (v->orders.list == nullptr) return CMD_ERROR;
 
 	if (flags & DC_EXEC) {
+		InvalidateDepartureCache(v);
 		v->orders.list->SetScheduledDispatchDuration(p2);
 		v->orders.list->UpdateScheduledDispatch();
 		SetWindowDirty(WC_SCHDISPATCH_SLOTS, v->index);
@@ -191,6 +196,7 @@ CommandCost CmdScheduledDispatchSetStartDate(TileIndex tile, DoCommandFlag flags
 	uint16 full_date_fract = (GB(p1, 20, 12) << 2) + GB(p2, 30, 2);
 
 	if (flags & DC_EXEC) {
+		InvalidateDepartureCache(v);
 		v->orders.list->SetScheduledDispatchStartDate(date, full_date_fract);
 		v->orders.list->UpdateScheduledDispatch();
 		SetWindowDirty(WC_SCHDISPATCH_SLOTS, v->index);
@@ -222,6 +228,7 @@ CommandCost CmdScheduledDispatchSetDelay(TileIndex tile, DoCommandFlag flags, ui
 	if (v->orders.list == nullptr) return CMD_ERROR;
 
 	if (flags & DC_EXEC) {
+		InvalidateDepartureCache(v);
 		v->orders.list->SetScheduledDispatchDelay(p2);
 		SetWindowDirty(WC_SCHDISPATCH_SLOTS, v->index);
 	}
@@ -257,6 +264,7 @@ CommandCost CmdScheduledDispatchResetLastDispatch(TileIndex tile, DoCommandFlag
 	if (v->orders.list == nullptr) return CMD_ERROR;
 
 	if (flags & DC_EXEC) {
+		InvalidateDepartureCache(v);
 		v->orders.list->SetScheduledDispatchLastDispatch(0);
 		SetWindowDirty(WC_SCHDISPATCH_SLOTS, v->index);
 	}
@@ -344,7 +352,10 @@ void OrderList::UpdateScheduledDispatch()
 				&this->scheduled_dispatch_start_date, &this->scheduled_dispatch_start_full_date_fract);
 		update_windows = true;
 	}
-	if (update_windows) InvalidateWindowClassesData(WC_SCHDISPATCH_SLOTS, VIWD_MODIFY_ORDERS);
+	if (update_windows) {
+		InvalidateWindowClassesData(WC_SCHDISPATCH_SLOTS, VIWD_MODIFY_ORDERS);
+		InvalidateDepartureCache(this->first_shared);
+	}
 }
 
 /**
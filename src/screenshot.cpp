@@ -240,6 +240,15 @@ static bool MakeBMPImage(const char *name, ScreenshotCallback *callb, void *user
  *********************************************************/
 #if defined(WITH_PNG)
 #include <png.h>
+#include <zlib.h>
+#include "thread.h"
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#if defined(__MINGW32__)
+#include "3rdparty/mingw-std-threads/mingw.mutex.h"
+#include "3rdparty/mingw-std-threads/mingw.condition_variable.h"
+#endif
 
 #ifdef PNG_TEXT_SUPPORTED
 #include "rev.h"
@@ -260,6 +269,281 @@ static void PNGAPI png_my_warning(png_structp png_ptr, png_const_charp message)
 	DEBUG(misc, 1, "[libpng] warning: %s - %s", message, (const char *)png_get_error_ptr(png_ptr));
 }
 
+/**
+ * A strip of lines of a PNG image. The strips are deflated independently,
+ * and their output is concatenated into one zlib stream.
+ */
+struct PNGStrip {
+	std::vector<byte> pixels; ///< Pixels as generated by the screenshot callback.
+	std::vector<byte> prior;  ///< Pixels of the line before the strip, empty for the first strip.
+	uint lines = 0;           ///< Number of lines in the strip.
+	bool last = false;        ///< Whether this is the last strip of the image.
+	bool done = false;        ///< Whether #data and #adler are filled.
+	bool failed = false;      ///< Whether deflating the lines failed.
+	std::vector<byte> data;   ///< The deflated lines.
+	uLong adler = 0;          ///< Adler-32 checksum of the lines before deflating.
+};
+
+/**
+ * Convert a line of pixels, as generated by the screenshot callback, to PNG image data.
+ * @param dst Destination of the image data.
+ * @param src The pixels.
+ * @param w Width of the image in pixels.
+ * @param pixelformat Bits per pixel, either 8 or 32.
+ */
+static void ConvertPNGLine(byte *dst, const byte *src, uint w, int pixelformat)
+{
+	if (pixelformat == 8) {
+		memcpy(dst, src, w);
+		return;
+	}
+	const Colour *colour = (const Colour *)src;
+	for (uint x = 0; x < w; x++, colour++) {
+		*dst++ = colour->r;
+		*dst++ = colour->g;
+		*dst++ = colour->b;
+	}
+}
+
+/**
+ * The Paeth predictor of PNG.
+ * @param a Byte to the left.
+ * @param b Byte above.
+ * @param c Byte above and to the left.
+ * @return Whichever of \a a, \a b and \a c is closest to a + b - c.
+ */
+static inline byte PaethPredictor(byte a, byte b, byte c)
+{
+	int pa = abs(b - c);
+	int pb = abs(a - c);
+	int pc = abs(a + b - 2 * c);
+	if (pa <= pb && pa <= pc) return a;
+	return pb <= pc ? b : c;
+}
+
+/**
+ * Filter a line of RGB image data with the filter which is likely to compress best.
+ * Like libpng, all filters are tried and the one with the lowest sum of
+ * absolute differences is chosen.
+ * @param dst Destination of the filter type followed by the filtered line.
+ * @param cur The line to filter.
+ * @param prior The line above, all zeros for the first line of the image.
+ * @param len Length of the line in bytes.
+ * @param scratch Buffer of \a len bytes for the candidates.
+ */
+static void FilterPNGLine(byte *dst, const byte *cur, const byte *prior, size_t len, byte *scratch)
+{
+	static const uint BPP = 3; // Bytes per pixel of RGB lines.
+
+	/* 'None' is the first candidate. */
+	uint64 best_sum = 0;
+	for (size_t i = 0; i < len; i++) best_sum += abs((int8)cur[i]);
+	dst[0] = 0;
+	memcpy(dst + 1, cur, len);
+
+	for (byte type = 1; type <= 4; type++) {
+		uint64 sum = 0;
+		for (size_t i = 0; i < len && sum < best_sum; i++) {
+			byte a = i >= BPP ? cur[i - BPP] : 0;
+			byte b = prior[i];
+			byte c = i >= BPP ? prior[i - BPP] : 0;
+			byte predictor;
+			switch (type) {
+				case 1: predictor = a; break;
+				case 2: predictor = b; break;
+				case 3: predictor = (a + b) / 2; break;
+				default: predictor = PaethPredictor(a, b, c); break;
+			}
+			scratch[i] = cur[i] - predictor;
+			sum += abs((int8)scratch[i]);
+		}
+		if (sum < best_sum) {
+			best_sum = sum;
+			dst[0] = type;
+			memcpy(dst + 1, scratch, len);
+		}
+	}
+}
+
+/**
+ * Convert the pixels of a strip to PNG image data and deflate them.
+ * Non-final strips end at a byte boundary with an empty stored block, so the
+ * outputs of all strips form a valid deflate stream when concatenated.
+ * On failure, #PNGStrip::failed is set.
+ * @param strip The strip to compress.
+ * @param w Width of the image in pixels.
+ * @param pixelformat Bits per pixel, either 8 or 32.
+ */
+static void CompressPNGStrip(PNGStrip &strip, uint w, int pixelformat)
+{
+	/* Each line starts with the filter type. As libpng does, palette images are not
+	 * filtered, and each line of RGB images gets the filter which suits it best. */
+	size_t row_size = (size_t)w * (pixelformat == 8 ? 1 : 3);
+	size_t line_size = 1 + row_size;
+	std::vector<byte> raw(line_size * strip.lines);
+	std::vector<byte> prior(row_size, 0);
+	std::vector<byte> cur(row_size);
+	std::vector<byte> scratch(row_size);
+	if (!strip.prior.empty()) ConvertPNGLine(prior.data(), strip.prior.data(), w, pixelformat);
+	for (uint i = 0; i < strip.lines; i++) {
+		byte *dst = raw.data() + i * line_size;
+		ConvertPNGLine(cur.data(), strip.pixels.data() + (size_t)i * w * (pixelformat / 8), w, pixelformat);
+		if (pixelformat == 8) {
+			dst[0] = 0;
+			memcpy(dst + 1, cur.data(), row_size);
+		} else {
+			FilterPNGLine(dst, cur.data(), prior.data(), row_size, scratch.data());
+		}
+		std::swap(cur, prior);
+	}
+	strip.adler = adler32(adler32(0, nullptr, 0), raw.data(), (uInt)raw.size());
+
+	z_stream z;
+	memset(&z, 0, sizeof(z));
+	strip.failed = false;
+	if (deflateInit2(&z, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, pixelformat == 8 ? Z_DEFAULT_STRATEGY : Z_FILTERED) != Z_OK) {
+		DEBUG(misc, 0, "Failed to initialise the PNG compressor");
+		strip.failed = true;
+		strip.data.clear();
+		return;
+	}
+	z.next_in = raw.data();
+	z.avail_in = (uInt)raw.size();
+
+	strip.data.resize(deflateBound(&z, (uLong)raw.size()) + 64);
+	size_t used = 0;
+	int flush = strip.last ? Z_FINISH : Z_FULL_FLUSH;
+	for (;;) {
+		z.next_out = strip.data.data() + used;
+		z.avail_out = (uInt)(strip.data.size() - used);
+		int r = deflate(&z, flush);
+		if (r != Z_OK && r != Z_STREAM_END && r != Z_BUF_ERROR) {
+			DEBUG(misc, 0, "Failed to compress PNG image data");
+			strip.failed = true;
+			used = 0;
+			break;
+		}
+		used = strip.data.size() - z.avail_out;
+		if (strip.last ? r == Z_STREAM_END : (z.avail_in == 0 && z.avail_out != 0)) break;
+		strip.data.resize(strip.data.size() * 2);
+	}
+	deflateEnd(&z);
+	strip.data.resize(used);
+}
+
+/** Pool of threads deflating the strips of a PNG image. */
+struct PNGStripCompressor {
+	uint w;                              ///< Width of the image in pixels.
+	int pixelformat;                     ///< Bits per pixel, either 8 or 32.
+	std::mutex lock;                     ///< Lock for #queue, #exit and the #PNGStrip::done flags.
+	std::condition_variable work_cv;     ///< Signalled when a strip is queued, or on exit.
+	std::condition_variable done_cv;     ///< Signalled when a strip has been compressed.
+	std::deque<PNGStrip *> queue;        ///< Strips waiting to be compressed.
+	bool exit = false;                   ///< Whether the threads have to stop.
+	std::vector<std::thread> workers;    ///< The threads.
+
+	/**
+	 * Start the threads.
+	 * @param w Width of the image in pixels.
+	 * @param pixelformat Bits per pixel, either 8 or 32.
+	 * @param threads Number of threads to start.
+	 */
+	PNGStripCompressor(uint w, int pixelformat, uint threads) : w(w), pixelformat(pixelformat)
+	{
+		for (uint i = 0; i < threads; i++) {
+			std::thread worker;
+			if (!StartNewThread(&worker, "ottd:png", &PNGStripCompressor::Run, this)) break;
+			this->workers.push_back(std::move(worker));
+		}
+	}
+
+	~PNGStripCompressor()
+	{
+		{
+			std::lock_guard<std::mutex> lk(this->lock);
+			this->exit = true;
+		}
+		this->work_cv.notify_all();
+		for (std::thread &worker : this->workers) worker.join();
+	}
+
+	/**
+	 * Compress queued strips until told to exit.
+	 * @param self The compressor to work for.
+	 */
+	static void Run(PNGStripCompressor *self)
+	{
+		std::unique_lock<std::mutex> lk(self->lock);
+		for (;;) {
+			self->work_cv.wait(lk, [&]() { return self->exit || !self->queue.empty(); });
+			if (self->exit) return;
+			PNGStrip *strip = self->queue.front();
+			self->queue.pop_front();
+
+			lk.unlock();
+			CompressPNGStrip(*strip, self->w, self->pixelformat);
+			lk.lock();
+
+			strip->done = true;
+			self->done_cv.notify_all();
+		}
+	}
+
+	/**
+	 * Compress a strip, in the background when there are threads.
+	 * @param strip The strip.
+	 */
+	void Add(PNGStrip &strip)
+	{
+		strip.done = false;
+		if (this->workers.empty()) {
+			CompressPNGStrip(strip, this->w, this->pixelformat);
+			strip.done = true;
+			return;
+		}
+		{
+			std::lock_guard<std::mutex> lk(this->lock);
+			this->queue.push_back(&strip);
+		}
+		this->work_cv.notify_one();
+	}
+
+	/**
+	 * Wait until a strip has been compressed.
+	 * @param strip The strip.
+	 */
+	void Wait(PNGStrip &strip)
+	{
+		std::unique_lock<std::mutex> lk(this->lock);
+		this->done_cv.wait(lk, [&]() { return strip.done; });
+	}
+};
+
+/**
+ * Write a PNG chunk.
+ * @param f File to write to.
+ * @param type Type of the chunk.
+ * @param prefix Data to write before \a data, may be \c nullptr when \a prefix_len is 0.
+ * @param prefix_len Length of \a prefix.
+ * @param data Data of the chunk, may be \c nullptr when \a len is 0.
+ * @param len Length of \a data.
+ * @return Whether the chunk was written.
+ */
+static bool WritePNGChunk(FILE *f, const char type[4], const byte *prefix, size_t prefix_len, const byte *data, size_t len)
+{
+	uint32 header[2] = { TO_BE32((uint32)(prefix_len + len)), 0 };
+	memcpy(&header[1], type, 4);
+	uLong crc = crc32(crc32(0, nullptr, 0), (const Bytef *)&header[1], 4);
+	if (prefix_len != 0) crc = crc32(crc, prefix, (uInt)prefix_len);
+	if (len != 0) crc = crc32(crc, data, (uInt)len);
+	uint32 footer = TO_BE32((uint32)crc);
+
+	return fwrite(header, sizeof(header), 1, f) == 1 &&
+			(prefix_len == 0 || fwrite(prefix, prefix_len, 1, f) == 1) &&
+			(len == 0 || fwrite(data, len, 1, f) == 1) &&
+			fwrite(&footer, sizeof(footer), 1, f) == 1;
+}
+
 /**
  * Generic .PNG file image writer.
  * @param name        Filename, including extension.
@@ -276,8 +560,7 @@ static bool MakePNGImage(const char *name, ScreenshotCallback *callb, void *user
 {
 	png_color rq[256];
 	FILE *f;
-	uint i, y, n;
-	uint maxlines;
+	uint i;
 	uint bpp = pixelformat / 8;
 	png_structp png_ptr;
 	png_infop info_ptr;
@@ -367,54 +650,57 @@ static bool MakePNGImage(const char *name, ScreenshotCallback *callb, void *user
 	}
 
 	png_write_info(png_ptr, info_ptr);
-	png_set_flush(png_ptr, 512);
-
-	if (pixelformat == 32) {
-		png_color_8 sig_bit;
-
-		/* Save exact colour/alpha resolution */
-		sig_bit.alpha = 0;
-		sig_bit.blue  = 8;
-		sig_bit.green = 8;
-		sig_bit.red   = 8;
-		sig_bit.gray  = 8;
-		png_set_sBIT(png_ptr, info_ptr, &sig_bit);
-
-#if TTD_ENDIAN == TTD_LITTLE_ENDIAN
-		png_set_bgr(png_ptr);
-		png_set_filler(png_ptr, 0, PNG_FILLER_AFTER);
-#else
-		png_set_filler(png_ptr, 0, PNG_FILLER_BEFORE);
-#endif /* TTD_ENDIAN == TTD_LITTLE_ENDIAN */
-	}
-
-	/* use by default 64k temp memory */
-	maxlines = Clamp(65536 / w, 16, 128);
-
-	/* now generate the bitmap bits */
-	void *buff = CallocT<uint8>(w * maxlines * bpp); // by default generate 128 lines at a time.
-
-	y = 0;
-	do {
-		/* determine # lines to write */
-		n = std::min(h - y, maxlines);
-
-		/* render the pixels into the buffer */
-		callb(userdata, buff, y, w, n);
-		y += n;
+	png_destroy_write_struct(&png_ptr, &info_ptr);
 
-		/* write them to png */
-		for (i = 0; i != n; i++) {
-			png_write_row(png_ptr, (png_bytep)buff + i * w * bpp);
+	/* The image data is written by ourselves instead of libpng, so strips of lines can be
+	 * deflated by multiple threads while the next lines are generated. The number of strips
+	 * in flight is limited, so memory use does not depend on the size of the image. */
+	uint threads = Clamp<uint>(std::thread::hardware_concurrency(), 1, 16);
+	PNGStripCompressor compressor(w, pixelformat, threads > 1 ? threads : 0);
+	std::vector<PNGStrip> strips(compressor.workers.empty() ? 1 : threads * 2);
+
+	/* Generate about 1 MiB of pixels per strip. */
+	uint maxlines = Clamp<uint>((1 << 20) / (w * bpp), 16, 1024);
+	uint num_strips = CeilDiv(h, maxlines);
+
+	static const byte zlib_header[] = { 0x78, 0x9C };
+	uLong adler = adler32(0, nullptr, 0);
+	bool success = true;
+	uint next_generate = 0;
+	std::vector<byte> prior_line; // Last line of the previously generated strip.
+	for (uint next_write = 0; next_write < num_strips; next_write++) {
+		/* Generate the pixels of as many strips as there is room for. */
+		for (; next_generate < num_strips && next_generate - next_write < strips.size(); next_generate++) {
+			PNGStrip &strip = strips[next_generate % strips.size()];
+			uint y = next_generate * maxlines;
+			strip.lines = std::min(h - y, maxlines);
+			strip.last = (next_generate == num_strips - 1);
+			strip.pixels.resize((size_t)w * strip.lines * bpp);
+
+			/* render the pixels into the buffer */
+			callb(userdata, strip.pixels.data(), y, w, strip.lines);
+
+			/* The filters of the first line of the strip look at the last line of the previous strip. */
+			strip.prior.swap(prior_line);
+			prior_line.assign(strip.pixels.end() - (size_t)w * bpp, strip.pixels.end());
+			compressor.Add(strip);
 		}
-	} while (y != h);
 
-	png_write_end(png_ptr, info_ptr);
-	png_destroy_write_struct(&png_ptr, &info_ptr);
+		/* Write the oldest strip to the png. */
+		PNGStrip &strip = strips[next_write % strips.size()];
+		compressor.Wait(strip);
+		if (strip.failed) success = false;
+		adler = adler32_combine(adler, strip.adler, (z_off_t)(1 + (size_t)w * (pixelformat == 8 ? 1 : 3)) * strip.lines);
+		if (success) success = WritePNGChunk(f, "IDAT", zlib_header, next_write == 0 ? sizeof(zlib_header) : 0, strip.data.data(), strip.data.size());
+		if (strip.last) {
+			uint32 checksum = TO_BE32((uint32)adler);
+			if (success) success = WritePNGChunk(f, "IDAT", nullptr, 0, (const byte *)&checksum, sizeof(checksum));
+		}
+	}
+	if (success) success = WritePNGChunk(f, "IEND", nullptr, 0, nullptr, 0);
 
-	free(buff);
 	fclose(f);
-	return true;
+	return success;
 }
 #endif /* WITH_PNG */
 
@@ -78,6 +78,7 @@
 #include "void_map.h"
 #include "station_base.h"
 #include "infrastructure_func.h"
+#include "departures_func.h"
 
 #if defined(WITH_FREETYPE) || defined(_WIN32) || defined(WITH_COCOA)
 #define HAS_TRUETYPE_FONT
@@ -1302,6 +1303,13 @@ static bool TownFoundingChanged(int32 p1)
 	return true;
 }
 
+/** Recompute the departure boards after a setting changed which affects their contents. */
+static bool InvalidateDepartureBoardsCallback(int32 p1)
+{
+	InvalidateDepartureBoards();
+	return true;
+}
+
 static bool InvalidateVehTimetableWindow(int32 p1)
 {
 	InvalidateWindowClassesData(WC_VEHICLE_TIMETABLE, VIWD_MODIFY_ORDERS);
@@ -1510,9 +1518,6 @@ static bool CheckYapfRailSignalPenalties(int32)
 
 static bool ViewportMapShowTunnelModeChanged(int32 p1)
 {
-	extern void ViewportMapBuildTunnelCache();
-	ViewportMapBuildTunnelCache();
-
 	extern void MarkAllViewportMapLandscapesDirty();
 	MarkAllViewportMapLandscapesDirty();
 
@@ -1822,6 +1822,7 @@ static SettingsContainer &GetSettingsTree()
 			interface->Add(new SettingEntry("gui.fast_forward_speed_limit"));
 			interface->Add(new SettingEntry("gui.autosave"));
 			interface->Add(new SettingEntry("gui.autosave_on_network_disconnect"));
+			interface->Add(new SettingEntry("network.compress_game_stream"));
 			interface->Add(new SettingEntry("gui.savegame_overwrite_confirm"));
 			interface->Add(new SettingEntry("gui.toolbar_pos"));
 			interface->Add(new SettingEntry("gui.statusbar_pos"));
@@ -2116,6 +2117,8 @@ static SettingsContainer &GetSettingsTree()
 				cdist->Add(new SettingEntry("linkgraph.accuracy"));
 				cdist->Add(new SettingEntry("linkgraph.demand_distance"));
 				cdist->Add(new SettingEntry("linkgraph.demand_size"));
+				cdist->Add(new SettingEntry("linkgraph.demand_recalc_interval"));
+				cdist->Add(new SettingEntry("linkgraph.demand_recalc_threshold"));
 				cdist->Add(new SettingEntry("linkgraph.short_path_saturation"));
 				cdist->Add(new SettingEntry("linkgraph.recalc_not_scaled_by_daylength"));
 			}
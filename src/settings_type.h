@@ -137,6 +137,7 @@ struct GUISettings : public TimeSettings {
 	bool   autosave_on_network_disconnect;   ///< save an autosave when you get disconnected from a network game with an error?
 	uint8  date_format_in_default_names;     ///< should the default savegame/screenshot name use long dates (31th Dec 2008), short dates (31-12-2008) or ISO dates (2008-12-31)
 	byte   max_num_autosaves;                ///< controls how many autosavegames are made before the game starts to overwrite (names them 0 to max_num_autosaves - 1)
+	byte   autosave_deltas;                  ///< number of delta autosaves written against a full autosave before the next full autosave, 0 to disable
 	uint8  savegame_overwrite_confirm;       ///< Mode for when to warn about overwriting an existing savegame
 	bool   population_in_label;              ///< show the population of a town in his label?
 	uint8  right_mouse_btn_emulation;        ///< should we emulate right mouse clicking?
@@ -319,6 +320,8 @@ struct NetworkSettings {
 	uint16 max_commands_in_queue;                         ///< how many commands may there be in the incoming queue before dropping the connection?
 	uint16 bytes_per_frame;                               ///< how many bytes may, over a long period, be received per frame?
 	uint16 bytes_per_frame_burst;                         ///< how many bytes may, over a short period, be received?
+	bool   compress_game_stream;                          ///< compress the commands and frames sent to clients after joining (server: allow, client: request)
+	bool   sync_state_checksum_tree;                      ///< send the checksum tree of the game state with sync packets, to locate desyncs (server side)
 	uint16 max_init_time;                                 ///< maximum amount of time, in game ticks, a client may take to initiate joining
 	uint16 max_join_time;                                 ///< maximum amount of time, in game ticks, a client may take to sync up during joining
 	uint16 max_download_time;                             ///< maximum amount of time, in game ticks, a client may take to download the map
@@ -664,6 +667,8 @@ struct LinkGraphSettings {
 	uint8 accuracy;                             ///< accuracy when calculating things on the link graph. low accuracy => low running time
 	uint8 demand_size;                          ///< influence of supply ("station size") on the demand function
 	uint8 demand_distance;                      ///< influence of distance between stations on the demand function
+	uint8 demand_recalc_interval;               ///< number of demand calculations after which the demands are calculated from scratch again
+	uint8 demand_recalc_threshold;              ///< change of a node's supply (in percent) above which its demands are recalculated
 	uint8 short_path_saturation;                ///< percentage up to which short paths are saturated before saturating most capacious paths
 
 	inline DistributionType GetDistributionType(CargoID cargo) const {
@@ -24,6 +24,7 @@
 #include "screenshot.h"
 #include "guitimer_func.h"
 #include "zoom_func.h"
+#include "thread.h"
 
 #include "smallmap_colours.h"
 #include "smallmap_gui.h"
@@ -31,6 +32,7 @@
 #include "table/strings.h"
 
 #include <bitset>
+#include <memory>
 
 #include "safeguards.h"
 
@@ -497,6 +499,153 @@ static void NotifyAllViewports(ViewportMapType map_type)
 				w->InvalidateData();
 			}
 	}
+	ViewportMapInvalidateColourCaches(map_type);
+}
+
+/**
+ * Cache of the colours of the smallmap in one map type.
+ * The smallmap shows cells of zoom x zoom tiles, and finding the colour of a cell means
+ * looking at all its tiles, which is expensive when zoomed out on large maps. So the colour
+ * of a cell is kept until a tile in it changes, see #MarkSmallMapTileDirty, or until the
+ * legends or colour settings change, see #InvalidateSmallMapColourCaches.
+ * The cells are aligned to the tiles that have been drawn, so changing the zoom level, or
+ * scrolling by a distance that is not a multiple of it, starts a new cache. The cells are
+ * stored in blocks, which are only allocated for the parts of the map that are drawn.
+ */
+struct SmallMapColourCache {
+	static const uint BLOCK_BITS = 6;                ///< Number of bits of the cell coordinates within a block.
+	static const uint BLOCK_SIZE = 1 << BLOCK_BITS;  ///< Number of cells along each side of a block.
+
+	/** A square of cells. */
+	struct Block {
+		uint32 colours[BLOCK_SIZE * BLOCK_SIZE]; ///< Colours of the cells.
+		bool valid[BLOCK_SIZE * BLOCK_SIZE];     ///< Whether the colour of the cell is up to date.
+	};
+
+	int zoom = 0;         ///< Zoom level of the cached cells, 0 when nothing is cached.
+	uint offset_x = 0;    ///< X coordinate of the first tile of the cells with a tile at X = 0, modulo zoom.
+	uint offset_y = 0;    ///< Y coordinate of the first tile of the cells with a tile at Y = 0, modulo zoom.
+	uint blocks_x = 0;    ///< Number of blocks along the X axis.
+	std::vector<std::unique_ptr<Block>> blocks; ///< The blocks of cells, \c nullptr when not allocated yet.
+
+	void Clear();
+	void Setup(int zoom, uint offset_x, uint offset_y);
+	Block *GetBlock(uint xc, uint yc, bool allocate);
+
+	/**
+	 * Get the index of a cell within its block.
+	 * @param xc X coordinate of the first tile of the cell.
+	 * @param yc Y coordinate of the first tile of the cell.
+	 * @return The index in the block.
+	 */
+	inline uint GetCellIndex(uint xc, uint yc) const
+	{
+		uint cx = (xc - this->offset_x) / this->zoom;
+		uint cy = (yc - this->offset_y) / this->zoom;
+		return (GB(cy, 0, BLOCK_BITS) << BLOCK_BITS) | GB(cx, 0, BLOCK_BITS);
+	}
+
+	void MarkTileDirty(uint x, uint y);
+};
+
+/** Maximum number of blocks of all smallmap colour caches together; about 64 MiB. */
+static const uint SMALLMAP_COLOUR_CACHE_MAX_BLOCKS = (64 << 20) / sizeof(SmallMapColourCache::Block);
+/** Minimum number of tiles to inspect for filling the colour cache using multiple threads. */
+static const uint SMALLMAP_COLOUR_CACHE_PARALLEL_TILES = 1 << 16;
+
+static SmallMapColourCache _smallmap_colour_caches[SmallMapWindow::SMT_END]; ///< The colour caches of all map types.
+static uint _smallmap_colour_cache_blocks = 0; ///< Number of blocks allocated by all colour caches.
+
+/** Free all cells. */
+void SmallMapColourCache::Clear()
+{
+	for (const auto &block : this->blocks) {
+		if (block != nullptr) _smallmap_colour_cache_blocks--;
+	}
+	this->blocks.clear();
+	this->zoom = 0;
+}
+
+/**
+ * Prepare the cache for drawing, and drop its content when it does not match.
+ * @param zoom Zoom level of the smallmap.
+ * @param offset_x X coordinate of the first tile of some cell, modulo zoom.
+ * @param offset_y Y coordinate of the first tile of some cell, modulo zoom.
+ */
+void SmallMapColourCache::Setup(int zoom, uint offset_x, uint offset_y)
+{
+	if (this->zoom == zoom && this->offset_x == offset_x && this->offset_y == offset_y) return;
+
+	this->Clear();
+	this->zoom = zoom;
+	this->offset_x = offset_x;
+	this->offset_y = offset_y;
+	uint cells_x = CeilDiv(MapSizeX() - offset_x, zoom);
+	uint cells_y = CeilDiv(MapSizeY() - offset_y, zoom);
+	this->blocks_x = CeilDiv(cells_x, BLOCK_SIZE);
+	this->blocks.resize(this->blocks_x * CeilDiv(cells_y, BLOCK_SIZE));
+}
+
+/**
+ * Get the block containing a cell.
+ * @param xc X coordinate of the first tile of the cell; must be within the map.
+ * @param yc Y coordinate of the first tile of the cell; must be within the map.
+ * @param allocate Allocate the block when it is not there yet.
+ * @return The block, or \c nullptr when it is not allocated.
+ */
+SmallMapColourCache::Block *SmallMapColourCache::GetBlock(uint xc, uint yc, bool allocate)
+{
+	uint index = (((yc - this->offset_y) / this->zoom) >> BLOCK_BITS) * this->blocks_x + (((xc - this->offset_x) / this->zoom) >> BLOCK_BITS);
+	std::unique_ptr<Block> &block = this->blocks[index];
+	if (block == nullptr && allocate) {
+		if (_smallmap_colour_cache_blocks >= SMALLMAP_COLOUR_CACHE_MAX_BLOCKS) {
+			/* Make room by dropping the caches of the other map types. */
+			for (SmallMapColourCache &cache : _smallmap_colour_caches) {
+				if (&cache != this) cache.Clear();
+			}
+			if (_smallmap_colour_cache_blocks >= SMALLMAP_COLOUR_CACHE_MAX_BLOCKS) return nullptr;
+		}
+		block.reset(new Block());
+		_smallmap_colour_cache_blocks++;
+	}
+	return block.get();
+}
+
+/**
+ * Mark the cell containing a tile as out of date.
+ * @param x X coordinate of the tile.
+ * @param y Y coordinate of the tile.
+ */
+void SmallMapColourCache::MarkTileDirty(uint x, uint y)
+{
+	if (this->zoom == 0 || x < this->offset_x || y < this->offset_y) return;
+
+	/* Move to the first tile of the cell. */
+	x -= (x - this->offset_x) % this->zoom;
+	y -= (y - this->offset_y) % this->zoom;
+	Block *block = this->GetBlock(x, y, false);
+	if (block != nullptr) block->valid[this->GetCellIndex(x, y)] = false;
+}
+
+/**
+ * Tell the smallmap that a tile has changed, so its colour has to be determined again.
+ * @param tile The changed tile.
+ */
+void MarkSmallMapTileDirty(TileIndex tile)
+{
+	if (_smallmap_colour_cache_blocks == 0) return;
+
+	for (SmallMapColourCache &cache : _smallmap_colour_caches) {
+		cache.MarkTileDirty(TileX(tile), TileY(tile));
+	}
+}
+
+/** Drop all cached smallmap colours, e.g. because the legends or colour settings have changed. */
+void InvalidateSmallMapColourCaches()
+{
+	for (SmallMapColourCache &cache : _smallmap_colour_caches) {
+		cache.Clear();
+	}
 }
 
 /** Vehicle colours in #SMT_VEHICLES mode. Indexed by #VehicleType. */
@@ -732,6 +881,40 @@ inline uint32 SmallMapWindow::GetTileColours(const TileArea &ta) const
 	}
 }
 
+/**
+ * Get the tiles of a cell of the smallmap.
+ * @param xc The X coordinate of the first tile of the cell.
+ * @param yc The Y coordinate of the first tile of the cell.
+ * @param[out] ta The tiles of the cell within the map.
+ * @return False when the cell has no tiles.
+ */
+inline bool SmallMapWindow::GetCellTileArea(uint xc, uint yc, TileArea &ta) const
+{
+	uint min_xy = _settings_game.construction.freeform_edges ? 1 : 0;
+
+	/* Construct tilearea covered by (xc, yc, xc + this->zoom, yc + this->zoom) such that it is within min_xy limits. */
+	if (min_xy == 1 && (xc == 0 || yc == 0)) {
+		if (this->zoom == 1) return false; // The tile area is empty, don't draw anything.
+
+		ta = TileArea(TileXY(std::max(min_xy, xc), std::max(min_xy, yc)), this->zoom - (xc == 0), this->zoom - (yc == 0));
+	} else {
+		ta = TileArea(TileXY(xc, yc), this->zoom, this->zoom);
+	}
+	ta.ClampToMap(); // Clamp to map boundaries (may contain MP_VOID tiles!).
+	return true;
+}
+
+/**
+ * Get the colour cache to draw the current map type with.
+ * @return The cache, or \c nullptr when the colours may not be cached.
+ */
+SmallMapColourCache *SmallMapWindow::GetColourCache() const
+{
+	/* The blinking of the highlighted industry changes the colours too often. */
+	if (this->map_type == SMT_INDUSTRY && _smallmap_industry_highlight != INVALID_INDUSTRYTYPE) return nullptr;
+	return &_smallmap_colour_caches[this->map_type];
+}
+
 /**
  * Draws one column of tiles of the small map in a certain mode onto the screen buffer, skipping the shifted rows in between.
  *
@@ -743,12 +926,12 @@ inline uint32 SmallMapWindow::GetTileColours(const TileArea &ta) const
  * @param start_pos Position of first pixel to draw.
  * @param end_pos Position of last pixel to draw (exclusive).
  * @param blitter current blitter
+ * @param cache Colour cache to use, or \c nullptr to determine all colours.
  * @note If pixel position is below \c 0, skip drawing.
  */
-void SmallMapWindow::DrawSmallMapColumn(void *dst, uint xc, uint yc, int pitch, int reps, int start_pos, int end_pos, Blitter *blitter) const
+void SmallMapWindow::DrawSmallMapColumn(void *dst, uint xc, uint yc, int pitch, int reps, int start_pos, int end_pos, Blitter *blitter, SmallMapColourCache *cache) const
 {
 	void *dst_ptr_abs_end = blitter->MoveTo(_screen.dst_ptr, 0, _screen.height);
-	uint min_xy = _settings_game.construction.freeform_edges ? 1 : 0;
 
 	do {
 		/* Check if the tile (xc,yc) is within the map range */
@@ -758,18 +941,21 @@ void SmallMapWindow::DrawSmallMapColumn(void *dst, uint xc, uint yc, int pitch,
 		if (dst < _screen.dst_ptr) continue;
 		if (dst >= dst_ptr_abs_end) continue;
 
-		/* Construct tilearea covered by (xc, yc, xc + this->zoom, yc + this->zoom) such that it is within min_xy limits. */
 		TileArea ta;
-		if (min_xy == 1 && (xc == 0 || yc == 0)) {
-			if (this->zoom == 1) continue; // The tile area is empty, don't draw anything.
-
-			ta = TileArea(TileXY(std::max(min_xy, xc), std::max(min_xy, yc)), this->zoom - (xc == 0), this->zoom - (yc == 0));
+		if (!this->GetCellTileArea(xc, yc, ta)) continue;
+
+		uint32 val;
+		SmallMapColourCache::Block *block = (cache != nullptr) ? cache->GetBlock(xc, yc, true) : nullptr;
+		if (block != nullptr) {
+			uint index = cache->GetCellIndex(xc, yc);
+			if (!block->valid[index]) {
+				block->colours[index] = this->GetTileColours(ta);
+				block->valid[index] = true;
+			}
+			val = block->colours[index];
 		} else {
-			ta = TileArea(TileXY(xc, yc), this->zoom, this->zoom);
+			val = this->GetTileColours(ta);
 		}
-		ta.ClampToMap(); // Clamp to map boundaries (may contain MP_VOID tiles!).
-
-		uint32 val = this->GetTileColours(ta);
 		uint8 *val8 = (uint8 *)&val;
 		int idx = std::max(0, -start_pos);
 		for (int pos = std::max(0, start_pos); pos < end_pos; pos++) {
@@ -868,27 +1054,16 @@ void SmallMapWindow::DrawMapIndicators() const
 }
 
 /**
- * Draws the small map.
- *
- * Basically, the small map is draw column of pixels by column of pixels. The pixels
- * are drawn directly into the screen buffer. The final map is drawn in multiple passes.
- * The passes are:
- * <ol><li>The colours of tiles in the different modes.</li>
- * <li>Town names (optional)</li></ol>
- *
- * @param dpi pointer to pixel to write onto
+ * Call a function for each column of cells of the smallmap drawn in an area.
+ * @param dpi The area to draw in.
+ * @param blitter Current blitter.
+ * @param column_proc Function called with the pointer to the screen buffer at the column, the X and Y coordinate
+ *                    of the first tile in the column, the number of cells in the column and the first and last
+ *                    (exclusive) horizontal position of the pixels to draw.
  */
-void SmallMapWindow::DrawSmallMap(DrawPixelInfo *dpi, bool draw_indicators) const
+template <typename F>
+void SmallMapWindow::IterateColumns(const DrawPixelInfo *dpi, Blitter *blitter, F column_proc) const
 {
-	Blitter *blitter = BlitterFactory::GetCurrentBlitter();
-	DrawPixelInfo *old_dpi;
-
-	old_dpi = _cur_dpi;
-	_cur_dpi = dpi;
-
-	/* Clear it */
-	GfxFillRect(dpi->left, dpi->top, dpi->left + dpi->width - 1, dpi->top + dpi->height - 1, PC_BLACK);
-
 	/* Which tile is displayed at (dpi->left, dpi->top)? */
 	int dx;
 	Point tile = this->PixelToTile(dpi->left, dpi->top, &dx);
@@ -907,7 +1082,7 @@ void SmallMapWindow::DrawSmallMap(DrawPixelInfo *dpi, bool draw_indicators) cons
 			int end_pos = std::min(dpi->width, x + 4);
 			int reps = (dpi->height - y + 1) / 2; // Number of lines.
 			if (reps > 0) {
-				this->DrawSmallMapColumn(ptr, tile_x, tile_y, dpi->pitch * 2, reps, x, end_pos, blitter);
+				column_proc(ptr, tile_x, tile_y, reps, x, end_pos);
 			}
 		}
 
@@ -923,6 +1098,101 @@ void SmallMapWindow::DrawSmallMap(DrawPixelInfo *dpi, bool draw_indicators) cons
 		ptr = blitter->MoveTo(ptr, 2, 0);
 		x += 2;
 	}
+}
+
+/**
+ * Make sure the colour cache matches the current zoom level and scroll position, and determine the
+ * colours of the cells to draw in an area which are not cached yet. When there are many of those,
+ * e.g. the first time the whole map is shown, this is done by multiple threads.
+ * @param dpi The area to draw in.
+ * @param cache The colour cache of the current map type.
+ */
+void SmallMapWindow::FillColourCache(const DrawPixelInfo *dpi, SmallMapColourCache *cache) const
+{
+	int dx;
+	Point tile = this->PixelToTile(dpi->left, dpi->top, &dx);
+	int tile_x = this->scroll_x / (int)TILE_SIZE + tile.x;
+	int tile_y = this->scroll_y / (int)TILE_SIZE + tile.y;
+	cache->Setup(this->zoom, ((tile_x % this->zoom) + this->zoom) % this->zoom, ((tile_y % this->zoom) + this->zoom) % this->zoom);
+
+	/** A cell whose colour has to be determined. */
+	struct PendingCell {
+		SmallMapColourCache::Block *block; ///< Block of the cell.
+		uint index;                        ///< Index of the cell in the block.
+		TileArea ta;                       ///< Tiles of the cell.
+	};
+	std::vector<PendingCell> pending;
+
+	this->IterateColumns(dpi, BlitterFactory::GetCurrentBlitter(), [&](void *ptr, uint xc, uint yc, int reps, int x, int end_pos) {
+		do {
+			if (xc >= MapMaxX() || yc >= MapMaxY()) continue;
+
+			SmallMapColourCache::Block *block = cache->GetBlock(xc, yc, true);
+			if (block == nullptr) continue;
+			uint index = cache->GetCellIndex(xc, yc);
+			if (block->valid[index]) continue;
+
+			TileArea ta;
+			if (this->GetCellTileArea(xc, yc, ta)) pending.push_back({ block, index, ta });
+		} while (xc += this->zoom, yc += this->zoom, --reps != 0);
+	});
+
+	/* Leave small amounts of work to drawing. */
+	if (pending.size() * this->zoom * this->zoom < SMALLMAP_COLOUR_CACHE_PARALLEL_TILES) return;
+
+	auto fill = [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			PendingCell &cell = pending[i];
+			cell.block->colours[cell.index] = this->GetTileColours(cell.ta);
+			cell.block->valid[cell.index] = true;
+		}
+	};
+
+	uint threads = Clamp<uint>(std::thread::hardware_concurrency(), 1, 16);
+	std::vector<std::thread> workers;
+	size_t per_thread = CeilDiv(pending.size(), threads);
+	for (uint i = 1; i < threads; i++) {
+		size_t begin = std::min(pending.size(), i * per_thread);
+		size_t end = std::min(pending.size(), begin + per_thread);
+		std::thread worker;
+		if (!StartNewThread(&worker, "ottd:smallmap", std::ref(fill), size_t(begin), size_t(end))) {
+			fill(begin, end);
+			continue;
+		}
+		workers.push_back(std::move(worker));
+	}
+	fill(0, std::min(pending.size(), per_thread));
+	for (std::thread &worker : workers) worker.join();
+}
+
+/**
+ * Draws the small map.
+ *
+ * Basically, the small map is draw column of pixels by column of pixels. The pixels
+ * are drawn directly into the screen buffer. The final map is drawn in multiple passes.
+ * The passes are:
+ * <ol><li>The colours of tiles in the different modes.</li>
+ * <li>Town names (optional)</li></ol>
+ *
+ * @param dpi pointer to pixel to write onto
+ */
+void SmallMapWindow::DrawSmallMap(DrawPixelInfo *dpi, bool draw_indicators) const
+{
+	Blitter *blitter = BlitterFactory::GetCurrentBlitter();
+	DrawPixelInfo *old_dpi;
+
+	old_dpi = _cur_dpi;
+	_cur_dpi = dpi;
+
+	/* Clear it */
+	GfxFillRect(dpi->left, dpi->top, dpi->left + dpi->width - 1, dpi->top + dpi->height - 1, PC_BLACK);
+
+	SmallMapColourCache *cache = this->GetColourCache();
+	if (cache != nullptr) this->FillColourCache(dpi, cache);
+
+	this->IterateColumns(dpi, blitter, [&](void *ptr, int tile_x, int tile_y, int reps, int x, int end_pos) {
+		this->DrawSmallMapColumn(ptr, tile_x, tile_y, dpi->pitch * 2, reps, x, end_pos, blitter, cache);
+	});
 
 	/* Draw vehicles */
 	if (this->map_type == SMT_CONTOUR || this->map_type == SMT_VEHICLES) this->DrawVehicles(dpi, blitter);
@@ -987,6 +1257,7 @@ void SmallMapWindow::SetupWidgetData()
 SmallMapWindow::SmallMapWindow(WindowDesc *desc, int window_number) : Window(desc), refresh(GUITimer())
 {
 	_smallmap_industry_highlight = INVALID_INDUSTRYTYPE;
+	InvalidateSmallMapColourCaches();
 	this->overlay = new LinkGraphOverlay(this, WID_SM_MAP, 0, this->GetOverlayCompanyMask(), 1);
 	this->InitNested(window_number);
 	this->LowerWidget(this->map_type + WID_SM_CONTOUR);
@@ -1009,6 +1280,7 @@ SmallMapWindow::~SmallMapWindow()
 {
 	delete this->overlay;
 	this->BreakIndustryChainLink();
+	InvalidateSmallMapColourCaches();
 }
 
 /**
@@ -1034,6 +1306,8 @@ void SmallMapWindow::RebuildColourIndexIfNecessary()
 
 	SmallMapWindow::map_height_limit = _settings_game.construction.map_height_limit;
 	BuildLandLegend();
+	InvalidateSmallMapColourCaches();
+	ViewportMapInvalidateColourCaches();
 }
 
 /* virtual */ void SmallMapWindow::SetStringParameters(int widget) const
@@ -1392,6 +1666,7 @@ int SmallMapWindow::GetPositionOnLegend(Point pt)
 					if (click_pos < _smallmap_industry_count) {
 						this->SelectLegendItem(click_pos, _legend_from_industries, _smallmap_industry_count);
 						NotifyAllViewports(VPMT_INDUSTRY);
+						InvalidateSmallMapColourCaches();
 					}
 				} else if (this->map_type == SMT_LINKSTATS) {
 					if (click_pos < _smallmap_cargo_count) {
@@ -1402,6 +1677,7 @@ int SmallMapWindow::GetPositionOnLegend(Point pt)
 					if (click_pos < _smallmap_company_count) {
 						this->SelectLegendItem(click_pos, _legend_land_owners, _smallmap_company_count, NUM_NO_COMPANY_ENTRIES);
 						NotifyAllViewports(VPMT_OWNER);
+						InvalidateSmallMapColourCaches();
 					}
 				}
 				this->SetDirty();
@@ -1430,6 +1706,7 @@ int SmallMapWindow::GetPositionOnLegend(Point pt)
 			for (;!tbl->end && tbl->legend != STR_LINKGRAPH_LEGEND_UNUSED; ++tbl) {
 				tbl->show_on_map = (widget == WID_SM_ENABLE_ALL);
 			}
+			InvalidateSmallMapColourCaches();
 			if (this->map_type == SMT_LINKSTATS) this->SetOverlayCargoMask();
 			this->SetDirty();
 			break;
@@ -1439,6 +1716,7 @@ int SmallMapWindow::GetPositionOnLegend(Point pt)
 			_smallmap_show_heightmap = !_smallmap_show_heightmap;
 			this->SetWidgetLoweredState(WID_SM_SHOW_HEIGHT, _smallmap_show_heightmap);
 			NotifyAllViewports(VPMT_INDUSTRY);
+			InvalidateSmallMapColourCaches();
 			this->SetDirty();
 			break;
 
@@ -1482,6 +1760,7 @@ int SmallMapWindow::GetPositionOnLegend(Point pt)
 
 		default: NOT_REACHED();
 	}
+	InvalidateSmallMapColourCaches();
 	this->SetDirty();
 }
 
@@ -50,6 +50,10 @@ void BuildIndustriesLegend();
 void ShowSmallMap();
 void BuildLandLegend();
 void BuildOwnerLegend();
+void MarkSmallMapTileDirty(TileIndex tile);
+void InvalidateSmallMapColourCaches();
+
+struct SmallMapColourCache;
 
 /** Structure for holding relevant data for legends in small map */
 struct LegendAndColour {
@@ -65,7 +69,7 @@ struct LegendAndColour {
 
 /** Class managing the smallmap window. */
 class SmallMapWindow : public Window {
-protected:
+public:
 	/** Types of legends in the #WID_SM_LEGEND widget. */
 	enum SmallMapType {
 		SMT_CONTOUR,
@@ -75,8 +79,11 @@ protected:
 		SMT_ROUTES,
 		SMT_VEGETATION,
 		SMT_OWNER,
+		SMT_END,   ///< End marker.
 	};
 
+protected:
+
 	/** Available kinds of zoomlevel changes. */
 	enum ZoomLevelChange {
 		ZLC_INITIALIZE, ///< Initialize zoom level.
@@ -181,7 +188,11 @@ protected:
 	uint PausedAdjustRefreshTimeDelta(uint delta_ms) const;
 
 	void DrawMapIndicators() const;
-	void DrawSmallMapColumn(void *dst, uint xc, uint yc, int pitch, int reps, int start_pos, int end_pos, Blitter *blitter) const;
+	bool GetCellTileArea(uint xc, uint yc, TileArea &ta) const;
+	SmallMapColourCache *GetColourCache() const;
+	template <typename F> void IterateColumns(const DrawPixelInfo *dpi, Blitter *blitter, F column_proc) const;
+	void FillColourCache(const DrawPixelInfo *dpi, SmallMapColourCache *cache) const;
+	void DrawSmallMapColumn(void *dst, uint xc, uint yc, int pitch, int reps, int start_pos, int end_pos, Blitter *blitter, SmallMapColourCache *cache) const;
 	void DrawVehicles(const DrawPixelInfo *dpi, Blitter *blitter) const;
 	void DrawTowns(const DrawPixelInfo *dpi) const;
 	void DrawSmallMap(DrawPixelInfo *dpi, bool draw_indicators = true) const;
@@ -14,6 +14,10 @@
 #include "core/bitmath_func.hpp"
 #include "core/smallvec_type.hpp"
 #include "date_type.h"
+#include "thread.h"
+
+#include <algorithm>
+#include <vector>
 
 /** Flags of the sort list. */
 enum SortListFlags {
@@ -37,6 +41,48 @@ struct Filtering {
 	byte criteria; ///< Filtering criteria
 };
 
+/** Minimum number of items for which #ParallelSort uses multiple threads. */
+static const size_t PARALLEL_SORT_MIN_ITEMS = 8192;
+
+/**
+ * Sort a range like std::sort, using multiple threads for long ranges.
+ * Each thread sorts a part of the range, after which the parts are merged.
+ * @param first Begin of the range.
+ * @param last End of the range.
+ * @param comp The function to compare two items; it is called from multiple threads.
+ */
+template <typename It, typename Comp>
+void ParallelSort(It first, It last, Comp comp)
+{
+	const size_t count = last - first;
+	const uint threads = std::min<uint>(std::thread::hardware_concurrency(), 8);
+	if (count < PARALLEL_SORT_MIN_ITEMS || threads < 2) {
+		std::sort(first, last, comp);
+		return;
+	}
+
+	std::vector<It> bounds;
+	for (uint i = 0; i <= threads; i++) bounds.push_back(first + count * i / threads);
+
+	std::vector<std::thread> workers;
+	for (uint i = 1; i < threads; i++) {
+		std::thread worker;
+		if (StartNewThread(&worker, "ottd:sort", [comp](It begin, It end) { std::sort(begin, end, comp); }, It(bounds[i]), It(bounds[i + 1]))) {
+			workers.push_back(std::move(worker));
+		} else {
+			std::sort(bounds[i], bounds[i + 1], comp);
+		}
+	}
+	std::sort(bounds[0], bounds[1], comp);
+	for (std::thread &worker : workers) worker.join();
+
+	for (uint step = 1; step < threads; step *= 2) {
+		for (uint i = 0; i + step < threads; i += 2 * step) {
+			std::inplace_merge(bounds[i], bounds[i + step], bounds[std::min(i + 2 * step, threads)], comp);
+		}
+	}
+}
+
 /**
  * List template of 'things' \p T to sort in a GUI.
  * @tparam T Type of data stored in the list to represent each item.
@@ -269,6 +315,41 @@ public:
 		return true;
 	}
 
+	/**
+	 * Sort the list by keys which are determined once for each item, instead of in
+	 * each comparison like #Sort. Use this when getting the value to sort on is
+	 * expensive, such as for names. As comparing keys does not look at the items,
+	 * long lists are sorted using multiple threads.
+	 * @param get_key The function returning the key of an item. Keys are compared with their operator <.
+	 * @return true if the list sequence has been altered
+	 */
+	template <typename KeyFunc>
+	bool SortByKey(KeyFunc get_key)
+	{
+		/* Do not sort if the resort bit is not set */
+		if (!(this->flags & VL_RESORT)) return false;
+
+		CLRBITS(this->flags, VL_RESORT);
+
+		this->ResetResortTimer();
+
+		/* Do not sort when the list is not sortable */
+		if (!this->IsSortable()) return false;
+
+		const bool desc = (this->flags & VL_DESC) != 0;
+
+		typedef std::pair<decltype(get_key(std::declval<const T &>())), T> KeyedItem;
+		std::vector<KeyedItem> keyed;
+		keyed.reserve(std::vector<T>::size());
+		for (T &item : *this) keyed.emplace_back(get_key(item), std::move(item));
+
+		ParallelSort(keyed.begin(), keyed.end(), [desc](const KeyedItem &a, const KeyedItem &b) { return desc ? b.first < a.first : a.first < b.first; });
+
+		auto it = std::vector<T>::begin();
+		for (KeyedItem &item : keyed) *it++ = std::move(item.second);
+		return true;
+	}
+
 	/**
 	 * Hand the array of sort function pointers to the sort list
 	 *
@@ -587,12 +587,6 @@ static void *ReadSprite(const SpriteCache *sc, SpriteID id, SpriteType sprite_ty
 	return encoder->Encode(sprite, allocator);
 }
 
-struct GrfSpriteOffset {
-	size_t file_pos;
-	uint count;
-	bool has_non_palette;
-};
-
 /** Map from sprite numbers to position in the GRF file. */
 static btree::btree_map<uint32, GrfSpriteOffset> _grf_sprite_offsets;
 
@@ -649,6 +643,36 @@ void ReadGRFSpriteOffsets(SpriteFile &file)
 	}
 }
 
+/**
+ * Get the sprite section offsets of the GRF which were last read by #ReadGRFSpriteOffsets.
+ * @param base Position to make the file positions relative to.
+ * @return The offsets, ordered by sprite ID.
+ */
+std::vector<std::pair<uint32, GrfSpriteOffset>> GetGRFSpriteOffsets(size_t base)
+{
+	std::vector<std::pair<uint32, GrfSpriteOffset>> offsets;
+	offsets.reserve(_grf_sprite_offsets.size());
+	for (const auto &it : _grf_sprite_offsets) {
+		offsets.emplace_back(it.first, it.second);
+		offsets.back().second.file_pos -= base;
+	}
+	return offsets;
+}
+
+/**
+ * Set the sprite section offsets of a GRF, instead of reading them with #ReadGRFSpriteOffsets.
+ * @param offsets The offsets, as returned by #GetGRFSpriteOffsets.
+ * @param base Position the file positions of the offsets are relative to.
+ */
+void SetGRFSpriteOffsets(const std::vector<std::pair<uint32, GrfSpriteOffset>> &offsets, size_t base)
+{
+	_grf_sprite_offsets.clear();
+	for (const auto &it : offsets) {
+		GrfSpriteOffset &offset = _grf_sprite_offsets[it.first];
+		offset = it.second;
+		offset.file_pos += base;
+	}
+}
 
 /**
  * Load a real or recolour sprite.
@@ -12,6 +12,7 @@
 
 #include "gfx_type.h"
 #include "spriteloader/spriteloader.hpp"
+#include <vector>
 
 /** Data structure describing a sprite. */
 struct Sprite {
@@ -55,7 +56,16 @@ void IncreaseSpriteLRU();
 
 SpriteFile &OpenCachedSpriteFile(const std::string &filename, Subdirectory subdir, bool palette_remap);
 
+/** Location of a sprite in the sprite section of a GRF. */
+struct GrfSpriteOffset {
+	size_t file_pos;      ///< Position of the first entry of the sprite.
+	uint count;           ///< Number of entries (zoom levels/bit depths) of the sprite.
+	bool has_non_palette; ///< Whether any of the entries is not a palette sprite.
+};
+
 void ReadGRFSpriteOffsets(SpriteFile &file);
+std::vector<std::pair<uint32, GrfSpriteOffset>> GetGRFSpriteOffsets(size_t base);
+void SetGRFSpriteOffsets(const std::vector<std::pair<uint32, GrfSpriteOffset>> &offsets, size_t base);
 size_t GetGRFSpriteOffset(uint32 id);
 bool LoadNextSprite(int load_index, SpriteFile &file, uint file_sprite_id);
 bool SkipSpriteData(SpriteFile &file, byte type, uint16 num);
@@ -52,6 +52,12 @@ public:
 	 * Seek to the begin of the content, i.e. the position just after the container version has been determined.
 	 */
 	void SeekToBegin() { this->SeekTo(this->content_begin, SEEK_SET); }
+
+	/**
+	 * Get the position of the begin of the content, i.e. the position just after the container version has been determined.
+	 * @return The position in the file.
+	 */
+	size_t GetContentBegin() const { return this->content_begin; }
 };
 
 #endif /* SPRITE_FILE_TYPE_HPP */
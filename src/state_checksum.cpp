@@ -0,0 +1,283 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file state_checksum.cpp Hierarchical checksums of the game state, for locating desyncs. */
+
+#include "stdafx.h"
+#include "state_checksum.h"
+#include "core/checksum_func.hpp"
+#include "map_func.h"
+#include "vehicle_base.h"
+#include "station_base.h"
+#include "company_base.h"
+#include "cargopacket.h"
+#include "town.h"
+#include "industry.h"
+#include "string_func.h"
+
+#include "safeguards.h"
+
+/** Names of the subsystems, for reporting. */
+static const char * const _state_checksum_subsystem_names[] = {
+	"trains",
+	"road vehicles",
+	"ships",
+	"aircraft",
+	"effect vehicles",
+	"disaster vehicles",
+	"map",
+	"stations",
+	"companies",
+	"cargo packets",
+	"towns",
+	"industries",
+};
+static_assert(lengthof(_state_checksum_subsystem_names) == SCS_END);
+
+/**
+ * Get the name of a subsystem.
+ * @param subsystem The subsystem.
+ * @return The name.
+ */
+const char *GetStateChecksumSubsystemName(StateChecksumSubsystem subsystem)
+{
+	return subsystem < SCS_END ? _state_checksum_subsystem_names[subsystem] : "invalid";
+}
+
+/** Checksum of a vehicle. */
+static uint64 VehicleChecksum(const Vehicle *v)
+{
+	SimpleChecksum64 cs;
+	cs.Update(((uint64)v->tile << 32) | v->engine_type);
+	cs.Update(((uint64)(uint32)v->x_pos << 32) | (uint32)v->y_pos);
+	cs.Update(((uint64)(uint32)v->z_pos << 32) | ((uint32)v->direction << 24) | ((uint32)v->vehstatus << 16) | ((uint32)v->progress << 8) | v->subspeed);
+	cs.Update(((uint64)v->cur_speed << 48) | ((uint64)v->owner << 40) | ((uint64)v->cargo_type << 32) | v->cargo_cap);
+	cs.Update(((uint64)v->cargo.TotalCount() << 32) | ((uint32)v->reliability << 16) | v->breakdown_ctr);
+	cs.Update(((uint64)v->current_order.GetType() << 48) | ((uint64)v->current_order.GetDestination() << 32) | ((uint32)v->cur_real_order_index << 16) | v->cur_implicit_order_index);
+	cs.Update(v->profit_this_year);
+	cs.Update(v->age);
+	return cs.state;
+}
+
+/** Checksum of the tiles of a map region. */
+static uint64 MapRegionChecksum(uint32 region)
+{
+	const uint regions_x = MapSizeX() / STATE_CHECKSUM_MAP_REGION_SIZE;
+	const uint x0 = (region % regions_x) * STATE_CHECKSUM_MAP_REGION_SIZE;
+	const uint y0 = (region / regions_x) * STATE_CHECKSUM_MAP_REGION_SIZE;
+
+	SimpleChecksum64 cs;
+	for (uint y = y0; y < y0 + STATE_CHECKSUM_MAP_REGION_SIZE; y++) {
+		for (uint x = x0; x < x0 + STATE_CHECKSUM_MAP_REGION_SIZE; x++) {
+			const TileIndex t = TileXY(x, y);
+			const Tile &m = _m[t];
+			const TileExtended &me = _me[t];
+			cs.Update(((uint64)m.type << 56) | ((uint64)m.height << 48) | ((uint64)m.m2 << 32) | ((uint32)m.m1 << 24) | ((uint32)m.m3 << 16) | ((uint32)m.m4 << 8) | m.m5);
+			cs.Update(((uint32)me.m6 << 24) | ((uint32)me.m7 << 16) | me.m8);
+		}
+	}
+	return cs.state;
+}
+
+/** Checksum of a station or waypoint, including the amounts of cargo waiting. */
+static uint64 StationChecksum(const BaseStation *bst)
+{
+	SimpleChecksum64 cs;
+	cs.Update(((uint64)bst->xy << 32) | ((uint32)bst->owner << 8) | bst->facilities);
+	if (Station::IsExpected(bst)) {
+		const Station *st = Station::From(bst);
+		for (CargoID c = 0; c < NUM_CARGO; c++) {
+			const GoodsEntry &ge = st->goods[c];
+			cs.Update(((uint64)ge.cargo.TotalCount() << 32) | ((uint32)ge.rating << 8) | ge.status);
+		}
+	}
+	return cs.state;
+}
+
+/** Checksum of a company. */
+static uint64 CompanyChecksum(const Company *c)
+{
+	SimpleChecksum64 cs;
+	cs.Update(c->money);
+	cs.Update(c->current_loan);
+	cs.Update(c->bankrupt_value);
+	cs.Update(c->money_fraction);
+	return cs.state;
+}
+
+/** Checksum of a cargo packet. */
+static uint64 CargoPacketChecksum(const CargoPacket *cp)
+{
+	SimpleChecksum64 cs;
+	cs.Update(((uint64)cp->SourceStationXY() << 32) | ((uint32)cp->Count() << 16) | cp->SourceSubsidyID());
+	cs.Update(((uint64)cp->DaysInTransit() << 32) | cp->SourceSubsidyType());
+	cs.Update(cp->FeederShare());
+	return cs.state;
+}
+
+/** Checksum of a town. */
+static uint64 TownChecksum(const Town *t)
+{
+	SimpleChecksum64 cs;
+	cs.Update(((uint64)t->xy << 32) | t->cache.population);
+	cs.Update(((uint64)t->grow_counter << 48) | ((uint64)t->growth_rate << 32) | ((uint32)t->flags << 16) | ((uint32)t->fund_buildings_months << 8) | t->road_build_months);
+	cs.Update(t->have_ratings);
+	for (const int16 rating : t->ratings) cs.Update((uint16)rating);
+	return cs.state;
+}
+
+/** Checksum of an industry. */
+static uint64 IndustryChecksum(const Industry *i)
+{
+	SimpleChecksum64 cs;
+	cs.Update(((uint64)i->location.tile << 32) | ((uint32)i->type << 16) | ((uint32)i->prod_level << 8));
+	cs.Update(i->counter);
+	for (uint j = 0; j < INDUSTRY_NUM_OUTPUTS; j++) {
+		cs.Update(((uint64)i->produced_cargo_waiting[j] << 8) | i->production_rate[j]);
+	}
+	return cs.state;
+}
+
+/**
+ * Call a procedure for all items of a pool which are in a node, in order of their index.
+ * @param node The node.
+ * @param proc The procedure to call with the index and the item.
+ */
+template <typename T, typename F>
+static void IteratePoolNode(const StateChecksumNode &node, F proc)
+{
+	const size_t stride = (size_t)1 << (node.depth * STATE_CHECKSUM_CHILD_BITS);
+	for (size_t index = node.value; index < T::GetPoolSize(); index += stride) {
+		if (T::IsValidID(index)) proc((uint32)index, T::Get(index));
+	}
+}
+
+/**
+ * Call a procedure for all entities of a node, in order of their key.
+ * @param node The node.
+ * @param proc The procedure to call with the key and the checksum of each entity.
+ */
+template <typename F>
+static void IterateNodeEntities(const StateChecksumNode &node, F proc)
+{
+	static const VehicleType vehicle_types[] = { VEH_TRAIN, VEH_ROAD, VEH_SHIP, VEH_AIRCRAFT, VEH_EFFECT, VEH_DISASTER };
+
+	switch (node.subsystem) {
+		case SCS_TRAINS:
+		case SCS_ROAD_VEHICLES:
+		case SCS_SHIPS:
+		case SCS_AIRCRAFT:
+		case SCS_EFFECT_VEHICLES:
+		case SCS_DISASTER_VEHICLES: {
+			const VehicleType type = vehicle_types[node.subsystem - SCS_TRAINS];
+			IteratePoolNode<Vehicle>(node, [&](uint32 key, const Vehicle *v) {
+				if (v->type == type) proc(key, VehicleChecksum(v));
+			});
+			break;
+		}
+
+		case SCS_MAP: {
+			const uint32 regions = MapSize() / (STATE_CHECKSUM_MAP_REGION_SIZE * STATE_CHECKSUM_MAP_REGION_SIZE);
+			const uint64 stride = (uint64)1 << (node.depth * STATE_CHECKSUM_CHILD_BITS);
+			for (uint64 region = node.value; region < regions; region += stride) {
+				proc((uint32)region, MapRegionChecksum((uint32)region));
+			}
+			break;
+		}
+
+		case SCS_STATIONS:   IteratePoolNode<BaseStation>(node, [&](uint32 key, const BaseStation *bst) { proc(key, StationChecksum(bst)); }); break;
+		case SCS_COMPANIES:  IteratePoolNode<Company>(node, [&](uint32 key, const Company *c) { proc(key, CompanyChecksum(c)); }); break;
+		case SCS_CARGO:      IteratePoolNode<CargoPacket>(node, [&](uint32 key, const CargoPacket *cp) { proc(key, CargoPacketChecksum(cp)); }); break;
+		case SCS_TOWNS:      IteratePoolNode<Town>(node, [&](uint32 key, const Town *t) { proc(key, TownChecksum(t)); }); break;
+		case SCS_INDUSTRIES: IteratePoolNode<Industry>(node, [&](uint32 key, const Industry *i) { proc(key, IndustryChecksum(i)); }); break;
+
+		default: NOT_REACHED();
+	}
+}
+
+/**
+ * Calculate the checksums of the entities or the children of a node of the checksum tree.
+ * Root nodes never list their entities.
+ * @param node The node, which must be valid.
+ * @param contents Output for the checksums.
+ */
+void CalculateStateChecksumNode(const StateChecksumNode &node, StateChecksumNodeContents &contents)
+{
+	assert(node.IsValid());
+
+	SimpleChecksum64 children[STATE_CHECKSUM_CHILDREN];
+	const uint shift = node.depth * STATE_CHECKSUM_CHILD_BITS;
+	size_t count = 0;
+	contents.entities.clear();
+	IterateNodeEntities(node, [&](uint32 key, uint64 checksum) {
+		SimpleChecksum64 &child = children[(key >> shift) % STATE_CHECKSUM_CHILDREN];
+		child.Update(key);
+		child.Update(checksum);
+		if (++count <= STATE_CHECKSUM_MAX_LEAF_ENTITIES) contents.entities.emplace_back(key, checksum);
+	});
+
+	contents.leaf = (node.depth > 0 && count <= STATE_CHECKSUM_MAX_LEAF_ENTITIES);
+	if (!contents.leaf) contents.entities.clear();
+	for (uint i = 0; i < STATE_CHECKSUM_CHILDREN; i++) {
+		contents.children[i] = contents.leaf ? 0 : children[i].state;
+	}
+}
+
+/**
+ * Calculate the checksums of the children of the root nodes of all subsystems.
+ * This goes through the whole game state, so it is expensive on large games.
+ * @param tree Output for the checksums.
+ */
+void CalculateStateChecksumTree(StateChecksumTree &tree)
+{
+	StateChecksumNodeContents contents;
+	for (uint s = 0; s < SCS_END; s++) {
+		CalculateStateChecksumNode({ (StateChecksumSubsystem)s, 0, 0 }, contents);
+		std::copy(std::begin(contents.children), std::end(contents.children), tree.subsystems[s]);
+	}
+}
+
+/**
+ * Describe an entity of a subsystem.
+ * @param b The buffer to write to.
+ * @param last The last element in the buffer.
+ * @param subsystem The subsystem of the entity.
+ * @param key The key of the entity.
+ * @return Pointer to the terminating '\0' in the buffer.
+ */
+char *DescribeStateChecksumEntity(char *b, const char *last, StateChecksumSubsystem subsystem, uint32 key)
+{
+	switch (subsystem) {
+		case SCS_TRAINS:
+		case SCS_ROAD_VEHICLES:
+		case SCS_SHIPS:
+		case SCS_AIRCRAFT:
+		case SCS_EFFECT_VEHICLES:
+		case SCS_DISASTER_VEHICLES:
+			b += seprintf(b, last, "vehicle %u", key);
+			if (Vehicle::IsValidID(key)) {
+				const Vehicle *v = Vehicle::Get(key);
+				b += seprintf(b, last, " (unit %u, owner %u, tile %u x %u)", v->unitnumber, v->owner, TileX(v->tile), TileY(v->tile));
+			}
+			return b;
+
+		case SCS_MAP: {
+			const uint regions_x = MapSizeX() / STATE_CHECKSUM_MAP_REGION_SIZE;
+			const uint x = (key % regions_x) * STATE_CHECKSUM_MAP_REGION_SIZE;
+			const uint y = (key / regions_x) * STATE_CHECKSUM_MAP_REGION_SIZE;
+			return b + seprintf(b, last, "region %u (tiles %u x %u to %u x %u)", key, x, y, x + STATE_CHECKSUM_MAP_REGION_SIZE - 1, y + STATE_CHECKSUM_MAP_REGION_SIZE - 1);
+		}
+
+		case SCS_STATIONS:   return b + seprintf(b, last, "station %u", key);
+		case SCS_COMPANIES:  return b + seprintf(b, last, "company %u", key);
+		case SCS_CARGO:      return b + seprintf(b, last, "cargo packet %u", key);
+		case SCS_TOWNS:      return b + seprintf(b, last, "town %u", key);
+		case SCS_INDUSTRIES: return b + seprintf(b, last, "industry %u", key);
+
+		default: return b + seprintf(b, last, "entity %u", key);
+	}
+}
@@ -0,0 +1,87 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file state_checksum.h Hierarchical checksums of the game state, for locating desyncs. */
+
+#ifndef STATE_CHECKSUM_H
+#define STATE_CHECKSUM_H
+
+#include <vector>
+
+/** Subsystems of the game state which are checksummed separately. */
+enum StateChecksumSubsystem : uint8 {
+	SCS_TRAINS,            ///< Train vehicles.
+	SCS_ROAD_VEHICLES,     ///< Road vehicles.
+	SCS_SHIPS,             ///< Ships.
+	SCS_AIRCRAFT,          ///< Aircraft.
+	SCS_EFFECT_VEHICLES,   ///< Effect vehicles.
+	SCS_DISASTER_VEHICLES, ///< Disaster vehicles.
+	SCS_MAP,               ///< The map, in regions of #STATE_CHECKSUM_MAP_REGION_SIZE tiles square.
+	SCS_STATIONS,          ///< Stations and waypoints.
+	SCS_COMPANIES,         ///< Companies.
+	SCS_CARGO,             ///< Cargo packets.
+	SCS_TOWNS,             ///< Towns.
+	SCS_INDUSTRIES,        ///< Industries.
+	SCS_END,               ///< End marker.
+};
+
+static const uint STATE_CHECKSUM_CHILD_BITS = 4;                                 ///< Number of bits of the entity key which select the child of a node.
+static const uint STATE_CHECKSUM_CHILDREN = 1 << STATE_CHECKSUM_CHILD_BITS;      ///< Number of children of each node.
+static const uint STATE_CHECKSUM_MAX_DEPTH = 32 / STATE_CHECKSUM_CHILD_BITS;      ///< Maximum depth of a node.
+static const uint STATE_CHECKSUM_MAX_LEAF_ENTITIES = 32;                         ///< Nodes with at most this many entities list the entities instead of their children.
+static const uint STATE_CHECKSUM_MAP_REGION_SIZE = 16;                           ///< Size of the map regions, in tiles.
+
+/**
+ * A node of the checksum tree of a subsystem.
+ * Each entity of a subsystem has a key, the node contains the entities of which
+ * the lowest depth * #STATE_CHECKSUM_CHILD_BITS bits of the key are equal to the
+ * value of the node. The root of the tree of a subsystem has depth 0.
+ */
+struct StateChecksumNode {
+	StateChecksumSubsystem subsystem; ///< Subsystem of the node.
+	uint8 depth;                      ///< Depth of the node.
+	uint32 value;                     ///< Lowest bits of the keys of the entities of the node.
+
+	bool operator==(const StateChecksumNode &other) const
+	{
+		return this->subsystem == other.subsystem && this->depth == other.depth && this->value == other.value;
+	}
+
+	bool IsValid() const
+	{
+		return this->subsystem < SCS_END && this->depth < STATE_CHECKSUM_MAX_DEPTH && (this->value >> (this->depth * STATE_CHECKSUM_CHILD_BITS)) == 0;
+	}
+
+	/**
+	 * Get a child of this node.
+	 * @param child Index of the child.
+	 * @return The child node.
+	 */
+	StateChecksumNode GetChild(uint child) const
+	{
+		return { this->subsystem, (uint8)(this->depth + 1), this->value | (child << (this->depth * STATE_CHECKSUM_CHILD_BITS)) };
+	}
+};
+
+/** Checksums of the entities or the children of a node. */
+struct StateChecksumNodeContents {
+	bool leaf = false;                               ///< Whether the node lists its entities instead of its children.
+	uint64 children[STATE_CHECKSUM_CHILDREN] = {};   ///< Checksums of the children, when not a leaf.
+	std::vector<std::pair<uint32, uint64>> entities; ///< Keys and checksums of the entities, when a leaf.
+};
+
+/** Checksums of the children of the root nodes of all subsystems. */
+struct StateChecksumTree {
+	uint64 subsystems[SCS_END][STATE_CHECKSUM_CHILDREN]; ///< Checksums of the children of the root node of each subsystem.
+};
+
+void CalculateStateChecksumTree(StateChecksumTree &tree);
+void CalculateStateChecksumNode(const StateChecksumNode &node, StateChecksumNodeContents &contents);
+const char *GetStateChecksumSubsystemName(StateChecksumSubsystem subsystem);
+char *DescribeStateChecksumEntity(char *b, const char *last, StateChecksumSubsystem subsystem, uint32 key);
+
+#endif /* STATE_CHECKSUM_H */
@@ -4120,12 +4120,22 @@ void DeleteStaleLinks(Station *from)
 		GoodsEntry &ge = from->goods[c];
 		LinkGraph *lg = LinkGraph::GetIfValid(ge.link_graph);
 		if (lg == nullptr) continue;
-		Node node = (*lg)[ge.node];
-		for (EdgeIterator it(node.Begin()); it != node.End();) {
-			Edge edge = it->second;
-			Station *to = Station::Get((*lg)[it->first].Station());
-			assert(to->goods[c].node == it->first);
-			++it; // Do that before removing the edge. Anything else may crash.
+		/* Refreshing links below may add edges to the node, which moves the
+		 * other edges around. So only remember the destinations here and look
+		 * up the edges again where necessary. Edges are only looked up for
+		 * modification when they are actually modified, so that they don't
+		 * need to be copied if a link graph job still refers to them. */
+		const LinkGraph &const_lg = *lg;
+		std::vector<NodeID> dests;
+		ConstNode node = const_lg[ge.node];
+		dests.reserve(node.EdgeCount());
+		for (ConstEdgeIterator it(node.Begin()); it != node.End(); ++it) dests.push_back(it->first);
+
+		for (NodeID to_id : dests) {
+			if (!const_lg[ge.node].HasEdgeTo(to_id)) continue;
+			ConstEdge edge = const_lg[ge.node][to_id];
+			Station *to = Station::Get((*lg)[to_id].Station());
+			assert(to->goods[c].node == to_id);
 			assert(_date >= edge.LastUpdate());
 			uint timeout = std::max<uint>((LinkGraph::MIN_TIMEOUT_DISTANCE + (DistanceManhattan(from->xy, to->xy) >> 3)) / _settings_game.economy.day_length_factor, 1);
 			if ((uint)(_date - edge.LastUpdate()) > timeout) {
@@ -4161,7 +4171,7 @@ void DeleteStaleLinks(Station *from)
 						if (res.second) {
 							LinkRefresher::Run(v, false); // Don't allow merging. Otherwise lg might get deleted.
 						}
-						if (edge.LastUpdate() == _date) {
+						if (const_lg[ge.node][to_id].LastUpdate() == _date) {
 							updated = true;
 							break;
 						}
@@ -4180,16 +4190,16 @@ void DeleteStaleLinks(Station *from)
 
 				if (!updated) {
 					/* If it's still considered dead remove it. */
-					node.RemoveEdge(to->goods[c].node);
+					(*lg)[ge.node].RemoveEdge(to_id);
 					ge.flows.DeleteFlows(to->index);
 					RerouteCargo(from, c, to->index, from->index);
 				}
 			} else if (edge.LastUnrestrictedUpdate() != INVALID_DATE && (uint)(_date - edge.LastUnrestrictedUpdate()) > timeout) {
-				edge.Restrict();
+				(*lg)[ge.node][to_id].Restrict();
 				ge.flows.RestrictFlows(to->index);
 				RerouteCargo(from, c, to->index, from->index);
 			} else if (edge.LastRestrictedUpdate() != INVALID_DATE && (uint)(_date - edge.LastRestrictedUpdate()) > timeout) {
-				edge.Release();
+				(*lg)[ge.node][to_id].Release();
 			}
 		}
 		assert(_date >= lg->LastCompression());
@@ -341,7 +341,12 @@ protected:
 	/** Sort the stations list */
 	void SortStationsList()
 	{
-		if (!this->stations.Sort()) return;
+		if (this->stations.SortType() == 0) {
+			/* Sort by name, using the name of each station only once. */
+			if (!this->stations.SortByKey([](const Station * const &st) { return std::make_pair(GetNatSortKey(st->GetCachedName()), st->index); })) return;
+		} else {
+			if (!this->stations.Sort()) return;
+		}
 
 		/* Set the modified widget dirty */
 		this->SetWidgetDirty(WID_STL_LIST);
@@ -19,6 +19,7 @@
 #include <stdarg.h>
 #include <ctype.h> /* required for tolower() */
 #include <sstream>
+#include <limits>
 
 #ifdef _MSC_VER
 #include <errno.h> // required by vsnprintf implementation for MSVC
@@ -871,6 +872,62 @@ int strnatcmp(const char *s1, const char *s2, bool ignore_garbage_at_front)
 	return _strnatcmpIntl(s1, s2);
 }
 
+/**
+ * Make the key for sorting a string like #strnatcmp.
+ * Without a collator of the operating system or ICU, the key encodes the manual
+ * natural sort comparison: characters are lowercased, and each run of digits is
+ * replaced by its length and its digits without leading zeros.
+ *
+ * @param s The string to make the key of.
+ * @param ignore_garbage_at_front Skip punctuation characters in the front
+ * @return The key.
+ */
+NatSortKey GetNatSortKey(const char *s, bool ignore_garbage_at_front)
+{
+	if (ignore_garbage_at_front) s = SkipGarbage(s);
+
+	NatSortKey result;
+	result.raw = false;
+
+#ifdef WITH_ICU_I18N
+	if (_current_collator) {
+		icu::UnicodeString str = icu::UnicodeString::fromUTF8(s);
+		int32_t length = _current_collator->getSortKey(str, nullptr, 0);
+		if (length > 0) {
+			result.key.resize(length);
+			_current_collator->getSortKey(str, (uint8_t *)&result.key[0], length);
+			result.key.pop_back(); // The terminating zero.
+			return result;
+		}
+	}
+#endif /* WITH_ICU_I18N */
+
+#if (defined(_WIN32) || defined(WITH_COCOA)) && !defined(STRGEN) && !defined(SETTINGSGEN)
+	/* The collators of the operating system cannot make keys. */
+	result.key = s;
+	result.raw = true;
+	return result;
+#else
+	/* The manual comparison compares (possibly signed) chars, while keys are compared as unsigned chars. */
+	const char flip = std::numeric_limits<char>::is_signed ? (char)0x80 : 0;
+	while (*s != '\0') {
+		if (IsInsideBS(*s, '0', 10)) {
+			/* Runs of digits compare as '0'..'9' with other characters, so start with '0'. */
+			while (*s == '0' && IsInsideBS(s[1], '0', 10)) s++;
+			const char *digits = s;
+			while (IsInsideBS(*s, '0', 10)) s++;
+			result.key += (char)('0' ^ flip);
+			result.key += (char)std::min<ptrdiff_t>(s - digits, 0xFF);
+			result.key.append(digits, s - digits);
+		} else {
+			result.key += (char)(tolower(*s) ^ flip);
+			s++;
+		}
+	}
+	return result;
+#endif
+}
+
 #ifdef WITH_UNISCRIBE
 
 /* static */ StringIterator *StringIterator::Create()
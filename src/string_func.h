@@ -275,4 +275,22 @@ char *strcasestr(const char *haystack, const char *needle);
 
 int strnatcmp(const char *s1, const char *s2, bool ignore_garbage_at_front = false);
 
+/**
+ * Key for sorting a string in the same order as #strnatcmp does.
+ * Comparing keys is much cheaper than comparing the strings with #strnatcmp,
+ * so make keys once when the same strings have to be compared many times.
+ */
+struct NatSortKey {
+	std::string key; ///< Collation key of the string, or the string itself when #raw.
+	bool raw;        ///< Whether no collation key could be made, so the string has to be compared with #strnatcmp.
+
+	bool operator<(const NatSortKey &other) const
+	{
+		if (this->raw || other.raw) return strnatcmp(this->key.c_str(), other.key.c_str()) < 0;
+		return this->key < other.key;
+	}
+};
+
+NatSortKey GetNatSortKey(const char *s, bool ignore_garbage_at_front = false);
+
 #endif /* STRING_FUNC_H */
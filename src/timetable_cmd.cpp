@@ -19,6 +19,7 @@
 #include "company_base.h"
 #include "settings_type.h"
 #include "scope.h"
+#include "departures_func.h"
 
 #include "table/strings.h"
 
@@ -39,6 +40,8 @@ static void ChangeTimetable(Vehicle *v, VehicleOrderID order_number, uint32 val,
 	int total_delta = 0;
 	int timetable_delta = 0;
 
+	InvalidateDepartureCache(v);
+
 	switch (mtf) {
 		case MTF_WAIT_TIME:
 			if (!ignore_lock && order->IsWaitFixed()) return;
@@ -340,6 +343,7 @@ CommandCost CmdSetVehicleOnTime(TileIndex tile, DoCommandFlag flags, uint32 p1,
 
 	if (flags & DC_EXEC) {
 		v->lateness_counter = 0;
+		InvalidateDepartureCache(v);
 		SetWindowDirty(WC_VEHICLE_TIMETABLE, v->index);
 	}
 
@@ -415,6 +419,8 @@ CommandCost CmdSetTimetableStart(TileIndex tile, DoCommandFlag flags, uint32 p1,
 	DateTicksScaled start_date_scaled = (_settings_game.economy.day_length_factor * (((DateTicksScaled)_date * DAY_TICKS) + _date_fract + (DateTicksScaled)(int32)p2)) + sub_ticks;
 
 	if (flags & DC_EXEC) {
+		InvalidateDepartureCache(v);
+
 		std::vector<Vehicle *> vehs;
 
 		if (timetable_all) {
@@ -778,6 +784,8 @@ void UpdateVehicleTimetable(Vehicle *v, bool travelling)
 	v->current_order_time = 0;
 	v->current_loading_time = 0;
 
+	InvalidateDepartureCache(v);
+
 	if (v->current_order.IsType(OT_IMPLICIT)) return; // no timetabling of auto orders
 
 	if (v->cur_real_order_index >= v->GetNumOrders()) return;
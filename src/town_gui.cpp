@@ -718,7 +718,12 @@ private:
 			this->vscroll->SetCount((uint)this->towns.size()); // Update scrollbar as well.
 		}
 		/* Always sort the towns. */
-		this->towns.Sort();
+		if (this->towns.SortType() == 0) {
+			/* Sort by name, using the name of each town only once. */
+			this->towns.SortByKey([](const Town * const &t) { return std::make_pair(GetNatSortKey(t->GetCachedName()), t->index); });
+		} else {
+			this->towns.Sort();
+		}
 		this->SetWidgetDirty(WID_TD_LIST); // Force repaint of the displayed towns.
 	}
 
@@ -45,6 +45,7 @@
 #include "core/checksum_func.hpp"
 #include "debug_settings.h"
 #include "train_speed_adaptation.h"
+#include "departures_func.h"
 
 #include "table/strings.h"
 #include "table/train_cmd.h"
@@ -2161,7 +2162,7 @@ CommandCost CmdMoveRailVehicle(TileIndex tile, DoCommandFlag flags, uint32 p1, u
 			InvalidateWindowData(WC_VEHICLE_DEPOT, src->tile);
 			InvalidateWindowClassesData(WC_TRAINS_LIST, 0);
 			InvalidateWindowClassesData(WC_TRACE_RESTRICT_SLOTS, 0);
-			InvalidateWindowClassesData(WC_DEPARTURES_BOARD, 0);
+			InvalidateDepartureBoards();
 		}
 	} else {
 		/* We don't want to execute what we're just tried. */
@@ -2253,7 +2254,7 @@ CommandCost CmdSellRailWagon(DoCommandFlag flags, Vehicle *t, uint16 data, uint3
 			InvalidateWindowData(WC_VEHICLE_DEPOT, v->tile);
 			InvalidateWindowClassesData(WC_TRAINS_LIST, 0);
 			InvalidateWindowClassesData(WC_TRACE_RESTRICT_SLOTS, 0);
-			InvalidateWindowClassesData(WC_DEPARTURES_BOARD, 0);
+			InvalidateDepartureBoards();
 		}
 
 		/* Actually delete the sold 'goods' */
@@ -772,6 +772,8 @@ CommandCost CmdBuildBridge(TileIndex end_tile, DoCommandFlag flags, uint32 p1, u
 				NOT_REACHED();
 		}
 
+		if (!is_upgrade) ViewportMapStoreBridge(tile_start, tile_end);
+
 		/* Mark all tiles dirty */
 		MarkBridgeDirty(tile_start, tile_end, AxisToDiagDir(direction), z_start);
 		DirtyCompanyInfrastructureWindows(company);
@@ -1411,6 +1413,8 @@ static CommandCost DoClearBridge(TileIndex tile, DoCommandFlag flags)
 		if (IsTunnelBridgeSignalSimulationEntrance(tile)) ClearBridgeEntranceSimulatedSignals(tile);
 		if (IsTunnelBridgeSignalSimulationEntrance(endtile)) ClearBridgeEntranceSimulatedSignals(endtile);
 
+		ViewportMapInvalidateBridgeCacheByTile(std::min(tile, endtile), DiagDirToAxis(direction));
+
 		DoClearSquare(tile);
 		DoClearSquare(endtile);
 
@@ -58,6 +58,7 @@
 #include "string_func.h"
 #include "scope_info.h"
 #include "debug_settings.h"
+#include "departures_func.h"
 #include "3rdparty/cpp-btree/btree_set.h"
 
 #include "table/strings.h"
@@ -351,7 +352,7 @@ uint Vehicle::Crash(bool flooded)
 	SetWindowWidgetDirty(WC_VEHICLE_VIEW, this->index, WID_VV_START_STOP);
 	SetWindowDirty(WC_VEHICLE_DETAILS, this->index);
 	SetWindowDirty(WC_VEHICLE_DEPOT, this->tile);
-	InvalidateWindowClassesData(WC_DEPARTURES_BOARD, 0);
+	InvalidateDepartureBoards();
 
 	delete this->cargo_payment;
 	assert(this->cargo_payment == nullptr); // cleared by ~CargoPayment
@@ -1151,7 +1152,7 @@ void Vehicle::PreDestructor()
 		OrderBackup::ClearVehicle(this);
 	}
 	InvalidateWindowClassesData(GetWindowClassForVehicleType(this->type), 0);
-	InvalidateWindowClassesData(WC_DEPARTURES_BOARD, 0);
+	InvalidateDepartureBoards();
 
 	this->cargo.Truncate();
 	DeleteVehicleOrders(this);
@@ -3089,6 +3090,8 @@ static void VehicleIncreaseStats(const Vehicle *front)
  */
 void Vehicle::BeginLoading()
 {
+	InvalidateDepartureCache(this);
+
 	if (this->type == VEH_TRAIN) {
 		assert_tile(IsTileType(Train::From(this)->GetStationLoadingVehicle()->tile, MP_STATION), Train::From(this)->GetStationLoadingVehicle()->tile);
 	} else {
@@ -3258,6 +3261,8 @@ void Vehicle::LeaveStation()
 {
 	assert(this->current_order.IsAnyLoadingType());
 
+	InvalidateDepartureCache(this);
+
 	delete this->cargo_payment;
 	assert(this->cargo_payment == nullptr); // cleared by ~CargoPayment
 
@@ -3514,6 +3519,8 @@ CommandCost Vehicle::SendToDepot(DoCommandFlag flags, DepotCommand command, Tile
 	if (this->vehstatus & VS_CRASHED) return CMD_ERROR;
 	if (this->IsStoppedInDepot()) return CMD_ERROR;
 
+	if (flags & DC_EXEC) InvalidateDepartureCache(this);
+
 	auto cancel_order = [&]() {
 		if (flags & DC_EXEC) {
 			/* If the orders to 'goto depot' are in the orders list (forced servicing),
@@ -34,6 +34,7 @@
 #include "tbtr_template_vehicle.h"
 #include "tbtr_template_vehicle_func.h"
 #include "scope.h"
+#include "departures_func.h"
 #include <sstream>
 #include <iomanip>
 #include <cctype>
@@ -173,7 +174,7 @@ CommandCost CmdBuildVehicle(TileIndex tile, DoCommandFlag flags, uint32 p1, uint
 		if (flags & DC_EXEC) {
 			InvalidateWindowData(WC_VEHICLE_DEPOT, v->tile);
 			InvalidateWindowClassesData(GetWindowClassForVehicleType(type), 0);
-			InvalidateWindowClassesData(WC_DEPARTURES_BOARD, 0);
+			InvalidateDepartureBoards();
 			SetWindowDirty(WC_COMPANY, _current_company);
 			if (IsLocalCompany()) {
 				InvalidateAutoreplaceWindow(v->engine_type, v->group_id); // updates the auto replace window (must be called before incrementing num_engines)
@@ -562,7 +563,7 @@ CommandCost CmdRefitVehicle(TileIndex tile, DoCommandFlag flags, uint32 p1, uint
 		if (!free_wagon) {
 			InvalidateWindowData(WC_VEHICLE_DETAILS, front->index);
 			InvalidateWindowClassesData(GetWindowClassForVehicleType(v->type), 0);
-			InvalidateWindowClassesData(WC_DEPARTURES_BOARD, 0);
+			InvalidateDepartureBoards();
 		}
 		/* virtual vehicles get their cargo changed by the TemplateCreateWindow, so set this dirty instead of a depot window */
 		if (HasBit(v->subtype, GVSF_VIRTUAL)) {
@@ -668,6 +669,7 @@ CommandCost CmdStartStopVehicle(TileIndex tile, DoCommandFlag flags, uint32 p1,
 		SetWindowDirty(WC_VEHICLE_DEPOT, v->tile);
 		DirtyVehicleListWindowForVehicle(v);
 		InvalidateWindowData(WC_VEHICLE_VIEW, v->index);
+		InvalidateDepartureCache(v);
 	}
 	return CommandCost();
 }
@@ -1696,7 +1698,7 @@ CommandCost CmdRenameVehicle(TileIndex tile, DoCommandFlag flags, uint32 p1, uin
 			v->name = text;
 		}
 		InvalidateWindowClassesData(GetWindowClassForVehicleType(v->type), 1);
-		InvalidateWindowClassesData(WC_DEPARTURES_BOARD, 0);
+		InvalidateDepartureBoards();
 		MarkWholeScreenDirty();
 	}
 
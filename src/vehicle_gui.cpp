@@ -479,6 +479,54 @@ static const Vehicle *_last_vehicle[2] = { nullptr, nullptr };
 
 void BaseVehicleListWindow::SortVehicleList()
 {
+	if (this->grouping == GB_NONE) {
+		/* Sort on values which are expensive to determine using keys, so each is only determined once per vehicle. */
+		switch (this->vehgroups.SortType()) {
+			case VST_NAME:
+				this->vehgroups.SortByKey([](const GUIVehicleGroup &vg) {
+					const Vehicle *v = *vg.vehicles_begin;
+					SetDParam(0, v->index);
+					char name[64];
+					GetString(name, STR_VEHICLE_NAME, lastof(name));
+					return std::make_pair(GetNatSortKey(name), v->unitnumber);
+				});
+				return;
+
+			case VST_PROFIT_THIS_YEAR:
+				this->vehgroups.SortByKey([](const GUIVehicleGroup &vg) {
+					const Vehicle *v = *vg.vehicles_begin;
+					return std::make_pair(v->GetDisplayProfitThisYear(), v->unitnumber);
+				});
+				return;
+
+			case VST_PROFIT_LAST_YEAR:
+				this->vehgroups.SortByKey([](const GUIVehicleGroup &vg) {
+					const Vehicle *v = *vg.vehicles_begin;
+					return std::make_pair(v->GetDisplayProfitLastYear(), v->unitnumber);
+				});
+				return;
+
+			case VST_PROFIT_LIFETIME:
+				this->vehgroups.SortByKey([](const GUIVehicleGroup &vg) {
+					const Vehicle *v = *vg.vehicles_begin;
+					return std::make_pair(v->GetDisplayProfitLifetime(), v->unitnumber);
+				});
+				return;
+
+			case VST_VALUE:
+				this->vehgroups.SortByKey([](const GUIVehicleGroup &vg) {
+					const Vehicle *v = *vg.vehicles_begin;
+					Money value = 0;
+					for (const Vehicle *u = v; u != nullptr; u = u->Next()) value += u->value;
+					return std::make_pair(value, v->unitnumber);
+				});
+				return;
+
+			default:
+				break;
+		}
+	}
+
 	if (this->vehgroups.Sort()) return;
 
 	/* invalidate cached values for name sorter - vehicle names could change */
@@ -1623,7 +1671,7 @@ static inline void ChangeVehicleWindow(WindowClass window_class, VehicleID from_
 	Window *w = FindWindowById(window_class, from_index);
 	if (w != nullptr) {
 		/* Update window_number */
-		w->window_number = to_index;
+		w->ChangeWindowNumber(to_index);
 		if (w->viewport != nullptr) w->viewport->follow_vehicle = to_index;
 
 		/* Update vehicle drag data */
@@ -2454,7 +2502,7 @@ public:
 		if (!gui_scope && HasBit(data, 31) && this->vli.type == VL_SHARED_ORDERS) {
 			/* Needs to be done in command-scope, so everything stays valid */
 			this->vli.index = GB(data, 0, 20);
-			this->window_number = this->vli.Pack();
+			this->ChangeWindowNumber(this->vli.Pack());
 			this->vehgroups.ForceRebuild();
 			return;
 		}
@@ -125,6 +125,9 @@ void VideoDriver_SDL_Default::Paint()
 		this->local_palette.count_dirty = 0;
 	}
 
+	/* Palette animation might not have found any animated pixels. */
+	if (IsEmptyRect(this->dirty_rect)) return;
+
 	SDL_Rect r = { this->dirty_rect.left, this->dirty_rect.top, this->dirty_rect.right - this->dirty_rect.left, this->dirty_rect.bottom - this->dirty_rect.top };
 
 	if (_sdl_surface != _sdl_real_surface) {
@@ -259,7 +259,11 @@ void VideoDriver_SDL_Base::CheckPaletteAnim()
 
 	this->local_palette = _cur_palette;
 	_cur_palette.count_dirty = 0;
-	this->MakeDirty(0, 0, _screen.width, _screen.height);
+
+	/* A blitter animating the palette itself only marks the animated pixels dirty, unless it is drawn by OpenGL. */
+	if (this->HasAnimBuffer() || BlitterFactory::GetCurrentBlitter()->UsePaletteAnimation() != Blitter::PALETTE_ANIMATION_BLITTER) {
+		this->MakeDirty(0, 0, _screen.width, _screen.height);
+	}
 }
 
 static const Dimension default_resolutions[] = {
@@ -816,7 +816,11 @@ void VideoDriver_Win32Base::CheckPaletteAnim()
 
 	_local_palette = _cur_palette;
 	_cur_palette.count_dirty = 0;
-	this->MakeDirty(0, 0, _screen.width, _screen.height);
+
+	/* A blitter animating the palette itself only marks the animated pixels dirty, unless it is drawn by OpenGL. */
+	if (this->HasAnimBuffer() || BlitterFactory::GetCurrentBlitter()->UsePaletteAnimation() != Blitter::PALETTE_ANIMATION_BLITTER) {
+		this->MakeDirty(0, 0, _screen.width, _screen.height);
+	}
 }
 
 void VideoDriver_Win32Base::InputLoop()
@@ -1130,7 +1134,7 @@ void VideoDriver_Win32GDI::Paint()
 {
 	PerformanceMeasurer framerate(PFE_VIDEO);
 
-	if (IsEmptyRect(this->dirty_rect)) return;
+	if (IsEmptyRect(this->dirty_rect) && _local_palette.count_dirty == 0) return;
 
 	HDC dc = GetDC(this->main_wnd);
 	HDC dc2 = CreateCompatibleDC(dc);
@@ -1143,7 +1147,9 @@ void VideoDriver_Win32GDI::Paint()
 
 		switch (blitter->UsePaletteAnimation()) {
 			case Blitter::PALETTE_ANIMATION_VIDEO_BACKEND:
+				/* Any pixel might use the changed colours, so the whole window has to be redrawn. */
 				this->UpdatePalette(dc2, _local_palette.first_dirty, _local_palette.count_dirty);
+				this->dirty_rect = { 0, 0, this->width, this->height };
 				break;
 
 			case Blitter::PALETTE_ANIMATION_BLITTER: {
@@ -1160,7 +1166,11 @@ void VideoDriver_Win32GDI::Paint()
 		_local_palette.count_dirty = 0;
 	}
 
-	BitBlt(dc, 0, 0, this->width, this->height, dc2, 0, 0, SRCCOPY);
+	/* Palette animation might not have found any animated pixels. */
+	if (!IsEmptyRect(this->dirty_rect)) {
+		const Rect &r = this->dirty_rect;
+		BitBlt(dc, r.left, r.top, r.right - r.left, r.bottom - r.top, dc2, r.left, r.top, SRCCOPY);
+	}
 	SelectPalette(dc, old_palette, TRUE);
 	SelectObject(dc2, old_bmp);
 	DeleteDC(dc2);
@@ -110,11 +110,19 @@
 #include "scope.h"
 #include "blitter/32bpp_base.hpp"
 
+#include "thread.h"
+
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include <math.h>
 #include <algorithm>
 #include <tuple>
+#include <atomic>
+#include <mutex>
+#if defined(__MINGW32__)
+#include "3rdparty/mingw-std-threads/mingw.mutex.h"
+#endif
 
 #include "table/strings.h"
 #include "table/string_colours.h"
@@ -218,20 +226,6 @@ struct TunnelToMapStorage {
 	std::vector<TunnelToMap> tunnels;
 };
 
-struct BridgeSetXComparator {
-	bool operator() (const TileIndex a, const TileIndex b) const
-	{
-		return std::make_tuple(TileX(a), TileY(a)) < std::make_tuple(TileX(b), TileY(b));
-	}
-};
-
-struct BridgeSetYComparator {
-	bool operator() (const TileIndex a, const TileIndex b) const
-	{
-		return a < b;
-	}
-};
-
 /** Data structure storing rendering information */
 struct ViewportDrawer {
 	DrawPixelInfo dpi;
@@ -245,8 +239,8 @@ struct ViewportDrawer {
 	ChildScreenSpriteToDrawVector child_screen_sprites_to_draw;
 	TunnelToMapStorage tunnel_to_map_x;
 	TunnelToMapStorage tunnel_to_map_y;
-	btree::btree_map<TileIndex, TileIndex, BridgeSetXComparator> bridge_to_map_x;
-	btree::btree_map<TileIndex, TileIndex, BridgeSetYComparator> bridge_to_map_y;
+	TunnelToMapStorage bridge_to_map_x;
+	TunnelToMapStorage bridge_to_map_y;
 
 	int *last_child;
 
@@ -1559,6 +1553,368 @@ static int GetViewportY(Point tile)
 	return (tile.y * (int)(TILE_PIXELS / 2) + tile.x * (int)(TILE_PIXELS / 2) - TilePixelHeightOutsideMap(tile.x, tile.y)) << ZOOM_LVL_SHIFT;
 }
 
+/** Sprites added by the draw tile proc of a tile, see #ViewportTileSpriteCache. */
+struct ViewportTileSpriteCacheEntry {
+	uint32 tile_sprites_first;                          ///< Index of the first tile sprite in ViewportTileSpriteCache::tile_sprites.
+	uint32 parent_sprites_first;                        ///< Index of the first parent sprite in ViewportTileSpriteCache::parent_sprites.
+	uint32 child_sprites_first;                         ///< Index of the first child sprite in ViewportTileSpriteCache::child_sprites.
+	uint16 tile_sprites_count;                          ///< Number of tile sprites.
+	uint16 parent_sprites_count;                        ///< Number of parent sprites.
+	uint16 child_sprites_count;                         ///< Number of child sprites.
+	FoundationPart foundation_part;                     ///< Active foundation part after drawing the tile.
+	int foundation[FOUNDATION_PART_END];                ///< Foundation sprites (index into the parent sprites of the entry), or -1.
+	int32 last_foundation_child[FOUNDATION_PART_END];   ///< Tail of the ChildSprite lists of the foundations, see #ViewportTileSpriteCache::EncodeChildLink.
+	Point foundation_offset[FOUNDATION_PART_END];       ///< Pixel offset for ground sprites on the foundations.
+	int32 last_child;                                   ///< Tail of the active ChildSprite list after drawing the tile, see #ViewportTileSpriteCache::EncodeChildLink.
+};
+
+/**
+ * Cache of the sprites added by the draw tile procs of tiles, for one zoom level.
+ * The sprites of a tile are recorded without clipping them to the drawn area, and are clipped when replayed.
+ * Replaying the sprites of an unchanged tile skips resolving them, which includes NewGRF callbacks and foundations.
+ * Entries are invalidated when the tile or one of its neighbours is marked dirty.
+ */
+struct ViewportTileSpriteCache {
+	std::unordered_map<TileIndex, ViewportTileSpriteCacheEntry> entries;
+	TileSpriteToDrawVector tile_sprites;
+	ParentSpriteToDrawVector parent_sprites;
+	ChildScreenSpriteToDrawVector child_sprites;
+	size_t garbage = 0; ///< Number of sprites in the vectors belonging to removed entries.
+
+	static const size_t MAX_SPRITES = 1 << 19; ///< Maximum number of cached sprites, before the cache is cleared.
+
+	size_t GetSpriteCount() const
+	{
+		return this->tile_sprites.size() + this->parent_sprites.size() + this->child_sprites.size();
+	}
+
+	void Clear()
+	{
+		this->entries.clear();
+		this->tile_sprites.clear();
+		this->parent_sprites.clear();
+		this->child_sprites.clear();
+		this->garbage = 0;
+	}
+
+	void Remove(TileIndex tile)
+	{
+		auto it = this->entries.find(tile);
+		if (it == this->entries.end()) return;
+		this->garbage += it->second.tile_sprites_count + it->second.parent_sprites_count + it->second.child_sprites_count;
+		this->entries.erase(it);
+	}
+
+	/** Remove the sprites of removed entries, or drop everything when the cache has grown too big. */
+	void Compact()
+	{
+		if (this->GetSpriteCount() > MAX_SPRITES) {
+			this->Clear();
+			return;
+		}
+		if (this->garbage < 4096 || this->garbage * 2 < this->GetSpriteCount()) return;
+
+		TileSpriteToDrawVector tile_sprites;
+		ParentSpriteToDrawVector parent_sprites;
+		ChildScreenSpriteToDrawVector child_sprites;
+		for (auto &it : this->entries) {
+			ViewportTileSpriteCacheEntry &entry = it.second;
+			auto move = [](auto &from, auto &to, uint32 &first, uint16 count) {
+				uint32 new_first = (uint32)to.size();
+				to.insert(to.end(), from.begin() + first, from.begin() + first + count);
+				first = new_first;
+			};
+			move(this->tile_sprites, tile_sprites, entry.tile_sprites_first, entry.tile_sprites_count);
+			move(this->parent_sprites, parent_sprites, entry.parent_sprites_first, entry.parent_sprites_count);
+			move(this->child_sprites, child_sprites, entry.child_sprites_first, entry.child_sprites_count);
+		}
+		this->tile_sprites = std::move(tile_sprites);
+		this->parent_sprites = std::move(parent_sprites);
+		this->child_sprites = std::move(child_sprites);
+		this->garbage = 0;
+	}
+
+	/**
+	 * Encode a link to the next child sprite of a sprite list as an index relative to the sprites of a tile.
+	 * @param link The link: the first_child of a parent sprite, or the next of a child sprite.
+	 * @param parent_first Index in #ViewportDrawer::parent_sprites_to_draw of the first parent sprite of the tile.
+	 * @param child_first Index in #ViewportDrawer::child_screen_sprites_to_draw of the first child sprite of the tile.
+	 * @return -1 for no link, (index << 1) for the first_child of a parent sprite, (index << 1) | 1 for the next of a child sprite, or -2 if the link is not within the sprites of the tile.
+	 */
+	static int32 EncodeChildLink(const int *link, size_t parent_first, size_t child_first)
+	{
+		if (link == nullptr) return -1;
+		for (size_t i = parent_first; i < _vd.parent_sprites_to_draw.size(); i++) {
+			if (link == &_vd.parent_sprites_to_draw[i].first_child) return (int32)((i - parent_first) << 1);
+		}
+		for (size_t i = child_first; i < _vd.child_screen_sprites_to_draw.size(); i++) {
+			if (link == &_vd.child_screen_sprites_to_draw[i].next) return (int32)(((i - child_first) << 1) | 1);
+		}
+		return -2;
+	}
+};
+
+/** State which the cached sprites of tiles depend on, besides the tiles themselves. */
+struct ViewportTileSpriteCacheState {
+	TransparencyOptionBits transparency;
+	TransparencyOptionBits invisibility;
+	byte display_opt;
+	int32 year;
+	uint8 month;
+
+	bool IsSameDisplay(const ViewportTileSpriteCacheState &other) const
+	{
+		return this->transparency == other.transparency && this->invisibility == other.invisibility && this->display_opt == other.display_opt;
+	}
+};
+
+static ViewportTileSpriteCache _vp_tile_sprite_caches[ZOOM_LVL_END];
+static ViewportTileSpriteCacheState _vp_tile_sprite_cache_state;
+static bool _vp_tile_sprite_cache_state_valid = false;
+
+/**
+ * Clear the cached sprites of the tiles of all zoom levels.
+ * This is done whenever the whole screen is marked dirty.
+ */
+void ClearViewportTileSpriteCaches()
+{
+	for (ViewportTileSpriteCache &cache : _vp_tile_sprite_caches) {
+		cache.Clear();
+	}
+	_vp_tile_sprite_cache_state_valid = false;
+}
+
+/**
+ * Drop the cached sprites of a tile and its neighbours, as tiles may be drawn differently depending on their neighbours.
+ * @param tile The changed tile.
+ */
+void InvalidateViewportTileSpriteCache(TileIndex tile)
+{
+	uint x = TileX(tile);
+	uint y = TileY(tile);
+	for (ViewportTileSpriteCache &cache : _vp_tile_sprite_caches) {
+		if (cache.entries.empty()) continue;
+		for (uint ny = std::max<uint>(y, 1) - 1; ny <= std::min(y + 1, MapMaxY()); ny++) {
+			for (uint nx = std::max<uint>(x, 1) - 1; nx <= std::min(x + 1, MapMaxX()); nx++) {
+				cache.Remove(TileXY(nx, ny));
+			}
+		}
+	}
+}
+
+/**
+ * Get the cache of the sprites of the tiles for the current drawing.
+ * @return The cache, or nullptr if the cache is not to be used.
+ */
+static ViewportTileSpriteCache *GetViewportTileSpriteCache()
+{
+	if (_draw_bounding_boxes || unlikely(HasBit(_viewport_debug_flags, VDF_DISABLE_LANDSCAPE_CACHE))) return nullptr;
+
+	ViewportTileSpriteCacheState state;
+	state.transparency = _transparency_opt;
+	state.invisibility = _invisibility_opt;
+	state.display_opt = _display_opt;
+	state.year = _cur_date_ymd.year;
+	state.month = _cur_date_ymd.month;
+
+	if (_vp_tile_sprite_cache_state_valid && (state.year != _vp_tile_sprite_cache_state.year || state.month != _vp_tile_sprite_cache_state.month)) {
+		/* Refresh the cache monthly, for NewGRF graphics which depend on the date. */
+		ClearViewportTileSpriteCaches();
+	}
+	if (!_vp_tile_sprite_cache_state_valid) {
+		_vp_tile_sprite_cache_state = state;
+		_vp_tile_sprite_cache_state_valid = true;
+	} else if (!state.IsSameDisplay(_vp_tile_sprite_cache_state)) {
+		/* Viewports which temporarily override the transparency settings are drawn without the cache. */
+		return nullptr;
+	}
+
+	ViewportTileSpriteCache &cache = _vp_tile_sprite_caches[_vd.dpi.zoom];
+	cache.Compact();
+	return &cache;
+}
+
+/**
+ * Check whether the sprites of a tile can be cached.
+ * Tiles whose appearance changes without them being marked dirty, such as stations with their cargo
+ * and industries, and tiles below bridges, are always drawn directly.
+ * @param tile The tile.
+ * @param tile_type The type of the tile.
+ * @return Whether the sprites of the tile can be cached.
+ */
+static bool IsViewportTileSpriteCacheable(TileIndex tile, TileType tile_type)
+{
+	switch (tile_type) {
+		case MP_CLEAR:
+		case MP_RAILWAY:
+		case MP_ROAD:
+		case MP_HOUSE:
+		case MP_TREES:
+		case MP_WATER:
+		case MP_OBJECT:
+			return !IsBridgeAbove(tile);
+
+		default:
+			return false;
+	}
+}
+
+/**
+ * Run the draw tile proc of a tile without clipping, and store the sprites it added in the cache.
+ * On success, the sprites are removed from the sprites to draw again, to be replayed with clipping.
+ * @param cache The cache.
+ * @param ti The tile to draw.
+ * @param tile_type The type of the tile.
+ * @return The cache entry, or nullptr if the sprites could not be cached. In the latter case the sprites stay in the sprites to draw.
+ */
+static const ViewportTileSpriteCacheEntry *ViewportRecordTileSprites(ViewportTileSpriteCache &cache, TileInfo *ti, TileType tile_type)
+{
+	const size_t tile_first = _vd.tile_sprites_to_draw.size();
+	const size_t parent_first = _vd.parent_sprites_to_draw.size();
+	const size_t child_first = _vd.child_screen_sprites_to_draw.size();
+
+	/* Draw the whole tile, regardless of the area being drawn */
+	const DrawPixelInfo dpi_backup = _vd.dpi;
+	_vd.dpi.left = INT_MIN / 2;
+	_vd.dpi.top = INT_MIN / 2;
+	_vd.dpi.width = INT_MAX;
+	_vd.dpi.height = INT_MAX;
+	_vd.last_child = nullptr;
+	_tile_type_procs[tile_type]->draw_tile_proc(ti, { INT_MIN, false });
+	_vd.dpi = dpi_backup;
+
+	const size_t tile_count = _vd.tile_sprites_to_draw.size() - tile_first;
+	const size_t parent_count = _vd.parent_sprites_to_draw.size() - parent_first;
+	const size_t child_count = _vd.child_screen_sprites_to_draw.size() - child_first;
+	if (tile_count > UINT16_MAX || parent_count > UINT16_MAX || child_count > UINT16_MAX) return nullptr;
+
+	ViewportTileSpriteCacheEntry entry;
+	entry.foundation_part = _vd.foundation_part;
+	for (uint i = 0; i < FOUNDATION_PART_END; i++) {
+		entry.foundation[i] = _vd.foundation[i] < 0 ? -1 : _vd.foundation[i] - (int)parent_first;
+		entry.last_foundation_child[i] = ViewportTileSpriteCache::EncodeChildLink(_vd.last_foundation_child[i], parent_first, child_first);
+		entry.foundation_offset[i] = _vd.foundation_offset[i];
+		if (entry.foundation[i] < -1 || entry.last_foundation_child[i] == -2) return nullptr;
+	}
+	entry.last_child = ViewportTileSpriteCache::EncodeChildLink(_vd.last_child, parent_first, child_first);
+	if (entry.last_child == -2) return nullptr;
+
+	/* All child sprite lists must stay within the sprites of the tile */
+	auto in_range = [&](int index) -> bool {
+		return index == -1 || (index >= (int)child_first && index < (int)(child_first + child_count));
+	};
+	for (size_t i = parent_first; i < parent_first + parent_count; i++) {
+		if (!in_range(_vd.parent_sprites_to_draw[i].first_child)) return nullptr;
+	}
+	for (size_t i = child_first; i < child_first + child_count; i++) {
+		if (!in_range(_vd.child_screen_sprites_to_draw[i].next)) return nullptr;
+	}
+
+	entry.tile_sprites_first = (uint32)cache.tile_sprites.size();
+	entry.tile_sprites_count = (uint16)tile_count;
+	cache.tile_sprites.insert(cache.tile_sprites.end(), _vd.tile_sprites_to_draw.begin() + tile_first, _vd.tile_sprites_to_draw.end());
+
+	entry.parent_sprites_first = (uint32)cache.parent_sprites.size();
+	entry.parent_sprites_count = (uint16)parent_count;
+	for (size_t i = parent_first; i < parent_first + parent_count; i++) {
+		ParentSpriteToDraw &ps = cache.parent_sprites.emplace_back(_vd.parent_sprites_to_draw[i]);
+		if (ps.first_child >= 0) ps.first_child -= (int)child_first;
+	}
+
+	entry.child_sprites_first = (uint32)cache.child_sprites.size();
+	entry.child_sprites_count = (uint16)child_count;
+	for (size_t i = child_first; i < child_first + child_count; i++) {
+		ChildScreenSpriteToDraw &cs = cache.child_sprites.emplace_back(_vd.child_screen_sprites_to_draw[i]);
+		if (cs.next >= 0) cs.next -= (int)child_first;
+	}
+
+	_vd.tile_sprites_to_draw.resize(tile_first);
+	_vd.parent_sprites_to_draw.resize(parent_first);
+	_vd.child_screen_sprites_to_draw.resize(child_first);
+
+	cache.Remove(ti->tile);
+	return &(cache.entries[ti->tile] = entry);
+}
+
+/**
+ * Add the cached sprites of a tile to the sprites to draw, clipped to the area being drawn.
+ * This also sets up the foundation state, as the draw tile proc would.
+ * @param cache The cache.
+ * @param entry The cached sprites of the tile.
+ * @param no_ground_tiles Whether the ground of the tile is outside the area being drawn.
+ */
+static void ViewportReplayTileSprites(const ViewportTileSpriteCache &cache, const ViewportTileSpriteCacheEntry &entry, bool no_ground_tiles)
+{
+	static std::vector<int> parent_index;
+
+	if (!no_ground_tiles) {
+		auto first = cache.tile_sprites.begin() + entry.tile_sprites_first;
+		_vd.tile_sprites_to_draw.insert(_vd.tile_sprites_to_draw.end(), first, first + entry.tile_sprites_count);
+	}
+
+	const int child_first = (int)_vd.child_screen_sprites_to_draw.size();
+	for (uint i = 0; i < entry.child_sprites_count; i++) {
+		ChildScreenSpriteToDraw &cs = _vd.child_screen_sprites_to_draw.emplace_back(cache.child_sprites[entry.child_sprites_first + i]);
+		if (cs.next >= 0) cs.next += child_first;
+	}
+
+	parent_index.resize(entry.parent_sprites_count);
+	for (uint i = 0; i < entry.parent_sprites_count; i++) {
+		const ParentSpriteToDraw &cached = cache.parent_sprites[entry.parent_sprites_first + i];
+		if (cached.left >= _vd.dpi.left + _vd.dpi.width ||
+				cached.left + cached.width <= _vd.dpi.left ||
+				cached.top >= _vd.dpi.top + _vd.dpi.height ||
+				cached.top + cached.height <= _vd.dpi.top) {
+			/* Do not add the sprite to the viewport, if it is outside */
+			parent_index[i] = -1;
+			continue;
+		}
+		parent_index[i] = (int)_vd.parent_sprites_to_draw.size();
+		ParentSpriteToDraw &ps = _vd.parent_sprites_to_draw.emplace_back(cached);
+		if (ps.first_child >= 0) ps.first_child += child_first;
+	}
+
+	auto decode_link = [&](int32 link) -> int * {
+		if (link < 0) return nullptr;
+		if (link & 1) return &_vd.child_screen_sprites_to_draw[child_first + (link >> 1)].next;
+		int index = parent_index[link >> 1];
+		return index < 0 ? nullptr : &_vd.parent_sprites_to_draw[index].first_child;
+	};
+
+	_vd.foundation_part = entry.foundation_part;
+	for (uint i = 0; i < FOUNDATION_PART_END; i++) {
+		_vd.foundation[i] = entry.foundation[i] < 0 ? -1 : parent_index[entry.foundation[i]];
+		_vd.last_foundation_child[i] = _vd.foundation[i] < 0 ? nullptr : decode_link(entry.last_foundation_child[i]);
+		_vd.foundation_offset[i] = entry.foundation_offset[i];
+	}
+	_vd.last_child = decode_link(entry.last_child);
+}
+
+/**
+ * Add the sprites of a tile to the viewport, from the cache when possible.
+ * @param cache The cache.
+ * @param ti The tile to draw.
+ * @param tile_type The type of the tile.
+ * @param params The draw tile proc parameters, used when the tile is not cached.
+ */
+static void ViewportAddTileSprites(ViewportTileSpriteCache *cache, TileInfo *ti, TileType tile_type, DrawTileProcParams params)
+{
+	if (cache == nullptr || !IsViewportTileSpriteCacheable(ti->tile, tile_type)) {
+		_tile_type_procs[tile_type]->draw_tile_proc(ti, params);
+		return;
+	}
+
+	const ViewportTileSpriteCacheEntry *entry;
+	auto it = cache->entries.find(ti->tile);
+	if (it != cache->entries.end()) {
+		entry = &it->second;
+	} else {
+		entry = ViewportRecordTileSprites(*cache, ti, tile_type);
+		if (entry == nullptr) return;
+	}
+	ViewportReplayTileSprites(*cache, *entry, params.no_ground_tiles);
+}
+
 /**
  * Add the landscape to the viewport, i.e. all ground tiles and buildings.
  */
@@ -1588,6 +1944,8 @@ static void ViewportAddLandscape()
 
 	int potential_bridge_height = ZOOM_LVL_BASE * TILE_HEIGHT * _settings_game.construction.max_bridge_height;
 
+	ViewportTileSpriteCache *sprite_cache = GetViewportTileSpriteCache();
+
 	/* Rows overlap with neighbouring rows by a half tile.
 	 * The first row that could possibly be visible is the row above upper_left (if it is at height 0).
 	 * Due to integer-division not rounding down for negative numbers, we need another decrement.
@@ -1670,7 +2028,7 @@ static void ViewportAddLandscape()
 				_vd.last_foundation_child[1] = nullptr;
 
 				bool no_ground_tiles = min_visible_height > 0;
-				_tile_type_procs[tile_type]->draw_tile_proc(&tile_info, { min_visible_height, no_ground_tiles });
+				ViewportAddTileSprites(sprite_cache, &tile_info, tile_type, { min_visible_height, no_ground_tiles });
 				if (tile_info.tile != INVALID_TILE && min_visible_height <= 0) {
 					DrawTileSelection(&tile_info);
 					DrawTileZoning(&tile_info);
@@ -1999,74 +2357,20 @@ static void ViewportDrawBoundingBoxes(const ParentSpriteToSortVector *psd)
 	}
 }
 
-static void ViewportMapStoreBridge(const Viewport * const vp, const TileIndex tile)
-{
-	extern LegendAndColour _legend_land_owners[NUM_NO_COMPANY_ENTRIES + MAX_COMPANIES + 1];
-	extern uint _company_to_list_pos[MAX_COMPANIES];
-
-	/* No need to bother for hidden things */
-	if (!_settings_client.gui.show_bridges_on_map) return;
-	const Owner o = GetTileOwner(tile);
-	if (o < MAX_COMPANIES && !_legend_land_owners[_company_to_list_pos[o]].show_on_map) return;
-
-	switch (GetTunnelBridgeDirection(tile)) {
-		case DIAGDIR_NE: {
-			/* X axis: tile at higher coordinate, facing towards lower coordinate */
-			auto iter = _vd.bridge_to_map_x.lower_bound(tile);
-			if (iter != _vd.bridge_to_map_x.begin()) {
-				auto prev = iter;
-				--prev;
-				if (prev->second == tile) return;
-			}
-			_vd.bridge_to_map_x.insert(iter, std::make_pair(GetOtherTunnelBridgeEnd(tile), tile));
-			break;
-		}
-
-		case DIAGDIR_NW: {
-			/* Y axis: tile at higher coordinate, facing towards lower coordinate */
-			auto iter = _vd.bridge_to_map_y.lower_bound(tile);
-			if (iter != _vd.bridge_to_map_y.begin()) {
-				auto prev = iter;
-				--prev;
-				if (prev->second == tile) return;
-			}
-			_vd.bridge_to_map_y.insert(iter, std::make_pair(GetOtherTunnelBridgeEnd(tile), tile));
-			break;
-		}
-
-		case DIAGDIR_SW: {
-			/* X axis: tile at lower coordinate, facing towards higher coordinate */
-			auto iter = _vd.bridge_to_map_x.lower_bound(tile);
-			if (iter != _vd.bridge_to_map_x.end() && iter->first == tile) return;
-			_vd.bridge_to_map_x.insert(iter, std::make_pair(tile, GetOtherTunnelBridgeEnd(tile)));
-			break;
-		}
-
-		case DIAGDIR_SE: {
-			/* Y axis: tile at lower coordinate, facing towards higher coordinate */
-			auto iter = _vd.bridge_to_map_y.lower_bound(tile);
-			if (iter != _vd.bridge_to_map_y.end() && iter->first == tile) return;
-			_vd.bridge_to_map_y.insert(iter, std::make_pair(tile, GetOtherTunnelBridgeEnd(tile)));
-			break;
-		}
-
-		default:
-			NOT_REACHED();
-	}
-}
-
-void ViewportMapStoreTunnel(const TileIndex tile, const TileIndex tile_south, const int tunnel_z, const bool insert_sorted)
+/**
+ * Add a tunnel or bridge to the list of tunnels or bridges drawn on top of the viewport map.
+ * All of them are stored, whether they are shown or not, so that changing what is shown
+ * does not require rebuilding the lists.
+ * @param storage The list of tunnels or bridges along one axis.
+ * @param tile The northern end.
+ * @param tile_south The southern end.
+ * @param z Height level at which the tunnel or bridge is drawn.
+ * @param insert_sorted Whether to keep the list sorted; when false, the caller has to sort the list afterwards.
+ */
+static void ViewportMapStoreTunnelBridge(TunnelToMapStorage &storage, const TileIndex tile, const TileIndex tile_south, const int z, const bool insert_sorted)
 {
-	extern LegendAndColour _legend_land_owners[NUM_NO_COMPANY_ENTRIES + MAX_COMPANIES + 1];
-	extern uint _company_to_list_pos[MAX_COMPANIES];
-
-	/* No need to bother for hidden things */
-	if (!_settings_client.gui.show_tunnels_on_map) return;
-	const Owner o = GetTileOwner(tile);
-	if (o < MAX_COMPANIES && !_legend_land_owners[_company_to_list_pos[o]].show_on_map) return;
-
 	const Axis axis = (TileX(tile) == TileX(tile_south)) ? AXIS_Y : AXIS_X;
-	const Point viewport_pt = RemapCoords(TileX(tile) * TILE_SIZE, TileY(tile) * TILE_SIZE, tunnel_z);
+	const Point viewport_pt = RemapCoords(TileX(tile) * TILE_SIZE, TileY(tile) * TILE_SIZE, z * TILE_HEIGHT);
 	int y_intercept;
 	if (axis == AXIS_X) {
 		/* NE to SW */
@@ -2075,7 +2379,6 @@ void ViewportMapStoreTunnel(const TileIndex tile, const TileIndex tile_south, co
 		/* NW to SE */
 		y_intercept = viewport_pt.y - (viewport_pt.x / 2);
 	}
-	TunnelToMapStorage &storage = (axis == AXIS_X) ? _vd.tunnel_to_map_x : _vd.tunnel_to_map_y;
 	TunnelToMap *tbtm;
 	if (insert_sorted) {
 		auto iter = std::upper_bound(storage.tunnels.begin(), storage.tunnels.end(), y_intercept, [](int a, const TunnelToMap &b) -> bool {
@@ -2091,40 +2394,90 @@ void ViewportMapStoreTunnel(const TileIndex tile, const TileIndex tile_south, co
 	tbtm->tb.from_tile = tile;
 	tbtm->tb.to_tile = tile_south;
 	tbtm->y_intercept = y_intercept;
-	tbtm->tunnel_z = tunnel_z;
+	tbtm->tunnel_z = z;
+}
+
+/**
+ * Remove a tunnel or bridge from the list of tunnels or bridges drawn on top of the viewport map.
+ * @param storage The list of tunnels or bridges along one axis.
+ * @param tile The northern end.
+ */
+static void ViewportMapRemoveTunnelBridge(TunnelToMapStorage &storage, const TileIndex tile)
+{
+	for (auto tbtm = storage.tunnels.begin(); tbtm != storage.tunnels.end(); tbtm++) {
+		if (tbtm->tb.from_tile == tile) {
+			storage.tunnels.erase(tbtm);
+			return;
+		}
+	}
+}
+
+/** Sort the lists of tunnels and bridges drawn on top of the viewport map, after they have been filled unsorted. */
+static void ViewportMapSortTunnelBridgeStorage(TunnelToMapStorage &storage)
+{
+	std::sort(storage.tunnels.begin(), storage.tunnels.end(), [](const TunnelToMap &a, const TunnelToMap &b) -> bool {
+		return a.y_intercept < b.y_intercept;
+	});
+}
+
+void ViewportMapStoreTunnel(const TileIndex tile, const TileIndex tile_south, const int tunnel_z, const bool insert_sorted)
+{
+	const Axis axis = (TileX(tile) == TileX(tile_south)) ? AXIS_Y : AXIS_X;
+	ViewportMapStoreTunnelBridge((axis == AXIS_X) ? _vd.tunnel_to_map_x : _vd.tunnel_to_map_y, tile, tile_south, tunnel_z, insert_sorted);
 }
 
 void ViewportMapClearTunnelCache()
 {
 	_vd.tunnel_to_map_x.tunnels.clear();
 	_vd.tunnel_to_map_y.tunnels.clear();
+	_vd.bridge_to_map_x.tunnels.clear();
+	_vd.bridge_to_map_y.tunnels.clear();
 }
 
 void ViewportMapInvalidateTunnelCacheByTile(const TileIndex tile, const Axis axis)
 {
-	if (!_settings_client.gui.show_tunnels_on_map) return;
-	std::vector<TunnelToMap> &tbtmv = (axis == AXIS_X) ? _vd.tunnel_to_map_x.tunnels : _vd.tunnel_to_map_y.tunnels;
-	for (auto tbtm = tbtmv.begin(); tbtm != tbtmv.end(); tbtm++) {
-		if (tbtm->tb.from_tile == tile) {
-			tbtmv.erase(tbtm);
-			return;
-		}
-	}
+	ViewportMapRemoveTunnelBridge((axis == AXIS_X) ? _vd.tunnel_to_map_x : _vd.tunnel_to_map_y, tile);
+}
+
+/**
+ * Add a bridge to the bridges drawn on top of the viewport map.
+ * @param tile The northern end of the bridge.
+ * @param tile_south The southern end of the bridge.
+ */
+void ViewportMapStoreBridge(const TileIndex tile, const TileIndex tile_south)
+{
+	const Axis axis = (TileX(tile) == TileX(tile_south)) ? AXIS_Y : AXIS_X;
+	ViewportMapStoreTunnelBridge((axis == AXIS_X) ? _vd.bridge_to_map_x : _vd.bridge_to_map_y, tile, tile_south, GetBridgeHeight(tile) - 1, true);
 }
 
+/**
+ * Remove a bridge from the bridges drawn on top of the viewport map.
+ * @param tile The northern end of the bridge.
+ * @param axis The axis of the bridge.
+ */
+void ViewportMapInvalidateBridgeCacheByTile(const TileIndex tile, const Axis axis)
+{
+	ViewportMapRemoveTunnelBridge((axis == AXIS_X) ? _vd.bridge_to_map_x : _vd.bridge_to_map_y, tile);
+}
+
+/** Build the lists of tunnels and bridges drawn on top of the viewport map, e.g. after loading a game. */
 void ViewportMapBuildTunnelCache()
 {
 	ViewportMapClearTunnelCache();
-	if (_settings_client.gui.show_tunnels_on_map) {
-		for (Tunnel *tunnel : Tunnel::Iterate()) {
-			ViewportMapStoreTunnel(tunnel->tile_n, tunnel->tile_s, tunnel->height, false);
-		}
-		auto sorter = [](const TunnelToMap &a, const TunnelToMap &b) -> bool {
-			return a.y_intercept < b.y_intercept;
-		};
-		std::sort(_vd.tunnel_to_map_x.tunnels.begin(), _vd.tunnel_to_map_x.tunnels.end(), sorter);
-		std::sort(_vd.tunnel_to_map_y.tunnels.begin(), _vd.tunnel_to_map_y.tunnels.end(), sorter);
+	for (Tunnel *tunnel : Tunnel::Iterate()) {
+		ViewportMapStoreTunnel(tunnel->tile_n, tunnel->tile_s, tunnel->height, false);
 	}
+	for (TileIndex tile = 0; tile < MapSize(); tile++) {
+		if (!IsBridgeTile(tile)) continue;
+		/* Only store a bridge once, by its northern end. */
+		DiagDirection dir = GetTunnelBridgeDirection(tile);
+		if (dir != DIAGDIR_SW && dir != DIAGDIR_SE) continue;
+		ViewportMapStoreTunnelBridge((DiagDirToAxis(dir) == AXIS_X) ? _vd.bridge_to_map_x : _vd.bridge_to_map_y, tile, GetOtherTunnelBridgeEnd(tile), GetBridgeHeight(tile) - 1, false);
+	}
+	ViewportMapSortTunnelBridgeStorage(_vd.tunnel_to_map_x);
+	ViewportMapSortTunnelBridgeStorage(_vd.tunnel_to_map_y);
+	ViewportMapSortTunnelBridgeStorage(_vd.bridge_to_map_x);
+	ViewportMapSortTunnelBridgeStorage(_vd.bridge_to_map_y);
 }
 
 /**
@@ -2830,34 +3183,24 @@ static inline uint32 ViewportMapGetColourRoutes(const TileIndex tile, TileType t
 	return IS32(colour);
 }
 
-static inline void ViewportMapStoreBridgeAboveTile(const Viewport * const vp, const TileIndex tile)
+/**
+ * Get the number of tiles along each side of the area of which the most significant tile is shown by a pixel of a viewport map.
+ * @param vp The viewport.
+ * @return The number of tiles, or 0 when each pixel shows the tile below it.
+ */
+static inline uint ViewportMapGetScanLength(const Viewport * const vp)
 {
-	/* No need to bother for hidden things */
-	if (!_settings_client.gui.show_bridges_on_map) return;
-
-	if (GetBridgeAxis(tile) == AXIS_X) {
-		auto iter = _vd.bridge_to_map_x.lower_bound(tile);
-		if (iter != _vd.bridge_to_map_x.end() && iter->first < tile && iter->second > tile) return; /* already covered */
-		_vd.bridge_to_map_x.insert(iter, std::make_pair(GetNorthernBridgeEnd(tile), GetSouthernBridgeEnd(tile)));
-	} else {
-		auto iter = _vd.bridge_to_map_y.lower_bound(tile);
-		if (iter != _vd.bridge_to_map_y.end() && iter->first < tile && iter->second > tile) return; /* already covered */
-		_vd.bridge_to_map_y.insert(iter, std::make_pair(GetNorthernBridgeEnd(tile), GetSouthernBridgeEnd(tile)));
-	}
+	if (vp->zoom <= ZOOM_LVL_OUT_128X || !_settings_client.gui.viewport_map_scan_surroundings) return 0;
+	return (vp->zoom - ZOOM_LVL_OUT_128X) * 2;
 }
 
-static inline TileIndex ViewportMapGetMostSignificantTileType(const Viewport * const vp, const TileIndex from_tile, TileType * const tile_type)
+static inline TileIndex ViewportMapGetMostSignificantTileType(const uint scan_length, const TileIndex from_tile, TileType * const tile_type)
 {
-	if (vp->zoom <= ZOOM_LVL_OUT_128X || !_settings_client.gui.viewport_map_scan_surroundings) {
+	if (scan_length == 0) {
 		const TileType ttype = GetTileType(from_tile);
-		/* Store bridges and tunnels. */
 		if (ttype != MP_TUNNELBRIDGE) {
 			*tile_type = ttype;
-			if (IsBridgeAbove(from_tile)) ViewportMapStoreBridgeAboveTile(vp, from_tile);
 		} else {
-			if (IsBridge(from_tile)) {
-				ViewportMapStoreBridge(vp, from_tile);
-			}
 			switch (GetTunnelBridgeTransportType(from_tile)) {
 				case TRANSPORT_RAIL:  *tile_type = MP_RAILWAY; break;
 				case TRANSPORT_ROAD:  *tile_type = MP_ROAD;    break;
@@ -2868,8 +3211,7 @@ static inline TileIndex ViewportMapGetMostSignificantTileType(const Viewport * c
 		return from_tile;
 	}
 
-	const uint8 length = (vp->zoom - ZOOM_LVL_OUT_128X) * 2;
-	TileArea tile_area = TileArea(from_tile, length, length);
+	TileArea tile_area = TileArea(from_tile, scan_length, scan_length);
 	tile_area.ClampToMap();
 
 	/* Find the most important tile of the area. */
@@ -2882,17 +3224,10 @@ static inline TileIndex ViewportMapGetMostSignificantTileType(const Viewport * c
 			importance = tile_importance;
 			result = tile;
 		}
-		if (ttype != MP_TUNNELBRIDGE && IsBridgeAbove(tile)) {
-			ViewportMapStoreBridgeAboveTile(vp, tile);
-		}
 	}
 
-	/* Store bridges and tunnels. */
 	*tile_type = GetTileType(result);
 	if (*tile_type == MP_TUNNELBRIDGE) {
-		if (IsBridge(result)) {
-			ViewportMapStoreBridge(vp, result);
-		}
 		switch (GetTunnelBridgeTransportType(result)) {
 			case TRANSPORT_RAIL: *tile_type = MP_RAILWAY; break;
 			case TRANSPORT_ROAD: *tile_type = MP_ROAD;    break;
@@ -2903,9 +3238,219 @@ static inline TileIndex ViewportMapGetMostSignificantTileType(const Viewport * c
 	return result;
 }
 
-/** Get the colour of a tile, can be 32bpp RGB or 8bpp palette index. */
+/**
+ * Cache of the colours of tiles in the viewport map mode, for one map type.
+ * The colour shown for a tile, which at far zoom levels means looking at the tiles around
+ * it, is kept until a tile it depends on changes, see #ViewportMapMarkTileDirty, or until
+ * the legends or colour settings change, see #ViewportMapInvalidateColourCaches.
+ * The tiles are stored in blocks, which are only allocated for the parts of the map that are
+ * drawn. Blocks may be allocated and tiles filled by multiple threads drawing the same viewport.
+ */
+struct ViewportMapColourCache {
+	static const uint BLOCK_BITS = 6;                ///< Number of bits of the tile coordinates within a block.
+	static const uint BLOCK_SIZE = 1 << BLOCK_BITS;  ///< Number of tiles along each side of a block.
+	static const uint32 INVALID_COLOUR = 0xD7D7D7D7; ///< Marker of a colour which is not cached, as in the land pixel cache.
+
+	/** A square of tiles. */
+	struct Block {
+		std::atomic<uint32> colours[BLOCK_SIZE * BLOCK_SIZE][4]; ///< Colours of the tiles, for each colour index.
+
+		Block()
+		{
+			for (auto &tile : this->colours) {
+				for (auto &colour : tile) colour.store(INVALID_COLOUR, std::memory_order_relaxed);
+			}
+		}
+	};
+
+	uint32 key = 0;    ///< Drawing parameters the colours were determined with, see #GetKey; 0 when nothing is cached.
+	uint blocks_x = 0; ///< Number of blocks along the X axis.
+	uint blocks_y = 0; ///< Number of blocks along the Y axis.
+	std::unique_ptr<std::atomic<Block *>[]> blocks; ///< The blocks of tiles, \c nullptr when not allocated yet.
+
+	~ViewportMapColourCache() { this->Clear(); }
+
+	/**
+	 * Get the key of the drawing parameters which the colours depend on, besides the map type.
+	 * @param is_32bpp Whether 32bpp colours are cached.
+	 * @param show_slope Whether slopes are shown.
+	 * @param scan_length The result of #ViewportMapGetScanLength.
+	 * @return The key.
+	 */
+	static inline uint32 GetKey(bool is_32bpp, bool show_slope, uint scan_length)
+	{
+		return 1 | (is_32bpp ? 2 : 0) | (show_slope ? 4 : 0) | (scan_length << 3);
+	}
+
+	/**
+	 * Get the index of a tile within its block.
+	 * @param tile The tile.
+	 * @return The index in the block.
+	 */
+	static inline uint GetTileIndexInBlock(TileIndex tile)
+	{
+		return (GB(TileY(tile), 0, BLOCK_BITS) << BLOCK_BITS) | GB(TileX(tile), 0, BLOCK_BITS);
+	}
+
+	void Clear();
+	void Setup(uint32 key);
+	Block *GetBlock(TileIndex tile, bool allocate);
+	void MarkTileDirty(uint x, uint y);
+};
+
+/** Maximum number of blocks of all viewport map colour caches together; about 64 MiB. */
+static const uint VIEWPORT_MAP_COLOUR_CACHE_MAX_BLOCKS = (64 << 20) / sizeof(ViewportMapColourCache::Block);
+/** Minimum number of pixels to determine for drawing a viewport map using multiple threads. */
+static const uint VIEWPORT_MAP_PARALLEL_PIXELS = 1 << 16;
+
+static ViewportMapColourCache _vp_map_colour_caches[VPMT_END]; ///< The colour caches of all map types.
+static uint _vp_map_colour_cache_blocks = 0;                   ///< Number of blocks allocated by all colour caches.
+static std::mutex _vp_map_colour_cache_lock;                   ///< Lock for allocating blocks while drawing with multiple threads.
+
+/** Free all tiles. */
+void ViewportMapColourCache::Clear()
+{
+	if (this->blocks != nullptr) {
+		for (uint i = 0; i < this->blocks_x * this->blocks_y; i++) {
+			Block *block = this->blocks[i].load(std::memory_order_relaxed);
+			if (block == nullptr) continue;
+			delete block;
+			_vp_map_colour_cache_blocks--;
+		}
+		this->blocks.reset();
+	}
+	this->key = 0;
+}
+
+/**
+ * Prepare the cache for drawing, and drop its content when it does not match.
+ * @param key The key of the drawing parameters, see #GetKey.
+ */
+void ViewportMapColourCache::Setup(uint32 key)
+{
+	uint blocks_x = CeilDiv(MapSizeX(), BLOCK_SIZE);
+	uint blocks_y = CeilDiv(MapSizeY(), BLOCK_SIZE);
+	if (this->key == key && this->blocks_x == blocks_x && this->blocks_y == blocks_y) return;
+
+	this->Clear();
+	this->key = key;
+	this->blocks_x = blocks_x;
+	this->blocks_y = blocks_y;
+	this->blocks.reset(new std::atomic<Block *>[blocks_x * blocks_y]());
+}
+
+/**
+ * Get the block containing a tile.
+ * @param tile The tile; must be within the map.
+ * @param allocate Allocate the block when it is not there yet.
+ * @return The block, or \c nullptr when it is not allocated.
+ */
+ViewportMapColourCache::Block *ViewportMapColourCache::GetBlock(TileIndex tile, bool allocate)
+{
+	std::atomic<Block *> &slot = this->blocks[(TileY(tile) >> BLOCK_BITS) * this->blocks_x + (TileX(tile) >> BLOCK_BITS)];
+	Block *block = slot.load(std::memory_order_acquire);
+	if (block != nullptr || !allocate) return block;
+
+	std::lock_guard<std::mutex> lock(_vp_map_colour_cache_lock);
+	block = slot.load(std::memory_order_relaxed);
+	if (block != nullptr) return block;
+
+	if (_vp_map_colour_cache_blocks >= VIEWPORT_MAP_COLOUR_CACHE_MAX_BLOCKS) {
+		/* Make room by dropping the caches of the other map types; they are not being drawn. */
+		for (ViewportMapColourCache &cache : _vp_map_colour_caches) {
+			if (&cache != this) cache.Clear();
+		}
+		if (_vp_map_colour_cache_blocks >= VIEWPORT_MAP_COLOUR_CACHE_MAX_BLOCKS) return nullptr;
+	}
+	block = new Block();
+	_vp_map_colour_cache_blocks++;
+	slot.store(block, std::memory_order_release);
+	return block;
+}
+
+/**
+ * Mark the tiles whose colour depends on a tile as out of date.
+ * @param x X coordinate of the tile.
+ * @param y Y coordinate of the tile.
+ */
+void ViewportMapColourCache::MarkTileDirty(uint x, uint y)
+{
+	if (this->key == 0) return;
+
+	/* A tile shows the most significant tile of the area south of it. */
+	uint scan_length = std::max<uint>(this->key >> 3, 1);
+	uint x0 = x >= scan_length ? x - scan_length + 1 : 0;
+	uint y0 = y >= scan_length ? y - scan_length + 1 : 0;
+	for (uint ty = y0; ty <= y; ty++) {
+		for (uint tx = x0; tx <= x; tx++) {
+			TileIndex tile = TileXY(tx, ty);
+			Block *block = this->GetBlock(tile, false);
+			if (block == nullptr) continue;
+			for (auto &colour : block->colours[GetTileIndexInBlock(tile)]) colour.store(INVALID_COLOUR, std::memory_order_relaxed);
+		}
+	}
+}
+
+/**
+ * Tell the viewport map that a tile has changed, so the colours depending on it have to be determined again.
+ * @param tile The changed tile.
+ */
+static void ViewportMapMarkTileDirty(TileIndex tile)
+{
+	if (_vp_map_colour_cache_blocks == 0) return;
+
+	for (ViewportMapColourCache &cache : _vp_map_colour_caches) {
+		cache.MarkTileDirty(TileX(tile), TileY(tile));
+	}
+}
+
+/**
+ * Drop cached viewport map colours, e.g. because the legends or colour settings have changed.
+ * @param map_type The map type to drop the colours of, or #VPMT_END for all of them.
+ */
+void ViewportMapInvalidateColourCaches(ViewportMapType map_type)
+{
+	for (uint i = VPMT_BEGIN; i < VPMT_END; i++) {
+		if (map_type == VPMT_END || map_type == (ViewportMapType)i) _vp_map_colour_caches[i].Clear();
+	}
+}
+
+/**
+ * Get the colour of a tile, without looking at the colour cache.
+ * @param map_type The map type.
+ * @param scan_length The result of #ViewportMapGetScanLength.
+ * @param tile The tile.
+ * @param colour_index Index of the colour within the colour patterns.
+ * @return 32bpp RGB colour or 8bpp palette index.
+ */
 template <bool is_32bpp, bool show_slope>
-uint32 ViewportMapGetColour(const Viewport * const vp, int x, int y, const uint colour_index)
+static uint32 ViewportMapGetTileColour(const ViewportMapType map_type, const uint scan_length, TileIndex tile, const uint colour_index)
+{
+	TileType tile_type = MP_VOID;
+	tile = ViewportMapGetMostSignificantTileType(scan_length, tile, &tile_type);
+	if (tile_type == MP_VOID) return 0;
+
+	/* Return the colours. */
+	switch (map_type) {
+		default:              return ViewportMapGetColourOwner<is_32bpp, show_slope>(tile, tile_type, colour_index);
+		case VPMT_INDUSTRY:   return ViewportMapGetColourIndustries<is_32bpp, show_slope>(tile, tile_type, colour_index);
+		case VPMT_VEGETATION: return ViewportMapGetColourVegetation<is_32bpp, show_slope>(tile, tile_type, colour_index);
+		case VPMT_ROUTES:     return ViewportMapGetColourRoutes<is_32bpp, show_slope>(tile, tile_type, colour_index);
+	}
+}
+
+/**
+ * Get the colour of a pixel, can be 32bpp RGB or 8bpp palette index.
+ * @param map_type The map type.
+ * @param scan_length The result of #ViewportMapGetScanLength.
+ * @param cache The colour cache to use, or \c nullptr to not use one.
+ * @param x Virtual X coordinate of the pixel.
+ * @param y Virtual Y coordinate of the pixel.
+ * @param colour_index Index of the colour within the colour patterns.
+ * @return The colour.
+ */
+template <bool is_32bpp, bool show_slope>
+uint32 ViewportMapGetColour(const ViewportMapType map_type, const uint scan_length, ViewportMapColourCache * const cache, int x, int y, const uint colour_index)
 {
 	if (x >= static_cast<int>(MapMaxX() * TILE_SIZE) || y >= static_cast<int>(MapMaxY() * TILE_SIZE)) return 0;
 
@@ -2928,17 +3473,17 @@ uint32 ViewportMapGetColour(const Viewport * const vp, int x, int y, const uint
 		tile = TileVirtXY(x + approx_z, y + approx_z);
 		if (tile >= MapSize()) return 0;
 	}
-	TileType tile_type = MP_VOID;
-	tile = ViewportMapGetMostSignificantTileType(vp, tile, &tile_type);
-	if (tile_type == MP_VOID) return 0;
 
-	/* Return the colours. */
-	switch (vp->map_type) {
-		default:              return ViewportMapGetColourOwner<is_32bpp, show_slope>(tile, tile_type, colour_index);
-		case VPMT_INDUSTRY:   return ViewportMapGetColourIndustries<is_32bpp, show_slope>(tile, tile_type, colour_index);
-		case VPMT_VEGETATION: return ViewportMapGetColourVegetation<is_32bpp, show_slope>(tile, tile_type, colour_index);
-		case VPMT_ROUTES:     return ViewportMapGetColourRoutes<is_32bpp, show_slope>(tile, tile_type, colour_index);
+	ViewportMapColourCache::Block *block = (cache != nullptr) ? cache->GetBlock(tile, true) : nullptr;
+	if (block == nullptr) return ViewportMapGetTileColour<is_32bpp, show_slope>(map_type, scan_length, tile, colour_index);
+
+	std::atomic<uint32> &cached = block->colours[ViewportMapColourCache::GetTileIndexInBlock(tile)][colour_index];
+	uint32 colour = cached.load(std::memory_order_relaxed);
+	if (colour == ViewportMapColourCache::INVALID_COLOUR) {
+		colour = ViewportMapGetTileColour<is_32bpp, show_slope>(map_type, scan_length, tile, colour_index);
+		cached.store(colour, std::memory_order_relaxed);
 	}
+	return colour;
 }
 
 /* Taken from http://stereopsis.com/doubleblend.html, PixelBlend() is faster than ComposeColourRGBANoCheck() */
@@ -3068,56 +3613,85 @@ void ViewportMapDraw(Viewport * const vp)
 	const  int sx = UnScaleByZoomLower(_vd.dpi.left, _vd.dpi.zoom);
 	const  int sy = UnScaleByZoomLower(_vd.dpi.top, _vd.dpi.zoom);
 	const uint line_padding = 2 * (sy & 1);
-	uint       colour_index_base = (sx + line_padding) & 3;
 
 	const  int incr_a = (1 << (vp->zoom - 2)) / ZOOM_LVL_BASE;
 	const  int incr_b = (1 << (vp->zoom - 1)) / ZOOM_LVL_BASE;
 	const  int a = (_vd.dpi.left >> 2) / ZOOM_LVL_BASE;
-	int        b = (_vd.dpi.top >> 1) / ZOOM_LVL_BASE;
+	const  int b = (_vd.dpi.top >> 1) / ZOOM_LVL_BASE;
 	const  int w = UnScaleByZoom(_vd.dpi.width, vp->zoom);
 	const  int h = UnScaleByZoom(_vd.dpi.height, vp->zoom);
-	int        j = 0;
 
 	const int land_cache_start = _vd.offset_x + (_vd.offset_y * vp->width);
-	uint32 *land_cache_ptr32 = reinterpret_cast<uint32 *>(vp->land_pixel_cache.data()) + land_cache_start;
-	uint8 *land_cache_ptr8 = reinterpret_cast<uint8 *>(vp->land_pixel_cache.data()) + land_cache_start;
-
-	bool cache_updated = false;
-
-	/* Render base map. */
-	do { // For each line
-		int i = w;
-		uint colour_index = colour_index_base;
-		colour_index_base ^= 2;
-		int c = b - a;
-		int d = b + a;
-		do { // For each pixel of a line
-			if (is_32bpp) {
-				if (*land_cache_ptr32 == 0xD7D7D7D7) {
-					*land_cache_ptr32 = ViewportMapGetColour<is_32bpp, show_slope>(vp, c, d, colour_index);
-					cache_updated = true;
-				}
-				land_cache_ptr32++;
-			} else {
-				if (*land_cache_ptr8 == 0xD7) {
-					*land_cache_ptr8 = (uint8) ViewportMapGetColour<is_32bpp, show_slope>(vp, c, d, colour_index);
-					cache_updated = true;
+	uint32 * const land_cache_32 = reinterpret_cast<uint32 *>(vp->land_pixel_cache.data()) + land_cache_start;
+	uint8 * const land_cache_8 = reinterpret_cast<uint8 *>(vp->land_pixel_cache.data()) + land_cache_start;
+
+	const ViewportMapType map_type = vp->map_type;
+	const uint scan_length = ViewportMapGetScanLength(vp);
+	ViewportMapColourCache *cache = nullptr;
+	if (likely(!HasBit(_viewport_debug_flags, VDF_DISABLE_LANDSCAPE_CACHE))) {
+		cache = &_vp_map_colour_caches[map_type];
+		cache->Setup(ViewportMapColourCache::GetKey(is_32bpp, show_slope, scan_length));
+	}
+
+	/* Count the pixels which are not in the land pixel cache, up to the amount which is worth using multiple threads for. */
+	uint pending = 0;
+	for (int j = 0; j < h && pending < VIEWPORT_MAP_PARALLEL_PIXELS; j++) {
+		for (int i = 0; i < w; i++) {
+			if (is_32bpp ? land_cache_32[i + j * vp->width] == 0xD7D7D7D7 : land_cache_8[i + j * vp->width] == 0xD7) pending++;
+		}
+	}
+
+	/* Render the base map for the lines [begin, end). */
+	auto render_lines = [&](int begin, int end) {
+		uint colour_index_base = ((sx + line_padding) & 3) ^ ((begin & 1) ? 2 : 0);
+		for (int j = begin; j < end; j++) { // For each line
+			uint colour_index = colour_index_base;
+			colour_index_base ^= 2;
+			int c = (b + j * incr_b) - a;
+			int d = (b + j * incr_b) + a;
+			uint32 *land_cache_ptr32 = land_cache_32 + j * vp->width;
+			uint8 *land_cache_ptr8 = land_cache_8 + j * vp->width;
+			for (int i = w; i > 0; i--) { // For each pixel of a line
+				if (is_32bpp) {
+					if (*land_cache_ptr32 == 0xD7D7D7D7) {
+						*land_cache_ptr32 = ViewportMapGetColour<is_32bpp, show_slope>(map_type, scan_length, cache, c, d, colour_index);
+					}
+					land_cache_ptr32++;
+				} else {
+					if (*land_cache_ptr8 == 0xD7) {
+						*land_cache_ptr8 = (uint8) ViewportMapGetColour<is_32bpp, show_slope>(map_type, scan_length, cache, c, d, colour_index);
+					}
+					land_cache_ptr8++;
 				}
-				land_cache_ptr8++;
+				colour_index = (colour_index + 1) & 3;
+				c -= incr_a;
+				d += incr_a;
 			}
-			colour_index = (colour_index + 1) & 3;
-			c -= incr_a;
-			d += incr_a;
-		} while (--i);
-		if (is_32bpp) {
-			land_cache_ptr32 += (vp->width - w);
-		} else {
-			land_cache_ptr8 += (vp->width - w);
 		}
-		b += incr_b;
-	} while (++j < h);
+	};
 
-	auto draw_tunnels = [&](const int y_intercept_min, const int y_intercept_max, const TunnelToMapStorage &storage) {
+	const bool cache_updated = pending > 0;
+	if (pending >= VIEWPORT_MAP_PARALLEL_PIXELS) {
+		uint threads = Clamp<uint>(std::thread::hardware_concurrency(), 1, 16);
+		std::vector<std::thread> workers;
+		int per_thread = CeilDiv(h, threads);
+		for (uint t = 1; t < threads; t++) {
+			int begin = std::min<int>(h, t * per_thread);
+			int end = std::min<int>(h, begin + per_thread);
+			std::thread worker;
+			if (!StartNewThread(&worker, "ottd:vpmap", std::ref(render_lines), int(begin), int(end))) {
+				render_lines(begin, end);
+				continue;
+			}
+			workers.push_back(std::move(worker));
+		}
+		render_lines(0, std::min(h, per_thread));
+		for (std::thread &worker : workers) worker.join();
+	} else if (pending > 0) {
+		render_lines(0, h);
+	}
+
+	auto draw_tunnel_bridges = [&](const int y_intercept_min, const int y_intercept_max, const TunnelToMapStorage &storage, const bool is_tunnel) {
 		auto iter = std::lower_bound(storage.tunnels.begin(), storage.tunnels.end(), y_intercept_min, [](const TunnelToMap &a, int b) -> bool {
 			return a.y_intercept < b;
 		});
@@ -3135,35 +3709,26 @@ void ViewportMapDraw(Viewport * const vp)
 			const int y_to = UnScaleByZoomLower(pt_to.y - _vd.dpi.top, _vd.dpi.zoom);
 			if ((y_from < 0 && y_to < 0) || (y_from > h && y_to > h)) continue;
 
-			ViewportMapDrawBridgeTunnel<is_32bpp>(vp, &ttm.tb, tunnel_z, true, w, h, blitter);
+			ViewportMapDrawBridgeTunnel<is_32bpp>(vp, &ttm.tb, tunnel_z, is_tunnel, w, h, blitter);
 		}
 	};
 
 	if (cache_updated) {
+		const int x_y_intercept_min = _vd.dpi.top + (_vd.dpi.left / 2);
+		const int x_y_intercept_max = _vd.dpi.top + _vd.dpi.height + ((_vd.dpi.left + _vd.dpi.width) / 2);
+		const int y_y_intercept_min = _vd.dpi.top - ((_vd.dpi.left + _vd.dpi.width) / 2);
+		const int y_y_intercept_max = _vd.dpi.top + _vd.dpi.height - (_vd.dpi.left / 2);
+
 		/* Render tunnels */
-		if (_settings_client.gui.show_tunnels_on_map && _vd.tunnel_to_map_x.tunnels.size() != 0) {
-			const int y_intercept_min = _vd.dpi.top + (_vd.dpi.left / 2);
-			const int y_intercept_max = _vd.dpi.top + _vd.dpi.height + ((_vd.dpi.left + _vd.dpi.width) / 2);
-			draw_tunnels(y_intercept_min, y_intercept_max, _vd.tunnel_to_map_x);
-		}
-		if (_settings_client.gui.show_tunnels_on_map && _vd.tunnel_to_map_y.tunnels.size() != 0) {
-			const int y_intercept_min = _vd.dpi.top - ((_vd.dpi.left + _vd.dpi.width) / 2);
-			const int y_intercept_max = _vd.dpi.top + _vd.dpi.height - (_vd.dpi.left / 2);
-			draw_tunnels(y_intercept_min, y_intercept_max, _vd.tunnel_to_map_y);
+		if (_settings_client.gui.show_tunnels_on_map) {
+			draw_tunnel_bridges(x_y_intercept_min, x_y_intercept_max, _vd.tunnel_to_map_x, true);
+			draw_tunnel_bridges(y_y_intercept_min, y_y_intercept_max, _vd.tunnel_to_map_y, true);
 		}
 
 		/* Render bridges */
-		if (_settings_client.gui.show_bridges_on_map && _vd.bridge_to_map_x.size() != 0) {
-			for (const auto &it : _vd.bridge_to_map_x) { // For each bridge
-				TunnelBridgeToMap tbtm { it.first, it.second };
-				ViewportMapDrawBridgeTunnel<is_32bpp>(vp, &tbtm, (GetBridgeHeight(tbtm.from_tile) - 1) * TILE_HEIGHT, false, w, h, blitter);
-			}
-		}
-		if (_settings_client.gui.show_bridges_on_map && _vd.bridge_to_map_y.size() != 0) {
-			for (const auto &it : _vd.bridge_to_map_y) { // For each bridge
-				TunnelBridgeToMap tbtm { it.first, it.second };
-				ViewportMapDrawBridgeTunnel<is_32bpp>(vp, &tbtm, (GetBridgeHeight(tbtm.from_tile) - 1) * TILE_HEIGHT, false, w, h, blitter);
-			}
+		if (_settings_client.gui.show_bridges_on_map) {
+			draw_tunnel_bridges(x_y_intercept_min, x_y_intercept_max, _vd.bridge_to_map_x, false);
+			draw_tunnel_bridges(y_y_intercept_min, y_y_intercept_max, _vd.bridge_to_map_y, false);
 		}
 	}
 
@@ -3350,8 +3915,6 @@ void ViewportDoDraw(Viewport *vp, int left, int top, int right, int bottom)
 
 	_cur_dpi = old_dpi;
 
-	_vd.bridge_to_map_x.clear();
-	_vd.bridge_to_map_y.clear();
 	_vd.string_sprites_to_draw.clear();
 	_vd.tile_sprites_to_draw.clear();
 	_vd.parent_sprites_to_draw.clear();
@@ -3706,6 +4269,8 @@ void MarkAllViewportMapLandscapesDirty()
 			w->SetDirty();
 		}
 	}
+	InvalidateSmallMapColourCaches();
+	ViewportMapInvalidateColourCaches();
 }
 
 void MarkWholeNonMapViewportsDirty()
@@ -3764,6 +4329,11 @@ void MarkTileDirtyByTile(TileIndex tile, ViewportMarkDirtyFlags flags, int bridg
 			pt.y - 122 * ZOOM_LVL_BASE + 154 * ZOOM_LVL_BASE,
 			flags
 	);
+	if (!(flags & VMDF_NOT_LANDSCAPE)) {
+		MarkSmallMapTileDirty(tile);
+		ViewportMapMarkTileDirty(tile);
+		InvalidateViewportTileSpriteCache(tile);
+	}
 }
 
 void MarkTileGroundDirtyByTile(TileIndex tile, ViewportMarkDirtyFlags flags)
@@ -3773,6 +4343,11 @@ void MarkTileGroundDirtyByTile(TileIndex tile, ViewportMarkDirtyFlags flags)
 	Point top = RemapCoords(x, y, GetTileMaxPixelZ(tile));
 	Point bot = RemapCoords(x + TILE_SIZE, y + TILE_SIZE, GetTilePixelZ(tile));
 	MarkAllViewportsDirty(top.x - TILE_PIXELS * ZOOM_LVL_BASE, top.y - TILE_HEIGHT * ZOOM_LVL_BASE, top.x + TILE_PIXELS * ZOOM_LVL_BASE, bot.y, flags);
+	if (!(flags & VMDF_NOT_LANDSCAPE)) {
+		MarkSmallMapTileDirty(tile);
+		ViewportMapMarkTileDirty(tile);
+		InvalidateViewportTileSpriteCache(tile);
+	}
 }
 
 void MarkViewportLineDirty(Viewport * const vp, const Point from_pt, const Point to_pt, const int block_radius, ViewportMarkDirtyFlags flags)
@@ -130,7 +130,12 @@ void ShowTooltipForTile(Window *w, const TileIndex tile);
 void ViewportMapStoreTunnel(const TileIndex tile, const TileIndex tile_south, const int tunnel_z, const bool insert_sorted);
 void ViewportMapClearTunnelCache();
 void ViewportMapInvalidateTunnelCacheByTile(const TileIndex tile, const Axis axis);
+void ViewportMapStoreBridge(const TileIndex tile, const TileIndex tile_south);
+void ViewportMapInvalidateBridgeCacheByTile(const TileIndex tile, const Axis axis);
 void ViewportMapBuildTunnelCache();
+void ViewportMapInvalidateColourCaches(ViewportMapType map_type = VPMT_END);
+void ClearViewportTileSpriteCaches();
+void InvalidateViewportTileSpriteCache(TileIndex tile);
 
 void DrawTileSelectionRect(const TileInfo *ti, PaletteID pal);
 void DrawSelectionSprite(SpriteID image, PaletteID pal, const TileInfo *ti, int z_offset, FoundationPart foundation_part, const SubSprite *sub = nullptr);
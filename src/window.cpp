@@ -39,6 +39,8 @@
 #include "guitimer_func.h"
 #include "news_func.h"
 
+#include <unordered_map>
+
 #include "safeguards.h"
 
 /** Values for _settings_client.gui.auto_scrolling */
@@ -63,6 +65,113 @@ bool _window_highlight_colour = false;
 
 uint64 _window_update_number = 1;
 
+/** Index of the open windows by their class and window number, see #GetWindowIndexKey. */
+static std::unordered_multimap<uint64, Window *> _window_id_index;
+/** Index of the open windows by their class. */
+static std::unordered_multimap<WindowClass, Window *> _window_class_index;
+
+/**
+ * Get the key of a window in #_window_id_index.
+ * @param cls Window class.
+ * @param number Window number.
+ * @return The key.
+ */
+static inline uint64 GetWindowIndexKey(WindowClass cls, WindowNumber number)
+{
+	return ((uint64)cls << 32) | (uint32)number;
+}
+
+/**
+ * Add a window to the indices of open windows.
+ * @param w The window.
+ */
+static void AddWindowToIndex(Window *w)
+{
+	w->index_class = w->window_class;
+	w->index_number = w->window_number;
+	_window_id_index.insert({ GetWindowIndexKey(w->index_class, w->index_number), w });
+	_window_class_index.insert({ w->index_class, w });
+}
+
+/**
+ * Remove a window from an index of open windows.
+ * @param index The index.
+ * @param key The key of the window in the index.
+ * @param w The window.
+ */
+template <typename K>
+static void RemoveWindowFromIndex(std::unordered_multimap<K, Window *> &index, K key, Window *w)
+{
+	auto range = index.equal_range(key);
+	for (auto it = range.first; it != range.second; ++it) {
+		if (it->second == w) {
+			index.erase(it);
+			return;
+		}
+	}
+}
+
+/**
+ * Remove a window from the indices of open windows.
+ * The window is looked up by the class and number it was added with, as those might have been changed since.
+ * @param w The window.
+ */
+static void RemoveWindowFromIndex(Window *w)
+{
+	RemoveWindowFromIndex(_window_id_index, GetWindowIndexKey(w->index_class, w->index_number), w);
+	RemoveWindowFromIndex(_window_class_index, w->index_class, w);
+}
+
+/**
+ * Call a function for all windows found in an index.
+ * The windows are looked up before calling the function, so it may open, close or renumber windows.
+ * @param index The index.
+ * @param key The key of the windows in the index.
+ * @param is_match Function checking whether a window still has to be handled when it is its turn.
+ * @param proc The function to call.
+ */
+template <typename K, typename M, typename F>
+static void ForAllIndexedWindows(const std::unordered_multimap<K, Window *> &index, K key, M is_match, F proc)
+{
+	auto range = index.equal_range(key);
+	if (range.first == range.second) return;
+
+	if (std::next(range.first) == range.second) {
+		/* The common case of a single window. */
+		if (is_match(range.first->second)) proc(range.first->second);
+		return;
+	}
+
+	std::vector<Window *> windows;
+	for (auto it = range.first; it != range.second; ++it) windows.push_back(it->second);
+	for (Window *w : windows) {
+		if (is_match(w)) proc(w);
+	}
+}
+
+/**
+ * Call a function for all open windows with a class and window number.
+ * @param cls Window class.
+ * @param number Window number.
+ * @param proc The function to call.
+ */
+template <typename F>
+static void ForAllWindowsById(WindowClass cls, WindowNumber number, F proc)
+{
+	ForAllIndexedWindows(_window_id_index, GetWindowIndexKey(cls, number), [&](const Window *w) { return w->window_class == cls && w->window_number == number; }, proc);
+}
+
+/**
+ * Call a function for all open windows of a class.
+ * @param cls Window class.
+ * @param proc The function to call.
+ */
+template <typename F>
+static void ForAllWindowsByClass(WindowClass cls, F proc)
+{
+	ForAllIndexedWindows(_window_class_index, cls, [&](const Window *w) { return w->window_class == cls; }, proc);
+}
+
 /*
  * Window that currently has focus. - The main purpose is to generate
  * #FocusLost events, not to give next window in z-order focus when a
@@ -1131,6 +1240,8 @@ Window::~Window()
 	free(this->nested_array); // Contents is released through deletion of #nested_root.
 	delete this->nested_root;
 
+	RemoveWindowFromIndex(this);
+
 	/*
 	 * Make fairly sure that this is written, and not "optimized" away.
 	 * The delete operator is overwritten to not delete it; the deletion
@@ -1151,13 +1262,40 @@ Window::~Window()
  */
 Window *FindWindowById(WindowClass cls, WindowNumber number)
 {
-	for (Window *w : Window::IterateFromBack()) {
-		if (w->window_class == cls && w->window_number == number) return w;
+	auto range = _window_id_index.equal_range(GetWindowIndexKey(cls, number));
+	for (auto it = range.first; it != range.second; ++it) {
+		/* Skip windows which are being closed. */
+		if (it->second->window_class == cls) return it->second;
 	}
-
 	return nullptr;
 }
 
+/**
+ * Change the window number of this window.
+ * The window number must not be assigned directly once the window has been initialised,
+ * as the window would then not be found by it.
+ * @param number The new window number.
+ */
+void Window::ChangeWindowNumber(WindowNumber number)
+{
+	RemoveWindowFromIndex(this);
+	this->window_number = number;
+	AddWindowToIndex(this);
+}
+
+/**
+ * Change the window class of this window.
+ * The window class must not be assigned directly once the window has been initialised,
+ * as the window would then not be found by it.
+ * @param cls The new window class.
+ */
+void Window::ChangeWindowClass(WindowClass cls)
+{
+	RemoveWindowFromIndex(this);
+	this->window_class = cls;
+	AddWindowToIndex(this);
+}
+
 /**
  * Find any window by its class. Useful when searching for a window that uses
  * the window number as a #WindowClass, like #WC_SEND_NETWORK_MSG.
@@ -1510,6 +1648,7 @@ void Window::InitializeData(WindowNumber window_number)
 
 	/* Insert the window into the correct location in the z-ordering. */
 	AddWindowToZOrdering(this);
+	AddWindowToIndex(this);
 }
 
 /**
@@ -1879,7 +2018,7 @@ void Window::InitNested(WindowNumber window_number)
  * Empty constructor, initialization has been moved to #InitNested() called from the constructor of the derived class.
  * @param desc The description of the window.
  */
-Window::Window(WindowDesc *desc) : window_desc(desc), mouse_capture_widget(-1)
+Window::Window(WindowDesc *desc) : window_desc(desc), index_class(WC_INVALID), index_number(0), mouse_capture_widget(-1)
 {
 }
 
@@ -1910,6 +2049,8 @@ void InitWindowSystem()
 
 	_z_back_window = nullptr;
 	_z_front_window = nullptr;
+	_window_id_index.clear();
+	_window_class_index.clear();
 	_focused_window = nullptr;
 	_mouseover_last_w = nullptr;
 	_last_scroll_window = nullptr;
@@ -3264,9 +3405,7 @@ void UpdateWindows()
  */
 void SetWindowDirty(WindowClass cls, WindowNumber number)
 {
-	for (Window *w : Window::IterateFromBack()) {
-		if (w->window_class == cls && w->window_number == number) w->SetDirty();
-	}
+	ForAllWindowsById(cls, number, [](Window *w) { w->SetDirty(); });
 }
 
 /**
@@ -3277,11 +3416,7 @@ void SetWindowDirty(WindowClass cls, WindowNumber number)
  */
 void SetWindowWidgetDirty(WindowClass cls, WindowNumber number, byte widget_index)
 {
-	for (Window *w : Window::IterateFromBack()) {
-		if (w->window_class == cls && w->window_number == number) {
-			w->SetWidgetDirty(widget_index);
-		}
-	}
+	ForAllWindowsById(cls, number, [&](Window *w) { w->SetWidgetDirty(widget_index); });
 }
 
 /**
@@ -3290,9 +3425,7 @@ void SetWindowWidgetDirty(WindowClass cls, WindowNumber number, byte widget_inde
  */
 void SetWindowClassesDirty(WindowClass cls)
 {
-	for (Window *w : Window::IterateFromBack()) {
-		if (w->window_class == cls) w->SetDirty();
-	}
+	ForAllWindowsByClass(cls, [](Window *w) { w->SetDirty(); });
 }
 
 /**
@@ -3303,8 +3436,11 @@ void SetWindowClassesDirty(WindowClass cls)
 void Window::InvalidateData(int data, bool gui_scope)
 {
 	if (!gui_scope) {
-		/* Schedule GUI-scope invalidation for next redraw. */
-		this->scheduled_invalidation_data.push_back(data);
+		/* Schedule GUI-scope invalidation for next redraw. Repeated invalidations with the
+		 * same data, e.g. from many vehicles in one tick, are only processed once. */
+		if (this->scheduled_invalidation_data.empty() || this->scheduled_invalidation_data.back() != data) {
+			this->scheduled_invalidation_data.push_back(data);
+		}
 	} else {
 		this->SetDirty();
 	}
@@ -3364,11 +3500,7 @@ void Window::ProcessHighlightedInvalidations()
  */
 void InvalidateWindowData(WindowClass cls, WindowNumber number, int data, bool gui_scope)
 {
-	for (Window *w : Window::IterateFromBack()) {
-		if (w->window_class == cls && w->window_number == number) {
-			w->InvalidateData(data, gui_scope);
-		}
-	}
+	ForAllWindowsById(cls, number, [&](Window *w) { w->InvalidateData(data, gui_scope); });
 }
 
 /**
@@ -3381,11 +3513,7 @@ void InvalidateWindowData(WindowClass cls, WindowNumber number, int data, bool g
  */
 void InvalidateWindowClassesData(WindowClass cls, int data, bool gui_scope)
 {
-	for (Window *w : Window::IterateFromBack()) {
-		if (w->window_class == cls) {
-			w->InvalidateData(data, gui_scope);
-		}
-	}
+	ForAllWindowsByClass(cls, [&](Window *w) { w->InvalidateData(data, gui_scope); });
 }
 
 /**
@@ -3669,7 +3797,7 @@ void RelocateAllWindows(int neww, int newh)
  */
 PickerWindowBase::~PickerWindowBase()
 {
-	this->window_class = WC_INVALID; // stop the ancestor from freeing the already (to be) child
+	this->ChangeWindowClass(WC_INVALID); // stop the ancestor from freeing the already (to be) child
 	ResetObjectToPlace();
 }
 
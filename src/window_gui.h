@@ -365,6 +365,8 @@ public:
 	WindowDesc *window_desc;    ///< Window description
 	WindowFlags flags;          ///< Window flags
 	WindowNumber window_number; ///< Window number within the window class
+	WindowClass index_class;    ///< Window class under which the window is in the indices of open windows.
+	WindowNumber index_number;  ///< Window number under which the window is in the indices of open windows.
 
 	uint8 timeout_timer;      ///< Timer value of the WF_TIMEOUT for flags.
 	uint8 white_border_timer; ///< Timer value of the WF_WHITE_BORDER for flags.
@@ -585,6 +587,8 @@ public:
 
 	void InvalidateData(int data = 0, bool gui_scope = true);
 	void ProcessScheduledInvalidations();
+	void ChangeWindowNumber(WindowNumber number);
+	void ChangeWindowClass(WindowClass cls);
 	void ProcessHighlightedInvalidations();
 
 	/*** Event handling ***/